@@ -0,0 +1,239 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: adcSequence.c
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Added the latency marker to ADC_ISR.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#include "adcSequence.h"
+#include "timebase.h"
+#include "profile.h"
+#include "memUsage.h"
+#include "latency.h"
+#include <msp430fr4133.h>
+#include <intrinsics.h>
+
+#define FIRST_CHANNEL   13                          // Sequence runs A13 down to A0
+#define POS_REFERENCE   (FIRST_CHANNEL - 13)
+#define POS_TEMPERATURE (FIRST_CHANNEL - 12)
+#define POS_LIGHT       (FIRST_CHANNEL - 4)
+#define POS_LAST        FIRST_CHANNEL               // A0
+
+static volatile unsigned int buffers[ADCSEQ_CHANNELS][ADCSEQ_BUFFER];
+static volatile unsigned int sequences = 0;
+static unsigned char position;                      // Next result's place in the sequence
+static unsigned int pending[ADCSEQ_CHANNELS];
+static volatile unsigned char running = 0;
+static AdcSeqHook sequenceHook = 0;
+
+/**************************************************************************
+ * Function: adcSeqArmTick
+ * Description:
+ *    Runs at ADCSEQ_HZ. Sets ADCENC so the next TA1.1 edge starts a
+ *    sequence, unless the last one is somehow still going.
+ **************************************************************************/
+static void adcSeqArmTick(void) {
+    if (!(ADCCTL0 & ADCENC) && !(ADCCTL1 & ADCBUSY)) {
+        position = 0;
+        ADCCTL0 |= ADCENC;
+    }
+}
+
+/**************************************************************************
+ * Function: adcSeqInit
+ **************************************************************************/
+int adcSeqInit(void) {
+    if (!timebaseClaimChannel(TIMEBASE_TA1, 1)) return 0;
+
+    PMMCTL0_H = PMMPW_H;                            // Unlock PMM
+    PMMCTL2 |= INTREFEN | TSENSOREN;                // 1.5 V reference & temperature sensor on
+    PMMCTL0_H = 0;
+
+    P1SEL0 |= BIT4;                                 // P1.4 analogue (A4)
+    SYSCFG2 |= ADCPCTL4;
+
+    ADCCTL0 &= ~ADCENC;
+    ADCCTL0 = ADCSHT_8 | ADCMSC | ADCON;            // 256 clock sample time (temp sensor needs > 30 us)
+    ADCCTL1 = ADCSHS_1 | ADCSHP | ADCCONSEQ_1;      // TA1.1 trigger, sequence of channels
+    ADCCTL2 = ADCRES;                               // 10-bit results
+    ADCMCTL0 = ADCSREF_0 | ADCINCH_13;              // AVCC reference, start at A13
+    ADCIFG = 0;
+    ADCIE = ADCIE0;
+
+    // TA1.1 in reset/set rises as each tick period starts
+    TA1CCR1 = TIMEBASE_TICK_PERIOD / 2;
+    TA1CCTL1 = OUTMOD_7;
+    return 1;
+}
+
+/**************************************************************************
+ * Function: adcSeqStart
+ **************************************************************************/
+int adcSeqStart(void) {
+    unsigned short state;
+
+    if (timebaseSubscribe(adcSeqArmTick, ADCSEQ_HZ) < 0) return -1;
+    state = __get_interrupt_state();
+    __disable_interrupt();
+    adcSeqArmTick();                                // First sequence on the next tick
+    running = 1;
+    __set_interrupt_state(state);
+    return 1;
+}
+
+/**************************************************************************
+ * Function: adcSeqStop
+ **************************************************************************/
+void adcSeqStop(void) {
+    timebaseUnsubscribe(adcSeqArmTick);
+    running = 0;
+}
+
+/**************************************************************************
+ * Function: adcSeqSetHook
+ **************************************************************************/
+void adcSeqSetHook(AdcSeqHook hook) {
+    unsigned short state = __get_interrupt_state();
+
+    __disable_interrupt();
+    sequenceHook = hook;
+    __set_interrupt_state(state);
+}
+
+/**************************************************************************
+ * Function: adcSeqCount
+ **************************************************************************/
+unsigned int adcSeqCount(void) {
+    return sequences;
+}
+
+/**************************************************************************
+ * Function: adcSeqLatest
+ **************************************************************************/
+unsigned int adcSeqLatest(unsigned char channel) {
+    return buffers[channel][(sequences - 1) & (ADCSEQ_BUFFER - 1)];
+}
+
+/**************************************************************************
+ * Function: adcSeqRead
+ **************************************************************************/
+unsigned int adcSeqRead(unsigned char channel, unsigned int *samples, unsigned int max) {
+    unsigned short state = __get_interrupt_state();
+    unsigned int newest, n, i;
+
+    __disable_interrupt();
+    newest = sequences;
+    n = newest < ADCSEQ_BUFFER ? newest : ADCSEQ_BUFFER;
+    if (max < n) n = max;
+    for (i = 0; i < n; i++) {
+        samples[i] = buffers[channel][(newest - n + i) & (ADCSEQ_BUFFER - 1)];
+    }
+    __set_interrupt_state(state);
+    return n;
+}
+
+/**************************************************************************
+ * Function: adcSeqWait
+ **************************************************************************/
+int adcSeqWait(void) {
+    unsigned int start = sequences;
+
+    if (!running || !(__get_SR_register() & GIE)) return 0;
+    while (sequences == start);
+    return 1;
+}
+
+/**************************************************************************
+ * Function: adcSeqSupplyMv
+ **************************************************************************/
+unsigned int adcSeqSupplyMv(void) {
+    unsigned int reference = adcSeqLatest(ADCSEQ_REFERENCE);
+
+    if (reference == 0) return 0;
+    return (unsigned int)((unsigned long)ADCSEQ_REF_MV * ADCSEQ_FULL_SCALE / reference);
+}
+
+/**************************************************************************
+ * Function: adcSeqTemperature
+ **************************************************************************/
+int adcSeqTemperature(void) {
+    unsigned int reference = adcSeqLatest(ADCSEQ_REFERENCE);
+    unsigned long sensorUv;
+
+    if (reference == 0) return 250;
+    // Sensor voltage, with AVCC cancelled out by the reference reading
+    sensorUv = (unsigned long)adcSeqLatest(ADCSEQ_TEMPERATURE) * (ADCSEQ_REF_MV * 1000UL) / reference;
+    return (int)(300 + ((long)sensorUv - (long)ADCSEQ_TSENSE_30C_UV) * 10 / ADCSEQ_TSENSE_UV_PER_C);
+}
+
+/**************************************************************************
+ * Function: adcSeqCompensate
+ **************************************************************************/
+unsigned int adcSeqCompensate(unsigned int light) {
+    unsigned int reference = adcSeqLatest(ADCSEQ_REFERENCE);
+    unsigned long nominal;
+    long gain;
+
+    if (reference == 0) return light;
+
+    // Supply: light * (supply / nominal), supply = 1.5 V * 1023 / reference
+    nominal = (unsigned long)light * ADCSEQ_REF_MV * ADCSEQ_FULL_SCALE / ADCSEQ_NOMINAL_MV / reference;
+
+    // Temperature: divide by the sensor gain 1 + k * (T - 25), in Q12.
+    // k in ppm per C and T in tenths makes the Q12 step 4096 / 1e7 = 1 / 2441
+    gain = 4096L + ADCSEQ_LIGHT_TEMPCO_PPM * (adcSeqTemperature() - 250) / 2441;
+    if (gain < 1) gain = 1;
+    if (nominal > 0xFFFF) nominal = 0xFFFF;
+    nominal = (nominal << 12) / (unsigned long)gain;
+
+    return nominal > ADCSEQ_FULL_SCALE ? ADCSEQ_FULL_SCALE : (unsigned int)nominal;
+}
+
+/**************************************************************************
+ * ISR: ADC_ISR
+ * Description:
+ *    Interrupt Service Routine for ADC_VECTOR. Reads each result of the
+ *    sequence (reading ADCMEM0 clears the flag), keeps the three wanted
+ *    channels and, after A0, files them and clears ADCENC until the next
+ *    arming tick, then runs the hook. Outside a sequence it just discards
+ *    the result.
+ **************************************************************************/
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma vector = ADC_VECTOR
+__interrupt void ADC_ISR(void)
+#elif defined(__GNUC__)
+void __attribute__ ((interrupt(ADC_VECTOR))) ADC_ISR(void)
+#endif
+{
+    unsigned int result;
+    unsigned char slot;
+
+    LATENCY_ADC_ENTER();
+    PROFILE_ISR_ENTER(PROFILE_ADC_ISR);
+    MEMUSAGE_ISR_ENTER(MEMUSAGE_ADC_ISR);
+    switch (__even_in_range(ADCIV, ADCIV_ADCIFG)) {
+        case ADCIV_ADCIFG:
+            result = ADCMEM0;
+            if (!(ADCCTL1 & ADCCONSEQ_1)) break;     // Not the sequence
+            if (position == POS_REFERENCE) pending[ADCSEQ_REFERENCE] = result;
+            else if (position == POS_TEMPERATURE) pending[ADCSEQ_TEMPERATURE] = result;
+            else if (position == POS_LIGHT) pending[ADCSEQ_LIGHT] = result;
+
+            if (position++ == POS_LAST) {
+                slot = sequences & (ADCSEQ_BUFFER - 1);
+                buffers[ADCSEQ_LIGHT][slot] = pending[ADCSEQ_LIGHT];
+                buffers[ADCSEQ_TEMPERATURE][slot] = pending[ADCSEQ_TEMPERATURE];
+                buffers[ADCSEQ_REFERENCE][slot] = pending[ADCSEQ_REFERENCE];
+                sequences++;
+                ADCCTL0 &= ~ADCENC;                  // Re-armed by adcSeqArmTick()
+                position = 0;
+                if (sequenceHook) sequenceHook();
+            }
+            break;
+    }
+    MEMUSAGE_ISR_EXIT(MEMUSAGE_ADC_ISR);
+    PROFILE_ISR_EXIT(PROFILE_ADC_ISR);
+}
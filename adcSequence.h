@@ -0,0 +1,176 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: adcSequence.h
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Added a hook run from ADC_ISR after each sequence.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#ifndef ADCSEQUENCE_H_
+#define ADCSEQUENCE_H_
+
+/**************************************************************************
+ * The ADC is set up once in sequence-of-channels mode against AVCC. The
+ * FR4133 sequence always counts down from ADCINCHx to A0, so starting at
+ * A13 one trigger converts:
+ *    A13  internal 1.5 V reference  - gives the supply voltage
+ *    A12  on-chip temperature sensor
+ *    A11..A5                        - converted and discarded
+ *    A4   phototransistor (P1.4)
+ *    A3..A0                         - converted and discarded
+ * back to back (ADCMSC). The trigger is the TA1.1 output (ADCSHS_1),
+ * which rises at the start of each system tick; a tick subscriber at the
+ * sequence rate sets ADCENC to arm the next one and ADC_ISR clears it
+ * when the sequence ends. Apart from that one bit nothing is written to
+ * the ADC per sample. ADC_ISR just files results into a buffer per
+ * channel by their position in the sequence.
+ *
+ * Compensation (adcSeqCompensate()):
+ *    supply      - the phototransistor gives an absolute voltage, so a
+ *                  reading against a drooping AVCC reads high. Scaling
+ *                  by the reference reading refers it to
+ *                  ADCSEQ_NOMINAL_MV.
+ *    temperature - divides out the sensor's gain change, modelled as
+ *                  ADCSEQ_LIGHT_TEMPCO_PPM per degree from 25 C.
+ * The temperature sensor constants are the datasheet typical values; the
+ * light temperature coefficient should be measured for the part fitted.
+ *
+ * Do not use initADC()/blockingReadADC() while the sequence is running.
+ **************************************************************************/
+#define ADCSEQ_LIGHT         0     // A4
+#define ADCSEQ_TEMPERATURE   1     // A12
+#define ADCSEQ_REFERENCE     2     // A13
+#define ADCSEQ_CHANNELS      3
+#define ADCSEQ_BUFFER        16    // Samples kept per channel, power of two
+
+#ifndef ADCSEQ_HZ
+#define ADCSEQ_HZ            100   // Sequences per second
+#endif
+#define ADCSEQ_FULL_SCALE    1023  // 10-bit results
+#define ADCSEQ_REF_MV        1500
+#define ADCSEQ_NOMINAL_MV    3300  // Supply the compensated light refers to
+#ifndef ADCSEQ_TSENSE_30C_UV
+#define ADCSEQ_TSENSE_30C_UV 788000UL  // Temperature sensor at 30 C
+#endif
+#ifndef ADCSEQ_TSENSE_UV_PER_C
+#define ADCSEQ_TSENSE_UV_PER_C 3350L   // Temperature sensor slope
+#endif
+#ifndef ADCSEQ_LIGHT_TEMPCO_PPM
+#define ADCSEQ_LIGHT_TEMPCO_PPM 4000L  // Light sensor gain change per C
+#endif
+
+/**************************************************************************
+ * Function: adcSeqInit
+ * Description:
+ *    Turns on the internal reference and temperature sensor, routes P1.4
+ *    to the ADC and configures the sequence and its trigger. Call once,
+ *    after timebaseInit().
+ * Returns:
+ *    1 on success, 0 if TA1.1 is already claimed.
+ **************************************************************************/
+int adcSeqInit(void);
+
+/**************************************************************************
+ * Function: adcSeqStart
+ * Description:
+ *    Starts converting ADCSEQ_HZ sequences per second, the first on the
+ *    next system tick.
+ * Returns:
+ *    1 if running, -1 if no tick slot is free.
+ **************************************************************************/
+int adcSeqStart(void);
+
+/**************************************************************************
+ * Function: adcSeqStop
+ * Description:
+ *    Stops arming new sequences. One in progress still completes.
+ **************************************************************************/
+void adcSeqStop(void);
+
+/**************************************************************************
+ * Type: AdcSeqHook
+ * Description:
+ *    Called from ADC_ISR as each sequence completes, after its results
+ *    are filed, so adcSeqLatest() returns them. Must be short.
+ **************************************************************************/
+typedef void (*AdcSeqHook)(void);
+
+/**************************************************************************
+ * Function: adcSeqSetHook
+ * Description:
+ *    Sets the function run after each sequence (one only).
+ * Parameters:
+ *    hook - Function to run, or 0 for none
+ **************************************************************************/
+void adcSeqSetHook(AdcSeqHook hook);
+
+/**************************************************************************
+ * Function: adcSeqCount
+ * Description:
+ *    Returns the number of sequences completed (wraps at 65536).
+ **************************************************************************/
+unsigned int adcSeqCount(void);
+
+/**************************************************************************
+ * Function: adcSeqLatest
+ * Description:
+ *    Returns the newest raw reading of a channel.
+ * Parameters:
+ *    channel - ADCSEQ_LIGHT, ADCSEQ_TEMPERATURE or ADCSEQ_REFERENCE
+ **************************************************************************/
+unsigned int adcSeqLatest(unsigned char channel);
+
+/**************************************************************************
+ * Function: adcSeqRead
+ * Description:
+ *    Copies the newest raw readings of a channel, oldest first.
+ * Parameters:
+ *    channel - Channel to read
+ *    samples - Destination
+ *    max - Samples wanted (up to ADCSEQ_BUFFER)
+ * Returns:
+ *    Number of samples copied.
+ **************************************************************************/
+unsigned int adcSeqRead(unsigned char channel, unsigned int *samples, unsigned int max);
+
+/**************************************************************************
+ * Function: adcSeqWait
+ * Description:
+ *    Waits for the next sequence to complete.
+ * Returns:
+ *    1 when a new sequence is in, 0 straight away if none can come
+ *    (not started or interrupts disabled).
+ **************************************************************************/
+int adcSeqWait(void);
+
+/**************************************************************************
+ * Function: adcSeqSupplyMv
+ * Description:
+ *    Returns the supply (AVCC) in millivolts from the newest reference
+ *    reading.
+ **************************************************************************/
+unsigned int adcSeqSupplyMv(void);
+
+/**************************************************************************
+ * Function: adcSeqTemperature
+ * Description:
+ *    Returns the die temperature in tenths of a degree C from the newest
+ *    temperature and reference readings.
+ **************************************************************************/
+int adcSeqTemperature(void);
+
+/**************************************************************************
+ * Function: adcSeqCompensate
+ * Description:
+ *    Corrects a light reading for supply and temperature using the newest
+ *    reference and temperature readings.
+ * Parameters:
+ *    light - Raw A4 reading (or a mean of them)
+ * Returns:
+ *    The reading at ADCSEQ_NOMINAL_MV and 25 C, 0 to ADCSEQ_FULL_SCALE.
+ **************************************************************************/
+unsigned int adcSeqCompensate(unsigned int light);
+
+#endif /* ADCSEQUENCE_H_ */
@@ -0,0 +1,268 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: boot.c
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    A decision saved with no valid state keeps the active calibration.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#include "boot.h"
+#include "clock.h"
+#include "timebase.h"
+#include "lcd.h"
+#include "colourCal.h"
+#include "adcSequence.h"
+#include "memUsage.h"
+#include "fram.h"
+#include <msp430fr4133.h>
+#include <intrinsics.h>
+#include <stddef.h>
+#include <string.h>
+
+/**************************************************************************
+ * FRAM boot state, kept as two copies so that a reset part way through
+ * writing one leaves the other whole. check is a Fletcher-16 of the rest
+ * of the copy; of the copies that check out, the one with the later
+ * sequence is current, and each write goes over the other one.
+ **************************************************************************/
+typedef struct {
+    ColourCal calibration;
+    unsigned int magic;
+    unsigned int sequence;
+    unsigned char planet;       // Last detector decision
+    unsigned char spare;
+    unsigned int check;
+} BootState;
+
+/**************************************************************************
+ * The boot counters sit outside the checksummed copies, so counting a
+ * boot never rewrites the calibration. A reset part way through a count
+ * only spoils that count.
+ **************************************************************************/
+typedef struct {
+    BootState copy[2];
+    unsigned int bootCount;
+    unsigned int warmCount;
+} BootStore;
+
+#define BOOT_MAGIC  (0xB000 | sizeof(BootState))    // Changes with the layout
+
+#if defined(__TI_COMPILER_VERSION__)
+#pragma PERSISTENT(bootStore)
+#endif
+static BootStore bootStore FRAM_PERSISTENT = { 0 };
+
+/**************************************************************************
+ * Function: bootChecksum
+ **************************************************************************/
+static unsigned int bootChecksum(const BootState *state) {
+    const unsigned char *bytes = (const unsigned char *)state;
+    unsigned int sum1 = 0, sum2 = 0, i;
+
+    for (i = 0; i < offsetof(BootState, check); i++) {
+        sum1 = (sum1 + bytes[i]) % 255;
+        sum2 = (sum2 + sum1) % 255;
+    }
+    return (sum2 << 8) | sum1;
+}
+
+/**************************************************************************
+ * Function: bootValid
+ **************************************************************************/
+static int bootValid(const BootState *state) {
+    return state->magic == BOOT_MAGIC && state->check == bootChecksum(state);
+}
+
+/**************************************************************************
+ * Function: bootCurrent
+ * Description:
+ *    Returns the index of the current copy, or -1 if neither checks out.
+ **************************************************************************/
+static int bootCurrent(void) {
+    int valid0 = bootValid(&bootStore.copy[0]);
+    int valid1 = bootValid(&bootStore.copy[1]);
+
+    if (valid0 && valid1) return (int)(bootStore.copy[1].sequence - bootStore.copy[0].sequence) > 0;
+    if (valid0) return 0;
+    return valid1 ? 1 : -1;
+}
+
+/**************************************************************************
+ * Function: bootCopy
+ * Description:
+ *    Copies out the current state, or all zeros if there is none.
+ **************************************************************************/
+static int bootCopy(BootState *state) {
+    int current = bootCurrent();
+
+    if (current < 0) memset(state, 0, sizeof(*state));
+    else *state = bootStore.copy[current];
+    return current;
+}
+
+/**************************************************************************
+ * Function: bootWrite
+ * Description:
+ *    Seals a new state and writes it over the copy that is not current,
+ *    making it current. A reset part way through leaves that copy failing
+ *    its checksum, so the next boot uses the other one.
+ **************************************************************************/
+static void bootWrite(BootState *next) {
+    int current = bootCurrent();
+    unsigned int fram;
+    BootState *target = &bootStore.copy[current == 0];
+
+    next->magic = BOOT_MAGIC;
+    next->sequence = current < 0 ? 0 : bootStore.copy[current].sequence + 1;
+    next->check = bootChecksum(next);
+    FRAM_UNLOCK(fram);
+    memcpy(target, next, sizeof(*target));          // Padding too, it is checksummed
+    FRAM_RESTORE(fram);
+}
+
+/**************************************************************************
+ * Function: bootReadResetCause
+ * Description:
+ *    Reads SYSRSTIV until it is empty, so no stale cause is left for the
+ *    next boot, and returns the first (highest priority) value.
+ **************************************************************************/
+static unsigned int bootReadResetCause(void) {
+    unsigned int cause, first = SYSRSTIV_NONE;
+    unsigned char i;
+
+    for (i = 0; i < 32; i++) {
+        cause = SYSRSTIV;
+        if (cause == SYSRSTIV_NONE) break;
+        if (first == SYSRSTIV_NONE) first = cause;
+    }
+    return first;
+}
+
+/**************************************************************************
+ * Function: bootLoad
+ * Description:
+ *    Checks the stored state, restores the calibration from it and
+ *    decides warm or cold. Only writes the state when it changes: a cold
+ *    boot clears the stored decision, and one with no valid state stores
+ *    the defaults. Counts the boot.
+ **************************************************************************/
+static void bootLoad(BootReport *report) {
+    BootState state;
+    unsigned int cause = report->resetCause;
+    unsigned int fram;
+
+    report->stateValid = bootCopy(&state) >= 0;
+    if (report->stateValid) {
+        colourCalSet(&state.calibration);
+        report->warm = cause == SYSRSTIV_WDTTO || cause == SYSRSTIV_WDTKEY || cause == SYSRSTIV_SVSHIFG;
+        if (report->warm) report->lastPlanet = state.planet;
+    } else {
+        colourCalSet(0);                // Built-in defaults
+        state.calibration = *colourCalActive();
+    }
+    if (!report->stateValid || (!report->warm && state.planet != 0)) {
+        state.planet = 0;
+        bootWrite(&state);
+    }
+
+    FRAM_UNLOCK(fram);
+    bootStore.bootCount++;
+    if (report->warm) bootStore.warmCount++;
+    FRAM_RESTORE(fram);
+    report->bootCount = bootStore.bootCount;
+    report->warmCount = bootStore.warmCount;
+}
+
+/**************************************************************************
+ * Function: bootRun
+ **************************************************************************/
+int bootRun(const BootStage *stages, unsigned char count, BootReport *report) {
+    unsigned long start, now, lcdDue;
+    unsigned int firstSequence;
+    unsigned char next = 0, wait, lcdDone = 0;
+
+    WDTCTL = WDTPW | WDTHOLD;   // Stop watchdog timer
+#if MEMUSAGE_ENABLED
+    memUsageInit();             // Paint the free stack before anything uses it
+#endif
+    PM5CTL0 &= ~LOCKLPM5;       // Disable GPIO power-on default high-impedance mode
+    memset(report, 0, sizeof(*report));
+    report->resetCause = bootReadResetCause();
+
+    clockInit();
+    timebaseInit();
+    __enable_interrupt();       // The tick times the display waits
+    start = timebaseMicros();
+    firstSequence = adcSeqCount();
+
+    bootLoad(report);
+    wait = lcdInitBegin(report->warm && report->resetCause != SYSRSTIV_SVSHIFG);
+    lcdDue = timebaseMicros() + wait * 1000UL;
+
+    while (!lcdDone || next < count) {
+        now = timebaseMicros();
+        if (!report->firstSampleUs && adcSeqCount() != firstSequence) {
+            report->firstSampleUs = now - start;
+        }
+
+        if (!lcdDone && (long)(now - lcdDue) >= 0) {
+            wait = lcdInitStep();
+            now = timebaseMicros();
+            if (wait) {
+                lcdDue = now + wait * 1000UL;
+            } else {
+                lcdDone = 1;
+                report->lcdReadyUs = now - start;
+            }
+        } else if (next < count) {
+            stages[next++]();
+            if (next == count) report->stagesDoneUs = timebaseMicros() - start;
+        }
+    }
+
+    // The ADC sequence is started by a stage; wait for its first result
+    while (!report->firstSampleUs) {
+        now = timebaseMicros() - start;
+        if (adcSeqCount() != firstSequence) report->firstSampleUs = now;
+        else if (now > BOOT_SAMPLE_TIMEOUT_MS * 1000UL) break;
+    }
+    return report->warm;
+}
+
+/**************************************************************************
+ * Function: bootSaveCalibration
+ **************************************************************************/
+void bootSaveCalibration(void) {
+    BootState next;
+
+    bootCopy(&next);
+    next.calibration = *colourCalActive();
+    bootWrite(&next);
+}
+
+/**************************************************************************
+ * Function: bootSavePlanet
+ **************************************************************************/
+void bootSavePlanet(unsigned char planet) {
+    BootState next;
+    int current = bootCopy(&next);
+
+    if (current >= 0 && next.planet == planet) return;
+    if (current < 0) next.calibration = *colourCalActive();   // Not a zeroed calibration
+    next.planet = planet;
+    bootWrite(&next);
+}
+
+/**************************************************************************
+ * Function: bootInvalidate
+ **************************************************************************/
+void bootInvalidate(void) {
+    unsigned int fram;
+
+    FRAM_UNLOCK(fram);
+    bootStore.copy[0].check ^= 0xFFFF;
+    bootStore.copy[1].check ^= 0xFFFF;
+    FRAM_RESTORE(fram);
+}
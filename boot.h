@@ -0,0 +1,122 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: boot.h
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    bootSavePlanet() with no valid state stores the active calibration.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#ifndef BOOT_H_
+#define BOOT_H_
+
+/**************************************************************************
+ * bootRun() brings the clock and system tick up first, then runs the
+ * LCD power-up sequence (lcdInitBegin()/lcdInitStep()) as a state
+ * machine: whenever the display is not due its next command, the next
+ * of the caller's set-up stages runs instead, so the 20 ms power-up wait
+ * and the command waits overlap the GPIO, PWM, ADC and sensor set-up
+ * rather than adding to it. Stages must each be short (well under a
+ * millisecond) and must not need the display.
+ *
+ * The colour calibration (colourCal.h) and the last detector decision
+ * are kept in FRAM as two copies, each with a sequence number and a
+ * Fletcher-16 checksum. Saves alternate between the copies, so a reset
+ * part way through one leaves the previous state in the other. The
+ * calibration is restored on every boot with a copy that checks out. The
+ * boot is warm when a stored copy checks out and the reset was:
+ *    a watchdog reset  - the display stayed powered, so its power-up
+ *                        wait is skipped
+ *    a brown-out (SVSH) - the display may have dropped out too, so it
+ *                        still gets its power-up wait
+ * and a warm boot also hands back the last detector decision. Anything
+ * else (power-on, RST pin, no copy checking out) is cold and leaves the
+ * detector state at its defaults. The boot counts are kept beside the
+ * copies rather than in them, so a boot only writes the state when it
+ * changes.
+ *
+ * Times are from the system tick starting (the clock is already set up)
+ * and measured with timebaseMicros().
+ **************************************************************************/
+#define BOOT_SAMPLE_TIMEOUT_MS  50   // Longest wait for the first ADC sequence
+
+/**************************************************************************
+ * Type: BootStage
+ * Description:
+ *    One set-up step run by bootRun().
+ **************************************************************************/
+typedef void (*BootStage)(void);
+
+/**************************************************************************
+ * Structure: BootReport
+ * Description:
+ *    What bootRun() did and how long it took.
+ * Members:
+ *    resetCause - First SYSRSTIV value read (highest priority cause)
+ *    warm - 1 for a warm boot
+ *    stateValid - 1 if a copy of the FRAM boot state passed its checksum
+ *    lastPlanet - Last detector decision stored (valid if warm)
+ *    lcdReadyUs - Display ready
+ *    stagesDoneUs - Last set-up stage finished
+ *    firstSampleUs - First ADC sequence in, 0 if none arrived
+ *    bootCount - Boots recorded, this one included
+ *    warmCount - Of those, warm boots
+ **************************************************************************/
+typedef struct {
+    unsigned int resetCause;
+    unsigned char warm;
+    unsigned char stateValid;
+    unsigned char lastPlanet;
+    unsigned long lcdReadyUs;
+    unsigned long stagesDoneUs;
+    unsigned long firstSampleUs;
+    unsigned int bootCount;
+    unsigned int warmCount;
+} BootReport;
+
+/**************************************************************************
+ * Function: bootRun
+ * Description:
+ *    Stops the watchdog, paints the free stack (memUsage.h), unlocks the
+ *    GPIO, brings up the clock and system tick, enables interrupts, loads
+ *    the FRAM boot state and then runs the display sequence and the
+ *    stages interleaved as described above.
+ *    Returns once everything is set up and the first ADC sequence is in
+ *    (or BOOT_SAMPLE_TIMEOUT_MS has passed).
+ * Parameters:
+ *    stages - Set-up stages, run in order
+ *    count - Number of stages
+ *    report - Filled in
+ * Returns:
+ *    1 for a warm boot, 0 for a cold one.
+ **************************************************************************/
+int bootRun(const BootStage *stages, unsigned char count, BootReport *report);
+
+/**************************************************************************
+ * Function: bootSaveCalibration
+ * Description:
+ *    Stores the active colour calibration (colourCalActive()).
+ **************************************************************************/
+void bootSaveCalibration(void);
+
+/**************************************************************************
+ * Function: bootSavePlanet
+ * Description:
+ *    Stores the latest detector decision. Only writes FRAM when it
+ *    changes. With no valid state stored, the active calibration is
+ *    stored with it.
+ * Parameters:
+ *    planet - Decision after hysteresis
+ **************************************************************************/
+void bootSavePlanet(unsigned char planet);
+
+/**************************************************************************
+ * Function: bootInvalidate
+ * Description:
+ *    Spoils the checksum of both stored copies so the next boot is cold
+ *    with default calibration.
+ **************************************************************************/
+void bootInvalidate(void);
+
+#endif /* BOOT_H_ */
@@ -0,0 +1,33 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: clock.c
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Defined clockInit function.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#include "clock.h"
+
+/**************************************************************************
+ * Function: clockInit
+ **************************************************************************/
+void clockInit(void) {
+    // FRAM wait states must be set before MCLK goes above 8 MHz
+    FRCTL0 = FRCTLPW | (CLOCK_FRAM_WAITS ? NWAITS_1 : NWAITS_0);
+
+    __bis_SR_register(SCG0);                   // Disable FLL while reconfiguring
+    CSCTL3 |= SELREF__REFOCLK;                 // REFO as FLL reference
+    CSCTL0 = 0;                                // Clear DCO and MOD registers
+    CSCTL1 &= ~(DCORSEL_7);                    // Clear DCO range select
+    CSCTL1 |= CLOCK_DCORSEL;                   // Select DCO range
+    CSCTL2 = FLLD_0 + CLOCK_FLLN;              // DCOCLKDIV = (FLLN + 1) x REFO
+    __delay_cycles(3);
+    __bic_SR_register(SCG0);                   // Enable FLL
+
+    while (CSCTL7 & (FLLUNLOCK0 | FLLUNLOCK1)); // Wait for FLL lock
+
+    CSCTL4 = SELMS__DCOCLKDIV | SELA__REFOCLK; // MCLK/SMCLK from DCOCLKDIV, ACLK from REFO
+    CSCTL5 = DIVM_0 | DIVS_0;                  // MCLK and SMCLK undivided
+}
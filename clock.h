@@ -0,0 +1,77 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: clock.h
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Noted host/clockCheck.sh, which runs the timing tests at each
+ *    CLOCK_MHZ.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#ifndef CLOCK_H_
+#define CLOCK_H_
+
+#include <msp430fr4133.h>
+#include <intrinsics.h>
+
+/**************************************************************************
+ * Clock selection:
+ *    Set CLOCK_MHZ to 1, 8 or 16 (e.g. -DCLOCK_MHZ=8) to choose the MCLK
+ *    frequency. The FLL locks DCOCLKDIV to (CLOCK_FLLN + 1) x 32768 Hz from
+ *    REFO, and MCLK and SMCLK both run from DCOCLKDIV undivided. The timer
+ *    rates follow from it (timebase.h); host/clockCheck.sh builds and runs
+ *    the timing tests at all three.
+ **************************************************************************/
+#ifndef CLOCK_MHZ
+#define CLOCK_MHZ 16
+#endif
+
+#if CLOCK_MHZ == 16
+#define CLOCK_DCORSEL      DCORSEL_5
+#define CLOCK_FLLN         487       // 488 x 32768 = 15.990784 MHz
+#define CLOCK_FRAM_WAITS   1         // FRAM needs a wait state above 8 MHz
+#elif CLOCK_MHZ == 8
+#define CLOCK_DCORSEL      DCORSEL_3
+#define CLOCK_FLLN         243       // 244 x 32768 = 7.995392 MHz
+#define CLOCK_FRAM_WAITS   0
+#elif CLOCK_MHZ == 1
+#define CLOCK_DCORSEL      DCORSEL_0
+#define CLOCK_FLLN         30        // 31 x 32768 = 1.015808 MHz
+#define CLOCK_FRAM_WAITS   0
+#else
+#error "clock: CLOCK_MHZ must be 1, 8 or 16"
+#endif
+
+#define CLOCK_REFO_HZ      32768UL
+#define CLOCK_MCLK_HZ      ((CLOCK_FLLN + 1UL) * CLOCK_REFO_HZ)
+#define CLOCK_SMCLK_HZ     CLOCK_MCLK_HZ
+
+// Consistency checks on the derived constants
+#if CLOCK_MCLK_HZ > 16000000UL
+#error "clock: MCLK above the 16 MHz rating of the FR4133"
+#endif
+#if CLOCK_MCLK_HZ > 8000000UL && CLOCK_FRAM_WAITS == 0
+#error "clock: FRAM wait state required above 8 MHz"
+#endif
+#if (CLOCK_MCLK_HZ + 500000UL) / 1000000UL != CLOCK_MHZ
+#error "clock: FLL multiplier does not match CLOCK_MHZ"
+#endif
+
+// Macros for time delays derived from the configured MCLK frequency
+#define CLOCK_CYCLES_PER_MS (CLOCK_MCLK_HZ / 1000UL)
+#define delay_us(x) __delay_cycles((unsigned long)(((unsigned long)(x) * CLOCK_CYCLES_PER_MS) / 1000UL)) // Microsecond delay
+#define delay_ms(x) __delay_cycles((unsigned long)((unsigned long)(x) * CLOCK_CYCLES_PER_MS))            // Millisecond delay
+#define delay_s(x)  __delay_cycles((unsigned long)((unsigned long)(x) * CLOCK_MCLK_HZ))                  // Second delay
+
+/**************************************************************************
+ * Function: clockInit
+ * Description:
+ *    Brings up the FLL/DCO at CLOCK_MHZ with REFO as reference, sets the
+ *    FRAM wait states needed for that speed, and selects DCOCLKDIV for MCLK
+ *    and SMCLK. Blocks until the FLL reports lock. Call first thing after
+ *    stopping the watchdog.
+ **************************************************************************/
+void clockInit(void);
+
+#endif /* CLOCK_H_ */
@@ -0,0 +1,157 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: colourCal.c
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Defined the target calibration, matrix solve and integer pipeline.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#include "colourCal.h"
+#include "colourSensor.h"
+#include <string.h>
+
+#define MATRIX_LIMIT  (8.0f * COLOURCAL_ONE - 1)   // Largest Q12 coefficient in an int
+
+static ColourCal activeCal;
+static unsigned char activeSet = 0;
+
+/**************************************************************************
+ * Function: colourCalIdentity
+ **************************************************************************/
+static void colourCalIdentity(ColourCal *cal) {
+    unsigned char i, j;
+
+    for (i = 0; i < 3; i++) {
+        for (j = 0; j < 3; j++) cal->matrix[i][j] = i == j ? COLOURCAL_ONE : 0;
+    }
+    cal->useMatrix = 0;
+}
+
+/**************************************************************************
+ * Function: colourCalLevel
+ * Description:
+ *    Black-corrected, gain-scaled value of one channel, clamped.
+ **************************************************************************/
+static unsigned int colourCalLevel(const ColourCal *cal, unsigned char c, unsigned int pulses) {
+    unsigned long level;
+
+    if (pulses <= cal->black[c]) return 0;
+    level = ((unsigned long)(pulses - cal->black[c]) * cal->gain[c]) >> COLOURCAL_SHIFT;
+    return level > COLOURCAL_FULL_SCALE ? COLOURCAL_FULL_SCALE : (unsigned int)level;
+}
+
+/**************************************************************************
+ * Function: colourCalDefaults
+ **************************************************************************/
+void colourCalDefaults(ColourCal *cal) {
+    memset(cal, 0, sizeof(*cal));
+    cal->gain[0] = (unsigned int)(COLOURCAL_ONE / red_coeff + 0.5f);
+    cal->gain[1] = (unsigned int)(COLOURCAL_ONE / green_coeff + 0.5f);
+    cal->gain[2] = (unsigned int)(COLOURCAL_ONE / blue_coeff + 0.5f);
+    colourCalIdentity(cal);
+}
+
+/**************************************************************************
+ * Function: colourCalFromTargets
+ **************************************************************************/
+int colourCalFromTargets(const unsigned int white[3], const unsigned int black[3], ColourCal *cal) {
+    unsigned int span;
+    unsigned char c;
+
+    for (c = 0; c < 3; c++) {
+        if (black[c] > 0xFFFF - COLOURCAL_MIN_SPAN || white[c] < black[c] + COLOURCAL_MIN_SPAN) return 0;
+    }
+    for (c = 0; c < 3; c++) {
+        span = white[c] - black[c];
+        cal->black[c] = black[c];
+        cal->gain[c] = (unsigned int)(((unsigned long)COLOURCAL_FULL_SCALE * COLOURCAL_ONE + span / 2) / span);
+    }
+    colourCalIdentity(cal);
+    return 1;
+}
+
+/**************************************************************************
+ * Function: colourCalSolveMatrix
+ * Description:
+ *    With A[c][t] the gain-corrected level of channel c for target t, the
+ *    matrix wanted is M = 255 * inverse(A), so that M * A is 255 times
+ *    the identity. Inverted by cofactors.
+ **************************************************************************/
+int colourCalSolveMatrix(ColourCal *cal, const unsigned int primaries[3][3]) {
+    float a[3][3], inverse[3][3], det, value;
+    int matrix[3][3];
+    unsigned char c, t, i, j;
+
+    for (t = 0; t < 3; t++) {
+        for (c = 0; c < 3; c++) a[c][t] = (float)colourCalLevel(cal, c, primaries[t][c]);
+    }
+
+    inverse[0][0] = a[1][1] * a[2][2] - a[1][2] * a[2][1];
+    inverse[0][1] = a[0][2] * a[2][1] - a[0][1] * a[2][2];
+    inverse[0][2] = a[0][1] * a[1][2] - a[0][2] * a[1][1];
+    inverse[1][0] = a[1][2] * a[2][0] - a[1][0] * a[2][2];
+    inverse[1][1] = a[0][0] * a[2][2] - a[0][2] * a[2][0];
+    inverse[1][2] = a[0][2] * a[1][0] - a[0][0] * a[1][2];
+    inverse[2][0] = a[1][0] * a[2][1] - a[1][1] * a[2][0];
+    inverse[2][1] = a[0][1] * a[2][0] - a[0][0] * a[2][1];
+    inverse[2][2] = a[0][0] * a[1][1] - a[0][1] * a[1][0];
+    det = a[0][0] * inverse[0][0] + a[0][1] * inverse[1][0] + a[0][2] * inverse[2][0];
+
+    // Each primary should read well clear of zero on its own channel, so a
+    // determinant below 1/64 of full scale cubed means the targets overlap
+    if (det < (float)COLOURCAL_FULL_SCALE * COLOURCAL_FULL_SCALE * COLOURCAL_FULL_SCALE / 64) return 0;
+
+    for (i = 0; i < 3; i++) {
+        for (j = 0; j < 3; j++) {
+            value = inverse[i][j] / det * COLOURCAL_FULL_SCALE * COLOURCAL_ONE;
+            if (value > MATRIX_LIMIT || value < -MATRIX_LIMIT) return 0;
+            matrix[i][j] = (int)(value < 0 ? value - 0.5f : value + 0.5f);
+        }
+    }
+    memcpy(cal->matrix, matrix, sizeof(matrix));
+    cal->useMatrix = 1;
+    return 1;
+}
+
+/**************************************************************************
+ * Function: colourCalApply
+ **************************************************************************/
+void colourCalApply(const ColourCal *cal, const unsigned int pulses[3], unsigned int rgb[3]) {
+    unsigned int level[3];
+    long sum;
+    unsigned char i;
+
+    for (i = 0; i < 3; i++) level[i] = colourCalLevel(cal, i, pulses[i]);
+    if (!cal->useMatrix) {
+        rgb[0] = level[0];
+        rgb[1] = level[1];
+        rgb[2] = level[2];
+        return;
+    }
+    for (i = 0; i < 3; i++) {
+        sum = (long)cal->matrix[i][0] * level[0] + (long)cal->matrix[i][1] * level[1] +
+              (long)cal->matrix[i][2] * level[2] + COLOURCAL_ONE / 2;
+        if (sum < 0) rgb[i] = 0;
+        else if ((sum >> COLOURCAL_SHIFT) > COLOURCAL_FULL_SCALE) rgb[i] = COLOURCAL_FULL_SCALE;
+        else rgb[i] = (unsigned int)(sum >> COLOURCAL_SHIFT);
+    }
+}
+
+/**************************************************************************
+ * Function: colourCalActive
+ **************************************************************************/
+const ColourCal *colourCalActive(void) {
+    if (!activeSet) colourCalSet(0);
+    return &activeCal;
+}
+
+/**************************************************************************
+ * Function: colourCalSet
+ **************************************************************************/
+void colourCalSet(const ColourCal *cal) {
+    if (cal) activeCal = *cal;
+    else colourCalDefaults(&activeCal);
+    activeSet = 1;
+}
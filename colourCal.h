@@ -0,0 +1,123 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: colourCal.h
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Initial creation of the fixed-point colour sensor calibration.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#ifndef COLOURCAL_H_
+#define COLOURCAL_H_
+
+/**************************************************************************
+ * Each filter window gives a pulse count per channel. Calibration turns
+ * the counts into 0-255 values in two integer steps:
+ *
+ *    v[c]   = (pulses[c] - black[c]) * gain[c] >> 12, clamped to 0-255
+ *    out[i] = sum over j of matrix[i][j] * v[j] >> 12, clamped to 0-255
+ *
+ * black and gain come from measuring a white and a black reference
+ * target (colourCalFromTargets()): black is the count for the black
+ * target and gain maps the white target to 255. The 3x3 matrix is
+ * optional (useMatrix); colourCalSolveMatrix() works it out from red,
+ * green and blue reference targets so that each reads as a pure primary,
+ * which takes out the filters' crosstalk. Solving uses floats, but only
+ * once at calibration time; applying costs three (or twelve) 16x16
+ * multiplies per sample.
+ *
+ * The default calibration is the old hand-tuned coefficients: black 0,
+ * gain 4096 / red_coeff (etc.), no matrix. The active calibration is
+ * kept in the FRAM boot state (boot.h).
+ **************************************************************************/
+#define COLOURCAL_SHIFT       12
+#define COLOURCAL_ONE         (1 << COLOURCAL_SHIFT)  // 1.0 in gain/matrix units
+#define COLOURCAL_FULL_SCALE  255
+#ifndef COLOURCAL_MIN_SPAN
+#define COLOURCAL_MIN_SPAN    16    // White minus black pulses, per channel
+#endif
+
+/**************************************************************************
+ * Structure: ColourCal
+ * Description:
+ *    One calibration.
+ * Members:
+ *    black - Pulses per window for the black target
+ *    gain - Q12, COLOURCAL_FULL_SCALE / (white - black)
+ *    matrix - Q12 correction applied after the gains, rows are outputs
+ *    useMatrix - 1 to apply the matrix
+ **************************************************************************/
+typedef struct {
+    unsigned int black[3];
+    unsigned int gain[3];
+    int matrix[3][3];
+    unsigned char useMatrix;
+} ColourCal;
+
+/**************************************************************************
+ * Function: colourCalDefaults
+ * Description:
+ *    Fills in the calibration equivalent to red_coeff, green_coeff and
+ *    blue_coeff.
+ **************************************************************************/
+void colourCalDefaults(ColourCal *cal);
+
+/**************************************************************************
+ * Function: colourCalFromTargets
+ * Description:
+ *    Works out black levels and gains from the two reference targets and
+ *    clears the matrix.
+ * Parameters:
+ *    white - Red, green and blue pulse counts for the white target
+ *    black - The same for the black target
+ *    cal - Filled in on success
+ * Returns:
+ *    1 on success, 0 if a channel's white count is not at least
+ *    COLOURCAL_MIN_SPAN above its black count (cal is left alone).
+ **************************************************************************/
+int colourCalFromTargets(const unsigned int white[3], const unsigned int black[3], ColourCal *cal);
+
+/**************************************************************************
+ * Function: colourCalSolveMatrix
+ * Description:
+ *    Works out the correction matrix from red, green and blue reference
+ *    targets, measured after colourCalFromTargets(), and enables it.
+ * Parameters:
+ *    cal - Calibration with black levels and gains set
+ *    primaries - Pulse counts: primaries[t][c] is channel c for target t
+ *                (0 red, 1 green, 2 blue)
+ * Returns:
+ *    1 on success, 0 if the targets are too alike to separate or a
+ *    coefficient falls outside +/-8 (cal is left alone).
+ **************************************************************************/
+int colourCalSolveMatrix(ColourCal *cal, const unsigned int primaries[3][3]);
+
+/**************************************************************************
+ * Function: colourCalApply
+ * Description:
+ *    Turns pulse counts into calibrated red, green and blue values.
+ * Parameters:
+ *    cal - Calibration to apply
+ *    pulses - Red, green and blue pulse counts
+ *    rgb - Results, 0 to COLOURCAL_FULL_SCALE
+ **************************************************************************/
+void colourCalApply(const ColourCal *cal, const unsigned int pulses[3], unsigned int rgb[3]);
+
+/**************************************************************************
+ * Function: colourCalActive
+ * Description:
+ *    Returns the calibration Colour_Detect() and the detector use.
+ **************************************************************************/
+const ColourCal *colourCalActive(void);
+
+/**************************************************************************
+ * Function: colourCalSet
+ * Description:
+ *    Makes a calibration active (RAM only, see bootSaveCalibration()).
+ * Parameters:
+ *    cal - Calibration to copy, or 0 for the defaults
+ **************************************************************************/
+void colourCalSet(const ColourCal *cal);
+
+#endif /* COLOURCAL_H_ */
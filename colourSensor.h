@@ -1,65 +1,90 @@
-/**************************************************************************
- * Project Name: Exoplanet Detection Simulator
- * Module Name: colourSensor.c
- * Created on: 15 March 2024
- * Date Last Updated: 02/05/2024
- * Update Description:
- *    Modified red,blue,green coeffs to not be a constant.
- * Author: Tingwan Liu (primary author) & Finlay Harris
- **************************************************************************/
-#ifndef COLOURSENSOR_H_
-#define COLOURSENSOR_H_
-
-#include <msp430fr4133.h>
-#include <intrinsics.h>
-
-// Macros for time delays using the specified crystal frequency
-#define XTAL   4  // Crystal frequency in MHz
-#define delay_us(x) __delay_cycles((unsigned long)(((unsigned long)x) * XTAL))         // Microsecond delay
-#define delay_ms(x) __delay_cycles((unsigned long)(((unsigned long)x) * XTAL * 1000))  // Millisecond delay
-#define delay_s(x)  __delay_cycles((unsigned long)(((unsigned long)x) * XTAL * 1000000)) // Second delay
-
-
-// Declaration of global variables used in color detection
-extern unsigned int pulses_num;          // Count of pulses from the colour sensor
-extern unsigned char timer_10ms_cnt;     // Counter for timing events
-extern unsigned char colour_det_flag;    // Flag to control detection process
-extern float red_coeff;                  // Coefficient for red colour calculations
-extern float green_coeff;                // Coefficient for green colour calculations
-extern float blue_coeff;                 // Coefficient for blue colour calculations
-extern unsigned int red_val;             // Calculated intensity of red colour
-extern unsigned int green_val;           // Calculated intensity of green colour
-extern unsigned int blue_val;            // Calculated intensity of blue colour
-
-
-/**************************************************************************
- * Function: initialiseColourSensor
- * Description:
- *    Configures the GPIO and interrupt settings necessary for the operation
- *    of the colour sensor. This includes setting up the sensor input pin
- *    and the control outputs for the LEDs used in color detection.
- **************************************************************************/
-void initialiseColourSensor(void);
-
-/**************************************************************************
- * Function: Colour_Detect
- * Description:
- *    Executes the sequence for detecting colours using the RGB LEDs.
- *    It controls the LEDs to emit specific colours and measures the response
- *    from the colour sensor to determine the reflected colour.
- **************************************************************************/
-void Colour_Detect(void);
-
-/**************************************************************************
- * Function: Identify_Colour
- * Description:
- *    Analyses the RGB values obtained from Colour_Detect function to determine
- *    the most prominent colour detected. Uses a simple threshold mechanism to
- *    differentiate among predefined colours.
- * Returns:
- *    A string literal indicating the identified colour: "Red", "Blue", "White",
- *    or "Unknown" if no clear colour match is found.
- **************************************************************************/
-char* Identify_Colour(void);
-
-#endif /* COLOURSENSOR_H_ */
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: colourSensor.c
+ * Created on: 15 March 2024
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    initialiseColourSensor() returns -1 if its timeout tick could not
+ *    be subscribed.
+ * Author: Tingwan Liu (primary author) & Finlay Harris
+ **************************************************************************/
+#ifndef COLOURSENSOR_H_
+#define COLOURSENSOR_H_
+
+#include <msp430fr4133.h>
+#include <intrinsics.h>
+#include "clock.h" // delay_us/delay_ms/delay_s
+#include "pwm.h"   // PWM_USE_HARDWARE
+
+// Colour sensor filter select outputs (A on P8.2, B on P8.3 or P1.5)
+#define COLOUR_SEL_A_DIR P8DIR
+#define COLOUR_SEL_A_OUT P8OUT
+#define COLOUR_SEL_A     BIT2
+#if PWM_USE_HARDWARE
+#define COLOUR_SEL_B_DIR P1DIR
+#define COLOUR_SEL_B_OUT P1OUT
+#define COLOUR_SEL_B     BIT5  // P8.3 is the blue LED (TA1.2)
+#else
+#define COLOUR_SEL_B_DIR P8DIR
+#define COLOUR_SEL_B_OUT P8OUT
+#define COLOUR_SEL_B     BIT3
+#endif
+
+
+// Declaration of global variables used in color detection
+extern unsigned int pulses_num;          // Count of pulses from the colour sensor
+extern unsigned char timer_10ms_cnt;     // Counter for timing events
+extern unsigned char colour_det_flag;    // Flag to control detection process
+extern float red_coeff;                  // Default red scaling (colourCalDefaults())
+extern float green_coeff;                // Default green scaling
+extern float blue_coeff;                 // Default blue scaling
+extern unsigned int red_val;             // Calculated intensity of red colour
+extern unsigned int green_val;           // Calculated intensity of green colour
+extern unsigned int blue_val;            // Calculated intensity of blue colour
+
+
+/**************************************************************************
+ * Function: initialiseColourSensor
+ * Description:
+ *    Configures the GPIO and interrupt settings necessary for the operation
+ *    of the colour sensor. This includes setting up the sensor input pin
+ *    and the control outputs for the LEDs used in color detection.
+ * Returns:
+ *    0 on success, -1 if the timeout tick could not be subscribed.
+ **************************************************************************/
+int initialiseColourSensor(void);
+
+/**************************************************************************
+ * Function: Colour_Detect
+ * Description:
+ *    Executes the sequence for detecting colours using the RGB LEDs.
+ *    It controls the LEDs to emit specific colours and measures the response
+ *    from the colour sensor to determine the reflected colour. The counts
+ *    are scaled by the active calibration (colourCal.h).
+ **************************************************************************/
+void Colour_Detect(void);
+
+/**************************************************************************
+ * Function: colourMeasureRaw
+ * Description:
+ *    Runs the same filter sequence as Colour_Detect() and returns the raw
+ *    pulse counts, for calibration against reference targets. Blocks for
+ *    about 400 ms.
+ * Parameters:
+ *    pulses - Red, green and blue pulse counts per 100 ms window
+ **************************************************************************/
+void colourMeasureRaw(unsigned int pulses[3]);
+
+/**************************************************************************
+ * Function: Identify_Colour
+ * Description:
+ *    Analyses the RGB values obtained from Colour_Detect function to determine
+ *    the most prominent colour detected. Uses a simple threshold mechanism to
+ *    differentiate among predefined colours.
+ * Returns:
+ *    A string literal indicating the identified colour: "Red", "Blue", "White",
+ *    or "Unknown" if no clear colour match is found.
+ **************************************************************************/
+char* Identify_Colour(void);
+
+#endif /* COLOURSENSOR_H_ */
@@ -0,0 +1,307 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: dataLog.c
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Light samples are coded into blocks and stored as DATALOG_LIGHT_CODE
+ *    records committed by a DATALOG_LIGHT_BLOCK record.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#include "dataLog.h"
+#include "fram.h"
+#include "timebase.h"
+#include "lightCodec.h"
+
+#define DATALOG_MASK   (DATALOG_RECORDS - 1)
+#define DATALOG_MAGIC  (0x4C00 | (DATALOG_RECORDS & 0xFF))  // Changes with the layout
+#define DATALOG_KEY    0x5AC3
+#define DATALOG_SEQ(x) ((x) & 0xFFFF)                       // Sequence numbers wrap at 16 bits
+
+#if (DATALOG_RECORDS & DATALOG_MASK) != 0
+#error "DATALOG_RECORDS must be a power of two"
+#endif
+
+/**************************************************************************
+ * Control block. nextSequence is the only word written per append; full
+ * is set once and never cleared until the log is formatted.
+ **************************************************************************/
+typedef struct {
+    unsigned int magic;
+    unsigned int nextSequence;
+    unsigned int full;
+} DataLogControl;
+
+// Accessed through volatile so the compiler keeps the write order
+#if defined(__TI_COMPILER_VERSION__)
+#pragma PERSISTENT(dataLogSlots)
+#pragma PERSISTENT(dataLogControl)
+#endif
+static volatile DataLogRecord dataLogSlots[DATALOG_RECORDS] FRAM_PERSISTENT = { { 0 } };
+static volatile DataLogControl dataLogControl FRAM_PERSISTENT = { 0 };
+
+// The light block being coded, in RAM until it is stored
+static LightEncoder dataLogEncoder;
+static unsigned char dataLogCode[DATALOG_BLOCK_BYTES];
+
+/**************************************************************************
+ * Function: dataLogCheck
+ * Description:
+ *    Works out the commit word for a slot's contents. Never returns 0, so
+ *    a slot whose commit word has been cleared is never valid.
+ **************************************************************************/
+static unsigned int dataLogCheck(const volatile DataLogRecord *slot) {
+    unsigned int words[7];
+    unsigned int check = DATALOG_KEY;
+    unsigned char i;
+
+    words[0] = slot->sequence;
+    words[1] = slot->type;
+    words[2] = (unsigned int)slot->tick;
+    words[3] = (unsigned int)(slot->tick >> 16);
+    words[4] = slot->value[0];
+    words[5] = slot->value[1];
+    words[6] = slot->value[2];
+
+    for (i = 0; i < 7; i++) {
+        check = ((check << 1) | ((check >> 15) & 1)) & 0xFFFF;
+        check ^= words[i] & 0xFFFF;
+    }
+    return check ? check : 1;
+}
+
+/**************************************************************************
+ * Function: dataLogHolds
+ * Description:
+ *    Returns 1 if the slot for a sequence number holds that record intact.
+ **************************************************************************/
+static int dataLogHolds(unsigned int sequence) {
+    const volatile DataLogRecord *slot = &dataLogSlots[sequence & DATALOG_MASK];
+    return slot->sequence == DATALOG_SEQ(sequence) && slot->commit == dataLogCheck(slot);
+}
+
+/**************************************************************************
+ * Function: dataLogFormat
+ **************************************************************************/
+static void dataLogFormat(void) {
+    unsigned int i;
+    unsigned char fram;
+
+    FRAM_UNLOCK(fram);
+    dataLogControl.magic = 0;              // Format again if cut short
+    for (i = 0; i < DATALOG_RECORDS; i++) {
+        dataLogSlots[i].commit = 0;
+    }
+    dataLogControl.nextSequence = 0;
+    dataLogControl.full = 0;
+    dataLogControl.magic = DATALOG_MAGIC;
+    FRAM_RESTORE(fram);
+}
+
+/**************************************************************************
+ * Function: dataLogRescan
+ * Description:
+ *    Finds the newest record by walking every slot. Only used if the
+ *    control word does not agree with the slots, which a word-atomic FRAM
+ *    write never causes, but a torn one could.
+ **************************************************************************/
+static unsigned int dataLogRescan(void) {
+    unsigned int i;
+    unsigned int sequence;
+
+    for (i = 0; i < DATALOG_RECORDS; i++) {
+        sequence = dataLogSlots[i].sequence;
+        if ((sequence & DATALOG_MASK) == i && dataLogHolds(sequence) && !dataLogHolds(sequence + 1)) {
+            return DATALOG_SEQ(sequence + 1);
+        }
+    }
+    return 0;
+}
+
+/**************************************************************************
+ * Function: dataLogBlockStart
+ **************************************************************************/
+static void dataLogBlockStart(void) {
+    lightEncoderInit(&dataLogEncoder, dataLogCode, sizeof(dataLogCode), 0, 0);
+}
+
+/**************************************************************************
+ * Function: dataLogInit
+ **************************************************************************/
+void dataLogInit(void) {
+    unsigned int next;
+    unsigned char fram;
+
+    dataLogBlockStart();
+    if (dataLogControl.magic != DATALOG_MAGIC) {
+        dataLogFormat();
+        return;
+    }
+
+    // The control word must point just past the newest record, or at a
+    // record committed just before the control update was lost
+    next = DATALOG_SEQ(dataLogControl.nextSequence);
+    if (dataLogHolds(next) && !dataLogHolds(next + 1)) {
+        next = DATALOG_SEQ(next + 1);      // Committed, but the control update was lost
+    } else if (dataLogHolds(next) || ((next != 0 || dataLogControl.full) && !dataLogHolds(next - 1))) {
+        next = dataLogRescan();
+    }
+
+    FRAM_UNLOCK(fram);
+    dataLogControl.nextSequence = next;
+    if (next >= DATALOG_RECORDS) dataLogControl.full = 1;
+    FRAM_RESTORE(fram);
+}
+
+/**************************************************************************
+ * Function: dataLogAppend
+ **************************************************************************/
+void dataLogAppend(unsigned char type, unsigned int v0, unsigned int v1, unsigned int v2) {
+    unsigned int sequence = dataLogControl.nextSequence;
+    volatile DataLogRecord *slot = &dataLogSlots[sequence & DATALOG_MASK];
+    unsigned char fram;
+
+    FRAM_UNLOCK(fram);
+    slot->commit = 0;                      // Invalidate first, the old record is being replaced
+    slot->sequence = sequence;
+    slot->type = type;
+    slot->reserved = 0;
+    slot->tick = timebaseTicks();
+    slot->value[0] = v0;
+    slot->value[1] = v1;
+    slot->value[2] = v2;
+    slot->commit = dataLogCheck(slot);     // Record is live from here
+
+    dataLogControl.nextSequence = DATALOG_SEQ(sequence + 1);
+    if (sequence + 1 == DATALOG_RECORDS) dataLogControl.full = 1;
+    FRAM_RESTORE(fram);
+}
+
+/**************************************************************************
+ * Function: dataLogLight
+ **************************************************************************/
+void dataLogLight(unsigned int adcValue, int percentage) {
+    dataLogAppend(DATALOG_LIGHT, adcValue, (unsigned int)percentage, 0);
+}
+
+/**************************************************************************
+ * Function: dataLogColour
+ **************************************************************************/
+void dataLogColour(unsigned int red, unsigned int green, unsigned int blue) {
+    dataLogAppend(DATALOG_COLOUR, red, green, blue);
+}
+
+/**************************************************************************
+ * Function: dataLogCodeWord
+ * Description:
+ *    Two bytes of the block's code as a record word, high byte first,
+ *    with zeros past the end of the code.
+ **************************************************************************/
+static unsigned int dataLogCodeWord(unsigned int at, unsigned int bytes) {
+    unsigned int high = at < bytes ? dataLogCode[at] : 0;
+    unsigned int low = at + 1 < bytes ? dataLogCode[at + 1] : 0;
+    return (high << 8) | low;
+}
+
+/**************************************************************************
+ * Function: dataLogLightSample
+ **************************************************************************/
+void dataLogLightSample(unsigned int adcValue) {
+    if (!lightEncode(&dataLogEncoder, adcValue)) {
+        dataLogLightFlush();                          // Code buffer full, store the block early
+        lightEncode(&dataLogEncoder, adcValue);       // A new block always takes its keyframe
+    }
+    if (dataLogEncoder.samples == LIGHTCODEC_KEYFRAME) dataLogLightFlush();
+}
+
+/**************************************************************************
+ * Function: dataLogLightFlush
+ **************************************************************************/
+void dataLogLightFlush(void) {
+    unsigned int bytes = lightEncoderBytes(&dataLogEncoder);
+    unsigned int at;
+
+    if (dataLogEncoder.samples == 0) return;
+    for (at = 0; at < bytes; at += 6) {
+        dataLogAppend(DATALOG_LIGHT_CODE, dataLogCodeWord(at, bytes), dataLogCodeWord(at + 2, bytes),
+                      dataLogCodeWord(at + 4, bytes));
+    }
+    dataLogAppend(DATALOG_LIGHT_BLOCK, (unsigned int)dataLogEncoder.samples, bytes, 0);  // Commits the block
+    dataLogBlockStart();
+}
+
+/**************************************************************************
+ * Function: dataLogCount
+ **************************************************************************/
+unsigned int dataLogCount(void) {
+    return dataLogControl.full ? DATALOG_RECORDS : dataLogControl.nextSequence;
+}
+
+/**************************************************************************
+ * Function: dataLogRead
+ **************************************************************************/
+int dataLogRead(unsigned int index, DataLogRecord *record) {
+    unsigned int count = dataLogCount();
+    unsigned int sequence = DATALOG_SEQ(dataLogControl.nextSequence - count + index);
+    const volatile DataLogRecord *slot = &dataLogSlots[sequence & DATALOG_MASK];
+
+    if (index >= count || !dataLogHolds(sequence)) return 0;
+
+    record->sequence = slot->sequence;
+    record->type = slot->type;
+    record->reserved = 0;
+    record->tick = slot->tick;
+    record->value[0] = slot->value[0];
+    record->value[1] = slot->value[1];
+    record->value[2] = slot->value[2];
+    record->commit = slot->commit;
+    return 1;
+}
+
+/**************************************************************************
+ * Function: dataLogExport
+ **************************************************************************/
+unsigned int dataLogExport(unsigned int index, DataLogRecord *records, unsigned int maxRecords) {
+    unsigned int count = dataLogCount();
+    unsigned int copied = 0;
+
+    for (; index < count && copied < maxRecords; index++) {
+        if (dataLogRead(index, &records[copied])) copied++;
+    }
+    return copied;
+}
+
+/**************************************************************************
+ * Function: dataLogReadBlock
+ **************************************************************************/
+int dataLogReadBlock(unsigned int index, unsigned char *code, unsigned int *bytes, unsigned int *samples) {
+    DataLogRecord record;
+    unsigned int records, n, at = 0;
+    unsigned char i;
+
+    if (!dataLogRead(index, &record) || record.type != DATALOG_LIGHT_BLOCK) return 0;
+    *samples = record.value[0];
+    *bytes = record.value[1];
+    records = (*bytes + 5) / 6;
+    if (*samples == 0 || *samples > LIGHTCODEC_KEYFRAME || records > DATALOG_BLOCK_RECORDS || records > index) {
+        return 0;
+    }
+
+    for (n = index - records; n < index; n++) {
+        if (!dataLogRead(n, &record) || record.type != DATALOG_LIGHT_CODE) return 0;
+        for (i = 0; i < 3; i++) {
+            code[at++] = (unsigned char)(record.value[i] >> 8);
+            code[at++] = (unsigned char)record.value[i];
+        }
+    }
+    return 1;
+}
+
+/**************************************************************************
+ * Function: dataLogClear
+ **************************************************************************/
+void dataLogClear(void) {
+    dataLogFormat();
+    dataLogBlockStart();
+}
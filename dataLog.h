@@ -0,0 +1,168 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: dataLog.h
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Light samples are stored as lightCodec blocks.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#ifndef DATALOG_H_
+#define DATALOG_H_
+
+/**************************************************************************
+ * Circular log of timestamped samples kept in FRAM.
+ *
+ * Each slot is written in three steps: its commit word is cleared, the
+ * body is written, then the commit word is written last. A record only
+ * counts once its commit word matches its contents, so a power cut part
+ * way through leaves at worst the one slot being written unreadable and
+ * every other record intact. The control block holds the next sequence
+ * number as a single word (a single word write cannot tear), and the slot
+ * it points at is checked on boot in case the cut fell between a commit
+ * and the control update. Recovery therefore touches one or two slots
+ * however large the log is; only if the control word does not meet the
+ * newest record are all the slots scanned.
+ *
+ * Light samples taken at the sequence rate are not stored one a record:
+ * they are compressed with lightCodec.c into blocks of up to
+ * LIGHTCODEC_KEYFRAME samples, each a stream of its own. A block is
+ * stored as its code, six bytes a DATALOG_LIGHT_CODE record, followed by
+ * a DATALOG_LIGHT_BLOCK record that commits it, so a block cut short by a
+ * power cut is never read. A curve with a few counts of noise takes 5 to 8
+ * records for 64 samples rather than 64.
+ **************************************************************************/
+#define DATALOG_RECORDS       128   // Slots, power of two (16 bytes each)
+#define DATALOG_BLOCK_RECORDS 8     // Most DATALOG_LIGHT_CODE records a block takes
+#define DATALOG_BLOCK_BYTES   (DATALOG_BLOCK_RECORDS * 6)
+
+// Record types
+#define DATALOG_LIGHT       1   // value[0] ADC count, value[1] percentage
+#define DATALOG_COLOUR      2   // value[0..2] red, green, blue
+#define DATALOG_LIGHT_CODE  3   // value[0..2] six bytes of block code, high byte first
+#define DATALOG_LIGHT_BLOCK 4   // value[0] samples, value[1] code bytes before it
+
+/**************************************************************************
+ * Structure: DataLogRecord
+ * Description:
+ *    One log slot as stored in FRAM.
+ * Members:
+ *    sequence - Running record number, wraps at 65536
+ *    type - One of the record types above
+ *    tick - System tick when the sample was logged
+ *    value - Sample values, meaning depends on type
+ *    commit - Check word, written last
+ **************************************************************************/
+typedef struct {
+    unsigned int sequence;
+    unsigned char type;
+    unsigned char reserved;
+    unsigned long tick;
+    unsigned int value[3];
+    unsigned int commit;
+} DataLogRecord;
+
+/**************************************************************************
+ * Function: dataLogInit
+ * Description:
+ *    Recovers the log after reset. Formats it on first use (or after the
+ *    layout changes), otherwise only the newest slot is examined.
+ **************************************************************************/
+void dataLogInit(void);
+
+/**************************************************************************
+ * Function: dataLogAppend
+ * Description:
+ *    Appends a record, overwriting the oldest one once the log is full.
+ * Parameters:
+ *    type - Record type
+ *    v0, v1, v2 - Sample values
+ **************************************************************************/
+void dataLogAppend(unsigned char type, unsigned int v0, unsigned int v1, unsigned int v2);
+
+/**************************************************************************
+ * Functions: dataLogLight, dataLogColour
+ * Description:
+ *    Append a light-intensity or colour sample.
+ **************************************************************************/
+void dataLogLight(unsigned int adcValue, int percentage);
+void dataLogColour(unsigned int red, unsigned int green, unsigned int blue);
+
+/**************************************************************************
+ * Function: dataLogLightSample
+ * Description:
+ *    Adds a light sample to the block being coded. The block is stored
+ *    once it holds LIGHTCODEC_KEYFRAME samples, or sooner if a noisy
+ *    curve fills its code buffer. Runs lightEncode() once or twice.
+ * Parameters:
+ *    adcValue - ADC count
+ **************************************************************************/
+void dataLogLightSample(unsigned int adcValue);
+
+/**************************************************************************
+ * Function: dataLogLightFlush
+ * Description:
+ *    Stores the block being coded, if it holds any samples, and starts
+ *    the next. Call when a run of light samples ends.
+ **************************************************************************/
+void dataLogLightFlush(void);
+
+/**************************************************************************
+ * Function: dataLogCount
+ * Description:
+ *    Returns the number of slots that hold records, up to DATALOG_RECORDS.
+ **************************************************************************/
+unsigned int dataLogCount(void);
+
+/**************************************************************************
+ * Function: dataLogRead
+ * Description:
+ *    Copies one record, index 0 being the oldest.
+ * Parameters:
+ *    index - Record index, below dataLogCount()
+ *    record - Destination for the record
+ * Returns:
+ *    1 if the record is valid, 0 if it is out of range or was torn by a
+ *    power cut.
+ **************************************************************************/
+int dataLogRead(unsigned int index, DataLogRecord *record);
+
+/**************************************************************************
+ * Function: dataLogExport
+ * Description:
+ *    Bulk readback for export. Copies valid records starting at index,
+ *    skipping torn ones.
+ * Parameters:
+ *    index - First record index to read
+ *    records - Destination array
+ *    maxRecords - Size of the destination array
+ * Returns:
+ *    The number of records copied.
+ **************************************************************************/
+unsigned int dataLogExport(unsigned int index, DataLogRecord *records, unsigned int maxRecords);
+
+/**************************************************************************
+ * Function: dataLogReadBlock
+ * Description:
+ *    Gathers a light block's code from the records before its
+ *    DATALOG_LIGHT_BLOCK record, for lightDecoderInit().
+ * Parameters:
+ *    index - Record index of the DATALOG_LIGHT_BLOCK record
+ *    code - Destination for the code, DATALOG_BLOCK_BYTES long
+ *    bytes - Destination for the number of code bytes
+ *    samples - Destination for the number of samples coded
+ * Returns:
+ *    1 if the block is whole, 0 if the record is not a block or part of
+ *    its code is torn or has been overwritten.
+ **************************************************************************/
+int dataLogReadBlock(unsigned int index, unsigned char *code, unsigned int *bytes, unsigned int *samples);
+
+/**************************************************************************
+ * Function: dataLogClear
+ * Description:
+ *    Empties the log.
+ **************************************************************************/
+void dataLogClear(void);
+
+#endif /* DATALOG_H_ */
@@ -0,0 +1,257 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: detect.c
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    detectStart() fails if the colour sensor cannot be set up.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#include "detect.h"
+#include "colourSensor.h"
+#include "lightIntensity.h"
+#include "adcSequence.h"
+#include "colourCal.h"
+#include "timebase.h"
+#include "latency.h"
+#include <msp430fr4133.h>
+#include <string.h>
+
+#define SETTLE_TICKS    (DETECT_SETTLE_MS * DETECT_TICK_HZ / 1000)
+#define WINDOW_TICKS    (DETECT_WINDOW_MS * DETECT_TICK_HZ / 1000)
+#define TICKS_TO_MS(t)  ((unsigned int)((t) * 1000UL / TIMEBASE_TICK_HZ))
+
+#if SETTLE_TICKS < 1 || WINDOW_TICKS < 1
+#error "Detection phases must be at least one detect tick long"
+#endif
+
+// Acquisition phases, in order
+#define PHASE_IDLE      0
+#define PHASE_SETTLE    1
+#define PHASE_RED       2
+#define PHASE_GREEN     3
+#define PHASE_BLUE      4
+
+/**************************************************************************
+ * One finished cycle, written by the tick handler and read by
+ * detectPoll().
+ **************************************************************************/
+typedef struct {
+    unsigned int pulses[3];
+    unsigned long adcSum;
+    unsigned char adcCount;
+    unsigned long startTick;
+    unsigned long endTick;
+} DetectRaw;
+
+static volatile unsigned char phase = PHASE_IDLE;
+static unsigned char phaseTicks;
+static unsigned char continuousMode;
+static DetectRaw acquiring;
+static DetectRaw finished;
+static volatile unsigned char finishedReady = 0;
+static unsigned int overruns = 0;
+static unsigned char planetState = 0;
+static unsigned int lastSequence;
+
+/**************************************************************************
+ * Function: selectFilter
+ * Description:
+ *    Drives the filter select lines as Colour_Detect() does: both low is
+ *    off, both high red, B only green, A only blue.
+ **************************************************************************/
+static void selectFilter(unsigned char nextPhase) {
+    if (nextPhase == PHASE_RED || nextPhase == PHASE_BLUE) COLOUR_SEL_A_OUT |= COLOUR_SEL_A;
+    else COLOUR_SEL_A_OUT &= ~COLOUR_SEL_A;
+    if (nextPhase == PHASE_RED || nextPhase == PHASE_GREEN) COLOUR_SEL_B_OUT |= COLOUR_SEL_B;
+    else COLOUR_SEL_B_OUT &= ~COLOUR_SEL_B;
+    LATENCY_RESTART(LATENCY_PORT1_ISR);    // New pulse rate
+}
+
+/**************************************************************************
+ * Function: beginCycle
+ **************************************************************************/
+static void beginCycle(void) {
+    selectFilter(PHASE_SETTLE);
+    acquiring.adcSum = 0;
+    acquiring.adcCount = 0;
+    acquiring.startTick = timebaseTickCount;  // Tick ISR context, no tear
+    phase = PHASE_SETTLE;
+    phaseTicks = SETTLE_TICKS;
+}
+
+/**************************************************************************
+ * Function: detectTick
+ * Description:
+ *    Runs at DETECT_TICK_HZ. Adds in the light reading of any ADC
+ *    sequence completed since the last tick, then moves to the next phase
+ *    when this one has run its time. Pulses are counted by Port_1 while
+ *    colour_det_flag is set.
+ **************************************************************************/
+static void detectTick(void) {
+    unsigned int sequence = adcSeqCount();
+
+    if (sequence != lastSequence) {
+        lastSequence = sequence;
+        acquiring.adcSum += adcSeqLatest(ADCSEQ_LIGHT);
+        if (acquiring.adcCount < 0xFF) acquiring.adcCount++;
+    }
+
+    timer_10ms_cnt = 0;                    // Keep the 1 s colour timeout away
+    if (--phaseTicks) return;
+
+    if (phase != PHASE_SETTLE) {
+        acquiring.pulses[phase - PHASE_RED] = pulses_num;
+    }
+    if (phase != PHASE_BLUE) {
+        phase++;
+        selectFilter(phase);
+        pulses_num = 0;
+        colour_det_flag = 1;
+        phaseTicks = WINDOW_TICKS;
+        return;
+    }
+
+    // Last window closed
+    colour_det_flag = 0;
+    selectFilter(PHASE_SETTLE);
+    acquiring.endTick = timebaseTickCount;
+    if (finishedReady) overruns++;          // Previous cycle never polled
+    finished = acquiring;
+    finishedReady = 1;
+
+    if (continuousMode) {
+        beginCycle();
+    } else {
+        P1IE &= ~BIT3;
+        phase = PHASE_IDLE;
+        timebaseUnsubscribe(detectTick);
+    }
+}
+
+/**************************************************************************
+ * Function: detectStart
+ **************************************************************************/
+int detectStart(unsigned char continuous) {
+    unsigned short state;
+
+    detectStop();
+    if (initialiseColourSensor() < 0) return -1;
+    if (adcSeqStart() < 0) return -1;       // No-op if main already started it
+
+    state = __get_interrupt_state();
+    __disable_interrupt();
+    continuousMode = continuous;
+    colour_det_flag = 0;
+    P1IE |= BIT3;
+    beginCycle();
+    lastSequence = adcSeqCount();
+    __set_interrupt_state(state);
+
+    if (timebaseSubscribe(detectTick, DETECT_TICK_HZ) < 0) {
+        detectStop();
+        return -1;
+    }
+    return 1;
+}
+
+/**************************************************************************
+ * Function: detectStop
+ **************************************************************************/
+void detectStop(void) {
+    timebaseUnsubscribe(detectTick);
+    colour_det_flag = 0;
+    COLOUR_SEL_A_OUT &= ~COLOUR_SEL_A;
+    COLOUR_SEL_B_OUT &= ~COLOUR_SEL_B;
+    P1IE &= ~BIT3;
+    phase = PHASE_IDLE;
+    finishedReady = 0;
+}
+
+/**************************************************************************
+ * Function: detectBusy
+ **************************************************************************/
+int detectBusy(void) {
+    return phase != PHASE_IDLE || finishedReady;
+}
+
+/**************************************************************************
+ * Function: detectScore
+ **************************************************************************/
+unsigned char detectScore(unsigned char colourValid, unsigned char lightPercent) {
+    unsigned char light;
+
+    if (lightPercent >= DETECT_LIGHT_CLEAR) light = 0;
+    else if (lightPercent <= DETECT_LIGHT_DIP) light = 50;
+    else light = (unsigned char)(50 * (DETECT_LIGHT_CLEAR - lightPercent) / (DETECT_LIGHT_CLEAR - DETECT_LIGHT_DIP));
+
+    return light + (colourValid ? 50 : 0);
+}
+
+/**************************************************************************
+ * Function: detectHysteresis
+ **************************************************************************/
+unsigned char detectHysteresis(unsigned char planet, unsigned char score) {
+    if (!planet && score >= DETECT_ENTER) return 1;
+    if (planet && score <= DETECT_EXIT) return 0;
+    return planet;
+}
+
+/**************************************************************************
+ * Function: detectReset
+ **************************************************************************/
+void detectReset(void) {
+    planetState = 0;
+}
+
+/**************************************************************************
+ * Function: detectRestore
+ **************************************************************************/
+void detectRestore(unsigned char planet) {
+    planetState = planet ? 1 : 0;
+}
+
+/**************************************************************************
+ * Function: detectPoll
+ **************************************************************************/
+int detectPoll(DetectResult *result) {
+    DetectRaw raw;
+    unsigned int rgb[3];
+    unsigned short state;
+    char *colour;
+
+    state = __get_interrupt_state();
+    __disable_interrupt();
+    if (!finishedReady) {
+        __set_interrupt_state(state);
+        return 0;
+    }
+    raw = finished;
+    finishedReady = 0;
+    __set_interrupt_state(state);
+
+    // Same scaling as Colour_Detect()
+    colourCalApply(colourCalActive(), raw.pulses, rgb);
+    red_val = rgb[0];
+    green_val = rgb[1];
+    blue_val = rgb[2];
+    colour = Identify_Colour();
+
+    memset(result, 0, sizeof(*result));
+    result->red = red_val;
+    result->green = green_val;
+    result->blue = blue_val;
+    result->adcSamples = raw.adcCount;
+    result->lightAdc = raw.adcCount ? adcSeqCompensate((unsigned int)(raw.adcSum / raw.adcCount)) : 0;
+    result->lightPercent = (unsigned char)adcValueToPercentage(result->lightAdc, DETECT_ADC_MIN, DETECT_ADC_MAX);
+    result->colourValid = strcmp(colour, "White") == 0 || strcmp(colour, "Red") == 0 ||
+                          strcmp(colour, "Blue") == 0;
+    result->score = detectScore(result->colourValid, result->lightPercent);
+    planetState = detectHysteresis(planetState, result->score);
+    result->planet = planetState;
+    result->acquireMs = TICKS_TO_MS(raw.endTick - raw.startTick);
+    result->latencyMs = TICKS_TO_MS(timebaseTicks() - raw.startTick);
+    result->overruns = overruns;
+    return 1;
+}
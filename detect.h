@@ -0,0 +1,168 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: detect.h
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Colour is scaled through the calibration (colourCal.h).
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#ifndef DETECT_H_
+#define DETECT_H_
+
+/**************************************************************************
+ * A detection cycle runs from the system tick without blocking:
+ *
+ *    settle   filters off          DETECT_SETTLE_MS
+ *    red      red filter, count    DETECT_WINDOW_MS
+ *    green    green filter, count  DETECT_WINDOW_MS
+ *    blue     blue filter, count   DETECT_WINDOW_MS
+ *
+ * The Port_1 ISR counts colour sensor pulses during each window as it
+ * does for Colour_Detect(). Meanwhile every tick takes the light reading
+ * of the newest ADC sequence (adcSequence.h), so the light level is
+ * averaged over the whole cycle at no extra time, then compensated for
+ * supply and temperature.
+ *
+ * The tick handler only sequences the hardware and stores raw counts.
+ * detectPoll(), from the main loop, scales them through the colour
+ * calibration (colourCal.h), scores them and applies the hysteresis.
+ *
+ * Score (0-100):
+ *    light  - 0 at or above DETECT_LIGHT_CLEAR percent, rising linearly
+ *             to 50 at DETECT_LIGHT_DIP percent and below (the transit)
+ *    colour - 50 if the sensed colour is White, Red or Blue (the
+ *             atmosphere colours Identify_Colour() knows), else 0
+ * A planet is reported once the score reaches DETECT_ENTER and stays
+ * reported until it falls to DETECT_EXIT, so a reading near a threshold
+ * does not make the decision flicker between cycles.
+ **************************************************************************/
+#define DETECT_TICK_HZ       100   // One tick per 10 ms
+#ifndef DETECT_SETTLE_MS
+#define DETECT_SETTLE_MS     100
+#endif
+#ifndef DETECT_WINDOW_MS
+#define DETECT_WINDOW_MS     100
+#endif
+#define DETECT_ADC_MIN       3     // ADC reading for 0% light
+#define DETECT_ADC_MAX       150   // ADC reading for 100% light
+#define DETECT_LIGHT_CLEAR   100   // Percent light with no transit
+#define DETECT_LIGHT_DIP     50    // Percent light for a full transit score
+#define DETECT_ENTER         75    // Score to report a planet
+#define DETECT_EXIT          60    // Score to stop reporting it
+
+/**************************************************************************
+ * Structure: DetectResult
+ * Description:
+ *    Outcome of one detection cycle.
+ * Members:
+ *    red, green, blue - Scaled colour values, as Colour_Detect() sets
+ *    lightAdc - Mean ADC reading over the cycle, compensated
+ *    lightPercent - lightAdc as a percentage
+ *    adcSamples - Conversions averaged
+ *    colourValid - 1 if the colour is one that indicates a planet
+ *    score - Combined score, 0 to 100
+ *    planet - Decision after hysteresis
+ *    acquireMs - Start of the cycle to the last window closing
+ *    latencyMs - Start of the cycle to the decision being made
+ *    overruns - Cycles lost because detectPoll() was late (continuous)
+ **************************************************************************/
+typedef struct {
+    unsigned int red;
+    unsigned int green;
+    unsigned int blue;
+    unsigned int lightAdc;
+    unsigned char lightPercent;
+    unsigned char adcSamples;
+    unsigned char colourValid;
+    unsigned char score;
+    unsigned char planet;
+    unsigned int acquireMs;
+    unsigned int latencyMs;
+    unsigned int overruns;
+} DetectResult;
+
+/**************************************************************************
+ * Function: detectStart
+ * Description:
+ *    Starts acquiring. Sets up the colour sensor and starts the ADC
+ *    sequence (adcSeqInit() must have been called), so the colour button
+ *    must call detectStop() before using the sensor.
+ * Parameters:
+ *    continuous - 0 for a single cycle, 1 to repeat until detectStop()
+ * Returns:
+ *    1 if started, -1 if no tick slot is free.
+ **************************************************************************/
+int detectStart(unsigned char continuous);
+
+/**************************************************************************
+ * Function: detectStop
+ * Description:
+ *    Stops acquiring, turns the filter LEDs off and drops a cycle in
+ *    progress. The hysteresis state is kept.
+ **************************************************************************/
+void detectStop(void);
+
+/**************************************************************************
+ * Function: detectBusy
+ * Description:
+ *    Returns 1 while a cycle is being acquired or waiting for detectPoll().
+ **************************************************************************/
+int detectBusy(void);
+
+/**************************************************************************
+ * Function: detectPoll
+ * Description:
+ *    Turns a finished cycle into a decision. Call from the main loop.
+ *    Also sets red_val, green_val and blue_val.
+ * Parameters:
+ *    result - Filled in when a decision is made
+ * Returns:
+ *    1 if a new decision was made, 0 otherwise.
+ **************************************************************************/
+int detectPoll(DetectResult *result);
+
+/**************************************************************************
+ * Function: detectScore
+ * Description:
+ *    Combines the two sensors into a score.
+ * Parameters:
+ *    colourValid - 1 if the colour indicates a planet
+ *    lightPercent - Light level, 0 to 100
+ * Returns:
+ *    Score, 0 to 100.
+ **************************************************************************/
+unsigned char detectScore(unsigned char colourValid, unsigned char lightPercent);
+
+/**************************************************************************
+ * Function: detectHysteresis
+ * Description:
+ *    Applies the enter/exit thresholds to a score.
+ * Parameters:
+ *    planet - Previous decision
+ *    score - New score
+ * Returns:
+ *    New decision.
+ **************************************************************************/
+unsigned char detectHysteresis(unsigned char planet, unsigned char score);
+
+/**************************************************************************
+ * Function: detectReset
+ * Description:
+ *    Forgets the previous decision, so the next one is made on the enter
+ *    threshold alone.
+ **************************************************************************/
+void detectReset(void);
+
+/**************************************************************************
+ * Function: detectRestore
+ * Description:
+ *    Sets the previous decision, e.g. from the FRAM boot state after a
+ *    warm boot, so the hysteresis carries on from it.
+ * Parameters:
+ *    planet - Previous decision
+ **************************************************************************/
+void detectRestore(unsigned char planet);
+
+#endif /* DETECT_H_ */
@@ -0,0 +1,109 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: dither.c
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Green and blue are dithered in their compare ranges and staged with
+ *    pwmSetCompares(), not rounded to 256ths by setRGBDutyCycle().
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#include "dither.h"
+#include <intrinsics.h>
+
+/**************************************************************************
+ * Per-channel dither state. The target intensity is split once into a
+ * whole duty value and a 12-bit fraction, so the per-frame work is a
+ * 16-bit add, shift and mask per channel.
+ **************************************************************************/
+typedef struct {
+    unsigned int whole;   // Integer part of the scaled duty
+    unsigned int frac;    // Fractional part, in 1/4096 steps
+    unsigned int error;   // Accumulated fraction not yet output
+} DitherChannel;
+
+static DitherChannel channels[3];
+
+static void ditherFrame(void);
+
+/**************************************************************************
+ * Function: ditherSplit
+ **************************************************************************/
+static void ditherSplit(DitherChannel *channel, unsigned int value, unsigned int full) {
+    unsigned long scaled;
+
+    if (value >= DITHER_MAX) {
+        channel->whole = full;             // Fully on, nothing to dither
+        channel->frac = 0;
+        return;
+    }
+    scaled = (unsigned long)value * full;  // value/4096 of the channel's range
+
+    channel->whole = (unsigned int)(scaled >> DITHER_BITS);
+    channel->frac = (unsigned int)(scaled & DITHER_MAX);
+}
+
+/**************************************************************************
+ * Function: ditherNext
+ **************************************************************************/
+static unsigned int ditherNext(DitherChannel *channel) {
+    unsigned int carry;
+
+    channel->error += channel->frac;
+    carry = channel->error >> DITHER_BITS;  // 1 once a whole step has built up
+    channel->error &= DITHER_MAX;
+    return channel->whole + carry;
+}
+
+/**************************************************************************
+ * Function: ditherSetRGB
+ **************************************************************************/
+void ditherSetRGB(unsigned int red, unsigned int green, unsigned int blue) {
+    unsigned short state = __get_interrupt_state();
+    __disable_interrupt();
+
+    ditherSplit(&channels[0], red, PWM_RED_FULL);
+    ditherSplit(&channels[1], green, PWM_GREEN_FULL);
+    ditherSplit(&channels[2], blue, PWM_BLUE_FULL);
+
+    ditherFrame();                  // Stage the first frame straight away
+    if (channels[0].frac | channels[1].frac | channels[2].frac) {
+        pwmSetFrameHook(ditherFrame);
+    } else {
+        pwmSetFrameHook(0);         // Whole duty cycles, nothing more to do
+    }
+
+    __set_interrupt_state(state);
+}
+
+/**************************************************************************
+ * Function: ditherSetDuty
+ **************************************************************************/
+void ditherSetDuty(unsigned int red, unsigned int green, unsigned int blue) {
+    red = red >= TIMEBASE_PWM_PERIOD ? DITHER_MAX
+                                     : (unsigned int)(((unsigned long)red * DITHER_RED_SCALE + 0x8000) >> 16);
+    green = green >= 256 ? DITHER_MAX : green << (DITHER_BITS - 8);
+    blue = blue >= 256 ? DITHER_MAX : blue << (DITHER_BITS - 8);
+    ditherSetRGB(red, green, blue);
+}
+
+/**************************************************************************
+ * Function: ditherStop
+ **************************************************************************/
+void ditherStop(void) {
+    pwmSetFrameHook(0);
+}
+
+/**************************************************************************
+ * Function: ditherFrame
+ * Description:
+ *    PWM frame hook. Stages the compares for the following frame.
+ **************************************************************************/
+static void ditherFrame(void) {
+    unsigned int red = ditherNext(&channels[0]);
+    unsigned int green = ditherNext(&channels[1]);
+    unsigned int blue = ditherNext(&channels[2]);
+
+    pwmSetCompares(red, green, blue);
+}
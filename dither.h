@@ -0,0 +1,67 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: dither.h
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Dithers each channel in its own compare range (PWM_*_FULL), so green
+ *    and blue keep the hardware timers' resolution.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#ifndef DITHER_H_
+#define DITHER_H_
+
+#include "pwm.h"
+#include "timebase.h"
+
+/**************************************************************************
+ * Intensities are 12-bit (0 to DITHER_MAX) on every channel and are scaled
+ * to each channel's compare range (PWM_RED_FULL, PWM_GREEN_FULL and
+ * PWM_BLUE_FULL in pwm.h). The fractional part left over is carried in a
+ * per-channel error accumulator and added back on following frames, so
+ * the long-run average compare matches the requested intensity. DITHER_MAX
+ * itself is fully on.
+ **************************************************************************/
+#define DITHER_BITS       12
+#define DITHER_MAX        ((1 << DITHER_BITS) - 1)
+
+// Red duty to intensity, 4096 / 101 in 16.16 fixed point (no division)
+#define DITHER_RED_SCALE  ((((unsigned long)1 << (DITHER_BITS + 16)) + PWM_RED_FULL / 2) / PWM_RED_FULL)
+
+/**************************************************************************
+ * Function: ditherSetRGB
+ * Description:
+ *    Sets the target intensity of each channel and starts dithering. Each
+ *    PWM frame the next compares are staged through pwmSetCompares().
+ * Parameters:
+ *    red - Red intensity (0 to DITHER_MAX)
+ *    green - Green intensity (0 to DITHER_MAX)
+ *    blue - Blue intensity (0 to DITHER_MAX)
+ **************************************************************************/
+void ditherSetRGB(unsigned int red, unsigned int green, unsigned int blue);
+
+/**************************************************************************
+ * Function: ditherSetDuty
+ * Description:
+ *    ditherSetRGB() in setRGBDutyCycle() units, as used by setColour().
+ *    Green and blue convert to intensities exactly, and are dithered where
+ *    their 256ths fall between compares; red is rounded to the nearest
+ *    1/4096 of its range. A colour with nothing to dither is staged once
+ *    and the frame hook removed.
+ * Parameters:
+ *    red - Red duty cycle (0 to TIMEBASE_PWM_PERIOD, more is fully on)
+ *    green - Green duty cycle (0 to 256)
+ *    blue - Blue duty cycle (0 to 256)
+ **************************************************************************/
+void ditherSetDuty(unsigned int red, unsigned int green, unsigned int blue);
+
+/**************************************************************************
+ * Function: ditherStop
+ * Description:
+ *    Stops dithering and leaves the last staged duty cycles in place, so
+ *    setRGBDutyCycle()/setColour() can be used directly again.
+ **************************************************************************/
+void ditherStop(void);
+
+#endif /* DITHER_H_ */
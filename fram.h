@@ -0,0 +1,45 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: fram.h
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Initial creation of the FRAM persistence and write-protect helpers.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#ifndef FRAM_H_
+#define FRAM_H_
+
+#include <msp430fr4133.h>
+
+/**************************************************************************
+ * Variables that must survive a reset or power cycle live in program
+ * FRAM. Declare them as:
+ *
+ *    #if defined(__TI_COMPILER_VERSION__)
+ *    #pragma PERSISTENT(myData)
+ *    #endif
+ *    MyType myData FRAM_PERSISTENT = { 0 };
+ *
+ * The initialiser is only applied when the device is programmed. On the
+ * host build FRAM_PERSISTENT is empty and the variable is plain RAM.
+ *
+ * Program FRAM is write protected by SYSCFG0.PFWP. Wrap every write in
+ * FRAM_UNLOCK/FRAM_RESTORE and keep the window short, the protection is
+ * what stops a runaway pointer from overwriting code.
+ **************************************************************************/
+#if defined(__GNUC__) && defined(__MSP430__)
+#define FRAM_PERSISTENT __attribute__((persistent))
+#else
+#define FRAM_PERSISTENT
+#endif
+
+#define FRAM_UNLOCK(state) do {                                            \
+        (state) = SYSCFG0 & (PFWP | DFWP);                                 \
+        SYSCFG0 = FRWPPW | ((state) & ~PFWP);                              \
+    } while (0)
+
+#define FRAM_RESTORE(state)   (SYSCFG0 = FRWPPW | (state))
+
+#endif /* FRAM_H_ */
@@ -0,0 +1,138 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: adcSequenceSim.c
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Initial creation of the ADC sequence and compensation check.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+/**************************************************************************
+ * Host build:
+ *    gcc -I. -Ihost host/adcSequenceSim.c adcSequence.c timebase.c clock.c \
+ *        memUsage.c host/msp430sim.c -o adcSequenceSim
+ *
+ * Runs adcSequence.c on the simulator against a synthetic board: a
+ * phototransistor giving a fixed light voltage (scaled by its gain's
+ * temperature coefficient), the on-chip temperature sensor and the 1.5 V
+ * reference, all converted against an AVCC that droops from 3.3 V to
+ * 2.8 V and back while the die warms from 25 C to 60 C. The ADC inputs
+ * are what a real ADC would read, voltage / AVCC * 1023.
+ *
+ * Checks each step that the supply and temperature read back correctly,
+ * that the compensated light stays put while the raw reading moves, that
+ * sequences arrive at ADCSEQ_HZ and that each takes one ADC interrupt per
+ * channel from A13 to A0 (give or take a sequence straddling the window).
+ * Exits non-zero on any failure.
+ **************************************************************************/
+
+#include "msp430sim.h"
+#include "../adcSequence.h"
+#include "../timebase.h"
+#include "../clock.h"
+#include <msp430fr4133.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define LIGHT_MV        1200.0   // Phototransistor output at 25 C
+#define STEP_MS         200      // Each supply/temperature step
+
+typedef struct {
+    double supplyMv;
+    double temperature;
+} Condition;
+
+static const Condition steps[] = {
+    { 3300, 25 }, { 3200, 25 }, { 3000, 30 }, { 2800, 40 },
+    { 2900, 50 }, { 3100, 60 }, { 3300, 60 }, { 3300, 40 },
+};
+
+/**************************************************************************
+ * Function: toAdc
+ * Description:
+ *    Reading of a voltage against AVCC, rounded and clipped.
+ **************************************************************************/
+static unsigned int toAdc(double mv, double supplyMv) {
+    double reading = mv / supplyMv * ADCSEQ_FULL_SCALE + 0.5;
+
+    if (reading < 0) return 0;
+    return reading > ADCSEQ_FULL_SCALE ? ADCSEQ_FULL_SCALE : (unsigned int)reading;
+}
+
+/**************************************************************************
+ * Function: applyCondition
+ **************************************************************************/
+static void applyCondition(const Condition *c) {
+    double sensorMv = ADCSEQ_TSENSE_30C_UV / 1000.0 + (c->temperature - 30) * ADCSEQ_TSENSE_UV_PER_C / 1000.0;
+    double lightMv = LIGHT_MV * (1 + ADCSEQ_LIGHT_TEMPCO_PPM * 1e-6 * (c->temperature - 25));
+    unsigned char channel;
+
+    for (channel = 0; channel < 12; channel++) {
+        simSetAdcInput(channel, toAdc(channel == 4 ? lightMv : 0, c->supplyMv));
+    }
+    simSetAdcInput(12, toAdc(sensorMv, c->supplyMv));
+    simSetAdcInput(13, toAdc(ADCSEQ_REF_MV, c->supplyMv));
+}
+
+int main(void) {
+    unsigned int expected = toAdc(LIGHT_MV, ADCSEQ_NOMINAL_MV);
+    unsigned int samples[ADCSEQ_BUFFER];
+    unsigned int i, failures = 0;
+
+    simReset();
+    WDTCTL = WDTPW | WDTHOLD;
+    PM5CTL0 &= ~LOCKLPM5;
+    clockInit();
+    timebaseInit();
+    if (adcSeqInit() != 1 || adcSeqStart() != 1) {
+        printf("sequence would not start\n");
+        return 1;
+    }
+    __bis_SR_register(GIE);
+
+    printf("light %.0f mV reads %u at %u mV, 25 C\n\n", LIGHT_MV, expected, ADCSEQ_NOMINAL_MV);
+    printf("supply  temp   raw  ->  supply   temp   comp  seqs  ISRs/seq\n");
+    for (i = 0; i < sizeof(steps) / sizeof(steps[0]); i++) {
+        unsigned int firstSeq, seqs, supply, comp, raw, n;
+        unsigned long firstIsr, isrs;
+        int temp, ok;
+
+        applyCondition(&steps[i]);
+        simAdvance(20UL * CLOCK_CYCLES_PER_MS);      // Let two sequences through
+        firstSeq = adcSeqCount();
+        firstIsr = simInterruptCount(ADC_VECTOR);
+        simAdvance((unsigned long)STEP_MS * CLOCK_CYCLES_PER_MS);
+        seqs = adcSeqCount() - firstSeq;
+        isrs = simInterruptCount(ADC_VECTOR) - firstIsr;
+
+        raw = adcSeqLatest(ADCSEQ_LIGHT);
+        supply = adcSeqSupplyMv();
+        temp = adcSeqTemperature();
+        comp = adcSeqCompensate(raw);
+        n = adcSeqRead(ADCSEQ_LIGHT, samples, ADCSEQ_BUFFER);
+
+        ok = abs((int)supply - (int)steps[i].supplyMv) <= 15 &&
+             abs(temp - (int)(steps[i].temperature * 10)) <= 10 &&
+             abs((int)comp - (int)expected) <= 3 &&
+             seqs >= STEP_MS * ADCSEQ_HZ / 1000 - 1 && seqs <= STEP_MS * ADCSEQ_HZ / 1000 + 1 &&
+             seqs && isrs + 13 >= seqs * 14UL && isrs <= seqs * 14UL + 13 &&
+             n == ADCSEQ_BUFFER && samples[n - 1] == raw;
+        printf("%4.0f mV %3.0f C  %4u  ->  %4u mV %3d.%d C  %4u  %4u  %lu%s\n",
+               steps[i].supplyMv, steps[i].temperature, raw, supply, temp / 10, abs(temp % 10),
+               comp, seqs, seqs ? isrs / seqs : 0, ok ? "" : "  <-- FAIL");
+        if (!ok) failures++;
+    }
+
+    adcSeqStop();
+    simAdvance(50UL * CLOCK_CYCLES_PER_MS);
+    i = adcSeqCount();
+    simAdvance(50UL * CLOCK_CYCLES_PER_MS);
+    if (adcSeqCount() != i) {
+        printf("sequences continued after adcSeqStop()\n");
+        failures++;
+    }
+
+    printf("%u failure(s)\n", failures);
+    return failures != 0;
+}
@@ -0,0 +1,158 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: bootSim.c
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Links lightCodec.c, which dataLog.c now uses.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+/**************************************************************************
+ * Host build:
+ *    gcc -I. -Ihost host/bootSim.c boot.c clock.c timebase.c lcd.c \
+ *        colourSensor.c colourCal.c adcSequence.c dataLog.c lightCodec.c \
+ *        pwm.c telemetry.c memUsage.c host/msp430sim.c -o bootSim
+ *
+ * Boots the firmware's set-up stages on the simulator, first the old way
+ * (everything in turn, then the blocking lcdInit()) to get a baseline,
+ * then through bootRun() after a series of resets: power-on with blank
+ * FRAM, watchdog, brown-out, RST pin, a watchdog reset with a spoilt
+ * checksum and two causes pending at once. Between boots the RAM copy
+ * of the colour calibration is put back to its defaults, as a
+ * real reset would; the FRAM boot state is a plain variable on the host
+ * and so carries over like FRAM. Prints the times and exits non-zero if
+ * any boot takes the wrong path or restores the wrong state.
+ **************************************************************************/
+
+#include "msp430sim.h"
+#include "../boot.h"
+#include "../adcSequence.h"
+#include "../colourSensor.h"
+#include "../colourCal.h"
+#include "../dataLog.h"
+#include "../timebase.h"
+#include "../clock.h"
+#include "../lcd.h"
+#include "../pwm.h"
+#include "../telemetry.h"
+#include <msp430fr4133.h>
+#include <stdio.h>
+
+#define DEFAULT_RED     870     // Red gain, 4096 / red_coeff
+#define SAVED_RED       780
+
+static void startSampling(void) {
+    adcSeqInit();
+    adcSeqStart();
+}
+
+static const BootStage stages[] = {
+    dataLogInit, setupGPIO, setupPWM, setupTimerForSWPWM, startSampling,
+#if TELEMETRY_ENABLED
+    telemetryInit,
+#endif
+};
+#define STAGES  (sizeof(stages) / sizeof(stages[0]))
+
+/**************************************************************************
+ * Function: powerUp
+ * Description:
+ *    Resets the simulated part with the given causes pending and the RAM
+ *    calibration back at its defaults.
+ **************************************************************************/
+static void powerUp(unsigned int cause1, unsigned int cause2) {
+    simReset();
+    if (cause1) simSetResetCause(cause1);
+    if (cause2) simSetResetCause(cause2);
+    simSetAdcInput(13, 465);           // 1.5 V reference at 3.3 V
+    simSetAdcInput(12, 239);           // Temperature sensor at 25 C
+    colourCalSet(0);
+}
+
+/**************************************************************************
+ * Function: serialBoot
+ * Description:
+ *    The start-up as it was: each stage in turn, the LCD last, then the
+ *    first sample. Returns microseconds to the first sample.
+ **************************************************************************/
+static unsigned long serialBoot(unsigned long *lcdReadyUs) {
+    unsigned long long start;
+    unsigned int first;
+    unsigned char i;
+
+    powerUp(SYSRSTIV_BOR, 0);
+    WDTCTL = WDTPW | WDTHOLD;
+    PM5CTL0 &= ~LOCKLPM5;
+    clockInit();
+    timebaseInit();
+    start = simCycles();                // Interrupts are off, so no tick to time it by
+    for (i = 0; i < STAGES; i++) stages[i]();
+    lcdInit();
+    *lcdReadyUs = (unsigned long)((simCycles() - start) * 1000 / CLOCK_CYCLES_PER_MS);
+    first = adcSeqCount();
+    __bis_SR_register(GIE);             // Interrupts only came on at the end
+    while (adcSeqCount() == first) simAdvance(100);
+    __disable_interrupt();
+    return (unsigned long)((simCycles() - start) * 1000 / CLOCK_CYCLES_PER_MS);
+}
+
+/**************************************************************************
+ * Function: check
+ **************************************************************************/
+static int check(const char *name, unsigned int cause1, unsigned int cause2,
+                 unsigned char warm, unsigned char valid, unsigned int red, unsigned char planet,
+                 unsigned long minLcdUs) {
+    BootReport report;
+    int ok;
+
+    powerUp(cause1, cause2);
+    bootRun(stages, STAGES, &report);
+    __disable_interrupt();
+
+    ok = report.warm == warm && report.stateValid == valid && colourCalActive()->gain[0] == red &&
+         report.lastPlanet == planet && report.firstSampleUs != 0 &&
+         report.lcdReadyUs >= minLcdUs && SYSRSTIV == SYSRSTIV_NONE;
+    printf("%-22s cause 0x%02X  %-4s %-7s red %3u planet %u  lcd %6lu us  stages %5lu us  "
+           "sample %6lu us  boots %u/%u%s\n",
+           name, report.resetCause, report.warm ? "warm" : "cold", report.stateValid ? "valid" : "invalid",
+           colourCalActive()->gain[0], report.lastPlanet, report.lcdReadyUs, report.stagesDoneUs, report.firstSampleUs,
+           report.warmCount, report.bootCount, ok ? "" : "  <-- FAIL");
+    return ok;
+}
+
+int main(void) {
+    unsigned long serialUs, serialLcdUs;
+    unsigned int failures = 0;
+    ColourCal calibration;
+
+    serialUs = serialBoot(&serialLcdUs);
+    printf("serial start-up        lcd %6lu us, first sample %6lu us\n\n", serialLcdUs, serialUs);
+
+    // Blank FRAM: cold, defaults stored
+    failures += !check("power-on, blank FRAM", SYSRSTIV_BOR, 0, 0, 0, DEFAULT_RED, 0, 34000);
+
+    // New calibration and a planet, then the watchdog bites
+    colourCalDefaults(&calibration);
+    calibration.gain[0] = SAVED_RED;
+    colourCalSet(&calibration);
+    bootSaveCalibration();
+    bootSavePlanet(1);
+    failures += !check("watchdog", SYSRSTIV_WDTTO, 0, 1, 1, SAVED_RED, 1, 14000);
+    failures += !check("brown-out", SYSRSTIV_SVSHIFG, 0, 1, 1, SAVED_RED, 1, 34000);
+    failures += !check("RST pin", SYSRSTIV_RSTNMI, 0, 0, 1, SAVED_RED, 0, 34000);
+
+    // Planet cleared by the cold boot; stays clear after a warm one
+    failures += !check("watchdog after cold", SYSRSTIV_WDTKEY, 0, 1, 1, SAVED_RED, 0, 14000);
+
+    bootSavePlanet(1);
+    bootInvalidate();
+    failures += !check("watchdog, bad checksum", SYSRSTIV_WDTTO, 0, 0, 0, DEFAULT_RED, 0, 34000);
+
+    // Power-on outranks the watchdog flag left from before
+    bootSavePlanet(1);
+    failures += !check("power-on + watchdog", SYSRSTIV_WDTTO, SYSRSTIV_BOR, 0, 1, DEFAULT_RED, 0, 34000);
+
+    printf("%u failure(s)\n", failures);
+    return failures != 0;
+}
@@ -0,0 +1,204 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: bootStoreTest.c
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Checks a decision saved with no valid state keeps the calibration.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+/**************************************************************************
+ * Host build:
+ *    gcc -I. -Ihost host/bootStoreTest.c clock.c timebase.c lcd.c \
+ *        colourCal.c colourSensor.c adcSequence.c telemetry.c memUsage.c \
+ *        host/msp430sim.c -o bootStoreTest
+ *    (boot.c is compiled in, so the test can reach its FRAM image)
+ *
+ * Cuts the power part way through each write of the FRAM boot state: a
+ * new calibration, a new detector decision, and the cold boot that
+ * clears the decision. The bytes the write changes are replayed in
+ * order, and the cut either stops after a byte (truncated) or leaves the
+ * byte being written as garbage (corrupted). Then the next boot is run
+ * as a watchdog reset. Checks that:
+ *    - the stored state still checks out and the boot is warm
+ *    - the calibration and decision restored are both from before the
+ *      write or both from after it, never the defaults
+ *    - a warm boot with nothing to change only writes the boot counts
+ *    - a decision saved with no valid state stored keeps the active
+ *      calibration through the next boot
+ * Exits non-zero on any failure.
+ **************************************************************************/
+
+#include "msp430sim.h"
+#include "../boot.c"
+#include <stdio.h>
+
+#define FIRST_RED       780
+#define SECOND_RED      700
+
+typedef struct {
+    const char *name;
+    unsigned int redBefore, redAfter;
+    unsigned char planetBefore, planetAfter;
+} CutCase;
+
+static const CutCase cases[] = {
+    { "save calibration", FIRST_RED, SECOND_RED, 1, 1 },
+    { "save decision", FIRST_RED, FIRST_RED, 0, 1 },
+    { "cold boot", FIRST_RED, FIRST_RED, 1, 0 },
+};
+
+static unsigned int failures = 0;
+
+static void check(int ok, const char *what) {
+    printf("  %-66s %s\n", what, ok ? "ok" : "<-- FAIL");
+    if (!ok) failures++;
+}
+
+static void setRed(unsigned int red) {
+    ColourCal calibration;
+
+    colourCalDefaults(&calibration);
+    calibration.gain[0] = red;
+    colourCalSet(&calibration);
+}
+
+/**************************************************************************
+ * Function: boot
+ * Description:
+ *    Runs the FRAM part of a boot after a reset, with the RAM copy of the
+ *    calibration back at its defaults as a real reset leaves it.
+ **************************************************************************/
+static void boot(unsigned int cause, BootReport *report) {
+    memset(report, 0, sizeof(*report));
+    report->resetCause = cause;
+    colourCalSet(0);
+    bootLoad(report);
+}
+
+/**************************************************************************
+ * Function: makeStore
+ * Description:
+ *    Builds the store a case starts from: two saves, so both copies are
+ *    in use, ending with the calibration and decision before the write.
+ **************************************************************************/
+static void makeStore(const CutCase *c) {
+    BootReport report;
+
+    memset(&bootStore, 0, sizeof(bootStore));
+    boot(SYSRSTIV_BOR, &report);
+    setRed(c->redBefore + 1);
+    bootSaveCalibration();
+    setRed(c->redBefore);
+    bootSaveCalibration();
+    bootSavePlanet(c->planetBefore);
+}
+
+/**************************************************************************
+ * Function: doWrite
+ * Description:
+ *    Makes the case's write, with the active calibration as it would be.
+ **************************************************************************/
+static void doWrite(const CutCase *c) {
+    BootReport report;
+
+    if (c->redAfter != c->redBefore) {
+        setRed(c->redAfter);
+        bootSaveCalibration();
+    } else if (c->planetAfter != c->planetBefore && c->planetAfter) {
+        setRed(c->redBefore);
+        bootSavePlanet(c->planetAfter);
+    } else {
+        boot(SYSRSTIV_RSTNMI, &report);
+    }
+}
+
+static void checkCase(const CutCase *c) {
+    static BootStore pre, post;
+    const unsigned char *from = (const unsigned char *)&pre, *to = (const unsigned char *)&post;
+    unsigned int changed[sizeof(BootStore)];
+    unsigned int count = 0, k, i, bad[2] = { 0, 0 };
+    unsigned char mode;
+    BootReport report;
+    char what[128];
+
+    makeStore(c);
+    pre = bootStore;
+    doWrite(c);
+    post = bootStore;
+    for (i = 0; i < sizeof(BootStore); i++) {
+        if (from[i] != to[i]) changed[count++] = i;
+    }
+
+    for (mode = 0; mode < 2; mode++) {
+        for (k = 0; k <= count; k++) {
+            unsigned char *store = (unsigned char *)&bootStore;
+            unsigned int red;
+            int before, after;
+
+            if (mode == 1 && k == count) break;     // Nothing left to corrupt
+            bootStore = pre;
+            for (i = 0; i < k; i++) store[changed[i]] = to[changed[i]];
+            if (mode == 1) store[changed[k]] = (unsigned char)~to[changed[k]];
+            boot(SYSRSTIV_WDTTO, &report);
+            red = colourCalActive()->gain[0];
+            before = red == c->redBefore && report.lastPlanet == c->planetBefore;
+            after = red == c->redAfter && report.lastPlanet == c->planetAfter;
+            if (!report.stateValid || !report.warm || !(before || after)) {
+                if (bad[mode]++ == 0) {
+                    printf("    first bad cut: %s at byte %u of %u, %s, red %u, decision %u\n",
+                           mode ? "corrupted" : "truncated", k, count, report.stateValid ? "valid" : "invalid",
+                           red, report.lastPlanet);
+                }
+            }
+        }
+    }
+    sprintf(what, "%s: %u bytes, %u truncated and %u corrupted cuts bad", c->name, count, bad[0], bad[1]);
+    check(bad[0] == 0 && bad[1] == 0, what);
+}
+
+static void checkWarmWrites(void) {
+    static BootStore pre;
+    const unsigned char *from = (const unsigned char *)&pre, *to = (const unsigned char *)&bootStore;
+    unsigned int changed = 0, counts, i;
+    BootReport report;
+    char what[128];
+
+    makeStore(&cases[0]);
+    pre = bootStore;
+    boot(SYSRSTIV_WDTTO, &report);
+    for (i = 0; i < sizeof(BootStore); i++) {
+        if (from[i] != to[i]) changed++;
+    }
+    // Only the low bytes of the two counts move on this boot
+    counts = report.bootCount == pre.bootCount + 1 &&
+             report.warmCount == pre.warmCount + 1;
+    sprintf(what, "warm boot with nothing to change: %u bytes written", changed);
+    check(report.warm && counts && changed <= 2, what);
+}
+
+static void checkSaveWithoutState(void) {
+    BootReport report;
+    char what[128];
+
+    memset(&bootStore, 0, sizeof(bootStore));      // Blank FRAM, no boot yet
+    setRed(FIRST_RED);
+    bootSavePlanet(1);
+    boot(SYSRSTIV_WDTTO, &report);
+    sprintf(what, "decision saved with no state: red %u after the boot, decision %u",
+            colourCalActive()->gain[0], report.lastPlanet);
+    check(report.stateValid && report.warm && colourCalActive()->gain[0] == FIRST_RED && report.lastPlanet == 1, what);
+}
+
+int main(void) {
+    unsigned char n;
+
+    simReset();
+    printf("%u byte store, %u byte copies\n", (unsigned int)sizeof(BootStore), (unsigned int)sizeof(BootState));
+    for (n = 0; n < sizeof(cases) / sizeof(cases[0]); n++) checkCase(&cases[n]);
+    checkWarmWrites();
+    checkSaveWithoutState();
+    printf("%u failure(s)\n", failures);
+    return failures != 0;
+}
@@ -0,0 +1,71 @@
+#!/bin/sh
+###########################################################################
+# Project Name: Exoplanet Detection Simulator
+# Module Name: clockCheck.sh
+# Created on: 19 Oct 2026
+# Date Last Updated: 19/10/2026
+# Update Description:
+#    latencySim is run with the hardware PWM backend too.
+# Author: Finlay Harris
+###########################################################################
+
+###########################################################################
+# Usage (from the project root):
+#    sh host/clockCheck.sh [gcc]
+#
+# Builds and runs the host tests that depend on the clock at each
+# CLOCK_MHZ clock.h allows (1, 8 and 16), with the other PWM backend as
+# well for pwmTest and latencySim. Each test is built with the command in
+# its "Host build:" comment plus -DCLOCK_MHZ (and the backend), so the two
+# cannot drift apart.
+# Prints one line per build and exits non-zero if any fails to build or
+# reports a failure.
+###########################################################################
+
+CC=${1:-gcc}
+OUT=${TMPDIR:-/tmp}/clockCheck
+TESTS="timebaseTest pwmTest ditherTest profileTest latencySim"
+failed=0
+
+mkdir -p "$OUT" || exit 1
+
+# The gcc command from a test's "Host build:" comment, without its -o
+hostBuild() {
+    awk '/Host build:/ { found = 1; next }
+         found && /gcc/ { cmd = 1 }
+         cmd { print; if (!/\\[[:space:]]*$/) exit }' "host/$1.c" |
+        sed 's/^ \*//; s/\\[[:space:]]*$//; s/\r$//' | tr '\n' ' ' |
+        sed "s/^ *gcc //; s/ -o [^ ]*//"
+}
+
+# Builds and runs one test: name, CLOCK_MHZ, extra flags, file suffix.
+# A PWM_USE_HARDWARE in the extra flags replaces the test's own.
+check() {
+    exe="$OUT/$1_$2$4"
+    label="$1 at $2 MHz${3:+ $3}"
+    build=$(hostBuild $1)
+    case "$3" in
+        *PWM_USE_HARDWARE*) build=$(echo "$build" | sed 's/-DPWM_USE_HARDWARE=[01]//') ;;
+    esac
+    if ! $CC -DCLOCK_MHZ=$2 $3 $build -o "$exe" > "$exe.log" 2>&1; then
+        echo "$label: BUILD FAILED (see $exe.log)"
+        failed=1
+        return
+    fi
+    if "$exe" > "$exe.log" 2>&1; then
+        echo "$label: $(tail -n 1 "$exe.log")"
+    else
+        echo "$label: FAILED (see $exe.log)"
+        failed=1
+    fi
+}
+
+for mhz in 1 8 16; do
+    for test in $TESTS; do
+        check $test $mhz "" ""
+    done
+    check pwmTest $mhz -DPWM_USE_HARDWARE=0 _sw
+    check latencySim $mhz -DPWM_USE_HARDWARE=1 _hw
+done
+
+exit $failed
@@ -0,0 +1,259 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: colourCalTest.c
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Initial creation of the colour calibration checks.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+/**************************************************************************
+ * Host build:
+ *    gcc -I. -Ihost host/colourCalTest.c colourCal.c colourSensor.c lcd.c \
+ *        timebase.c clock.c telemetry.c memUsage.c host/msp430sim.c -lm \
+ *        -o colourCalTest
+ *
+ * Checks the calibration maths against synthetic sensors. Each sensor
+ * unit has its own dark count, sensitivity and filter crosstalk per
+ * channel, and a surface of reflectance (r, g, b) gives
+ *    pulses[c] = dark[c] + sensitivity[c] * sum over t of crosstalk[c][t] * refl[t]
+ * plus a little noise. For each unit the white/black and primary targets
+ * are "measured" this way and the calibration worked out, then:
+ *    - the defaults must reproduce the old float coefficient scaling
+ *    - white, black and mid grey must read 255, 0 and about 128
+ *    - with the matrix, each primary must read as that primary alone
+ *    - the integer pipeline must agree with a double-precision reference
+ *    - Identify_Colour() must name a set of test surfaces correctly
+ *    - targets without enough contrast, or primaries that cannot be told
+ *      apart, must be refused and leave the calibration alone
+ * Prints a line per check and exits non-zero on any failure.
+ **************************************************************************/
+
+#include "../colourCal.h"
+#include "../colourSensor.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    const char *name;
+    double dark[3];                // Pulses per window with no light
+    double sensitivity[3];         // Pulses per window for full reflectance
+    double crosstalk[3][3];        // Channel c's response to primary t
+} SensorUnit;
+
+static const SensorUnit units[] = {
+    { "reference unit",  {  0,  0,  0 }, { 1200, 1260, 1360 },
+      { { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } } },
+    { "dim, offset",     { 40, 55, 30 }, {  420,  380,  500 },
+      { { 1, 0.05, 0.02 }, { 0.04, 1, 0.06 }, { 0.01, 0.08, 1 } } },
+    { "leaky filters",   { 15, 20, 25 }, { 1800, 1500, 1300 },
+      { { 1, 0.25, 0.10 }, { 0.20, 1, 0.30 }, { 0.05, 0.35, 1 } } },
+};
+
+typedef struct {
+    const char *name;
+    double refl[3];
+    const char *colour;            // Identify_Colour() wanted
+} Surface;
+
+static const Surface surfaces[] = {
+    { "white card",   { 0.95, 0.95, 0.95 }, "White" },
+    { "red card",     { 0.85, 0.12, 0.10 }, "Red" },
+    { "blue card",    { 0.10, 0.15, 0.80 }, "Blue" },
+    { "green card",   { 0.10, 0.80, 0.15 }, "Unknown" },
+    { "grey card",    { 0.30, 0.30, 0.30 }, "Unknown" },
+};
+
+static unsigned int failures = 0;
+static unsigned int misnamed = 0;          // By the defaults, over all units
+
+/**************************************************************************
+ * Function: measure
+ * Description:
+ *    Pulse counts a unit gives for a surface, with up to +/-noise counts.
+ **************************************************************************/
+static void measure(const SensorUnit *unit, const double refl[3], int noise, unsigned int pulses[3]) {
+    double level;
+    unsigned char c, t;
+
+    for (c = 0; c < 3; c++) {
+        level = unit->dark[c];
+        for (t = 0; t < 3; t++) level += unit->sensitivity[c] * unit->crosstalk[c][t] * refl[t];
+        if (noise) level += rand() % (2 * noise + 1) - noise;
+        pulses[c] = level < 0 ? 0 : (unsigned int)(level + 0.5);
+    }
+}
+
+/**************************************************************************
+ * Function: expect
+ **************************************************************************/
+static void expect(int ok, const char *what) {
+    printf("  %-4s %s\n", ok ? "ok" : "FAIL", what);
+    if (!ok) failures++;
+}
+
+/**************************************************************************
+ * Function: within
+ **************************************************************************/
+static int within(const unsigned int rgb[3], double r, double g, double b, double tolerance) {
+    return fabs(rgb[0] - r) <= tolerance && fabs(rgb[1] - g) <= tolerance && fabs(rgb[2] - b) <= tolerance;
+}
+
+/**************************************************************************
+ * Function: reference
+ * Description:
+ *    The calibration applied in double precision, for comparison.
+ **************************************************************************/
+static void reference(const ColourCal *cal, const unsigned int pulses[3], double out[3]) {
+    double level[3], sum;
+    unsigned char i, j;
+
+    for (i = 0; i < 3; i++) {
+        level[i] = pulses[i] <= cal->black[i] ? 0 : (double)(pulses[i] - cal->black[i]) * cal->gain[i] / COLOURCAL_ONE;
+        level[i] = floor(level[i]);
+        if (level[i] > COLOURCAL_FULL_SCALE) level[i] = COLOURCAL_FULL_SCALE;
+    }
+    for (i = 0; i < 3; i++) {
+        if (!cal->useMatrix) {
+            out[i] = level[i];
+            continue;
+        }
+        for (sum = 0, j = 0; j < 3; j++) sum += (double)cal->matrix[i][j] / COLOURCAL_ONE * level[j];
+        out[i] = sum < 0 ? 0 : sum > COLOURCAL_FULL_SCALE ? COLOURCAL_FULL_SCALE : sum;
+    }
+}
+
+/**************************************************************************
+ * Function: checkDefaults
+ **************************************************************************/
+static void checkDefaults(void) {
+    ColourCal cal;
+    unsigned int pulses[3], rgb[3], p, worst = 0, expected;
+    unsigned char c;
+    const float coeff[3] = { red_coeff, green_coeff, blue_coeff };
+
+    printf("defaults\n");
+    colourCalDefaults(&cal);
+    for (p = 0; p <= 2000; p++) {
+        pulses[0] = pulses[1] = pulses[2] = p;
+        colourCalApply(&cal, pulses, rgb);
+        for (c = 0; c < 3; c++) {
+            expected = (unsigned int)(p / coeff[c]);
+            if (expected > 255) expected = 255;
+            if ((unsigned int)abs((int)rgb[c] - (int)expected) > worst) worst = abs((int)rgb[c] - (int)expected);
+        }
+    }
+    expect(worst <= 1, "match the float coefficients to 1 count");
+    expect(colourCalActive()->gain[0] == cal.gain[0] && !colourCalActive()->useMatrix, "active until set");
+}
+
+/**************************************************************************
+ * Function: checkUnit
+ **************************************************************************/
+static void checkUnit(const SensorUnit *unit) {
+    static const double white[3] = { 1, 1, 1 }, black[3] = { 0, 0, 0 }, grey[3] = { 0.5, 0.5, 0.5 };
+    static const double primary[3][3] = { { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } };
+    unsigned int whiteP[3], blackP[3], primaries[3][3], pulses[3], rgb[3], i;
+    unsigned char t, c, named;
+    double out[3], worst = 0;
+    ColourCal cal, defaults;
+    char *colour;
+
+    printf("%s\n", unit->name);
+    measure(unit, white, 0, whiteP);
+    measure(unit, black, 0, blackP);
+    expect(colourCalFromTargets(whiteP, blackP, &cal), "white/black accepted");
+
+    measure(unit, grey, 0, pulses);
+    colourCalApply(&cal, pulses, rgb);
+    expect(within(rgb, 127, 127, 127, 2), "mid grey about 128 (no matrix)");
+    colourCalApply(&cal, whiteP, rgb);
+    expect(within(rgb, 255, 255, 255, 1), "white reads 255");
+    colourCalApply(&cal, blackP, rgb);
+    expect(within(rgb, 0, 0, 0, 0), "black reads 0");
+
+    for (t = 0; t < 3; t++) measure(unit, primary[t], 0, primaries[t]);
+    expect(colourCalSolveMatrix(&cal, primaries), "primaries accepted");
+    for (t = 0, i = 1; t < 3; t++) {
+        colourCalApply(&cal, primaries[t], rgb);
+        for (c = 0; c < 3; c++) {
+            if (fabs(rgb[c] - (c == t ? 255.0 : 0.0)) > 3) i = 0;
+        }
+    }
+    expect(i, "each primary reads alone, to 3 counts");
+    measure(unit, grey, 0, pulses);
+    colourCalApply(&cal, pulses, rgb);
+    expect(within(rgb, 127.5, 127.5, 127.5, 3), "mid grey about 128 (matrix)");
+
+    // Integer pipeline against double precision, noisy inputs
+    for (i = 0; i < 2000; i++) {
+        double refl[3] = { rand() / (double)RAND_MAX, rand() / (double)RAND_MAX, rand() / (double)RAND_MAX };
+        measure(unit, refl, 6, pulses);
+        colourCalApply(&cal, pulses, rgb);
+        reference(&cal, pulses, out);
+        for (c = 0; c < 3; c++) if (fabs(rgb[c] - out[c]) > worst) worst = fabs(rgb[c] - out[c]);
+    }
+    printf("       worst fixed-point error %.2f counts\n", worst);
+    expect(worst <= 1.0, "fixed point within 1 count of double");
+
+    // Naming, uncalibrated and calibrated
+    colourCalDefaults(&defaults);
+    for (i = 0, named = 0; i < sizeof(surfaces) / sizeof(surfaces[0]); i++) {
+        measure(unit, surfaces[i].refl, 6, pulses);
+        colourCalApply(&defaults, pulses, rgb);
+        red_val = rgb[0]; green_val = rgb[1]; blue_val = rgb[2];
+        named += strcmp(Identify_Colour(), surfaces[i].colour) == 0;
+    }
+    printf("       uncalibrated: %u of %u surfaces named correctly\n", named,
+           (unsigned int)(sizeof(surfaces) / sizeof(surfaces[0])));
+    misnamed += sizeof(surfaces) / sizeof(surfaces[0]) - named;
+    for (i = 0; i < sizeof(surfaces) / sizeof(surfaces[0]); i++) {
+        measure(unit, surfaces[i].refl, 6, pulses);
+        colourCalApply(&cal, pulses, rgb);
+        red_val = rgb[0]; green_val = rgb[1]; blue_val = rgb[2];
+        colour = Identify_Colour();
+        if (strcmp(colour, surfaces[i].colour) != 0) {
+            printf("       %s read %u %u %u, named %s\n", surfaces[i].name, rgb[0], rgb[1], rgb[2], colour);
+            named = 0xFF;
+        }
+    }
+    expect(named != 0xFF, "every surface named correctly once calibrated");
+}
+
+/**************************************************************************
+ * Function: checkRefusals
+ **************************************************************************/
+static void checkRefusals(void) {
+    unsigned int white[3] = { 500, 500, 500 }, black[3] = { 490, 20, 20 };
+    unsigned int alike[3][3] = { { 800, 700, 650 }, { 760, 720, 640 }, { 780, 690, 700 } };
+    unsigned int black0[3] = { 0, 0, 0 };
+    ColourCal cal, before;
+
+    printf("refusals\n");
+    colourCalDefaults(&cal);
+    before = cal;
+    expect(!colourCalFromTargets(white, black, &cal) && memcmp(&cal, &before, sizeof(cal)) == 0,
+           "low contrast channel refused, calibration kept");
+    white[0] = 900;
+    expect(colourCalFromTargets(white, black0, &cal), "good targets accepted");
+    before = cal;
+    expect(!colourCalSolveMatrix(&cal, alike) && memcmp(&cal, &before, sizeof(cal)) == 0,
+           "indistinct primaries refused, calibration kept");
+}
+
+int main(void) {
+    unsigned int i;
+
+    srand(1);
+    checkDefaults();
+    for (i = 0; i < sizeof(units) / sizeof(units[0]); i++) checkUnit(&units[i]);
+    printf("all units\n");
+    expect(misnamed > 0, "the defaults misname some surfaces (units differ enough to matter)");
+    checkRefusals();
+
+    printf("%u failure(s)\n", failures);
+    return failures != 0;
+}
@@ -0,0 +1,291 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: dataLogTest.c
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Light samples stored as coded blocks read back and decode.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+/**************************************************************************
+ * Host build:
+ *    gcc -I. -Ihost host/dataLogTest.c lightCodec.c timebase.c clock.c \
+ *        memUsage.c host/msp430sim.c -o dataLogTest
+ *    (dataLog.c is compiled in, so the test can reach its FRAM image)
+ *
+ * Cuts the power part way through an append at every byte of it, with
+ * the log empty, part full, filling, full and wrapped, and with the
+ * sequence number about to wrap. The append's writes are replayed byte
+ * by byte in the order dataLogAppend() makes them, and the cut either
+ * stops after a byte (truncated) or leaves the byte being written as
+ * garbage (corrupted). Then dataLogInit() is run as on the next boot.
+ * Checks that:
+ *    - the count is what it was, or one more once the commit word is in
+ *    - every record reads back in order with its contents, except that
+ *      the oldest record may read as torn while its slot is being reused
+ *    - the new record reads back only once its commit word is in
+ *    - the next append after recovery follows on in sequence
+ * Then feeds a synthetic light curve, quiet with a dip then noisy, through
+ * dataLogLightSample(), and checks that every whole block in the log
+ * decodes to the samples fed, in order, up to the newest, and that code
+ * records left without their block record (as a cut would) are skipped.
+ * Exits non-zero on any failure.
+ **************************************************************************/
+
+#include "msp430sim.h"
+#include "../dataLog.c"
+#include "../lightCodec.h"
+#include <stdio.h>
+#include <string.h>
+
+#define MAX_WRITES  64           // Bytes one append writes
+#define CURVE       1500         // Light samples fed, enough to wrap the log
+#define QUIET       600          // Samples before the curve turns noisy
+
+// The FRAM the log lives in, as bytes
+typedef struct {
+    DataLogRecord slots[DATALOG_RECORDS];
+    DataLogControl control;
+} FramImage;
+
+// One byte of an append, in the order it is written
+typedef struct {
+    unsigned int offset;
+    unsigned char value;
+} ByteWrite;
+
+static const unsigned long scenarios[] = { 0, 1, 5, DATALOG_RECORDS - 1, DATALOG_RECORDS, 200, 65535, 65536 };
+
+static unsigned int failures = 0;
+
+static void saveImage(FramImage *image) {
+    memcpy(image->slots, (const void *)dataLogSlots, sizeof(image->slots));
+    memcpy(&image->control, (const void *)&dataLogControl, sizeof(image->control));
+}
+
+static void loadImage(const FramImage *image) {
+    memcpy((void *)dataLogSlots, image->slots, sizeof(image->slots));
+    memcpy((void *)&dataLogControl, &image->control, sizeof(image->control));
+}
+
+/**************************************************************************
+ * Function: append
+ * Description:
+ *    Appends record n of the run: its contents are worked out from n so
+ *    they can be checked later.
+ **************************************************************************/
+static void append(unsigned long n) {
+    timebaseTickCount = n * 7 + 1;
+    dataLogAppend(n & 1 ? DATALOG_COLOUR : DATALOG_LIGHT, (unsigned int)n, (unsigned int)(n * 3),
+                  (unsigned int)~n);
+}
+
+static int matches(const DataLogRecord *r, unsigned long n) {
+    return r->sequence == (unsigned int)(n & 0xFFFF) && r->type == (n & 1 ? DATALOG_COLOUR : DATALOG_LIGHT) &&
+           r->tick == n * 7 + 1 && r->value[0] == (unsigned int)n && r->value[1] == (unsigned int)(n * 3) &&
+           r->value[2] == (unsigned int)~n;
+}
+
+/**************************************************************************
+ * Function: addWrite
+ * Description:
+ *    Adds the bytes of one field write, taking the values from an image.
+ **************************************************************************/
+static void addWrite(ByteWrite *writes, unsigned int *count, const volatile void *field, unsigned int size,
+                     const FramImage *from) {
+    const volatile char *at = field;
+    unsigned int offset, i;
+
+    if (field == &dataLogControl.nextSequence || field == &dataLogControl.full) {
+        offset = (unsigned int)(sizeof(from->slots) + (at - (const volatile char *)&dataLogControl));
+    } else {
+        offset = (unsigned int)(at - (const volatile char *)dataLogSlots);
+    }
+    for (i = 0; i < size; i++) {
+        writes[*count].offset = offset + i;
+        writes[*count].value = ((const unsigned char *)from)[offset + i];
+        (*count)++;
+    }
+}
+
+/**************************************************************************
+ * Function: checkRecovery
+ * Description:
+ *    After the cut and dataLogInit(), with `before` records appended and
+ *    the append of record `before` cut, checks the log holds records up
+ *    to `newest` (exclusive) and that the next append follows on.
+ **************************************************************************/
+static int checkRecovery(unsigned long before, unsigned long newest) {
+    unsigned long oldest = newest > DATALOG_RECORDS ? newest - DATALOG_RECORDS : 0;
+    unsigned int count = dataLogCount(), i;
+    DataLogRecord record;
+
+    if (count != newest - oldest) return 0;
+    for (i = 0; i < count; i++) {
+        if (!dataLogRead(i, &record)) {
+            // Only the slot being reused may be torn, and only until the new record is in
+            if (oldest + i != before - DATALOG_RECORDS || newest != before) return 0;
+        } else if (!matches(&record, oldest + i)) {
+            return 0;
+        }
+    }
+    append(newest);
+    return dataLogRead(dataLogCount() - 1, &record) && matches(&record, newest);
+}
+
+/**************************************************************************
+ * Function: checkScenario
+ * Description:
+ *    Appends `before` records, then cuts the next append at every byte.
+ **************************************************************************/
+static void checkScenario(unsigned long before) {
+    static FramImage pre, post, cleared, cut;
+    static ByteWrite writes[MAX_WRITES];
+    volatile DataLogRecord *slot;
+    unsigned int count = 0, k, bad[2] = { 0, 0 };
+    unsigned long n;
+    unsigned char mode;
+
+    dataLogClear();
+    for (n = 0; n < before; n++) append(n);
+    saveImage(&pre);
+    append(before);
+    saveImage(&post);
+
+    // dataLogAppend()'s writes, in order: commit cleared, body, commit,
+    // next sequence and, when it fills the log, the full flag
+    slot = &dataLogSlots[before & DATALOG_MASK];
+    cleared = post;
+    cleared.slots[before & DATALOG_MASK].commit = 0;
+    addWrite(writes, &count, &slot->commit, sizeof(slot->commit), &cleared);
+    addWrite(writes, &count, &slot->sequence, sizeof(slot->sequence), &post);
+    addWrite(writes, &count, &slot->type, sizeof(slot->type), &post);
+    addWrite(writes, &count, &slot->reserved, sizeof(slot->reserved), &post);
+    addWrite(writes, &count, &slot->tick, sizeof(slot->tick), &post);
+    addWrite(writes, &count, slot->value, sizeof(slot->value), &post);
+    addWrite(writes, &count, &slot->commit, sizeof(slot->commit), &post);
+    addWrite(writes, &count, &dataLogControl.nextSequence, sizeof(dataLogControl.nextSequence), &post);
+    if (((before + 1) & 0xFFFF) == DATALOG_RECORDS) {
+        addWrite(writes, &count, &dataLogControl.full, sizeof(dataLogControl.full), &post);
+    }
+
+    for (mode = 0; mode < 2; mode++) {
+        for (k = 0; k <= count; k++) {
+            unsigned int i, index = before & DATALOG_MASK;
+            int committed;
+
+            if (mode == 1 && k == count) break;     // Nothing left to corrupt
+            cut = pre;
+            for (i = 0; i < k; i++) ((unsigned char *)&cut)[writes[i].offset] = writes[i].value;
+            if (mode == 1) ((unsigned char *)&cut)[writes[k].offset] = (unsigned char)~writes[k].value;
+            // The new record is in once its slot is whole, commit word last
+            committed = memcmp(&cut.slots[index], &post.slots[index], sizeof(post.slots[index])) == 0;
+            loadImage(&cut);
+            dataLogInit();
+            if (!checkRecovery(before, committed ? before + 1 : before)) {
+                if (bad[mode]++ == 0) {
+                    printf("    first bad cut: %s at byte %u of %u\n", mode ? "corrupted" : "truncated", k, count);
+                }
+            }
+        }
+    }
+    printf("  %6lu records before, %u bytes written: %u truncated and %u corrupted cuts bad%s\n",
+           before, count, bad[0], bad[1], bad[0] || bad[1] ? "  <-- FAIL" : "");
+    if (bad[0] || bad[1]) failures++;
+
+    // Without a cut, the append itself
+    loadImage(&post);
+    dataLogInit();
+    if (memcmp((const void *)dataLogSlots, post.slots, sizeof(post.slots)) != 0 || dataLogControl.nextSequence !=
+        post.control.nextSequence || !checkRecovery(before, before + 1)) {
+        printf("  %6lu records before: a reset with no cut changed the log  <-- FAIL\n", before);
+        failures++;
+    }
+}
+
+/**************************************************************************
+ * Function: curveSample
+ * Description:
+ *    Sample n of the synthetic light curve: a level of 700 with a count of
+ *    noise and a 30 count dip, then noise of a few tens of counts.
+ **************************************************************************/
+static unsigned int curveSample(unsigned int n) {
+    static unsigned long seed;
+    unsigned int level = n >= 200 && n < 320 ? 670 : 700;
+
+    if (n == 0) seed = 12345;
+    seed = seed * 1103515245UL + 12345;
+    return level + (unsigned int)((seed >> 16) % (n < QUIET ? 3 : 64)) - (n < QUIET ? 1 : 32);
+}
+
+/**************************************************************************
+ * Function: decodeLog
+ * Description:
+ *    Decodes every whole block in the log, oldest first, into samples.
+ *    Returns the number of samples, or 0 if a block fails to decode.
+ **************************************************************************/
+static unsigned int decodeLog(unsigned int *samples, unsigned int *blocks) {
+    unsigned char code[DATALOG_BLOCK_BYTES];
+    unsigned int index, bytes, count, decoded = 0;
+    LightDecoder decoder;
+
+    *blocks = 0;
+    for (index = 0; index < dataLogCount(); index++) {
+        if (!dataLogReadBlock(index, code, &bytes, &count)) continue;
+        lightDecoderInit(&decoder, code, bytes, count);
+        while (count--) {
+            if (!lightDecode(&decoder, &samples[decoded++])) return 0;
+        }
+        (*blocks)++;
+    }
+    return decoded;
+}
+
+static void checkLightBlocks(void) {
+    static unsigned int fed[CURVE], decoded[CURVE];
+    unsigned int n, count, blocks, bad = 0, orphans;
+
+    // A long curve: the newest blocks are kept, ending with the newest sample
+    dataLogClear();
+    for (n = 0; n < CURVE; n++) {
+        fed[n] = curveSample(n);
+        dataLogLightSample(fed[n]);
+    }
+    dataLogLightFlush();
+    count = decodeLog(decoded, &blocks);
+    for (n = 0; n < count; n++) {
+        if (decoded[n] != fed[CURVE - count + n]) bad++;
+    }
+    printf("  light curve: %u samples fed, %u blocks read back holding the newest %u, %u wrong%s\n", CURVE, blocks,
+           count, bad, count == 0 || bad ? "  <-- FAIL" : "");
+    if (count == 0 || bad) failures++;
+
+    // Code records without their block record, then a block after them
+    dataLogClear();
+    for (n = 0; n < 100; n++) dataLogLightSample(fed[n]);
+    dataLogLightFlush();
+    orphans = dataLogCount();
+    dataLogAppend(DATALOG_LIGHT_CODE, 0xFFFF, 0xFFFF, 0xFFFF);
+    dataLogAppend(DATALOG_LIGHT_CODE, 0x1234, 0x5678, 0x9ABC);
+    for (n = 100; n < 150; n++) dataLogLightSample(fed[n]);
+    dataLogLightFlush();
+    count = decodeLog(decoded, &blocks);
+    for (bad = 0, n = 0; n < count; n++) {
+        if (decoded[n] != fed[n]) bad++;
+    }
+    printf("  block after 2 code records at %u left by a cut: %u blocks, %u samples, %u wrong%s\n", orphans, blocks,
+           count, bad, count != 150 || bad ? "  <-- FAIL" : "");
+    if (count != 150 || bad) failures++;
+}
+
+int main(void) {
+    unsigned char s;
+
+    simReset();
+    printf("%u slots, %u byte records\n", DATALOG_RECORDS, (unsigned int)sizeof(DataLogRecord));
+    for (s = 0; s < sizeof(scenarios) / sizeof(scenarios[0]); s++) checkScenario(scenarios[s]);
+    checkLightBlocks();
+    printf("%u failure(s)\n", failures);
+    return failures != 0;
+}
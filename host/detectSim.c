@@ -0,0 +1,169 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: detectSim.c
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Starts the ADC sequence and feeds its reference and temperature
+ *    channels at 3.3 V and 25 C.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+/**************************************************************************
+ * Host build:
+ *    gcc -I. -Ihost host/detectSim.c detect.c adcSequence.c colourSensor.c \
+ *        colourCal.c lightIntensity.c lightStats.c timebase.c clock.c \
+ *        lcd.c pwm.c telemetry.c memUsage.c host/msp430sim.c -o detectSim
+ *
+ * Runs detect.c on the simulator with synthetic sensors: a phototransistor
+ * level (with noise) on A4, and a colour sensor whose pulse rate on P1.3
+ * follows the filter select lines, set so Colour_Detect()'s scaling gives
+ * the wanted red/green/blue values. Each scenario is one detection cycle;
+ * the last runs in continuous mode through a slow transit to show the
+ * hysteresis. Prints each decision with its score and latency and exits
+ * non-zero if any decision differs from the expected one.
+ **************************************************************************/
+
+#include "msp430sim.h"
+#include "../detect.h"
+#include "../adcSequence.h"
+#include "../colourSensor.h"
+#include "../timebase.h"
+#include "../clock.h"
+#include <msp430fr4133.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define ADC_NOISE   8      // Peak ADC noise, per millisecond
+#define ADC_REF     465    // 1.5 V reference read at 3.3 V
+#define ADC_TEMP    239    // Temperature sensor read at 25 C, 3.3 V
+
+typedef struct {
+    const char *name;
+    unsigned int lightPercent;
+    unsigned int red, green, blue;
+    unsigned char planet;              // Expected decision
+} Scenario;
+
+static const Scenario singles[] = {
+    { "clear sky, white star",      100, 200, 200, 200, 0 },
+    { "deep transit, white",         30, 200, 200, 200, 1 },
+    { "deep transit, green",         30,  40, 200,  40, 0 },
+    { "shallow transit, red",        70, 200,  40,  40, 1 },
+    { "slight dip, blue",            85,  40,  40, 200, 0 },
+    { "dark, no colour",             10,  20,  20,  20, 0 },
+};
+
+// Continuous run: light level per cycle through a transit, white star
+static const unsigned int ramp[] = { 100, 80, 70, 75, 80, 85, 95, 100 };
+static const unsigned char rampExpected[] = { 0, 0, 1, 1, 1, 1, 0, 0 };
+
+static const Scenario *current;
+static unsigned int currentLight;
+static unsigned int currentFilter = 0xFF;
+
+/**************************************************************************
+ * Function: updateSensors
+ * Description:
+ *    Sets the ADC level with fresh noise and the pulse rate for the
+ *    filter the firmware has selected.
+ **************************************************************************/
+static void updateSensors(void) {
+    unsigned int adc, value = 0, filter;
+    float coeff = 1;
+    long noisy;
+
+    adc = DETECT_ADC_MIN + (unsigned int)((unsigned long)currentLight * (DETECT_ADC_MAX - DETECT_ADC_MIN) / 100);
+    noisy = (long)adc + (rand() % (2 * ADC_NOISE + 1)) - ADC_NOISE;
+    simSetAdcInput(4, noisy < 0 ? 0 : (unsigned int)noisy);
+
+    filter = ((COLOUR_SEL_A_OUT & COLOUR_SEL_A) ? 1 : 0) | ((COLOUR_SEL_B_OUT & COLOUR_SEL_B) ? 2 : 0);
+    if (filter == currentFilter) return;
+    currentFilter = filter;
+    switch (filter) {
+        case 3: value = current->red;   coeff = red_coeff;   break;
+        case 2: value = current->green; coeff = green_coeff; break;
+        case 1: value = current->blue;  coeff = blue_coeff;  break;
+    }
+    // value * coeff pulses per window
+    simSetPulseInput(1, BIT3, value ? (unsigned long)(CLOCK_MCLK_HZ / (value * coeff * 1000.0 / DETECT_WINDOW_MS)) : 0);
+}
+
+/**************************************************************************
+ * Function: runUntilDecision
+ **************************************************************************/
+static int runUntilDecision(DetectResult *result, unsigned int limitMs) {
+    unsigned int ms;
+
+    for (ms = 0; ms < limitMs; ms++) {
+        updateSensors();
+        simAdvance(CLOCK_CYCLES_PER_MS);
+        if (detectPoll(result)) return 1;
+    }
+    return 0;
+}
+
+/**************************************************************************
+ * Function: report
+ **************************************************************************/
+static int report(const char *name, unsigned int light, const DetectResult *result, unsigned char expected) {
+    int ok = result->planet == expected;
+
+    printf("%-24s light %3u%% -> adc %3u (%2u samples) %3u%%  rgb %3u %3u %3u  score %3u  %-9s  "
+           "acquire %u ms, latency %u ms%s\n",
+           name, light, result->lightAdc, result->adcSamples, result->lightPercent,
+           result->red, result->green, result->blue, result->score,
+           result->planet ? "PLANET" : "no planet", result->acquireMs, result->latencyMs,
+           ok ? "" : "  <-- UNEXPECTED");
+    return ok;
+}
+
+int main(void) {
+    DetectResult result;
+    Scenario rampScenario = { "transit ramp", 0, 200, 200, 200, 0 };
+    unsigned int i, failures = 0;
+
+    simReset();
+    WDTCTL = WDTPW | WDTHOLD;
+    PM5CTL0 &= ~LOCKLPM5;
+    clockInit();
+    timebaseInit();
+    adcSeqInit();
+    simSetAdcInput(12, ADC_TEMP);
+    simSetAdcInput(13, ADC_REF);
+    __bis_SR_register(GIE);
+
+    for (i = 0; i < sizeof(singles) / sizeof(singles[0]); i++) {
+        current = &singles[i];
+        currentLight = current->lightPercent;
+        currentFilter = 0xFF;
+        detectReset();
+        if (detectStart(0) != 1 || !runUntilDecision(&result, 2000)) {
+            printf("%-24s no decision\n", current->name);
+            failures++;
+            continue;
+        }
+        if (!report(current->name, currentLight, &result, current->planet)) failures++;
+    }
+
+    printf("\ncontinuous, enter at %u, exit at %u:\n", DETECT_ENTER, DETECT_EXIT);
+    current = &rampScenario;
+    currentFilter = 0xFF;
+    detectReset();
+    currentLight = ramp[0];
+    detectStart(1);
+    for (i = 0; i < sizeof(ramp) / sizeof(ramp[0]); i++) {
+        if (!runUntilDecision(&result, 2000)) {
+            printf("cycle %u: no decision\n", i);
+            failures++;
+            break;
+        }
+        if (!report("  cycle", ramp[i], &result, rampExpected[i])) failures++;
+        if (i + 1 < sizeof(ramp) / sizeof(ramp[0])) currentLight = ramp[i + 1];
+    }
+    detectStop();
+    printf("overruns %u\n", result.overruns);
+
+    printf("%u unexpected decision(s)\n", failures);
+    return failures != 0;
+}
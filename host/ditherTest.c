@@ -0,0 +1,229 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: ditherTest.c
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Samples the compares once each frame is latched, as a frame can
+ *    take more than a tick at 1 MHz.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+/**************************************************************************
+ * Host build:
+ *    gcc -I. -Ihost -DPWM_USE_HARDWARE=1 host/ditherTest.c dither.c \
+ *        pwm.c timebase.c clock.c memUsage.c host/msp430sim.c -o ditherTest
+ *
+ * Runs dither.c and the hardware PWM backend on the simulator, and reads
+ * the red, green and blue compare registers (TA0CCR1, TA0CCR2, TA1CCR2)
+ * from a tick handler of its own once each frame is latched. For INTENSITIES sets of
+ * 12-bit intensities spread over the range (the three channels at
+ * different intensities at once) it runs FRAMES frames and checks that:
+ *    - the long-run average compare is within 1/4096 of the channel's
+ *      compare range of the target, so a channel rounded to 256ths on
+ *      the way to its compare fails
+ *    - each frame's compare is the whole part of the target or one more
+ *    - DITHER_MAX is fully on, with nothing to dither
+ * Then that ditherSetDuty() gives each channel within 1/4096 of its range
+ * on average, green and blue being 256ths of theirs, and that a colour
+ * with nothing to dither stops staging once it is in. Exits non-zero on
+ * any failure.
+ **************************************************************************/
+
+#include "msp430sim.h"
+#include "../dither.h"
+#include "../pwm.h"
+#include "../timebase.h"
+#include "../clock.h"
+#include <msp430fr4133.h>
+#include <intrinsics.h>
+#include <stdio.h>
+
+#if !PWM_USE_HARDWARE
+#error "ditherTest reads the hardware backend's compare registers"
+#endif
+
+#define FRAMES       4096
+#define INTENSITIES  64
+#define SETTLE       2           // Frames for a new colour to reach every compare
+#define IDLE_MS      20          // Long enough for a colour to latch and more
+#define CHANNELS     3
+
+static const unsigned int fulls[CHANNELS] = { PWM_RED_FULL, PWM_GREEN_FULL, PWM_BLUE_FULL };
+static const char *const names[CHANNELS] = { "red", "green", "blue" };
+
+static volatile unsigned int frames;
+static unsigned int lastCommit;
+static unsigned int compares[FRAMES + SETTLE][CHANNELS];
+
+/**************************************************************************
+ * Function: sampleFrame
+ * Description:
+ *    Tick handler, run after the PWM backend's: reads the compares the
+ *    LEDs are showing once each colour staged is latched on both timers.
+ **************************************************************************/
+static void sampleFrame(void) {
+    if (frames >= FRAMES + SETTLE || pwmCommitCount() == lastCommit) return;
+    lastCommit = pwmCommitCount();
+    compares[frames][0] = TA0CCR1;
+    compares[frames][1] = TA0CCR2;
+    compares[frames][2] = TA1CCR2;
+    frames++;
+}
+
+static void runFrames(void) {
+    frames = 0;
+    while (frames < FRAMES + SETTLE) simAdvance(CLOCK_CYCLES_PER_MS / 4);
+}
+
+static void runMs(unsigned int ms) {
+    while (ms--) simAdvance(CLOCK_CYCLES_PER_MS);
+}
+
+/**************************************************************************
+ * Function: average
+ * Description:
+ *    A channel's average compare over the frames after SETTLE.
+ **************************************************************************/
+static double average(unsigned char c) {
+    unsigned long sum = 0;
+    unsigned int frame;
+
+    for (frame = SETTLE; frame < FRAMES + SETTLE; frame++) sum += compares[frame][c];
+    return (double)sum / FRAMES;
+}
+
+/**************************************************************************
+ * Function: target
+ * Description:
+ *    Compare an intensity asks for, in 1/4096 of a compare.
+ **************************************************************************/
+static unsigned long target(unsigned int value, unsigned int full) {
+    return value >= DITHER_MAX ? (unsigned long)full << DITHER_BITS : (unsigned long)value * full;
+}
+
+static unsigned int checkIntensities(void) {
+    static unsigned int worstValue[CHANNELS];
+    double worstError[CHANNELS] = { 0 };
+    unsigned long badFrames[CHANNELS] = { 0 };
+    unsigned int n, frame, failures = 0;
+    unsigned char c;
+
+    for (n = 0; n < INTENSITIES; n++) {
+        unsigned int values[CHANNELS];
+
+        values[0] = n * (DITHER_MAX / (INTENSITIES - 1));      // 0 to DITHER_MAX
+        values[1] = (values[0] * 7 + 1) & DITHER_MAX;
+        values[2] = DITHER_MAX - values[0];
+        ditherSetRGB(values[0], values[1], values[2]);
+        runFrames();
+
+        for (c = 0; c < CHANNELS; c++) {
+            unsigned long want = target(values[c], fulls[c]);
+            unsigned int whole = (unsigned int)(want >> DITHER_BITS);
+            double error = average(c) - (double)want / (1 << DITHER_BITS);
+
+            for (frame = SETTLE; frame < FRAMES + SETTLE; frame++) {
+                if (compares[frame][c] != whole && compares[frame][c] != whole + 1) badFrames[c]++;
+            }
+            if (error < 0) error = -error;
+            error /= fulls[c];
+            if (error > worstError[c]) {
+                worstError[c] = error;
+                worstValue[c] = values[c];
+            }
+        }
+    }
+
+    for (c = 0; c < CHANNELS; c++) {
+        int ok = worstError[c] * (DITHER_MAX + 1) <= 1.0 && badFrames[c] == 0;
+
+        printf("  %-5s (0-%u) worst average error %.3f/4096 of range (intensity %u), "
+               "%lu frames off by more than a step%s\n",
+               names[c], fulls[c], worstError[c] * (DITHER_MAX + 1), worstValue[c], badFrames[c],
+               ok ? "" : "  <-- FAIL");
+        if (!ok) failures++;
+    }
+    return failures;
+}
+
+static unsigned int checkFull(void) {
+    unsigned int count;
+    int ok;
+
+    // Full scale is fully on, and once latched nothing more is staged
+    ditherSetRGB(DITHER_MAX, DITHER_MAX, DITHER_MAX);
+    runMs(IDLE_MS);
+    count = pwmCommitCount();
+    runMs(IDLE_MS);
+    ok = TA0CCR1 == PWM_RED_FULL && TA0CCR2 == PWM_GREEN_FULL && TA1CCR2 == PWM_BLUE_FULL &&
+         pwmCommitCount() == count;
+    printf("  DITHER_MAX latches %u %u %u, %u colours staged after%s\n", TA0CCR1, TA0CCR2, TA1CCR2,
+           pwmCommitCount() - count, ok ? "" : "  <-- FAIL");
+    return !ok;
+}
+
+static unsigned int checkDuty(void) {
+    double worst[CHANNELS] = { 0 };
+    unsigned int red, count, failures = 0;
+    unsigned char c;
+    int ok;
+
+    // setColour() units: red to 1/4096 of its range, green and blue 256ths
+    // of theirs, on average
+    for (red = 0; red <= TIMEBASE_PWM_PERIOD; red += 5) {
+        unsigned int duties[CHANNELS];
+
+        duties[0] = red;
+        duties[1] = red * 2 + 1;
+        duties[2] = 255 - red;
+        ditherSetDuty(duties[0], duties[1], duties[2]);
+        runFrames();
+        for (c = 0; c < CHANNELS; c++) {
+            double want = c == 0 ? (red < TIMEBASE_PWM_PERIOD ? red : PWM_RED_FULL)
+                                 : (double)duties[c] * fulls[c] / 256;
+            double error = average(c) - want;
+
+            if (error < 0) error = -error;
+            if (error / fulls[c] > worst[c]) worst[c] = error / fulls[c];
+        }
+    }
+    for (c = 0; c < CHANNELS; c++) {
+        ok = worst[c] * (DITHER_MAX + 1) <= 1.0;
+        printf("  ditherSetDuty(): %-5s worst %.3f/4096 of range%s\n", names[c], worst[c] * (DITHER_MAX + 1),
+               ok ? "" : "  <-- FAIL");
+        if (!ok) failures++;
+    }
+
+    // Whole compares on every channel: staged once, then left alone
+    ditherSetDuty(0, 0, 256);
+    runMs(IDLE_MS);
+    count = pwmCommitCount();
+    runMs(IDLE_MS);
+    ok = pwmCommitCount() == count;
+    printf("  whole colour: %u colours staged after it is in%s\n", pwmCommitCount() - count, ok ? "" : "  <-- FAIL");
+    if (!ok) failures++;
+    return failures;
+}
+
+int main(void) {
+    unsigned int failures = 0;
+
+    simReset();
+    WDTCTL = WDTPW | WDTHOLD;
+    PM5CTL0 &= ~LOCKLPM5;
+    clockInit();
+    timebaseInit();
+    setupGPIO();
+    setupPWM();
+    setupTimerForSWPWM();
+    timebaseSubscribe(sampleFrame, TIMEBASE_TICK_HZ);
+    __bis_SR_register(GIE);
+
+    printf("%u intensity sets, %u frames each\n", INTENSITIES, FRAMES);
+    failures += checkIntensities();
+    failures += checkFull();
+    failures += checkDuty();
+    printf("%u failure(s)\n", failures);
+    return failures != 0;
+}
@@ -0,0 +1,156 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: hd44780.c
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Initial creation of the HD44780 bus model.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#include "hd44780.h"
+#include "msp430sim.h"
+#include "../telemetry.h"
+#include <msp430fr4133.h>
+#include <string.h>
+
+// LCD pins, as wired in lcd.c
+#if TELEMETRY_ENABLED
+#define RS_HIGH   (sim_P8OUT & BIT1)
+#else
+#define RS_HIGH   (sim_P1OUT & BIT0)
+#endif
+#define E_HIGH    (sim_P1OUT & BIT1)
+
+Hd44780 hd44780;
+
+static unsigned char eWasHigh;
+static unsigned char latched;               // Nibble and RS while E is high
+static unsigned char latchedRs;
+static unsigned char highNibble;
+static unsigned char haveHigh;
+
+/**************************************************************************
+ * Function: hd44780Command
+ **************************************************************************/
+static void hd44780Command(unsigned char command) {
+    hd44780.commands++;
+    if (command & 0x80) {
+        hd44780.address = command & 0x7F;
+        hd44780.inCgram = 0;
+    } else if (command & 0x40) {
+        hd44780.address = command & 0x3F;
+        hd44780.inCgram = 1;
+    } else if (command & 0x20) {
+        if (!(command & 0x10)) hd44780.fourBit = 1;
+    } else if (command & 0x10) {
+        if (command & 0x08) {
+            hd44780.shifts++;
+            hd44780.shift = (unsigned char)((hd44780.shift + (command & 0x04 ? HD44780_DDRAM_LINE - 1 : 1))
+                                            % HD44780_DDRAM_LINE);
+        }
+    } else if (command & 0x0C) {
+        // Display control and entry mode: lcd.c only sets display on, increment
+    } else if (command & 0x02) {
+        hd44780.address = 0;                // Home
+        hd44780.inCgram = 0;
+        hd44780.shift = 0;
+    } else if (command & 0x01) {
+        memset(hd44780.ddram, ' ', sizeof(hd44780.ddram));  // Clear
+        hd44780.address = 0;
+        hd44780.inCgram = 0;
+        hd44780.shift = 0;
+    }
+}
+
+/**************************************************************************
+ * Function: hd44780Data
+ **************************************************************************/
+static void hd44780Data(unsigned char byte) {
+    unsigned char *cell;
+
+    hd44780.data++;
+    if (hd44780.inCgram) {
+        cell = &hd44780.cgram[hd44780.address];
+        hd44780.address = (hd44780.address + 1) & 0x3F;
+    } else {
+        cell = &hd44780.ddram[hd44780.address];
+        hd44780.address++;
+        if (hd44780.address == 0x28) hd44780.address = 0x40;
+        else if (hd44780.address == 0x68) hd44780.address = 0x00;
+    }
+    if (*cell == byte) hd44780.unchanged++;
+    *cell = byte;
+}
+
+/**************************************************************************
+ * Function: hd44780Watch
+ * Description:
+ *    Pin watch: the controller reads the bus on the falling edge of E.
+ **************************************************************************/
+static void hd44780Watch(void) {
+    unsigned char byte;
+
+    if (E_HIGH) {
+        eWasHigh = 1;
+        latched = (unsigned char)(((sim_P2OUT & BIT7) ? 0x01 : 0) | ((sim_P8OUT & BIT0) ? 0x02 : 0) |
+                                  ((sim_P5OUT & BIT1) ? 0x04 : 0) | ((sim_P2OUT & BIT5) ? 0x08 : 0));
+        latchedRs = RS_HIGH ? 1 : 0;
+        return;
+    }
+    if (!eWasHigh) return;
+    eWasHigh = 0;
+
+    if (!hd44780.fourBit) {
+        // 8-bit interface: only D7-D4 are wired, the low nibble reads 0
+        if (!latchedRs) hd44780Command((unsigned char)(latched << 4));
+        haveHigh = 0;
+        return;
+    }
+    if (!haveHigh) {
+        highNibble = latched;
+        haveHigh = 1;
+        return;
+    }
+    haveHigh = 0;
+    byte = (unsigned char)((highNibble << 4) | latched);
+    if (latchedRs) hd44780Data(byte);
+    else hd44780Command(byte);
+}
+
+/**************************************************************************
+ * Function: hd44780Attach
+ **************************************************************************/
+void hd44780Attach(void) {
+    memset(&hd44780, 0, sizeof(hd44780));
+    memset(hd44780.ddram, ' ', sizeof(hd44780.ddram));
+    memset(hd44780.cgram, 0xFF, sizeof(hd44780.cgram));     // Undefined at power-on: no glyph row matches
+    eWasHigh = 0;
+    haveHigh = 0;
+    simSetPinWatch(hd44780Watch);
+}
+
+/**************************************************************************
+ * Function: hd44780Writes
+ **************************************************************************/
+unsigned long hd44780Writes(void) {
+    hd44780Watch();                         // Take in a pulse that just ended
+    return hd44780.commands + hd44780.data;
+}
+
+/**************************************************************************
+ * Function: hd44780Visible
+ **************************************************************************/
+unsigned char hd44780Visible(unsigned char row, unsigned char col) {
+    return hd44780.ddram[(row ? 0x40 : 0) + (col + hd44780.shift) % HD44780_DDRAM_LINE];
+}
+
+/**************************************************************************
+ * Function: hd44780Line
+ **************************************************************************/
+void hd44780Line(unsigned char row, char *text) {
+    unsigned char col;
+
+    for (col = 0; col < HD44780_VISIBLE; col++) text[col] = (char)hd44780Visible(row, col);
+    text[HD44780_VISIBLE] = '\0';
+}
@@ -0,0 +1,86 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: hd44780.h
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Initial creation of the HD44780 bus model.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#ifndef HD44780_H_
+#define HD44780_H_
+
+/**************************************************************************
+ * Model of the 16x2 HD44780 on the simulator, for host checks of what
+ * lcd.c actually puts on the bus. hd44780Attach() watches the LCD pins
+ * (as wired in lcd.c) and decodes every E pulse: the 8-bit resync at
+ * power-up, then nibble pairs. It keeps DDRAM, CGRAM, the address counter
+ * and the display shift, and counts the bytes written.
+ **************************************************************************/
+#define HD44780_DDRAM_LINE  40
+#define HD44780_VISIBLE     16
+
+/**************************************************************************
+ * Structure: Hd44780
+ * Description:
+ *    Controller state and bus counters.
+ * Members:
+ *    ddram - Display data, line 0 at 0x00, line 1 at 0x40
+ *    cgram - User glyphs, 8 rows each
+ *    address - Address counter
+ *    inCgram - The address counter is in CGRAM
+ *    shift - Display shift to the left, 0 to 39
+ *    fourBit - Set once the interface is switched to 4 bits
+ *    commands, data - Bytes written of each kind
+ *    shifts - Display shift commands
+ *    unchanged - Data writes that did not change the byte they wrote
+ **************************************************************************/
+typedef struct {
+    unsigned char ddram[0x80];
+    unsigned char cgram[64];
+    unsigned char address;
+    unsigned char inCgram;
+    unsigned char shift;
+    unsigned char fourBit;
+    unsigned long commands;
+    unsigned long data;
+    unsigned long shifts;
+    unsigned long unchanged;
+} Hd44780;
+
+extern Hd44780 hd44780;
+
+/**************************************************************************
+ * Function: hd44780Attach
+ * Description:
+ *    Resets the model to power-on and starts watching the pins. Call after
+ *    simReset() and before lcdInit().
+ **************************************************************************/
+void hd44780Attach(void);
+
+/**************************************************************************
+ * Function: hd44780Writes
+ * Description:
+ *    Returns the bytes written so far, commands and data.
+ **************************************************************************/
+unsigned long hd44780Writes(void);
+
+/**************************************************************************
+ * Function: hd44780Visible
+ * Description:
+ *    Character code shown at a position, after the display shift.
+ * Parameters:
+ *    row - Line, 0 or 1
+ *    col - Column, 0 to 15
+ **************************************************************************/
+unsigned char hd44780Visible(unsigned char row, unsigned char col);
+
+/**************************************************************************
+ * Function: hd44780Line
+ * Description:
+ *    Copies the 16 characters shown on a line, terminated.
+ **************************************************************************/
+void hd44780Line(unsigned char row, char *text);
+
+#endif /* HD44780_H_ */
@@ -0,0 +1,31 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: intrinsics.h (host)
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Added __get_SP_register(), the simulator's stand-in stack pointer.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#ifndef INTRINSICS_HOST_H_
+#define INTRINSICS_HOST_H_
+
+void __delay_cycles(unsigned long cycles);
+void __bis_SR_register(unsigned short bits);
+void __bic_SR_register(unsigned short bits);
+void __bic_SR_register_on_exit(unsigned short bits);
+unsigned short __get_SR_register(void);
+unsigned short __get_SP_register(void);
+unsigned short __get_interrupt_state(void);
+void __set_interrupt_state(unsigned short state);
+void __enable_interrupt(void);
+void __disable_interrupt(void);
+void __no_operation(void);
+
+#define _bis_SR_register(bits)   __bis_SR_register(bits)
+#define _bic_SR_register(bits)   __bic_SR_register(bits)
+#define __even_in_range(value, bound) (value)
+#define _NOP()                   __no_operation()
+
+#endif /* INTRINSICS_HOST_H_ */
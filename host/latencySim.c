@@ -0,0 +1,321 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: latencySim.c
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Measures the PWM latch (Period_ISR) too, restaging the colour every
+ *    frame, and builds with either PWM backend.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+/**************************************************************************
+ * Host build:
+ *    gcc -I. -Ihost -DLATENCY_ENABLED=1 -DPWM_USE_HARDWARE=0 \
+ *        host/latencySim.c latency.c pwm.c \
+ *        adcSequence.c colourSensor.c colourCal.c lcd.c timebase.c clock.c \
+ *        telemetry.c memUsage.c host/msp430sim.c -o latencySim
+ *    (and again with -DPWM_USE_HARDWARE=1, where there is no Timer_A_ISR
+ *    and the latch runs every tick)
+ *
+ * Runs the software PWM (Timer_A_ISR), the PWM latch (Period_ISR), the
+ * system tick (Timebase_ISR), the ADC sequence (ADC_ISR) and a colour
+ * sensor pulse train on P1.3 (Port_1) together on the simulator, with a
+ * frame hook restaging the colour every frame as dithering does, and
+ * latency.h measuring each ISR,
+ * while the main loop masks interrupts for a stretch once a millisecond
+ * the way a blocking LCD or UART write would. Three masks are run:
+ *    none   - the ISRs only hold each other up
+ *    short  - shorter than a PWM period and a pulse period
+ *    long   - over a PWM period and several pulse periods, so periods and
+ *             edges are lost
+ * Both are capped at half a millisecond, which at 1 MHz leaves them the
+ * same and short of a PWM period.
+ * Each is swept over the phase of the pulse train and of the mask
+ * against the timers, the simulator being deterministic, and the worst
+ * phase for each ISR is reported and run again to check it reproduces
+ * exactly, with the histograms of the worst run printed.
+ *
+ * Every run is checked against the simulator's own figures: the entries
+ * counted match the ISRs dispatched, the missed PWM periods, lost edges
+ * and lost ADC results match the events the simulator saw arrive on a
+ * still-pending flag, a latch the simulator saw held up a whole period
+ * is counted late, and the timer latencies are within
+ * LATENCY_TOLERANCE cycles of the simulator's (one count for reading the
+ * counter, one for the count being whole). Exits non-zero on any failure.
+ **************************************************************************/
+
+#include "msp430sim.h"
+#include "../latency.h"
+#include "../pwm.h"
+#include "../adcSequence.h"
+#include "../colourSensor.h"
+#include "../timebase.h"
+#include "../clock.h"
+#include <msp430fr4133.h>
+#include <intrinsics.h>
+#include <stdio.h>
+#include <string.h>
+
+#define RUN_MS             50
+#define PWM_PERIOD_CYCLES  ((TIMEBASE_PWM_PERIOD + 1) * LATENCY_CYCLES_PER_COUNT)
+#define PULSE_PERIOD       1200     // Cycles, a 13.3 kHz colour sensor output
+#define PHASES             8        // Per swept phase
+#define LATENCY_TOLERANCE  ((long)(2 * LATENCY_CYCLES_PER_COUNT))
+#define PORT1_LOST_SLACK   0.05
+
+typedef struct {
+    const char *name;
+    unsigned long maskCycles;
+} Scenario;
+
+// No more than half the millisecond, for the slower clocks
+#define MASK_CYCLES(cycles) ((cycles) < CLOCK_CYCLES_PER_MS / 2 ? (cycles) : CLOCK_CYCLES_PER_MS / 2)
+
+static const Scenario scenarios[] = {
+    { "none", 0 },
+    { "short", MASK_CYCLES(800) },
+    { "long", MASK_CYCLES(4000) },
+};
+
+typedef struct {
+    const char *name;
+    unsigned char vector;
+    unsigned long timer;        // Timer period in cycles if latency is measured
+} Source;
+
+static const Source sources[LATENCY_SOURCES] = {
+    { "Timer_A_ISR", SIM_VECTOR_TIMER0_A1, PWM_PERIOD_CYCLES },
+    { "Timebase_ISR", SIM_VECTOR_TIMER1_A0, TIMEBASE_TICK_PERIOD * LATENCY_CYCLES_PER_COUNT },
+    { "ADC_ISR", SIM_VECTOR_ADC, 0 },
+    { "Port_1", SIM_VECTOR_PORT1, 0 },
+    { "Period_ISR", SIM_VECTOR_TIMER0_A0, PWM_PERIOD_CYCLES },
+};
+
+// One run's figures, measured and simulated
+typedef struct {
+    LatencyStats stats[LATENCY_SOURCES];
+    unsigned long entries[LATENCY_SOURCES];
+    unsigned long simLatency[LATENCY_SOURCES];
+    unsigned long simLost[LATENCY_SOURCES];
+} Run;
+
+/**************************************************************************
+ * Function: restage
+ * Description:
+ *    Frame hook: stages a slightly different colour every frame, so the
+ *    latch runs every frame as it does when dithering.
+ **************************************************************************/
+static void restage(void) {
+    static unsigned char flip;
+
+    flip ^= 1;
+    setRGBDutyCycle(30 + flip, 60, 90);
+}
+
+/**************************************************************************
+ * Function: run
+ * Description:
+ *    Starts the firmware from reset and runs RUN_MS milliseconds with the
+ *    pulse train and the mask at the given phases, in cycles.
+ **************************************************************************/
+static void run(unsigned long maskCycles, unsigned long pulsePhase, unsigned long maskPhase, Run *result) {
+    unsigned long lostBefore[LATENCY_SOURCES];
+    unsigned char i;
+    unsigned int ms;
+
+    simReset();
+    WDTCTL = WDTPW | WDTHOLD;
+    PM5CTL0 &= ~LOCKLPM5;
+    clockInit();
+    timebaseInit();
+    latencyInit();
+    setupGPIO();
+    setupPWM();
+    setupTimerForSWPWM();
+    setRGBDutyCycle(30, 60, 90);
+    pwmSetFrameHook(restage);
+    adcSeqInit();
+    adcSeqStart();
+    initialiseColourSensor();       // Sets GIE; colour_det_flag stays 0, so no timeout
+
+    // Periods that went by before Timer_A_ISR first ran were never going
+    // to be seen
+    simAdvance(PWM_PERIOD_CYCLES);
+    for (i = 0; i < LATENCY_SOURCES; i++) lostBefore[i] = simLostEvents(sources[i].vector);
+    simAdvance(pulsePhase);
+    simSetPulseInput(1, BIT3, PULSE_PERIOD);
+
+    for (ms = 0; ms < RUN_MS; ms++) {
+        simAdvance(maskPhase);
+        if (maskCycles) {
+            __disable_interrupt();
+            __delay_cycles(maskCycles);
+            __enable_interrupt();
+        }
+        simAdvance(CLOCK_CYCLES_PER_MS - maskPhase - maskCycles);
+    }
+
+    for (i = 0; i < LATENCY_SOURCES; i++) {
+        latencyGet(i, &result->stats[i]);
+        result->entries[i] = simInterruptCount(sources[i].vector);
+        result->simLatency[i] = simMaxLatency(sources[i].vector);
+        result->simLost[i] = simLostEvents(sources[i].vector) - lostBefore[i];
+    }
+}
+
+/**************************************************************************
+ * Function: missedAgrees
+ * Description:
+ *    PWM periods must match exactly. Port_1 edges are inferred from the
+ *    intervals, so are allowed PORT1_LOST_SLACK of the count; ADCOVIFG
+ *    only says that one or more results were overwritten. A latch counts
+ *    as late from one count after CCR0, well short of the whole period
+ *    the simulator needs to see an event lost.
+ **************************************************************************/
+static int missedAgrees(unsigned char i, unsigned int missed, unsigned long lost) {
+    long difference = (long)missed - (long)lost;
+
+    switch (i) {
+        case LATENCY_PORT1_ISR:
+            return difference <= (long)(lost * PORT1_LOST_SLACK) + 1 && -difference <= (long)(lost * PORT1_LOST_SLACK) + 1;
+        case LATENCY_ADC_ISR:
+            return (missed != 0) == (lost != 0) && missed <= lost;
+        case LATENCY_TICK_ISR:
+            return 1;                   // Checked as ticks lost below
+        case LATENCY_LATCH_ISR:
+            return lost == 0 || missed != 0;
+        default:
+            return difference == 0;
+    }
+}
+
+/**************************************************************************
+ * Function: checkRun
+ * Description:
+ *    Returns 1 when the measured figures agree with the simulator's,
+ *    printing each disagreement.
+ **************************************************************************/
+static int checkRun(const Run *r, const char *label) {
+    unsigned char i;
+    int ok = 1;
+
+    for (i = 0; i < LATENCY_SOURCES; i++) {
+        const LatencyStats *s = &r->stats[i];
+        long difference = (long)s->maxLatencyCycles - (long)r->simLatency[i];
+
+        if (s->count != (r->entries[i] > 0xFFFF ? 0xFFFF : r->entries[i])) {
+            printf("  %s %s: %u entries measured, %lu dispatched\n", label, sources[i].name, s->count, r->entries[i]);
+            ok = 0;
+        }
+        if (!missedAgrees(i, s->missed, r->simLost[i])) {
+            printf("  %s %s: %u missed measured, %lu lost\n", label, sources[i].name, s->missed, r->simLost[i]);
+            ok = 0;
+        }
+        // A timer ISR about a period late or more reads the counter round
+        // again: it shows as missed periods, not latency
+        if (sources[i].timer && r->simLost[i] == 0 && r->simLatency[i] + LATENCY_TOLERANCE < sources[i].timer &&
+            (difference > LATENCY_TOLERANCE || difference < -LATENCY_TOLERANCE)) {
+            printf("  %s %s: %lu cycles latency measured, %lu simulated\n",
+                   label, sources[i].name, s->maxLatencyCycles, r->simLatency[i]);
+            ok = 0;
+        }
+    }
+    if (r->simLost[LATENCY_TICK_ISR]) {
+        printf("  %s: %lu ticks lost, the timeline is wrong\n", label, r->simLost[LATENCY_TICK_ISR]);
+        ok = 0;
+    }
+    return ok;
+}
+
+/**************************************************************************
+ * Function: worstFigure
+ * Description:
+ *    What the sweep maximises per source: latency for timers, jitter for
+ *    streams, with missed events ahead of either.
+ **************************************************************************/
+static unsigned long worstFigure(const Run *r, unsigned char i) {
+    const LatencyStats *s = &r->stats[i];
+
+    return (unsigned long)s->missed * 100000UL + (sources[i].timer ? s->maxLatencyCycles : s->maxJitterCycles);
+}
+
+/**************************************************************************
+ * Function: printHistogram
+ **************************************************************************/
+static void printHistogram(const char *name, const unsigned int *histogram) {
+    unsigned char n;
+
+    printf("      %-8s", name);
+    for (n = 0; n < LATENCY_BUCKETS; n++) {
+        if (histogram[n]) {
+            printf(" %lu+:%u", n ? (1UL << n) * LATENCY_CYCLES_PER_COUNT : 0UL, histogram[n]);
+        }
+    }
+    printf("\n");
+}
+
+int main(void) {
+    static Run r, worst[LATENCY_SOURCES], again;
+    unsigned long worstPhase[LATENCY_SOURCES][2];
+    unsigned int s, p, m, failures = 0;
+    unsigned char i;
+    char label[48];
+
+    printf("PWM period %lu cycles, tick %lu, pulses %u, %u ms runs, %u x %u phases\n",
+           PWM_PERIOD_CYCLES, TIMEBASE_TICK_PERIOD * LATENCY_CYCLES_PER_COUNT,
+           PULSE_PERIOD, RUN_MS, PHASES, PHASES);
+
+    for (s = 0; s < sizeof(scenarios) / sizeof(scenarios[0]); s++) {
+        unsigned long maskCycles = scenarios[s].maskCycles;
+        unsigned int runFailures = 0;
+
+        memset(worst, 0, sizeof(worst));
+        memset(worstPhase, 0, sizeof(worstPhase));
+        for (p = 0; p < PHASES; p++) {
+            for (m = 0; m < PHASES; m++) {
+                unsigned long pulsePhase = (unsigned long)p * PULSE_PERIOD / PHASES;
+                unsigned long maskPhase = (unsigned long)m * (CLOCK_CYCLES_PER_MS - maskCycles) / PHASES;
+
+                run(maskCycles, pulsePhase, maskPhase, &r);
+                sprintf(label, "%s mask, phases %lu/%lu", scenarios[s].name, pulsePhase, maskPhase);
+                if (!checkRun(&r, label)) runFailures++;
+                for (i = 0; i < LATENCY_SOURCES; i++) {
+                    if ((p == 0 && m == 0) || worstFigure(&r, i) > worstFigure(&worst[i], i)) {
+                        worst[i] = r;
+                        worstPhase[i][0] = pulsePhase;
+                        worstPhase[i][1] = maskPhase;
+                    }
+                }
+            }
+        }
+
+        printf("\n%s mask (%lu cycles once a millisecond): %u of %u runs disagree\n",
+               scenarios[s].name, maskCycles, runFailures, PHASES * PHASES);
+        printf("  %-13s %7s %17s %8s %8s %11s %9s %s\n", "worst for", "entries", "max lat meas/sim",
+               "mean", "jitter", "missed/lost", "phases", "repeat");
+        for (i = 0; i < LATENCY_SOURCES; i++) {
+            const LatencyStats *w = &worst[i].stats[i];
+            int same;
+
+            run(maskCycles, worstPhase[i][0], worstPhase[i][1], &again);
+            same = memcmp(&again, &worst[i], sizeof(again)) == 0;
+            if (!same) runFailures++;
+            if (sources[i].timer) {
+                printf("  %-13s %7u %8lu/%-8lu %8lu %8lu %5u/%-5lu %4lu/%-5lu %s\n", sources[i].name, w->count,
+                       w->maxLatencyCycles, worst[i].simLatency[i], w->meanLatencyCycles, w->maxJitterCycles,
+                       w->missed, worst[i].simLost[i], worstPhase[i][0], worstPhase[i][1], same ? "same" : "DIFFERS");
+            } else {
+                printf("  %-13s %7u %8s/%-8lu %8s %8lu %5u/%-5lu %4lu/%-5lu %s\n", sources[i].name, w->count,
+                       "-", worst[i].simLatency[i], "-", w->maxJitterCycles,
+                       w->missed, worst[i].simLost[i], worstPhase[i][0], worstPhase[i][1], same ? "same" : "DIFFERS");
+            }
+            if (sources[i].timer) printHistogram("latency", w->latency);
+            printHistogram("jitter", w->jitter);
+        }
+        failures += runFailures;
+    }
+
+    printf("\n%u failure(s)\n", failures);
+    return failures != 0;
+}
@@ -0,0 +1,242 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: lcdGraphTest.c
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Initial creation of the bar graph and sparkline write check.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+/**************************************************************************
+ * Host build:
+ *    gcc -I. -Ihost host/lcdGraphTest.c host/hd44780.c lcdGraph.c lcd.c \
+ *        timebase.c clock.c memUsage.c host/msp430sim.c -o lcdGraphTest
+ *
+ * Runs lcdGraph.c and lcd.c on the simulator with the HD44780 model on
+ * the LCD pins. Steps a bar graph up and down a fifth of a cell at a time
+ * and through random values, and scrolls samples through the sparkline.
+ * After every draw but the first, checks that:
+ *    - the write count returned matches the bytes on the bus
+ *    - those writes are the fewest that make the change: one address set
+ *      per run of changed CGRAM rows (within a glyph) or DDRAM cells, and
+ *      one write per changed byte, with no byte written to its own value
+ *    - drawing again with nothing changed writes nothing
+ *    - the screen shows the bar's value and the sparkline's samples
+ * Exits non-zero on any failure.
+ **************************************************************************/
+
+#include "msp430sim.h"
+#include "hd44780.h"
+#include "../lcdGraph.h"
+#include "../lcd.h"
+#include "../timebase.h"
+#include "../clock.h"
+#include <msp430fr4133.h>
+#include <stdio.h>
+#include <string.h>
+
+#define BAR_ROW      1
+#define BAR_WIDTH    16
+#define BAR_MAX      (BAR_WIDTH * 5)
+#define RANDOM_BARS  60
+#define SPARK_ROW    0
+#define SPARK_PUSHES 120
+#define SPARK_LOW    100
+#define SPARK_HIGH   800
+
+// One group's samples: every group holds the lowest and highest, so the
+// scale is fixed once the first group is in
+static const unsigned int sparkPattern[5] = { SPARK_LOW, 450, SPARK_HIGH, 300, 620 };
+
+static Hd44780 before;
+static unsigned long busBefore;
+
+/**************************************************************************
+ * Function: runs
+ * Description:
+ *    Writes the fewest bytes that change `from` into `to` take: one
+ *    address set per run of changed bytes plus the bytes.
+ **************************************************************************/
+static unsigned int runs(const unsigned char *from, const unsigned char *to, unsigned int length) {
+    unsigned int i, writes = 0;
+    unsigned char inRun = 0;
+
+    for (i = 0; i < length; i++) {
+        if (from[i] == to[i]) {
+            inRun = 0;
+            continue;
+        }
+        if (!inRun) writes++;
+        inRun = 1;
+        writes++;
+    }
+    return writes;
+}
+
+static unsigned int fewestWrites(void) {
+    unsigned int writes = 0;
+    unsigned char glyph;
+
+    for (glyph = 0; glyph < 8; glyph++) writes += runs(&before.cgram[glyph * 8], &hd44780.cgram[glyph * 8], 8);
+    writes += runs(&before.ddram[0x00], &hd44780.ddram[0x00], HD44780_DDRAM_LINE);
+    writes += runs(&before.ddram[0x40], &hd44780.ddram[0x40], HD44780_DDRAM_LINE);
+    return writes;
+}
+
+static void mark(void) {
+    busBefore = hd44780Writes();
+    before = hd44780;
+}
+
+/**************************************************************************
+ * Function: checkDraw
+ * Description:
+ *    Checks a draw's returned count against the bus and the fewest
+ *    writes, and counts the failure once per kind.
+ **************************************************************************/
+static int checkDraw(unsigned int returned, int first) {
+    unsigned long bus = hd44780Writes() - busBefore;
+
+    if (returned != bus) return 0;
+    if (first) return 1;
+    return bus == fewestWrites() && hd44780.unchanged == before.unchanged;
+}
+
+/**************************************************************************
+ * Function: barShown
+ * Description:
+ *    Reads the bar's level, in fifths of a cell, off the model's screen.
+ **************************************************************************/
+static unsigned int barShown(void) {
+    unsigned int level = 0;
+    unsigned char col, code, bits;
+
+    for (col = 0; col < BAR_WIDTH; col++) {
+        code = hd44780Visible(BAR_ROW, col);
+        if (code == 0xFF) {
+            level += 5;
+        } else if (code < 8) {
+            for (bits = hd44780.cgram[code * 8]; bits; bits &= bits - 1) level++;
+        }
+    }
+    return level;
+}
+
+static unsigned int checkBar(void) {
+    unsigned int failures = 0, step = 0, bad = 0, shown = 0, idle = 0, seed = 4321;
+    unsigned int values[2 * BAR_MAX + 1 + RANDOM_BARS];
+    unsigned int n, writes, most = 0;
+
+    for (n = 0; n <= BAR_MAX; n++) values[step++] = n;                  // Up a fifth at a time
+    for (n = BAR_MAX; n-- > 0;) values[step++] = n;                     // And down
+    for (n = 0; n < RANDOM_BARS; n++) {
+        seed = seed * 25173 + 13849;
+        values[step++] = seed % (BAR_MAX + 1);
+    }
+
+    lcdGraphInit();
+    for (n = 0; n < step; n++) {
+        mark();
+        writes = lcdBarDraw(BAR_ROW, 0, BAR_WIDTH, values[n], BAR_MAX);
+        if (!checkDraw(writes, n == 0)) {
+            if (bad++ == 0) printf("  bar %u: %u writes returned, %lu on the bus, fewest %u\n", values[n], writes,
+                                   hd44780Writes() - busBefore, fewestWrites());
+        }
+        if (n > 0 && writes > most) most = writes;
+        if (barShown() != values[n]) {
+            if (shown++ == 0) printf("  bar %u: shows %u\n", values[n], barShown());
+        }
+        mark();
+        if (lcdBarDraw(BAR_ROW, 0, BAR_WIDTH, values[n], BAR_MAX) != 0 || hd44780Writes() != busBefore) idle++;
+    }
+    printf("  bar: %u draws, at most %u writes a step, %u not the fewest, %u shown wrong, %u redraws wrote%s\n",
+           step, most, bad, shown, idle, bad || shown || idle ? "  <-- FAIL" : "");
+    if (bad || shown || idle) failures++;
+    return failures;
+}
+
+/**************************************************************************
+ * Function: sparkHeight
+ * Description:
+ *    Height of a sparkline column on the model's screen, 0 (one pixel) to
+ *    7, or LCDGRAPH_SPARK_EMPTY.
+ **************************************************************************/
+static unsigned char sparkHeight(unsigned char column) {
+    unsigned char code = hd44780Visible(SPARK_ROW, column / 5);
+    unsigned char row, height = LCDGRAPH_SPARK_EMPTY;
+
+    if (code >= 8) return LCDGRAPH_SPARK_EMPTY;
+    for (row = 0; row < 8; row++) {
+        if (hd44780.cgram[code * 8 + row] & (0x10 >> (column % 5))) {
+            height = 7 - row;
+            break;
+        }
+    }
+    return height;
+}
+
+static unsigned int checkSpark(void) {
+    unsigned int failures = 0, bad = 0, shown = 0, idle = 0, writes, most = 0, total = 0;
+    unsigned long pushed, sample;
+    long n, first;
+    unsigned char column;
+
+    lcdGraphInit();
+    for (pushed = 1; pushed <= SPARK_PUSHES; pushed++) {
+        lcdSparkPush(sparkPattern[(pushed - 1) % 5]);
+        mark();
+        writes = lcdSparkDraw(SPARK_ROW, 0);
+        if (!checkDraw(writes, pushed == 1)) {
+            if (bad++ == 0) printf("  sparkline sample %lu: %u writes returned, %lu on the bus, fewest %u\n",
+                                   pushed, writes, hd44780Writes() - busBefore, fewestWrites());
+        }
+        if (pushed > 1) {
+            if (writes > most) most = writes;
+            total += writes;
+        }
+
+        // Every sample shown in its column once the scale is fixed: the
+        // newest group is in the right hand cell
+        if (pushed >= 5) {
+            first = ((long)(pushed - 1) / 5 - (LCDGRAPH_SPARK_CELLS - 1)) * 5;
+            for (column = 0; column < LCDGRAPH_SPARK_SAMPLES; column++) {
+                unsigned char want = LCDGRAPH_SPARK_EMPTY;
+                n = first + column;
+                if (n >= 0 && n < (long)pushed) {
+                    sample = sparkPattern[n % 5];
+                    want = (unsigned char)((sample - SPARK_LOW) * 7 / (SPARK_HIGH - SPARK_LOW));
+                }
+                if (sparkHeight(column) != want) {
+                    if (shown++ == 0) printf("  sparkline sample %lu: column %u shows %u, not %u\n", pushed, column,
+                                             sparkHeight(column), want);
+                    break;
+                }
+            }
+        }
+        mark();
+        if (lcdSparkDraw(SPARK_ROW, 0) != 0 || hd44780Writes() != busBefore) idle++;
+    }
+    printf("  sparkline: %u samples, %.1f writes a sample, at most %u, %u not the fewest, %u shown wrong, "
+           "%u redraws wrote%s\n", SPARK_PUSHES, (double)total / (SPARK_PUSHES - 1), most, bad, shown, idle,
+           bad || shown || idle ? "  <-- FAIL" : "");
+    if (bad || shown || idle) failures++;
+    return failures;
+}
+
+int main(void) {
+    unsigned int failures = 0;
+
+    simReset();
+    WDTCTL = WDTPW | WDTHOLD;
+    PM5CTL0 &= ~LOCKLPM5;
+    clockInit();
+    timebaseInit();
+    hd44780Attach();
+    lcdInit();
+    printf("%u cell bar, %u cell sparkline\n", BAR_WIDTH, LCDGRAPH_SPARK_CELLS);
+    failures += checkBar();
+    failures += checkSpark();
+    printf("%u failure(s)\n", failures);
+    return failures != 0;
+}
@@ -0,0 +1,197 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: lcdMarqueeTest.c
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Initial creation of the marquee display-shift check.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+/**************************************************************************
+ * Host build:
+ *    gcc -I. -Ihost host/lcdMarqueeTest.c host/hd44780.c lcd.c timebase.c \
+ *        clock.c memUsage.c host/msp430sim.c -o lcdMarqueeTest
+ *
+ * Runs lcdMarquee(), and lcdQueueMarquee() as the script MARQUEE does, on
+ * the simulator with the HD44780 model on the LCD pins, for twice round
+ * the DDRAM line, with a long line over a short one, an empty one and
+ * another long one, a line too long for DDRAM and two short lines.
+ * Checks that:
+ *    - when both lines fit their DDRAM lines (with the gap), every step is
+ *      one display-shift command and nothing else, and the shift goes all
+ *      the way round
+ *    - otherwise the display is never shifted, and a short line is left
+ *      where it is while the long one is redrawn
+ *    - between steps, each line shows 16 characters of its text and gap,
+ *      repeating; in hardware mode the two lines at the same shift
+ *    - lcdQueueLine() stops a queued marquee and undoes the shift
+ * Exits non-zero on any failure.
+ **************************************************************************/
+
+#include "msp430sim.h"
+#include "hd44780.h"
+#include "../lcd.h"
+#include "../timebase.h"
+#include "../clock.h"
+#include <msp430fr4133.h>
+#include <intrinsics.h>
+#include <stdio.h>
+#include <string.h>
+
+#define STEP_CYCLES  (CLOCK_MCLK_HZ / LCD_MARQUEE_HZ)
+#define RUN_STEPS    (2 * (HD44780_DDRAM_LINE + LCD_MARQUEE_HOLD) + 8)
+#define IDLE_MS      5           // Bus quiet this long: a step or load is out
+
+typedef struct {
+    const char *line[2];
+    unsigned char hardware;     // Expect the display shift
+} MarqueeCase;
+
+static const MarqueeCase cases[] = {
+    { { "Spectrum 1: Hydrogen Alpha", "Gas: Hydrogen" }, 1 },
+    { { "Spectrum 1: Hydrogen Alpha", "" }, 1 },
+    { { "", "Scrolling on the second line" }, 1 },
+    { { "Spectrum 2: Helium lines", "Gas: Helium, both lines long" }, 1 },
+    { { "A title far too long to fit in one forty character DDRAM line", "Gas: Neon" }, 0 },
+    { { "Spectrum 3", "Gas: Neon" }, 0 },
+};
+
+static unsigned int failures = 0;
+
+static void check(int ok, const char *what) {
+    printf("  %-66s %s\n", what, ok ? "ok" : "<-- FAIL");
+    if (!ok) failures++;
+}
+
+/**************************************************************************
+ * Function: patternChar
+ * Description:
+ *    Character at a position of text followed by blanks to `period`,
+ *    repeating.
+ **************************************************************************/
+static char patternChar(const char *text, unsigned int period, unsigned int position) {
+    position %= period;
+    return position < strlen(text) ? text[position] : ' ';
+}
+
+/**************************************************************************
+ * Function: settle
+ * Description:
+ *    Runs until nothing has been written for IDLE_MS, so the screen is
+ *    between steps.
+ **************************************************************************/
+static void settle(void) {
+    unsigned long before;
+    unsigned char quiet = 0;
+
+    while (quiet < IDLE_MS) {
+        before = hd44780Writes();
+        simAdvance(CLOCK_CYCLES_PER_MS);
+        quiet = hd44780Writes() == before ? quiet + 1 : 0;
+    }
+}
+
+static int showsWindow(unsigned char row, const char *text, unsigned int period, unsigned int offset) {
+    unsigned char col;
+
+    for (col = 0; col < HD44780_VISIBLE; col++) {
+        if (hd44780Visible(row, col) != (unsigned char)patternChar(text, period, offset + col)) return 0;
+    }
+    return 1;
+}
+
+/**************************************************************************
+ * Function: showsLine
+ * Description:
+ *    Checks a line shows its text: at the display shift in hardware mode,
+ *    at any offset of the text and gap if it scrolls in software, else
+ *    from its start.
+ **************************************************************************/
+static int showsLine(unsigned char row, const char *text, unsigned char hardware) {
+    unsigned int length = strlen(text), period, offset;
+
+    if (hardware) {
+        period = length + LCD_MARQUEE_GAP <= HD44780_DDRAM_LINE / 2 ? HD44780_DDRAM_LINE / 2 : HD44780_DDRAM_LINE;
+        return showsWindow(row, text, period, hd44780.shift);
+    }
+    if (length <= HD44780_VISIBLE) return hd44780.shift == 0 && showsWindow(row, text, HD44780_DDRAM_LINE, 0);
+    for (offset = 0; offset < length + LCD_MARQUEE_GAP; offset++) {
+        if (showsWindow(row, text, length + LCD_MARQUEE_GAP, offset)) return 1;
+    }
+    return 0;
+}
+
+static void checkCase(const MarqueeCase *c, unsigned char queued) {
+    unsigned long writes, data, shifts;
+    unsigned int step, shownBad = 0, scrolls = (strlen(c->line[0]) > HD44780_VISIBLE) +
+                                                (strlen(c->line[1]) > HD44780_VISIBLE);
+    char what[128];
+    int ok;
+
+    if (queued) {
+        lcdQueueMarquee(c->line[0], (unsigned char)strlen(c->line[0]), c->line[1], (unsigned char)strlen(c->line[1]));
+    } else {
+        lcdMarquee(c->line[0], c->line[1]);
+    }
+    settle();                               // The queued load has gone out
+    writes = hd44780Writes();
+    data = hd44780.data;
+    shifts = hd44780.shifts;
+
+    for (step = 0; step < RUN_STEPS; step++) {
+        if (!showsLine(0, c->line[0], c->hardware) || !showsLine(1, c->line[1], c->hardware)) shownBad++;
+        simAdvance(STEP_CYCLES);
+        settle();
+    }
+    writes = hd44780Writes() - writes;
+    data = hd44780.data - data;
+    shifts = hd44780.shifts - shifts;
+
+    sprintf(what, "%s \"%.12s\"/\"%.12s\": %lu writes, %lu shifts", queued ? "queued" : "direct", c->line[0],
+            c->line[1], writes, shifts);
+    if (c->hardware) {
+        ok = writes == shifts && data == 0 && shifts >= 2 * HD44780_DDRAM_LINE;
+    } else {
+        // A redraw per scrolling line per step, never a shift
+        ok = shifts == 0 && writes >= 2UL * HD44780_DDRAM_LINE * scrolls * (HD44780_VISIBLE + 1) &&
+             writes % (HD44780_VISIBLE + 1) == 0;
+    }
+    check(ok && shownBad == 0, what);
+}
+
+static void checkStop(void) {
+    unsigned long shifts;
+    int shifted;
+
+    lcdQueueMarquee(cases[0].line[0], (unsigned char)strlen(cases[0].line[0]), cases[0].line[1],
+                    (unsigned char)strlen(cases[0].line[1]));
+    simAdvance((LCD_MARQUEE_HOLD + 8) * STEP_CYCLES);
+    shifted = hd44780.shift != 0;
+    while (!lcdQueueLine(0, "Stopped", 7)) simAdvance(CLOCK_CYCLES_PER_MS);
+    while (!lcdQueueLine(1, "", 0)) simAdvance(CLOCK_CYCLES_PER_MS);
+    settle();
+    shifts = hd44780.shifts;
+    simAdvance(4 * STEP_CYCLES);
+    check(shifted && hd44780.shift == 0 && hd44780.shifts == shifts && showsLine(0, "Stopped", 0) && showsLine(1, "", 0),
+          "lcdQueueLine() after a queued marquee stops it and unshifts");
+}
+
+int main(void) {
+    unsigned char n;
+
+    simReset();
+    WDTCTL = WDTPW | WDTHOLD;
+    PM5CTL0 &= ~LOCKLPM5;
+    clockInit();
+    timebaseInit();
+    hd44780Attach();
+    lcdInit();
+    __bis_SR_register(GIE);
+    printf("%u steps/s, %u step hold, %u blank gap\n", LCD_MARQUEE_HZ, LCD_MARQUEE_HOLD, LCD_MARQUEE_GAP);
+    for (n = 0; n < sizeof(cases) / sizeof(cases[0]); n++) checkCase(&cases[n], 0);
+    for (n = 0; n < sizeof(cases) / sizeof(cases[0]); n++) checkCase(&cases[n], 1);
+    checkStop();
+    printf("%u failure(s)\n", failures);
+    return failures != 0;
+}
@@ -0,0 +1,138 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: lightCodecBench.c
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Initial creation of the light-curve codec benchmark.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+/**************************************************************************
+ * Host build:
+ *    gcc -O2 -I. -Ihost host/lightCodecBench.c lightCodec.c -lm -o lightCodecBench
+ *
+ * Encodes synthetic transit light curves at several noise levels, checks
+ * that every curve decodes exactly (from the start and from every
+ * keyframe) and reports the compression ratio against 2 bytes per sample
+ * with the host encode time per sample. Target cycles per sample come
+ * from the PROFILE_LIGHT_ENCODE region with PROFILE_ENABLED.
+ **************************************************************************/
+
+#include "../lightCodec.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define BENCH_SAMPLES   20000
+#define BENCH_KEYFRAMES (BENCH_SAMPLES / LIGHTCODEC_KEYFRAME + 1)
+
+static unsigned int curve[BENCH_SAMPLES];
+static unsigned char stream[BENCH_SAMPLES * 4];
+static unsigned int keyframeIndex[BENCH_KEYFRAMES];
+
+/**************************************************************************
+ * Function: gaussian
+ * Description:
+ *    Normal deviate (Box-Muller).
+ **************************************************************************/
+static double gaussian(void) {
+    double u = (rand() + 1.0) / (RAND_MAX + 2.0);
+    double v = (rand() + 1.0) / (RAND_MAX + 2.0);
+    return sqrt(-2.0 * log(u)) * cos(2.0 * M_PI * v);
+}
+
+/**************************************************************************
+ * Function: makeTransitCurve
+ * Description:
+ *    10-bit light curve: a baseline with slow drift, periodic transits of
+ *    the given depth with linear ingress/egress, and Gaussian noise.
+ **************************************************************************/
+static void makeTransitCurve(double depth, double noise) {
+    const double baseline = 700.0, period = 2500.0, duration = 300.0, ramp = 40.0;
+    unsigned int i;
+
+    for (i = 0; i < BENCH_SAMPLES; i++) {
+        double phase = fmod(i, period) - (period - duration) / 2.0;
+        double dip = 0.0, level;
+
+        if (phase >= 0.0 && phase <= duration) {
+            dip = depth;
+            if (phase < ramp) dip *= phase / ramp;
+            if (duration - phase < ramp) dip *= (duration - phase) / ramp;
+        }
+        level = baseline * (1.0 + 0.02 * sin(i / 3000.0)) * (1.0 - dip) + noise * gaussian();
+        if (level < 0.0) level = 0.0;
+        if (level > 1023.0) level = 1023.0;
+        curve[i] = (unsigned int)(level + 0.5);
+    }
+}
+
+/**************************************************************************
+ * Function: checkDecode
+ * Description:
+ *    Decodes the stream from the first sample and from every keyframe.
+ * Returns:
+ *    Number of mismatched samples.
+ **************************************************************************/
+static unsigned long checkDecode(const LightEncoder *encoder) {
+    LightDecoder decoder;
+    unsigned long errors = 0, i;
+    unsigned int sample, keyframe;
+
+    lightDecoderInit(&decoder, stream, lightEncoderBytes(encoder), encoder->samples);
+    for (i = 0; lightDecode(&decoder, &sample); i++) {
+        if (sample != curve[i]) errors++;
+    }
+    if (i != encoder->samples) errors++;
+
+    for (keyframe = 0; keyframe < encoder->keyframes; keyframe++) {
+        lightDecoderInit(&decoder, stream, lightEncoderBytes(encoder), encoder->samples);
+        if (!lightDecoderSeek(&decoder, keyframe, keyframeIndex[keyframe])) {
+            errors++;
+            continue;
+        }
+        for (i = (unsigned long)keyframe * LIGHTCODEC_KEYFRAME; lightDecode(&decoder, &sample); i++) {
+            if (sample != curve[i]) errors++;
+        }
+    }
+    return errors;
+}
+
+/**************************************************************************
+ * Function: main
+ **************************************************************************/
+int main(void) {
+    static const double depths[] = { 0.01, 0.01, 0.01, 0.05, 0.05 };
+    static const double noises[] = { 0.0, 1.0, 3.0, 3.0, 10.0 };
+    LightEncoder encoder;
+    struct timespec start, end;
+    unsigned int test, i;
+    int failed = 0;
+
+    srand(1);
+    printf("depth  noise  bytes   ratio  bits/sample  ns/sample  errors\n");
+    for (test = 0; test < sizeof(depths) / sizeof(depths[0]); test++) {
+        unsigned long errors;
+        double ns;
+
+        makeTransitCurve(depths[test], noises[test]);
+
+        lightEncoderInit(&encoder, stream, sizeof(stream), keyframeIndex, BENCH_KEYFRAMES);
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        for (i = 0; i < BENCH_SAMPLES; i++) {
+            lightEncode(&encoder, curve[i]);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        ns = ((end.tv_sec - start.tv_sec) * 1e9 + (end.tv_nsec - start.tv_nsec)) / BENCH_SAMPLES;
+
+        errors = checkDecode(&encoder);
+        if (errors) failed = 1;
+        printf("%4.0f%%  %5.1f  %6u  %5.2f  %11.2f  %9.1f  %6lu\n",
+               depths[test] * 100.0, noises[test], lightEncoderBytes(&encoder),
+               2.0 * BENCH_SAMPLES / lightEncoderBytes(&encoder),
+               8.0 * lightEncoderBytes(&encoder) / BENCH_SAMPLES, ns, errors);
+    }
+    return failed;
+}
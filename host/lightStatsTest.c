@@ -0,0 +1,228 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: lightStatsTest.c
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Initial creation of the light statistics checks and benchmark.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+/**************************************************************************
+ * Host build:
+ *    gcc -O2 -I. -Ihost host/lightStatsTest.c lightStats.c -lm -o lightStatsTest
+ *
+ * Feeds synthetic 10-bit light signals (constant, Gaussian noise at
+ * several levels, a transit dip, a step, full-scale square wave and
+ * uniform noise) through lightStats.c at several window settings and
+ * compares every snapshot with the same statistics kept in double
+ * precision:
+ *    - while the window fills, the plain mean and population variance of
+ *      all samples so far
+ *    - after that, the exponentially weighted mean and variance
+ *    - the EMA, min, max and count
+ * Then times lightStatsUpdate() per sample on the host against a
+ * double-precision Welford update with a division. Target cycles per
+ * sample come from the PROFILE_LIGHT_STATS region with PROFILE_ENABLED.
+ * Exits non-zero on any mismatch.
+ **************************************************************************/
+
+#include "../lightStats.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define TEST_SAMPLES   4000
+#define BENCH_SAMPLES  2000000UL
+
+// Allowed error: means to 1/8 count (Q4 rounding plus the Q16 reciprocals),
+// standard deviation to 1/16 count or 0.5%, whichever is larger (Q4
+// rounding plus Q5 products)
+#define MEAN_TOLERANCE  (1.0 / 8)
+#define SD_TOLERANCE    (1.0 / 16)
+#define SD_RELATIVE     0.005
+
+static unsigned int signal[TEST_SAMPLES];
+
+/**************************************************************************
+ * Function: gaussian
+ * Description:
+ *    Normal deviate (Box-Muller).
+ **************************************************************************/
+static double gaussian(void) {
+    double u = (rand() + 1.0) / (RAND_MAX + 2.0);
+    double v = (rand() + 1.0) / (RAND_MAX + 2.0);
+    return sqrt(-2.0 * log(u)) * cos(2.0 * M_PI * v);
+}
+
+/**************************************************************************
+ * Function: clampSample
+ **************************************************************************/
+static unsigned int clampSample(double level) {
+    if (level < 0) return 0;
+    if (level > LIGHTSTATS_MAX_SAMPLE) return LIGHTSTATS_MAX_SAMPLE;
+    return (unsigned int)(level + 0.5);
+}
+
+/**************************************************************************
+ * Function: makeSignal
+ * Description:
+ *    Fills signal[] with test signal number kind, returns its name.
+ **************************************************************************/
+static const char *makeSignal(unsigned char kind) {
+    unsigned int i;
+
+    for (i = 0; i < TEST_SAMPLES; i++) {
+        switch (kind) {
+            case 0: signal[i] = 612; break;
+            case 1: signal[i] = clampSample(700 + 0.6 * gaussian()); break;
+            case 2: signal[i] = clampSample(700 + 4 * gaussian()); break;
+            case 3: signal[i] = clampSample(500 + 60 * gaussian()); break;
+            case 4: signal[i] = clampSample((i % 1000 >= 400 && i % 1000 < 600 ? 640 : 700) + 3 * gaussian()); break;
+            case 5: signal[i] = clampSample((i < TEST_SAMPLES / 2 ? 300 : 800) + 2 * gaussian()); break;
+            case 6: signal[i] = (i / 3) & 1 ? LIGHTSTATS_MAX_SAMPLE : 0; break;
+            default: signal[i] = rand() % (LIGHTSTATS_MAX_SAMPLE + 1); break;
+        }
+    }
+    switch (kind) {
+        case 0: return "constant";
+        case 1: return "noise sd 0.6";
+        case 2: return "noise sd 4";
+        case 3: return "noise sd 60";
+        case 4: return "transits";
+        case 5: return "step";
+        case 6: return "full-scale square";
+        default: return "uniform";
+    }
+}
+#define SIGNALS 8
+
+/**************************************************************************
+ * Function: checkSignal
+ * Description:
+ *    Runs one signal at one setting against the double reference and
+ *    returns the number of mismatches. Reports the worst errors.
+ **************************************************************************/
+static unsigned int checkSignal(const char *name, unsigned char windowShift, unsigned char emaShift) {
+    LightStats stats;
+    LightStatsSnapshot snap;
+    double mean = 0, variance = 0, ema = 0, w, d, sd;
+    double worstMean = 0, worstSd = 0, worstEma = 0;
+    unsigned int i, min = 0, max = 0, bad = 0, window = 1u << windowShift;
+
+    lightStatsInit(&stats, windowShift, emaShift);
+    for (i = 0; i < TEST_SAMPLES; i++) {
+        lightStatsUpdate(&stats, signal[i]);
+        if (i == 0) {
+            mean = ema = signal[0];
+            variance = 0;
+            min = max = signal[0];
+        } else {
+            if (signal[i] < min) min = signal[i];
+            if (signal[i] > max) max = signal[i];
+            ema += (signal[i] - ema) / (double)(1u << emaShift);
+            w = i + 1 < window ? 1.0 / (i + 1) : 1.0 / window;
+            d = signal[i] - mean;
+            mean += w * d;
+            variance += w * (d * (signal[i] - mean) - variance);
+        }
+
+        lightStatsSnapshot(&stats, &snap);
+        sd = sqrt(variance);
+        if (fabs(snap.mean / 16.0 - mean) > worstMean) worstMean = fabs(snap.mean / 16.0 - mean);
+        if (fabs(snap.ema / 16.0 - ema) > worstEma) worstEma = fabs(snap.ema / 16.0 - ema);
+        if (fabs(snap.stdDev / 16.0 - sd) > worstSd) worstSd = fabs(snap.stdDev / 16.0 - sd);
+        if (fabs(snap.mean / 16.0 - mean) > MEAN_TOLERANCE ||
+            fabs(snap.ema / 16.0 - ema) > MEAN_TOLERANCE ||
+            fabs(snap.stdDev / 16.0 - sd) > fmax(SD_TOLERANCE, sd * SD_RELATIVE) ||
+            snap.min != min || snap.max != max || snap.count != i + 1) {
+            if (!bad) {
+                printf("    sample %u: mean %.4f/%.4f ema %.4f/%.4f sd %.4f/%.4f min %u/%u max %u/%u\n",
+                       i, snap.mean / 16.0, mean, snap.ema / 16.0, ema, snap.stdDev / 16.0, sd,
+                       snap.min, min, snap.max, max);
+            }
+            bad++;
+        }
+    }
+    printf("  %-18s window %3u ema 1/%-4u  worst mean %.4f ema %.4f sd %.4f  %s\n", name, window,
+           1u << emaShift, worstMean, worstEma, worstSd, bad ? "FAIL" : "ok");
+    return bad != 0;
+}
+
+/**************************************************************************
+ * Function: checkReset
+ **************************************************************************/
+static unsigned int checkReset(void) {
+    LightStats stats;
+    LightStatsSnapshot snap;
+    unsigned int bad = 0;
+
+    lightStatsInit(&stats, 20, 40);     // Both clamped
+    bad += stats.windowShift != LIGHTSTATS_MAX_WINDOW_SHIFT || stats.emaShift != LIGHTSTATS_MAX_EMA_SHIFT;
+    lightStatsSnapshot(&stats, &snap);
+    bad += snap.count != 0 || snap.mean != 0 || snap.stdDev != 0;
+    lightStatsUpdate(&stats, 100);
+    lightStatsUpdate(&stats, 5000);          // Clamped to full scale
+    lightStatsSnapshot(&stats, &snap);
+    bad += snap.max != LIGHTSTATS_MAX_SAMPLE || snap.min != 100 || snap.count != 2;
+    lightStatsReset(&stats);
+    lightStatsUpdate(&stats, 300);
+    lightStatsSnapshot(&stats, &snap);
+    bad += snap.count != 1 || snap.min != 300 || snap.max != 300 || snap.mean != 300 * 16 ||
+           snap.variance != 0 || stats.windowShift != LIGHTSTATS_MAX_WINDOW_SHIFT;
+    printf("  %-18s %s\n", "clamps and reset", bad ? "FAIL" : "ok");
+    return bad != 0;
+}
+
+/**************************************************************************
+ * Function: bench
+ **************************************************************************/
+static void bench(void) {
+    LightStats stats;
+    volatile LightStatsSnapshot snap;
+    volatile double sink;
+    double mean = 0, m2 = 0, d;
+    unsigned long i;
+    clock_t start;
+    double fixedNs, floatNs;
+
+    makeSignal(2);
+    lightStatsInit(&stats, 6, 3);
+    start = clock();
+    for (i = 0; i < BENCH_SAMPLES; i++) lightStatsUpdate(&stats, signal[i % TEST_SAMPLES]);
+    fixedNs = (double)(clock() - start) / CLOCKS_PER_SEC * 1e9 / BENCH_SAMPLES;
+    lightStatsSnapshot(&stats, (LightStatsSnapshot *)&snap);
+
+    start = clock();
+    for (i = 0; i < BENCH_SAMPLES; i++) {
+        d = signal[i % TEST_SAMPLES] - mean;
+        mean += d / (i + 1);
+        m2 += d * (signal[i % TEST_SAMPLES] - mean);
+    }
+    floatNs = (double)(clock() - start) / CLOCKS_PER_SEC * 1e9 / BENCH_SAMPLES;
+    sink = m2;
+    (void)sink;
+
+    printf("\nhost time per sample: fixed point %.1f ns, double Welford %.1f ns\n", fixedNs, floatNs);
+}
+
+int main(void) {
+    static const unsigned char settings[][2] = { { 1, 0 }, { 4, 2 }, { 6, 3 }, { 8, 5 }, { 8, 10 } };
+    unsigned int failures = 0;
+    unsigned char kind, s;
+    const char *name;
+
+    srand(1);
+    for (kind = 0; kind < SIGNALS; kind++) {
+        name = makeSignal(kind);
+        for (s = 0; s < sizeof(settings) / sizeof(settings[0]); s++) {
+            failures += checkSignal(name, settings[s][0], settings[s][1]);
+        }
+    }
+    failures += checkReset();
+    bench();
+
+    printf("%u failure(s)\n", failures);
+    return failures != 0;
+}
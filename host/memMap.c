@@ -0,0 +1,295 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: memMap.c
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Defined the GCC and TI map readers and the module table.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#include "memMap.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define FORMAT_NONE  0
+#define FORMAT_GCC   1
+#define FORMAT_TI    2
+#define FORMAT_DONE  3
+
+/**************************************************************************
+ * Function: sectionKind
+ * Description:
+ *    Kind of an input section by name (GCC or TI), or -1 to skip it.
+ **************************************************************************/
+static int sectionKind(const char *section) {
+    static const char *const prefixes[] = { ".lower", ".upper", ".either" };
+    unsigned char i;
+
+    for (i = 0; i < sizeof(prefixes) / sizeof(prefixes[0]); i++) {
+        size_t length = strlen(prefixes[i]);
+        if (strncmp(section, prefixes[i], length) == 0 && section[length] == '.') {
+            section += length;
+            break;
+        }
+    }
+    if (strncmp(section, ".text", 5) == 0 || strncmp(section, ".crt_", 5) == 0) return MEMMAP_CODE;
+    if (strncmp(section, ".rodata", 7) == 0 || strncmp(section, ".const", 6) == 0 ||
+        strcmp(section, ".cinit") == 0 || strcmp(section, ".binit") == 0) return MEMMAP_CONST;
+    if (strncmp(section, ".data", 5) == 0) return MEMMAP_DATA;
+    if (strncmp(section, ".bss", 4) == 0 || strncmp(section, ".noinit", 7) == 0 ||
+        strcmp(section, "COMMON") == 0 || strcmp(section, ".common") == 0 ||
+        strcmp(section, ".TI.noinit") == 0) return MEMMAP_BSS;
+    if (strncmp(section, ".persistent", 11) == 0 || strcmp(section, ".TI.persistent") == 0) {
+        return MEMMAP_PERSISTENT;
+    }
+    return -1;
+}
+
+/**************************************************************************
+ * Function: moduleName
+ * Description:
+ *    Short name for the file an input section came from: the library for
+ *    a library member, otherwise the object file without its directory
+ *    or extensions.
+ **************************************************************************/
+static void moduleName(const char *file, char *name) {
+    char buffer[256];
+    char *start, *end;
+
+    strncpy(buffer, file, sizeof(buffer) - 1);
+    buffer[sizeof(buffer) - 1] = '\0';
+    if ((end = strstr(buffer, " : ")) != 0 || (end = strchr(buffer, '(')) != 0) {
+        *end = '\0';                                    // Library member
+        while (end > buffer && end[-1] == ' ') *--end = '\0';
+        start = strrchr(buffer, '/');
+        if (!start) start = strrchr(buffer, '\\');
+        start = start ? start + 1 : buffer;
+    } else {
+        while ((end = buffer + strlen(buffer)) > buffer && end[-1] == ' ') end[-1] = '\0';
+        start = strrchr(buffer, '/');
+        if (!start) start = strrchr(buffer, '\\');
+        start = start ? start + 1 : buffer;
+        if ((end = strchr(start, '.')) != 0 && end != start) *end = '\0';
+    }
+    strncpy(name, *start ? start : "(unknown)", MEMMAP_NAME - 1);
+    name[MEMMAP_NAME - 1] = '\0';
+}
+
+/**************************************************************************
+ * Function: addSection
+ **************************************************************************/
+static void addSection(MemMap *map, const char *section, unsigned long size, const char *file) {
+    char name[MEMMAP_NAME];
+    int kind = sectionKind(section);
+    unsigned int i;
+
+    if (kind < 0 || size == 0) return;
+    if (*file) moduleName(file, name);
+    else strcpy(name, "(common)");
+
+    for (i = 0; i < map->count && strcmp(map->modules[i].name, name) != 0; i++);
+    if (i == map->count) {
+        if (map->count == MEMMAP_MAX_MODULES) {
+            map->dropped++;
+            return;
+        }
+        memset(&map->modules[i], 0, sizeof(map->modules[i]));
+        strcpy(map->modules[i].name, name);
+        map->count++;
+    }
+    map->modules[i].bytes[kind] += size;
+    map->entries++;
+}
+
+/**************************************************************************
+ * Function: gccLine
+ * Description:
+ *    GCC input section lines are " section 0xaddress 0xsize file", with
+ *    long section names alone on their line and the rest on the next.
+ **************************************************************************/
+static void gccLine(MemMap *map, const char *line) {
+    char section[64], file[256];
+    unsigned long address, size;
+    int used = 0;
+
+    if (map->pendingSection[0]) {
+        if (sscanf(line, " 0x%lx 0x%lx %n", &address, &size, &used) == 2 && used && line[used]) {
+            addSection(map, map->pendingSection, size, line + used);
+        }
+        map->pendingSection[0] = '\0';
+        return;
+    }
+    if (line[0] != ' ' || line[1] == ' ' || line[1] == '*') return;  // Output sections, symbols, patterns
+    if (sscanf(line, " %63s 0x%lx 0x%lx %n", section, &address, &size, &used) == 3 && used && line[used]) {
+        strncpy(file, line + used, sizeof(file) - 1);
+        file[sizeof(file) - 1] = '\0';
+        addSection(map, section, size, file);
+    } else if (sscanf(line, " %63s %n", section, &used) == 1 && !line[used]) {
+        strcpy(map->pendingSection, section);
+    }
+}
+
+/**************************************************************************
+ * Function: tiLine
+ * Description:
+ *    TI input section lines are "  address  size  file (section:name)",
+ *    where file may be "library : member" or missing.
+ **************************************************************************/
+static void tiLine(MemMap *map, const char *line) {
+    char file[256], section[64];
+    const char *open, *close;
+    unsigned long address, size;
+    int used = 0;
+    size_t length;
+
+    if (line[0] != ' ') return;                                       // Output sections
+    if (sscanf(line, " %8lx %8lx %n", &address, &size, &used) != 2 || !used) return;
+    open = strrchr(line + used, '(');
+    close = open ? strchr(open, ')') : 0;
+    if (!close) return;                                               // --HOLE-- and the like
+
+    length = (size_t)(open - (line + used));
+    if (length >= sizeof(file)) length = sizeof(file) - 1;
+    memcpy(file, line + used, length);
+    file[length] = '\0';
+    while (length && file[length - 1] == ' ') file[--length] = '\0';
+
+    length = (size_t)(close - open - 1);
+    if (length >= sizeof(section)) length = sizeof(section) - 1;
+    memcpy(section, open + 1, length);
+    section[length] = '\0';
+    if ((open = strchr(section + 1, ':')) != 0) section[open - section] = '\0';  // .text:main -> .text
+    addSection(map, section, size, file);
+}
+
+/**************************************************************************
+ * Function: memMapInit
+ **************************************************************************/
+void memMapInit(MemMap *map) {
+    memset(map, 0, sizeof(*map));
+}
+
+/**************************************************************************
+ * Function: memMapLine
+ **************************************************************************/
+void memMapLine(MemMap *map, const char *text) {
+    char line[512];
+    size_t length;
+
+    strncpy(line, text, sizeof(line) - 1);
+    line[sizeof(line) - 1] = '\0';
+    length = strlen(line);
+    while (length && (line[length - 1] == '\n' || line[length - 1] == '\r')) line[--length] = '\0';
+
+    if (strncmp(line, "Linker script and memory map", 28) == 0) {
+        map->format = FORMAT_GCC;
+    } else if (strncmp(line, "SECTION ALLOCATION MAP", 22) == 0) {
+        map->format = FORMAT_TI;
+    } else if (map->format == FORMAT_TI &&
+               (strncmp(line, "GLOBAL SYMBOLS", 14) == 0 || strncmp(line, "LINKER GENERATED", 16) == 0)) {
+        map->format = FORMAT_DONE;
+    } else if (map->format == FORMAT_GCC) {
+        gccLine(map, line);
+    } else if (map->format == FORMAT_TI) {
+        tiLine(map, line);
+    }
+}
+
+/**************************************************************************
+ * Function: memMapRam
+ **************************************************************************/
+unsigned long memMapRam(const MemMapModule *module) {
+    return module->bytes[MEMMAP_DATA] + module->bytes[MEMMAP_BSS];
+}
+
+/**************************************************************************
+ * Function: memMapFram
+ **************************************************************************/
+unsigned long memMapFram(const MemMapModule *module) {
+    return module->bytes[MEMMAP_CODE] + module->bytes[MEMMAP_CONST] +
+           module->bytes[MEMMAP_DATA] + module->bytes[MEMMAP_PERSISTENT];
+}
+
+/**************************************************************************
+ * Function: memMapFind
+ **************************************************************************/
+const MemMapModule *memMapFind(const MemMap *map, const char *name) {
+    unsigned int i;
+
+    for (i = 0; i < map->count; i++) {
+        if (strcmp(map->modules[i].name, name) == 0) return &map->modules[i];
+    }
+    return 0;
+}
+
+/**************************************************************************
+ * Function: compareModules
+ **************************************************************************/
+static int compareModules(const void *a, const void *b) {
+    const MemMapModule *first = a, *second = b;
+
+    if (memMapRam(first) != memMapRam(second)) return memMapRam(first) < memMapRam(second) ? 1 : -1;
+    if (memMapFram(first) != memMapFram(second)) return memMapFram(first) < memMapFram(second) ? 1 : -1;
+    return strcmp(first->name, second->name);
+}
+
+/**************************************************************************
+ * Function: memMapPrint
+ **************************************************************************/
+void memMapPrint(MemMap *map, FILE *stream) {
+    MemMapModule total;
+    unsigned int i;
+    unsigned char k;
+
+    qsort(map->modules, map->count, sizeof(map->modules[0]), compareModules);
+    memset(&total, 0, sizeof(total));
+    fprintf(stream, "%-20s %6s %6s %6s %6s %7s %6s %6s\n",
+            "module", "code", "const", "data", "bss", "persist", "RAM", "FRAM");
+    for (i = 0; i < map->count; i++) {
+        const MemMapModule *m = &map->modules[i];
+        fprintf(stream, "%-20s %6lu %6lu %6lu %6lu %7lu %6lu %6lu\n", m->name,
+                m->bytes[MEMMAP_CODE], m->bytes[MEMMAP_CONST], m->bytes[MEMMAP_DATA],
+                m->bytes[MEMMAP_BSS], m->bytes[MEMMAP_PERSISTENT], memMapRam(m), memMapFram(m));
+        for (k = 0; k < MEMMAP_KINDS; k++) total.bytes[k] += m->bytes[k];
+    }
+    fprintf(stream, "%-20s %6lu %6lu %6lu %6lu %7lu %6lu %6lu\n\n", "total",
+            total.bytes[MEMMAP_CODE], total.bytes[MEMMAP_CONST], total.bytes[MEMMAP_DATA],
+            total.bytes[MEMMAP_BSS], total.bytes[MEMMAP_PERSISTENT], memMapRam(&total), memMapFram(&total));
+    fprintf(stream, "RAM  %5lu of %5u bytes static (%lu%%), %ld left for the stack\n",
+            memMapRam(&total), MEMMAP_RAM_BYTES, memMapRam(&total) * 100 / MEMMAP_RAM_BYTES,
+            (long)MEMMAP_RAM_BYTES - (long)memMapRam(&total));
+    fprintf(stream, "FRAM %5lu of %5u bytes (%lu%%)\n",
+            memMapFram(&total), MEMMAP_FRAM_BYTES, memMapFram(&total) * 100 / MEMMAP_FRAM_BYTES);
+    if (map->dropped) fprintf(stream, "%lu sections not counted, more than %u modules\n",
+                              map->dropped, MEMMAP_MAX_MODULES);
+}
+
+#ifdef MEMMAP_MAIN
+/**************************************************************************
+ * Function: main
+ **************************************************************************/
+int main(int argc, char **argv) {
+    static MemMap map;
+    char line[512];
+    FILE *file;
+
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s firmware.map\n", argv[0]);
+        return 2;
+    }
+    if (!(file = fopen(argv[1], "r"))) {
+        perror(argv[1]);
+        return 1;
+    }
+    memMapInit(&map);
+    while (fgets(line, sizeof(line), file)) memMapLine(&map, line);
+    fclose(file);
+    if (map.format == FORMAT_NONE) {
+        fprintf(stderr, "%s: no section placement found, not a GCC or TI map?\n", argv[1]);
+        return 1;
+    }
+    memMapPrint(&map, stdout);
+    return 0;
+}
+#endif
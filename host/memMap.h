@@ -0,0 +1,123 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: memMap.h
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Initial creation of the linker map reader.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#ifndef MEMMAP_H_
+#define MEMMAP_H_
+
+#include <stdio.h>
+
+/**************************************************************************
+ * Host build:
+ *    Lists the static RAM and FRAM each module takes, from the linker map
+ *    of a firmware build (msp430-elf-gcc -Wl,-Map=fw.map, or the TI
+ *    linker's --map_file):
+ *        gcc -I. -Ihost -DMEMMAP_MAIN host/memMap.c -o memMap
+ *        ./memMap fw.map
+ *
+ * Only the input sections in the placement part of the map are counted
+ * ("Linker script and memory map" for GCC, "SECTION ALLOCATION MAP" for
+ * TI), so discarded sections are left out. Each is put down to its
+ * object file, with library members counted under the library, and
+ * sorted by section name:
+ *    code        .text*, .lower/.upper/.either.text*, TI .text:*
+ *    const       .rodata*, .const*, .cinit (initialisation tables)
+ *    data        .data* - RAM, with its initial image in FRAM too
+ *    bss         .bss*, .noinit*, COMMON
+ *    persistent  .persistent*, .TI.persistent - FRAM variables
+ * The stack, heap and vector table are not any module's and are skipped.
+ * TI .common variables are listed under "(common)", as the map does not
+ * say which file they came from.
+ **************************************************************************/
+#define MEMMAP_MAX_MODULES  64
+#define MEMMAP_NAME         32
+#define MEMMAP_RAM_BYTES    2048      // MSP430FR4133
+#define MEMMAP_FRAM_BYTES   15872
+
+enum {
+    MEMMAP_CODE,
+    MEMMAP_CONST,
+    MEMMAP_DATA,
+    MEMMAP_BSS,
+    MEMMAP_PERSISTENT,
+    MEMMAP_KINDS
+};
+
+/**************************************************************************
+ * Structure: MemMapModule
+ * Description:
+ *    Bytes of each kind for one module.
+ **************************************************************************/
+typedef struct {
+    char name[MEMMAP_NAME];
+    unsigned long bytes[MEMMAP_KINDS];
+} MemMapModule;
+
+/**************************************************************************
+ * Structure: MemMap
+ * Description:
+ *    Reader state and results.
+ * Members:
+ *    format - 0 before the placement part, 1 GCC, 2 TI, 3 after it (TI)
+ *    pendingSection - GCC input section name whose address and size are
+ *                     on the next line
+ *    entries - Input sections counted
+ *    dropped - Input sections not counted because the table was full
+ **************************************************************************/
+typedef struct {
+    unsigned char format;
+    char pendingSection[64];
+    MemMapModule modules[MEMMAP_MAX_MODULES];
+    unsigned int count;
+    unsigned long entries;
+    unsigned long dropped;
+} MemMap;
+
+/**************************************************************************
+ * Function: memMapInit
+ **************************************************************************/
+void memMapInit(MemMap *map);
+
+/**************************************************************************
+ * Function: memMapLine
+ * Description:
+ *    Reads one line of a map file (with or without its newline).
+ **************************************************************************/
+void memMapLine(MemMap *map, const char *line);
+
+/**************************************************************************
+ * Function: memMapRam
+ * Description:
+ *    Returns a module's static RAM: data plus bss.
+ **************************************************************************/
+unsigned long memMapRam(const MemMapModule *module);
+
+/**************************************************************************
+ * Function: memMapFram
+ * Description:
+ *    Returns a module's FRAM: code, const, the data image and persistent.
+ **************************************************************************/
+unsigned long memMapFram(const MemMapModule *module);
+
+/**************************************************************************
+ * Function: memMapFind
+ * Description:
+ *    Returns the module with the given name, or 0.
+ **************************************************************************/
+const MemMapModule *memMapFind(const MemMap *map, const char *name);
+
+/**************************************************************************
+ * Function: memMapPrint
+ * Description:
+ *    Prints the modules, largest RAM first, with totals against the
+ *    FR4133's RAM and FRAM.
+ **************************************************************************/
+void memMapPrint(MemMap *map, FILE *stream);
+
+#endif /* MEMMAP_H_ */
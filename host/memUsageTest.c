@@ -0,0 +1,286 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: memUsageTest.c
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Initial creation of the memory usage and map reader checks.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+/**************************************************************************
+ * Host build:
+ *    gcc -I. -Ihost host/memUsageTest.c memUsage.c host/memMap.c \
+ *        adcSequence.c timebase.c clock.c host/msp430sim.c -o memUsageTest
+ *
+ * Checks the report logic of memUsage.c and host/memMap.c:
+ *    - memPaint()/memUntouched() on a plain buffer
+ *    - the paint left by memUsageInit(), and the peak and overflow flag as
+ *      words of the host stack are overwritten
+ *    - the tick and ADC ISRs running on the simulator with the main loop
+ *      200 bytes down the stack: entry counts match the simulator's
+ *      interrupt counts, nesting is 1 and each came in 200 bytes plus its
+ *      interrupt frame down
+ *    - nested markers record the inner ISR at depth 2
+ *    - per-module totals from a sample GCC map and a sample TI map
+ * Exits non-zero on any failure.
+ **************************************************************************/
+
+#include "msp430sim.h"
+#include "memMap.h"
+#include "../memUsage.h"
+#include "../adcSequence.h"
+#include "../timebase.h"
+#include "../clock.h"
+#include <msp430fr4133.h>
+#include <stdio.h>
+#include <string.h>
+
+#define HOST_WORDS   (sizeof(memHostStack) / sizeof(memHostStack[0]))
+#define MAIN_DEPTH   200      // Bytes the main loop is down the stack
+
+static unsigned int failures = 0;
+
+// Abridged msp430-elf-gcc -Wl,-Map output
+static const char *const gccMap[] = {
+    "Archive member included to satisfy reference by file (symbol)",
+    "",
+    "/opt/msp430-gcc/msp430-elf/lib/libc.a(lib_a-vfprintf.o)",
+    "                              main.o (printf)",
+    "",
+    "Memory Configuration",
+    "",
+    "Name             Origin             Length             Attributes",
+    "RAM              0x0000000000002000 0x0000000000000800 xw",
+    "",
+    "Linker script and memory map",
+    "",
+    ".text           0x000000000000c400     0x1a00",
+    " *(.text .stub .text.* .gnu.linkonce.t.*)",
+    " .text          0x000000000000c400      0x120 main.o",
+    "                0x000000000000c400                main",
+    " .text.colourSensorInit",
+    "                0x000000000000c520       0x3c colourSensor.o",
+    " .text          0x000000000000c55c      0x200 /opt/msp430-gcc/msp430-elf/lib/libc.a(lib_a-vfprintf.o)",
+    " *fill*         0x000000000000c75c        0x2 ",
+    " .lower.text.lcdInit",
+    "                0x000000000000c75e       0x40 build/lcd.o",
+    "",
+    ".rodata         0x000000000000de00       0x80",
+    " .rodata        0x000000000000de00       0x60 main.o",
+    " .rodata.gasSpectra",
+    "                0x000000000000de60       0x20 GasSpectra.o",
+    "",
+    ".data           0x0000000000002000       0x42 load address 0x000000000000de80",
+    " .data          0x0000000000002000       0x40 GasSpectra.o",
+    " .data.state    0x0000000000002040        0x2 main.o",
+    "",
+    ".bss            0x0000000000002042       0x30",
+    " .bss           0x0000000000002042       0x20 build/lcd.o",
+    " COMMON         0x0000000000002062       0x10 main.o",
+    "",
+    ".persistent     0x000000000000e000        0x8",
+    " .persistent.bootState",
+    "                0x000000000000e000        0x8 boot.o",
+    "",
+    ".stack          0x00000000000027b0       0x50",
+    " .stack         0x00000000000027b0       0x50 crt0.o",
+    "",
+    ".debug_info     0x0000000000000000     0x4000",
+    " .debug_info    0x0000000000000000     0x2000 main.o",
+};
+
+// Abridged TI --map_file output
+static const char *const tiMap[] = {
+    "MEMORY CONFIGURATION",
+    "",
+    "         name            origin    length      used     unused   attr    fill",
+    "  RAM                   00002000   00000800  00000100  00000700  RWIX",
+    "",
+    "SECTION ALLOCATION MAP",
+    "",
+    " output                                  attributes/",
+    "section   page    origin      length       input sections",
+    "--------  ----  ----------  ----------   ----------------",
+    ".bss       0    00002000    00000024     UNINITIALIZED",
+    "                  00002000    00000020     lcd.obj (.bss:displayBuffer)",
+    "                  00002020    00000002     (.common:red_val)",
+    "                  00002022    00000002     (.common:green_val)",
+    "",
+    ".data      0    00002024    00000040     UNINITIALIZED",
+    "                  00002024    00000040     GasSpectra.obj (.data:gasSpectra)",
+    "",
+    ".stack     0    000027b0    00000050     UNINITIALIZED",
+    "                  000027b0    00000002     rts430_eabi.lib : boot.c.obj (.stack)",
+    "                  000027b2    0000004e     --HOLE--",
+    "",
+    ".text      0    0000c400    00000400     ",
+    "                  0000c400    00000120     main.obj (.text:main)",
+    "                  0000c520    000000a0     rts430_eabi.lib : printf.c.obj (.text:printf)",
+    "                  0000c5c0    00000060     rts430_eabi.lib : memcpy.c.obj (.text:memcpy)",
+    "                  0000c620    0000003c     colourSensor.obj (.text:_isr:Port_1)",
+    "",
+    ".const     0    0000de00    00000060     ",
+    "                  0000de00    00000060     main.obj (.const:.string)",
+    "",
+    ".TI.persistent ",
+    "*          0    0000e000    00000008     ",
+    "                  0000e000    00000008     boot.obj (.TI.persistent)",
+    "",
+    "PORT1      0    0000ffe6    00000002     ",
+    "                  0000ffe6    00000002     colourSensor.obj (.int38)",
+    "",
+    "GLOBAL SYMBOLS: SORTED ALPHABETICALLY BY Name",
+    "",
+    "address   name",
+    "-------   ----",
+    "0000c400  main.obj (.text:main)",
+};
+
+/**************************************************************************
+ * Function: check
+ **************************************************************************/
+static void check(const char *what, unsigned long got, unsigned long expected) {
+    printf("%-44s %6lu  %6lu%s\n", what, got, expected, got == expected ? "" : "  <-- FAIL");
+    if (got != expected) failures++;
+}
+
+/**************************************************************************
+ * Function: checkModule
+ **************************************************************************/
+static void checkModule(const MemMap *map, const char *format, const char *name,
+                        unsigned long code, unsigned long constant, unsigned long data,
+                        unsigned long bss, unsigned long persistent) {
+    const MemMapModule *module = memMapFind(map, name);
+    unsigned long expected[MEMMAP_KINDS];
+    char what[64];
+    unsigned char k, ok = 1;
+
+    expected[MEMMAP_CODE] = code;
+    expected[MEMMAP_CONST] = constant;
+    expected[MEMMAP_DATA] = data;
+    expected[MEMMAP_BSS] = bss;
+    expected[MEMMAP_PERSISTENT] = persistent;
+    for (k = 0; k < MEMMAP_KINDS; k++) ok &= module && module->bytes[k] == expected[k];
+    sprintf(what, "%s map: %s", format, name);
+    check(what, ok, 1);
+}
+
+/**************************************************************************
+ * Function: readMap
+ **************************************************************************/
+static void readMap(MemMap *map, const char *const *lines, unsigned int count) {
+    unsigned int i;
+
+    memMapInit(map);
+    for (i = 0; i < count; i++) memMapLine(map, lines[i]);
+}
+
+int main(void) {
+    static MemMap map;
+    unsigned int buffer[16], peak;
+    MemReport report;
+    unsigned long tickIsrs, adcIsrs;
+
+    // Paint and scan
+    memset(buffer, 0, sizeof(buffer));
+    memPaint(buffer + 2, buffer + 12);
+    check("untouched from the first painted word", memUntouched(buffer + 2, buffer + 16), 10 * sizeof(unsigned int));
+    check("untouched from an unpainted word", memUntouched(buffer, buffer + 16), 0);
+    buffer[7] = 0;
+    check("untouched up to an overwritten word", memUntouched(buffer + 2, buffer + 16), 5 * sizeof(unsigned int));
+
+    // Paint left by memUsageInit() with the stack pointer 100 bytes down
+    simReset();
+    simSetStackPointer(SIM_STACK_TOP - 100);
+    memUsageInit();
+    memUsageGet(&report);
+    check("static RAM below the host stack", report.staticRam, MEMUSAGE_HOST_STATIC);
+    check("stack size", report.stackSize, sizeof(memHostStack));
+    check("peak after init (depth + paint margin)", report.stackPeak, 100 + MEMUSAGE_PAINT_MARGIN);
+    check("overflow after init", report.overflow, 0);
+    check("memStackGrew first call", memStackGrew(&peak), 1);
+    check("memStackGrew unchanged", memStackGrew(&peak), 0);
+
+    memHostStack[HOST_WORDS - 300 / sizeof(unsigned int)] = 0;
+    memUsageGet(&report);
+    check("peak with a word 300 bytes down used", report.stackPeak, 300);
+    check("memStackGrew after it", memStackGrew(&peak), 1);
+    check("memStackGrew peak", peak, 300);
+
+    memHostStack[0] = 0;
+    memUsageGet(&report);
+    check("peak with the bottom word used", report.stackPeak, sizeof(memHostStack));
+    check("overflow with the bottom word used", report.overflow, 1);
+
+    // ISRs on the simulator
+    simReset();
+    simSetStackPointer(SIM_STACK_TOP - MAIN_DEPTH);
+    WDTCTL = WDTPW | WDTHOLD;
+    memUsageInit();
+    PM5CTL0 &= ~LOCKLPM5;
+    clockInit();
+    timebaseInit();
+    if (adcSeqInit() != 1 || adcSeqStart() != 1) {
+        printf("sequence would not start\n");
+        return 1;
+    }
+    __bis_SR_register(GIE);
+    simAdvance(100UL * CLOCK_CYCLES_PER_MS);
+    adcSeqStop();
+    __bic_SR_register(GIE);
+    tickIsrs = simInterruptCount(TIMER1_A0_VECTOR);
+    adcIsrs = simInterruptCount(ADC_VECTOR);
+
+    memUsageGet(&report);
+    check("tick ISR entries", report.isrEntries[MEMUSAGE_TICK_ISR], tickIsrs);
+    check("tick ISR nesting", report.isrNesting[MEMUSAGE_TICK_ISR], 1);
+    check("tick ISR stack on entry", report.isrStack[MEMUSAGE_TICK_ISR], MAIN_DEPTH + SIM_ISR_FRAME_BYTES);
+    check("ADC ISR entries", report.isrEntries[MEMUSAGE_ADC_ISR], adcIsrs);
+    check("ADC ISR nesting", report.isrNesting[MEMUSAGE_ADC_ISR], 1);
+    check("ADC ISR stack on entry", report.isrStack[MEMUSAGE_ADC_ISR], MAIN_DEPTH + SIM_ISR_FRAME_BYTES);
+    check("PWM ISR entries (not running)", report.isrEntries[MEMUSAGE_PWM_ISR], 0);
+    check("PWM ISR stack (not running)", report.isrStack[MEMUSAGE_PWM_ISR], 0);
+    check("ISRs seen at all", tickIsrs >= 100 && adcIsrs > 0, 1);
+
+    // The ADC ISR coming in on top of the PWM ISR
+    simSetStackPointer(SIM_STACK_TOP - 260);
+    MEMUSAGE_ISR_ENTER(MEMUSAGE_PWM_ISR);
+    simSetStackPointer(SIM_STACK_TOP - 300);
+    MEMUSAGE_ISR_ENTER(MEMUSAGE_ADC_ISR);
+    MEMUSAGE_ISR_EXIT(MEMUSAGE_ADC_ISR);
+    MEMUSAGE_ISR_EXIT(MEMUSAGE_PWM_ISR);
+    memUsageGet(&report);
+    check("nested: PWM ISR nesting", report.isrNesting[MEMUSAGE_PWM_ISR], 1);
+    check("nested: ADC ISR nesting", report.isrNesting[MEMUSAGE_ADC_ISR], 2);
+    check("nested: ADC ISR stack on entry", report.isrStack[MEMUSAGE_ADC_ISR], 300);
+    check("nesting back to 0", memIsrNesting, 0);
+
+    // Linker maps
+    readMap(&map, gccMap, sizeof(gccMap) / sizeof(gccMap[0]));
+    checkModule(&map, "GCC", "main", 0x120, 0x60, 0x2, 0x10, 0);
+    checkModule(&map, "GCC", "colourSensor", 0x3c, 0, 0, 0, 0);
+    checkModule(&map, "GCC", "libc.a", 0x200, 0, 0, 0, 0);
+    checkModule(&map, "GCC", "lcd", 0x40, 0, 0, 0x20, 0);
+    checkModule(&map, "GCC", "GasSpectra", 0, 0x20, 0x40, 0, 0);
+    checkModule(&map, "GCC", "boot", 0, 0, 0, 0, 0x8);
+    check("GCC map: stack not counted", memMapFind(&map, "crt0") == 0, 1);
+    check("GCC map: input sections counted", map.entries, 11);
+
+    readMap(&map, tiMap, sizeof(tiMap) / sizeof(tiMap[0]));
+    checkModule(&map, "TI", "main", 0x120, 0x60, 0, 0, 0);
+    checkModule(&map, "TI", "lcd", 0, 0, 0, 0x20, 0);
+    checkModule(&map, "TI", "(common)", 0, 0, 0, 0x4, 0);
+    checkModule(&map, "TI", "GasSpectra", 0, 0, 0x40, 0, 0);
+    checkModule(&map, "TI", "rts430_eabi.lib", 0x100, 0, 0, 0, 0);
+    checkModule(&map, "TI", "colourSensor", 0x3c, 0, 0, 0, 0);
+    checkModule(&map, "TI", "boot", 0, 0, 0, 0, 0x8);
+    check("TI map: input sections counted", map.entries, 10);
+
+    printf("\nGCC sample map:\n");
+    readMap(&map, gccMap, sizeof(gccMap) / sizeof(gccMap[0]));
+    memMapPrint(&map, stdout);
+
+    printf("\n%u failure(s)\n", failures);
+    return failures != 0;
+}
@@ -0,0 +1,332 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: msp430fr4133.h (host)
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Added the ADC overflow flag.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#ifndef MSP430FR4133_HOST_H_
+#define MSP430FR4133_HOST_H_
+
+#include "msp430sim.h"
+#include <intrinsics.h>
+
+/**************************************************************************
+ * Interrupt declarations. The TI pragma is ignored on the host and the
+ * GCC interrupt attribute expands to nothing; the simulator calls the
+ * ISRs by name.
+ **************************************************************************/
+#define __interrupt
+#define interrupt(vector)
+
+#define TIMER0_A0_VECTOR    SIM_VECTOR_TIMER0_A0
+#define TIMER0_A1_VECTOR    SIM_VECTOR_TIMER0_A1
+#define TIMER1_A0_VECTOR    SIM_VECTOR_TIMER1_A0
+#define TIMER1_A1_VECTOR    SIM_VECTOR_TIMER1_A1
+#define USCI_A0_VECTOR      SIM_VECTOR_USCI_A0
+#define ADC_VECTOR          SIM_VECTOR_ADC
+#define PORT1_VECTOR        SIM_VECTOR_PORT1
+#define PORT2_VECTOR        SIM_VECTOR_PORT2
+
+/**************************************************************************
+ * Register storage (defined in msp430sim.c)
+ **************************************************************************/
+#define SIM_REG8(name)   extern volatile unsigned char sim_##name;
+#define SIM_REG16(name)  extern volatile unsigned short sim_##name;
+#include "msp430sim_regs.h"
+#undef SIM_REG8
+#undef SIM_REG16
+
+#define SIM_R8(name)     (*simAccess8(&sim_##name))
+#define SIM_R16(name)    (*simAccess16(&sim_##name))
+
+// Watchdog, power management and system configuration
+#define WDTCTL      SIM_R16(WDTCTL)
+#define PM5CTL0     SIM_R16(PM5CTL0)
+#define PMMCTL0     SIM_R16(PMMCTL0)
+#define PMMCTL0_H   (*((volatile unsigned char *)simAccess16(&sim_PMMCTL0) + 1))
+#define PMMCTL2     SIM_R16(PMMCTL2)
+#define SYSCFG0     SIM_R16(SYSCFG0)
+#define SYSCFG2     SIM_R16(SYSCFG2)
+#define SYSRSTIV    SIM_R16(SYSRSTIV)
+#define FRCTL0      SIM_R16(FRCTL0)
+
+// Clock system
+#define CSCTL0      SIM_R16(CSCTL0)
+#define CSCTL1      SIM_R16(CSCTL1)
+#define CSCTL2      SIM_R16(CSCTL2)
+#define CSCTL3      SIM_R16(CSCTL3)
+#define CSCTL4      SIM_R16(CSCTL4)
+#define CSCTL5      SIM_R16(CSCTL5)
+#define CSCTL7      SIM_R16(CSCTL7)
+
+// Digital I/O
+#define P1IN        SIM_R8(P1IN)
+#define P1OUT       SIM_R8(P1OUT)
+#define P1DIR       SIM_R8(P1DIR)
+#define P1REN       SIM_R8(P1REN)
+#define P1SEL0      SIM_R8(P1SEL0)
+#define P1IES       SIM_R8(P1IES)
+#define P1IE        SIM_R8(P1IE)
+#define P1IFG       SIM_R8(P1IFG)
+#define P1IV        SIM_R16(P1IV)
+#define P2IN        SIM_R8(P2IN)
+#define P2OUT       SIM_R8(P2OUT)
+#define P2DIR       SIM_R8(P2DIR)
+#define P2REN       SIM_R8(P2REN)
+#define P2SEL0      SIM_R8(P2SEL0)
+#define P2IES       SIM_R8(P2IES)
+#define P2IE        SIM_R8(P2IE)
+#define P2IFG       SIM_R8(P2IFG)
+#define P2IV        SIM_R16(P2IV)
+#define P5IN        SIM_R8(P5IN)
+#define P5OUT       SIM_R8(P5OUT)
+#define P5DIR       SIM_R8(P5DIR)
+#define P5REN       SIM_R8(P5REN)
+#define P5SEL0      SIM_R8(P5SEL0)
+#define P8IN        SIM_R8(P8IN)
+#define P8OUT       SIM_R8(P8OUT)
+#define P8DIR       SIM_R8(P8DIR)
+#define P8REN       SIM_R8(P8REN)
+#define P8SEL0      SIM_R8(P8SEL0)
+
+// Timer_A0 and Timer_A1
+#define TA0CTL      SIM_R16(TA0CTL)
+#define TA0R        SIM_R16(TA0R)
+#define TA0CCTL0    SIM_R16(TA0CCTL0)
+#define TA0CCTL1    SIM_R16(TA0CCTL1)
+#define TA0CCTL2    SIM_R16(TA0CCTL2)
+#define TA0CCR0     SIM_R16(TA0CCR0)
+#define TA0CCR1     SIM_R16(TA0CCR1)
+#define TA0CCR2     SIM_R16(TA0CCR2)
+#define TA0EX0      SIM_R16(TA0EX0)
+#define TA0IV       SIM_R16(TA0IV)
+#define TA1CTL      SIM_R16(TA1CTL)
+#define TA1R        SIM_R16(TA1R)
+#define TA1CCTL0    SIM_R16(TA1CCTL0)
+#define TA1CCTL1    SIM_R16(TA1CCTL1)
+#define TA1CCTL2    SIM_R16(TA1CCTL2)
+#define TA1CCR0     SIM_R16(TA1CCR0)
+#define TA1CCR1     SIM_R16(TA1CCR1)
+#define TA1CCR2     SIM_R16(TA1CCR2)
+#define TA1EX0      SIM_R16(TA1EX0)
+#define TA1IV       SIM_R16(TA1IV)
+
+// ADC
+#define ADCCTL0     SIM_R16(ADCCTL0)
+#define ADCCTL1     SIM_R16(ADCCTL1)
+#define ADCCTL2     SIM_R16(ADCCTL2)
+#define ADCMCTL0    SIM_R16(ADCMCTL0)
+#define ADCMEM0     SIM_R16(ADCMEM0)
+#define ADCIE       SIM_R16(ADCIE)
+#define ADCIFG      SIM_R16(ADCIFG)
+#define ADCIV       SIM_R16(ADCIV)
+
+// eUSCI_A0 (UART)
+#define UCA0CTLW0   SIM_R16(UCA0CTLW0)
+#define UCA0BRW     SIM_R16(UCA0BRW)
+#define UCA0MCTLW   SIM_R16(UCA0MCTLW)
+#define UCA0STATW   SIM_R16(UCA0STATW)
+#define UCA0TXBUF   SIM_R16(UCA0TXBUF)
+#define UCA0RXBUF   SIM_R16(UCA0RXBUF)
+#define UCA0IE      SIM_R16(UCA0IE)
+#define UCA0IFG     SIM_R16(UCA0IFG)
+#define UCA0IV      SIM_R16(UCA0IV)
+
+/**************************************************************************
+ * Bit definitions (values as in the TI device header)
+ **************************************************************************/
+#define BIT0        (0x0001)
+#define BIT1        (0x0002)
+#define BIT2        (0x0004)
+#define BIT3        (0x0008)
+#define BIT4        (0x0010)
+#define BIT5        (0x0020)
+#define BIT6        (0x0040)
+#define BIT7        (0x0080)
+#define BIT8        (0x0100)
+#define BIT9        (0x0200)
+#define BITA        (0x0400)
+#define BITB        (0x0800)
+#define BITC        (0x1000)
+#define BITD        (0x2000)
+#define BITE        (0x4000)
+#define BITF        (0x8000)
+
+// Status register
+#define GIE         (0x0008)
+#define CPUOFF      (0x0010)
+#define OSCOFF      (0x0020)
+#define SCG0        (0x0040)
+#define SCG1        (0x0080)
+#define LPM0_bits   (CPUOFF)
+#define LPM3_bits   (SCG1 + SCG0 + CPUOFF)
+
+// WDTCTL, PM5CTL0, PMM, SYSCFG, FRCTL0
+#define WDTPW       (0x5A00)
+#define WDTHOLD     (0x0080)
+#define LOCKLPM5    (0x0001)
+#define PMMPW       (0xA500)
+#define PMMPW_H     (0xA5)
+
+// SYSRSTIV reset causes (highest priority first)
+#define SYSRSTIV_NONE     (0x0000)
+#define SYSRSTIV_BOR      (0x0002)
+#define SYSRSTIV_RSTNMI   (0x0004)
+#define SYSRSTIV_DOBOR    (0x0006)
+#define SYSRSTIV_LPM5WU   (0x0008)
+#define SYSRSTIV_SECYV    (0x000A)
+#define SYSRSTIV_SVSHIFG  (0x000E)
+#define SYSRSTIV_DOPOR    (0x0014)
+#define SYSRSTIV_WDTTO    (0x0016)
+#define SYSRSTIV_WDTKEY   (0x0018)
+#define INTREFEN    (0x0001)
+#define TSENSOREN   (0x0008)
+#define FRWPPW      (0xA500)
+#define PFWP        (0x0001)
+#define DFWP        (0x0002)
+#define ADCPCTL0    (0x0001)
+#define ADCPCTL1    (0x0002)
+#define ADCPCTL2    (0x0004)
+#define ADCPCTL3    (0x0008)
+#define ADCPCTL4    (0x0010)
+#define ADCPCTL5    (0x0020)
+#define ADCPCTL6    (0x0040)
+#define ADCPCTL7    (0x0080)
+#define FRCTLPW     (0xA500)
+#define NWAITS_0    (0x0000)
+#define NWAITS_1    (0x0010)
+
+// Clock system
+#define DCORSEL_0   (0x0000)
+#define DCORSEL_1   (0x0002)
+#define DCORSEL_2   (0x0004)
+#define DCORSEL_3   (0x0006)
+#define DCORSEL_4   (0x0008)
+#define DCORSEL_5   (0x000A)
+#define DCORSEL_6   (0x000C)
+#define DCORSEL_7   (0x000E)
+#define FLLD_0      (0x0000)
+#define SELREF__REFOCLK  (0x0010)
+#define FLLUNLOCK0  (0x0100)
+#define FLLUNLOCK1  (0x0200)
+#define SELMS__DCOCLKDIV (0x0000)
+#define SELA__REFOCLK    (0x0100)
+#define DIVM_0      (0x0000)
+#define DIVS_0      (0x0000)
+
+// Timer_A control
+#define TASSEL_0    (0x0000)
+#define TASSEL_1    (0x0100)
+#define TASSEL_2    (0x0200)
+#define TASSEL_3    (0x0300)
+#define ID_0        (0x0000)
+#define ID_1        (0x0040)
+#define ID_2        (0x0080)
+#define ID_3        (0x00C0)
+#define MC_0        (0x0000)
+#define MC_1        (0x0010)
+#define MC_2        (0x0020)
+#define MC_3        (0x0030)
+#define TACLR       (0x0004)
+#define TAIE        (0x0002)
+#define TAIFG       (0x0001)
+#define TAIDEX_0    (0x0000)
+#define TAIDEX_1    (0x0001)
+#define TAIDEX_2    (0x0002)
+#define TAIDEX_3    (0x0003)
+#define TAIDEX_4    (0x0004)
+#define TAIDEX_5    (0x0005)
+#define TAIDEX_6    (0x0006)
+#define TAIDEX_7    (0x0007)
+
+// Timer_A capture/compare control
+#define CM_0        (0x0000)
+#define CM_1        (0x4000)
+#define CM_2        (0x8000)
+#define CM_3        (0xC000)
+#define CCIS_0      (0x0000)
+#define CCIS_1      (0x1000)
+#define CCIS_2      (0x2000)
+#define CCIS_3      (0x3000)
+#define SCS         (0x0800)
+#define CAP         (0x0100)
+#define OUTMOD_0    (0x0000)
+#define OUTMOD_1    (0x0020)
+#define OUTMOD_2    (0x0040)
+#define OUTMOD_3    (0x0060)
+#define OUTMOD_4    (0x0080)
+#define OUTMOD_5    (0x00A0)
+#define OUTMOD_6    (0x00C0)
+#define OUTMOD_7    (0x00E0)
+#define CCIE        (0x0010)
+#define CCI         (0x0008)
+#define OUT         (0x0004)
+#define COV         (0x0002)
+#define CCIFG       (0x0001)
+#define TA0IV_NONE      (0x0000)
+#define TA0IV_TACCR1    (0x0002)
+#define TA0IV_TACCR2    (0x0004)
+#define TA0IV_TAIFG     (0x000E)
+#define TA1IV_NONE      (0x0000)
+#define TA1IV_TACCR1    (0x0002)
+#define TA1IV_TACCR2    (0x0004)
+#define TA1IV_TAIFG     (0x000E)
+
+// ADC
+#define ADCSHT_0    (0x0000)
+#define ADCSHT_1    (0x0100)
+#define ADCSHT_2    (0x0200)
+#define ADCSHT_3    (0x0300)
+#define ADCSHT_4    (0x0400)
+#define ADCSHT_8    (0x0800)
+#define ADCMSC      (0x0080)
+#define ADCON       (0x0010)
+#define ADCENC      (0x0002)
+#define ADCSC       (0x0001)
+#define ADCSHS_0    (0x0000)
+#define ADCSHS_1    (0x0400)
+#define ADCSHS_2    (0x0800)
+#define ADCSHS_3    (0x0C00)
+#define ADCSHP      (0x0200)
+#define ADCCONSEQ_0 (0x0000)
+#define ADCCONSEQ_1 (0x0002)
+#define ADCCONSEQ_2 (0x0004)
+#define ADCCONSEQ_3 (0x0006)
+#define ADCBUSY     (0x0001)
+#define ADCRES      (0x0010)
+#define ADCRES_0    (0x0000)
+#define ADCRES_1    (0x0010)
+#define ADCSREF_0   (0x0000)
+#define ADCSREF_1   (0x0010)
+#define ADCINCH_0   (0x0000)
+#define ADCINCH_4   (0x0004)
+#define ADCINCH_12  (0x000C)
+#define ADCINCH_13  (0x000D)
+#define ADCINCH_15  (0x000F)
+#define ADCIE0      (0x0001)
+#define ADCIFG0     (0x0001)
+#define ADCOVIFG    (0x0010)
+#define ADCIV_NONE      (0x0000)
+#define ADCIV_ADCOVIFG  (0x0002)
+#define ADCIV_ADCIFG    (0x000C)
+
+// eUSCI_A UART
+#define UCSWRST     (0x0001)
+#define UCSSEL__SMCLK (0x0080)
+#define UCOS16      (0x0001)
+#define UCBUSY      (0x0001)
+#define UCRXIE      (0x0001)
+#define UCTXIE      (0x0002)
+#define UCRXIFG     (0x0001)
+#define UCTXIFG     (0x0002)
+#define USCI_NONE          (0x0000)
+#define USCI_UART_UCRXIFG  (0x0002)
+#define USCI_UART_UCTXIFG  (0x0004)
+#define USCI_UART_UCSTTIFG (0x0006)
+#define USCI_UART_UCTXCPTIFG (0x0008)
+
+#endif /* MSP430FR4133_HOST_H_ */
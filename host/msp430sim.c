@@ -0,0 +1,648 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: msp430sim.c
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    An event raised on a flag that software has cleared no longer keeps
+ *    the earlier event's time.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#include <msp430fr4133.h>
+#include <string.h>
+
+/**************************************************************************
+ * Register storage
+ **************************************************************************/
+#define SIM_REG8(name)   volatile unsigned char sim_##name;
+#define SIM_REG16(name)  volatile unsigned short sim_##name;
+#include "msp430sim_regs.h"
+#undef SIM_REG8
+#undef SIM_REG16
+
+/**************************************************************************
+ * ISRs are looked up by name. Weak references leave the entry empty when
+ * the module that defines the ISR is not linked in.
+ **************************************************************************/
+extern void Period_ISR(void) __attribute__((weak));
+extern void Timer_A_ISR(void) __attribute__((weak));
+extern void Timebase_ISR(void) __attribute__((weak));
+extern void ADC_ISR(void) __attribute__((weak));
+extern void Port_1(void) __attribute__((weak));
+extern void USCI_A0_ISR(void) __attribute__((weak));
+
+typedef void (*SimHandler)(void);
+
+/**************************************************************************
+ * Timer_A model state
+ **************************************************************************/
+typedef struct {
+    volatile unsigned short *ctl;
+    volatile unsigned short *r;
+    volatile unsigned short *cctl[3];
+    volatile unsigned short *ccr[3];
+    volatile unsigned short *ex0;
+    volatile unsigned short *iv;
+    unsigned long prescale;           // MCLK cycles towards the next count
+    unsigned long long high[3];       // MCLK cycles each output spent high
+} SimTimer;
+
+static SimTimer timers[2] = {
+    { &sim_TA0CTL, &sim_TA0R, { &sim_TA0CCTL0, &sim_TA0CCTL1, &sim_TA0CCTL2 },
+      { &sim_TA0CCR0, &sim_TA0CCR1, &sim_TA0CCR2 }, &sim_TA0EX0, &sim_TA0IV, 0, { 0, 0, 0 } },
+    { &sim_TA1CTL, &sim_TA1R, { &sim_TA1CCTL0, &sim_TA1CCTL1, &sim_TA1CCTL2 },
+      { &sim_TA1CCR0, &sim_TA1CCR1, &sim_TA1CCR2 }, &sim_TA1EX0, &sim_TA1IV, 0, { 0, 0, 0 } }
+};
+
+static unsigned long long cycleCount;
+static unsigned short statusReg;
+static unsigned short exitStatusReg;    // SR restored when the running ISR returns
+static unsigned char dispatching;
+static unsigned short stackPointer;
+static unsigned long interruptCounts[SIM_VECTOR_COUNT];
+static unsigned char raised[SIM_VECTOR_COUNT];      // Enabled flag pending since raisedAt
+static unsigned long long raisedAt[SIM_VECTOR_COUNT];
+static unsigned long maxLatency[SIM_VECTOR_COUNT];
+static unsigned long lostEvents[SIM_VECTOR_COUNT];
+
+static unsigned char inputs[9];         // Externally driven pin levels, per port
+static unsigned char pulsePort, pulseBit;
+static unsigned long pulseHalfPeriod, pulseCount;
+
+static unsigned int adcInputs[16];
+static unsigned long adcRemaining;      // Cycles left in the running conversion
+static unsigned char adcChannel;        // Channel being converted
+static unsigned char adcSequencing;     // Part way through a channel sequence
+static unsigned char adcTriggered;      // TA1.1 rising edge not yet used
+
+static unsigned long resetCauses;       // Bit per pending SYSRSTIV value / 2
+
+static SimUartSink uartSink;
+static SimPinWatch pinWatch;
+static unsigned char uartTxWritten;     // UCA0TXBUF accessed since the last step
+static unsigned char uartShifting;
+static unsigned char uartShiftByte;
+static unsigned long uartRemaining;     // Cycles left on the byte being shifted
+
+static void simDispatch(void);
+
+/**************************************************************************
+ * Function: simReset
+ **************************************************************************/
+void simReset(void) {
+#define SIM_REG8(name)   sim_##name = 0;
+#define SIM_REG16(name)  sim_##name = 0;
+#include "msp430sim_regs.h"
+#undef SIM_REG8
+#undef SIM_REG16
+
+    sim_WDTCTL = 0x6904;                 // Watchdog running after reset
+    sim_PM5CTL0 = LOCKLPM5;
+    sim_SYSCFG0 = PFWP | DFWP;
+    sim_CSCTL1 = DCORSEL_0 | 0x0001;     // DCO at ~1 MHz
+    sim_CSCTL2 = 31;                     // FLLN = 31
+
+    timers[0].prescale = timers[1].prescale = 0;
+    memset(timers[0].high, 0, sizeof(timers[0].high));
+    memset(timers[1].high, 0, sizeof(timers[1].high));
+
+    cycleCount = 0;
+    statusReg = 0;
+    exitStatusReg = 0;
+    dispatching = 0;
+    stackPointer = SIM_STACK_TOP;
+    memset(interruptCounts, 0, sizeof(interruptCounts));
+    memset(raised, 0, sizeof(raised));
+    memset(maxLatency, 0, sizeof(maxLatency));
+    memset(lostEvents, 0, sizeof(lostEvents));
+
+    memset(inputs, 0xFF, sizeof(inputs)); // Buttons idle high (active low)
+    sim_P1IN = sim_P2IN = sim_P5IN = sim_P8IN = 0xFF;
+    pulseHalfPeriod = 0;
+    pulseCount = 0;
+
+    memset(adcInputs, 0, sizeof(adcInputs));
+    adcRemaining = 0;
+    adcSequencing = 0;
+    adcTriggered = 0;
+    resetCauses = 0;
+
+    sim_UCA0CTLW0 = UCSWRST;
+    sim_UCA0IFG = UCTXIFG;
+    uartTxWritten = 0;
+    uartShifting = 0;
+    uartRemaining = 0;
+}
+
+/**************************************************************************
+ * Function: simCycles
+ **************************************************************************/
+unsigned long long simCycles(void) {
+    return cycleCount;
+}
+
+/**************************************************************************
+ * Function: simRaise
+ * Description:
+ *    Notes an enabled interrupt flag being set at cycle when. If it was
+ *    already set, the event it stood for is lost. If it was clear, any
+ *    earlier event has gone, by dispatch or by software clearing the flag.
+ **************************************************************************/
+static void simRaise(unsigned char vector, unsigned char wasSet, unsigned long long when) {
+    if (wasSet) {
+        lostEvents[vector]++;
+    }
+    if (!raised[vector] || !wasSet) {
+        raised[vector] = 1;
+        raisedAt[vector] = when;
+    }
+}
+
+/**************************************************************************
+ * Function: simTimerCount
+ * Description:
+ *    Advances one timer by a single count, made at cycle when, and
+ *    updates its flags and compare outputs.
+ **************************************************************************/
+static void simTimerCount(SimTimer *t, unsigned long long when) {
+    unsigned short mode = *t->ctl & MC_3;
+    unsigned short period = *t->ccr[0];
+    unsigned char n;
+
+    if (mode == MC_1) {                  // Up mode: 0 to CCR0
+        if (*t->r >= period) {
+            *t->r = 0;
+            *t->ctl |= TAIFG;
+        } else {
+            (*t->r)++;
+        }
+    } else {                             // Continuous mode: 0 to 0xFFFF
+        if (++(*t->r) == 0) {
+            *t->ctl |= TAIFG;
+        }
+    }
+
+    for (n = 0; n < 3; n++) {
+        unsigned short cctl = *t->cctl[n];
+        if (cctl & CAP) continue;
+        if (*t->r == *t->ccr[n]) {
+            if (cctl & CCIE) {
+                unsigned char vector = (t == &timers[0] ? SIM_VECTOR_TIMER0_A0 : SIM_VECTOR_TIMER1_A0) + (n != 0);
+                simRaise(vector, (cctl & CCIFG) != 0, when);
+            }
+            *t->cctl[n] |= CCIFG;
+            if (n != 0 && (cctl & OUTMOD_7) == OUTMOD_7) {
+                *t->cctl[n] &= ~OUT;     // Reset/set: reset at CCRn
+            }
+        }
+        if (n != 0 && (cctl & OUTMOD_7) == OUTMOD_7 && *t->r == period) {
+            if (t == &timers[1] && n == 1 && !(cctl & OUT)) {
+                adcTriggered = 1;        // TA1.1 rising edge, ADCSHS_1 trigger
+            }
+            *t->cctl[n] |= OUT;          // Reset/set: set at CCR0
+        }
+    }
+}
+
+/**************************************************************************
+ * Function: simTimerStep
+ **************************************************************************/
+static void simTimerStep(SimTimer *t, unsigned long cycles) {
+    unsigned short ctl = *t->ctl;
+    unsigned long div;
+    unsigned char n;
+
+    if (ctl & TACLR) {
+        *t->r = 0;
+        *t->ctl &= ~TACLR;
+        t->prescale = 0;
+    }
+    if ((ctl & MC_3) == MC_0) return;
+    if ((ctl & MC_3) == MC_1 && *t->ccr[0] == 0) return;
+
+    div = (1UL << ((ctl & ID_3) >> 6)) * ((*t->ex0 & 0x7) + 1);
+
+    t->prescale += cycles;
+    while (t->prescale >= div) {
+        t->prescale -= div;
+        simTimerCount(t, cycleCount - t->prescale);
+        for (n = 1; n < 3; n++) {
+            if (*t->cctl[n] & OUT) t->high[n] += div;
+        }
+    }
+}
+
+/**************************************************************************
+ * Function: simPortEdge
+ * Description:
+ *    Applies a new level to an input pin, at cycle when, and raises the
+ *    port interrupt flag on the selected edge.
+ **************************************************************************/
+static void simPortEdge(unsigned char port, unsigned char bit, int level, unsigned long long when) {
+    unsigned char old = inputs[port] & bit;
+    volatile unsigned char *ies = 0;
+    volatile unsigned char *ifg = 0;
+
+    if (level) inputs[port] |= bit;
+    else inputs[port] &= ~bit;
+
+    if (port == 1) { ies = &sim_P1IES; ifg = &sim_P1IFG; }
+    if (port == 2) { ies = &sim_P2IES; ifg = &sim_P2IFG; }
+    if (ies == 0 || (old != 0) == (level != 0)) return;
+
+    // IES = 0 flags low-to-high transitions, IES = 1 high-to-low
+    if ((*ies & bit) ? !level : level) {
+        if (port == 1 && (sim_P1IE & bit)) simRaise(SIM_VECTOR_PORT1, (*ifg & bit) != 0, when);
+        *ifg |= bit;
+    }
+}
+
+/**************************************************************************
+ * Function: simInputStep
+ **************************************************************************/
+static void simInputStep(unsigned long cycles) {
+    if (pulseHalfPeriod) {
+        pulseCount += cycles;
+        while (pulseCount >= pulseHalfPeriod) {
+            pulseCount -= pulseHalfPeriod;
+            simPortEdge(pulsePort, pulseBit, !(inputs[pulsePort] & pulseBit), cycleCount - pulseCount);
+        }
+    }
+
+    // PxIN shows outputs for output pins and the driven level otherwise
+    sim_P1IN = (sim_P1OUT & sim_P1DIR) | (inputs[1] & ~sim_P1DIR);
+    sim_P2IN = (sim_P2OUT & sim_P2DIR) | (inputs[2] & ~sim_P2DIR);
+    sim_P5IN = (sim_P5OUT & sim_P5DIR) | (inputs[5] & ~sim_P5DIR);
+    sim_P8IN = (sim_P8OUT & sim_P8DIR) | (inputs[8] & ~sim_P8DIR);
+}
+
+/**************************************************************************
+ * Function: simAdcStep
+ **************************************************************************/
+static void simAdcStep(unsigned long cycles) {
+    unsigned short source = sim_ADCCTL1 & ADCSHS_3;
+    int start;
+
+    if (!(sim_ADCCTL0 & ADCON)) return;
+
+    if (adcRemaining == 0) {
+        if (adcSequencing && (sim_ADCCTL0 & ADCMSC)) {
+            start = 1;                    // Next channel follows at once
+        } else if (!(sim_ADCCTL0 & ADCENC)) {
+            start = 0;
+        } else if (source == ADCSHS_0) {
+            start = (sim_ADCCTL0 & ADCSC) != 0;
+        } else {
+            start = source == ADCSHS_1 && adcTriggered;
+        }
+        if (!start) return;
+        if (!adcSequencing) adcChannel = sim_ADCMCTL0 & 0x0F;
+        sim_ADCCTL0 &= ~ADCSC;            // Start bit clears once sampling starts
+        sim_ADCCTL1 |= ADCBUSY;
+        adcTriggered = 0;
+        adcRemaining = SIM_ADC_CONV_CYCLES;
+        return;
+    }
+    if (cycles < adcRemaining) {
+        adcRemaining -= cycles;
+        return;
+    }
+    if (sim_ADCIE & ADCIE0) {
+        simRaise(SIM_VECTOR_ADC, (sim_ADCIFG & ADCIFG0) != 0, cycleCount - (cycles - adcRemaining));
+    }
+    if (sim_ADCIFG & ADCIFG0) {
+        sim_ADCIFG |= ADCOVIFG;           // Previous result never read
+    }
+    adcRemaining = 0;
+    sim_ADCMEM0 = adcInputs[adcChannel];
+    sim_ADCIFG |= ADCIFG0;
+
+    // Sequence-of-channels mode counts down from ADCINCHx to A0
+    if ((sim_ADCCTL1 & ADCCONSEQ_3) == ADCCONSEQ_1 && adcChannel > 0) {
+        adcChannel--;
+        adcSequencing = 1;
+    } else {
+        adcSequencing = 0;
+        adcTriggered = 0;                 // Edges during a sequence are ignored
+        sim_ADCCTL1 &= ~ADCBUSY;
+    }
+}
+
+/**************************************************************************
+ * Function: simUartByteCycles
+ * Description:
+ *    Ten bit times at the configured baud rate, in MCLK cycles (SMCLK is
+ *    assumed to be MCLK). Fractional modulation is ignored.
+ **************************************************************************/
+static unsigned long simUartByteCycles(void) {
+    unsigned long bit = sim_UCA0BRW ? sim_UCA0BRW : 1;
+
+    if (sim_UCA0MCTLW & UCOS16) {
+        bit = bit * 16 + ((sim_UCA0MCTLW >> 4) & 0x0F);
+    }
+    return bit * 10;
+}
+
+/**************************************************************************
+ * Function: simUartStep
+ **************************************************************************/
+static void simUartStep(unsigned long cycles) {
+    if (sim_UCA0CTLW0 & UCSWRST) {
+        uartTxWritten = 0;
+        uartShifting = 0;
+        sim_UCA0IFG |= UCTXIFG;
+        return;
+    }
+
+    if (uartShifting) {
+        if (cycles < uartRemaining) {
+            uartRemaining -= cycles;
+        } else {
+            uartShifting = 0;
+            sim_UCA0STATW &= ~UCBUSY;
+            if (uartSink) uartSink(uartShiftByte);
+        }
+    }
+
+    // TXBUF moves to the shift register as soon as the last byte is out
+    if (uartTxWritten && !uartShifting) {
+        uartTxWritten = 0;
+        uartShiftByte = (unsigned char)sim_UCA0TXBUF;
+        uartShifting = 1;
+        uartRemaining = simUartByteCycles();
+        sim_UCA0STATW |= UCBUSY;
+        sim_UCA0IFG |= UCTXIFG;
+    }
+}
+
+/**************************************************************************
+ * Function: simAdvance
+ **************************************************************************/
+void simAdvance(unsigned long cycles) {
+    if (pinWatch) pinWatch();           // The last write has landed
+
+    // Long delays are run in short steps so edges and timer events
+    // interleave with ISR dispatch the way they would on the device
+    do {
+        unsigned long step = cycles > SIM_STEP_CYCLES ? SIM_STEP_CYCLES : cycles;
+
+        cycleCount += step;
+        simTimerStep(&timers[0], step);
+        simTimerStep(&timers[1], step);
+        simInputStep(step);
+        simAdcStep(step);
+        simUartStep(step);
+        simDispatch();
+        cycles -= step;
+    } while (cycles);
+}
+
+/**************************************************************************
+ * Function: simTimerVector
+ * Description:
+ *    Resolves the Timer_Ax CCR1/CCR2/TAIFG vector the way TAxIV does,
+ *    clearing the flag being served.
+ **************************************************************************/
+static int simTimerVector(SimTimer *t) {
+    if ((*t->cctl[1] & (CCIE | CCIFG)) == (CCIE | CCIFG)) {
+        *t->cctl[1] &= ~CCIFG;
+        *t->iv = TA0IV_TACCR1;
+        return 1;
+    }
+    if ((*t->cctl[2] & (CCIE | CCIFG)) == (CCIE | CCIFG)) {
+        *t->cctl[2] &= ~CCIFG;
+        *t->iv = TA0IV_TACCR2;
+        return 1;
+    }
+    if ((*t->ctl & (TAIE | TAIFG)) == (TAIE | TAIFG)) {
+        *t->ctl &= ~TAIFG;
+        *t->iv = TA0IV_TAIFG;
+        return 1;
+    }
+    return 0;
+}
+
+/**************************************************************************
+ * Function: simPendingHandler
+ * Description:
+ *    Finds the highest priority pending interrupt that has an ISR linked,
+ *    prepares its vector register and returns the ISR.
+ **************************************************************************/
+static SimHandler simPendingHandler(unsigned char *vector) {
+    unsigned char n;
+
+    if (Period_ISR && (sim_TA0CCTL0 & (CCIE | CCIFG)) == (CCIE | CCIFG)) {
+        sim_TA0CCTL0 &= ~CCIFG;
+        *vector = SIM_VECTOR_TIMER0_A0;
+        return Period_ISR;
+    }
+    if (Timer_A_ISR && simTimerVector(&timers[0])) {
+        *vector = SIM_VECTOR_TIMER0_A1;
+        return Timer_A_ISR;
+    }
+    if (Timebase_ISR && (sim_TA1CCTL0 & (CCIE | CCIFG)) == (CCIE | CCIFG)) {
+        sim_TA1CCTL0 &= ~CCIFG;           // Single-source vector clears on entry
+        *vector = SIM_VECTOR_TIMER1_A0;
+        return Timebase_ISR;
+    }
+    if (USCI_A0_ISR && (sim_UCA0IE & sim_UCA0IFG & UCTXIE)) {
+        *vector = SIM_VECTOR_USCI_A0;
+        return USCI_A0_ISR;
+    }
+    if (ADC_ISR && (sim_ADCIE & sim_ADCIFG & ADCIFG0)) {
+        sim_ADCIV = ADCIV_ADCIFG;
+        *vector = SIM_VECTOR_ADC;
+        return ADC_ISR;
+    }
+    if (Port_1 && (sim_P1IE & sim_P1IFG)) {
+        for (n = 0; n < 8; n++) {
+            if (sim_P1IE & sim_P1IFG & (1 << n)) break;
+        }
+        sim_P1IV = (unsigned short)((n + 1) * 2);
+        *vector = SIM_VECTOR_PORT1;
+        return Port_1;
+    }
+    return 0;
+}
+
+/**************************************************************************
+ * Function: simDispatch
+ **************************************************************************/
+static void simDispatch(void) {
+    SimHandler handler;
+    unsigned char vector;
+
+    while (!dispatching && (statusReg & GIE) && (handler = simPendingHandler(&vector)) != 0) {
+        dispatching = 1;
+        exitStatusReg = statusReg;
+        statusReg &= ~(GIE | LPM3_bits); // ISR runs awake with GIE clear
+
+        if (raised[vector]) {
+            unsigned long latency = (unsigned long)(cycleCount + SIM_ISR_ENTRY_CYCLES - raisedAt[vector]);
+            raised[vector] = 0;           // Events from here on are new
+            if (latency > maxLatency[vector]) maxLatency[vector] = latency;
+        }
+        simAdvance(SIM_ISR_ENTRY_CYCLES);
+        stackPointer -= SIM_ISR_FRAME_BYTES;
+        handler();
+        stackPointer += SIM_ISR_FRAME_BYTES;
+        simAdvance(SIM_ISR_EXIT_CYCLES);
+
+        interruptCounts[vector]++;
+        statusReg = exitStatusReg;        // RETI restores the stacked SR
+        dispatching = 0;
+    }
+}
+
+/**************************************************************************
+ * Register access hooks
+ **************************************************************************/
+volatile unsigned char *simAccess8(volatile unsigned char *reg) {
+    simAdvance(SIM_CYCLES_PER_ACCESS);
+    return reg;
+}
+
+volatile unsigned short *simAccess16(volatile unsigned short *reg) {
+    simAdvance(SIM_CYCLES_PER_ACCESS);
+    if (reg == &sim_ADCMEM0) {
+        sim_ADCIFG &= ~ADCIFG0;           // Reading the result clears the flag
+    }
+    if (reg == &sim_SYSRSTIV) {
+        unsigned char n;                  // Each read takes the next pending cause
+        sim_SYSRSTIV = 0;
+        for (n = 1; n < 32; n++) {
+            if (resetCauses & (1UL << n)) {
+                resetCauses &= ~(1UL << n);
+                sim_SYSRSTIV = n * 2;
+                break;
+            }
+        }
+    }
+    if (reg == &sim_UCA0IV) {
+        sim_UCA0IV = 0;                   // Reading takes and clears the highest pending flag
+        if (sim_UCA0IE & sim_UCA0IFG & UCRXIFG) {
+            sim_UCA0IFG &= ~UCRXIFG;
+            sim_UCA0IV = USCI_UART_UCRXIFG;
+        } else if (sim_UCA0IE & sim_UCA0IFG & UCTXIFG) {
+            sim_UCA0IFG &= ~UCTXIFG;
+            sim_UCA0IV = USCI_UART_UCTXIFG;
+        }
+    }
+    if (reg == &sim_UCA0TXBUF) {
+        sim_UCA0IFG &= ~UCTXIFG;          // Writing TXBUF clears the flag
+        uartTxWritten = 1;
+    }
+    return reg;
+}
+
+/**************************************************************************
+ * Inputs
+ **************************************************************************/
+void simSetInput(unsigned char port, unsigned char bit, int level) {
+    if (port > 8) return;
+    simPortEdge(port, bit, level, cycleCount);
+    simAdvance(0);
+}
+
+void simSetPulseInput(unsigned char port, unsigned char bit, unsigned long periodCycles) {
+    pulsePort = port;
+    pulseBit = bit;
+    pulseHalfPeriod = periodCycles / 2;
+    pulseCount = 0;
+}
+
+void simSetResetCause(unsigned int cause) {
+    if (cause >= 2 && cause < 64) resetCauses |= 1UL << (cause / 2);
+}
+
+void simSetUartSink(SimUartSink sink) {
+    uartSink = sink;
+}
+
+void simSetPinWatch(SimPinWatch watch) {
+    pinWatch = watch;
+}
+
+void simSetAdcInput(unsigned char channel, unsigned int value) {
+    adcInputs[channel & 0x0F] = value;
+}
+
+unsigned long long simTimerHighCycles(unsigned char timer, unsigned char channel) {
+    if (timer > 1 || channel > 2) return 0;
+    return timers[timer].high[channel];
+}
+
+unsigned long simInterruptCount(unsigned char vector) {
+    return vector < SIM_VECTOR_COUNT ? interruptCounts[vector] : 0;
+}
+
+unsigned long simMaxLatency(unsigned char vector) {
+    return vector < SIM_VECTOR_COUNT ? maxLatency[vector] : 0;
+}
+
+unsigned long simLostEvents(unsigned char vector) {
+    return vector < SIM_VECTOR_COUNT ? lostEvents[vector] : 0;
+}
+
+/**************************************************************************
+ * Intrinsics
+ **************************************************************************/
+void __delay_cycles(unsigned long cycles) {
+    simAdvance(cycles);
+}
+
+void __no_operation(void) {
+    simAdvance(1);
+}
+
+void __bis_SR_register(unsigned short bits) {
+    statusReg |= bits;
+    simDispatch();
+
+    // Low power mode: run the peripherals until an ISR clears the bits
+    // on exit. Without GIE nothing could wake the CPU, so return instead.
+    while ((statusReg & CPUOFF) && (statusReg & GIE)) {
+        simAdvance(SIM_CYCLES_PER_ACCESS);
+    }
+    statusReg &= ~LPM3_bits;
+}
+
+void __bic_SR_register(unsigned short bits) {
+    statusReg &= ~bits;
+}
+
+void __bic_SR_register_on_exit(unsigned short bits) {
+    if (dispatching) exitStatusReg &= ~bits;
+    else statusReg &= ~bits;
+}
+
+unsigned short __get_SR_register(void) {
+    return statusReg;
+}
+
+unsigned short __get_SP_register(void) {
+    return stackPointer;
+}
+
+void simSetStackPointer(unsigned short sp) {
+    stackPointer = sp;
+}
+
+unsigned short __get_interrupt_state(void) {
+    return statusReg & GIE;
+}
+
+void __set_interrupt_state(unsigned short state) {
+    statusReg = (statusReg & ~GIE) | (state & GIE);
+    simDispatch();
+}
+
+void __enable_interrupt(void) {
+    statusReg |= GIE;
+    simDispatch();
+}
+
+void __disable_interrupt(void) {
+    statusReg &= ~GIE;
+}
@@ -0,0 +1,224 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: msp430sim.h
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Added the output pin watch.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#ifndef MSP430SIM_H_
+#define MSP430SIM_H_
+
+/**************************************************************************
+ * Host build:
+ *    The host/ directory shadows <msp430fr4133.h> and <intrinsics.h>, so
+ *    the firmware modules compile unchanged on Linux with e.g.
+ *        gcc -Ihost lcd.c pwm.c ... host/msp430sim.c yourMain.c
+ *    (leave out main.c, it has its own main()). Every register access goes
+ *    through the simulator, which advances a virtual cycle counter, runs
+ *    Timer_A0/Timer_A1, the ADC, the UART transmitter and the port
+ *    interrupts, and dispatches ISRs when GIE is set.
+ *
+ * Cycle model:
+ *    Each register access costs SIM_CYCLES_PER_ACCESS cycles, every
+ *    __delay_cycles(n) costs n, and ISR entry/exit cost 6 and 5 cycles.
+ *    Plain C between register accesses is free, so counts are a lower
+ *    bound that tracks register traffic and busy-waits, which is where
+ *    the firmware spends its time. Pending interrupts are checked at least
+ *    every SIM_STEP_CYCLES.
+ **************************************************************************/
+
+#define SIM_CYCLES_PER_ACCESS  3
+#define SIM_ISR_ENTRY_CYCLES   6
+#define SIM_ISR_EXIT_CYCLES    5
+#define SIM_ADC_CONV_CYCLES    200  // Sample + conversion time in MCLK cycles
+#define SIM_STEP_CYCLES        16   // Longest stretch run without checking interrupts
+#define SIM_STACK_TOP          0x2800  // End of RAM, where the stack starts
+#define SIM_ISR_FRAME_BYTES    4    // PC and SR pushed on interrupt entry
+
+// Interrupt vectors handled by the simulator, highest priority first
+enum {
+    SIM_VECTOR_TIMER0_A0,
+    SIM_VECTOR_TIMER0_A1,
+    SIM_VECTOR_TIMER1_A0,
+    SIM_VECTOR_TIMER1_A1,
+    SIM_VECTOR_USCI_A0,
+    SIM_VECTOR_ADC,
+    SIM_VECTOR_PORT1,
+    SIM_VECTOR_PORT2,
+    SIM_VECTOR_COUNT
+};
+
+/**************************************************************************
+ * Function: simReset
+ * Description:
+ *    Puts every simulated register, the cycle counter, the inputs and the
+ *    interrupt state back to their power-on values.
+ **************************************************************************/
+void simReset(void);
+
+/**************************************************************************
+ * Function: simCycles
+ * Description:
+ *    Returns the number of virtual MCLK cycles since simReset().
+ **************************************************************************/
+unsigned long long simCycles(void);
+
+/**************************************************************************
+ * Function: simAdvance
+ * Description:
+ *    Runs the peripherals forward by the given number of MCLK cycles and
+ *    dispatches any interrupts that became pending.
+ * Parameters:
+ *    cycles - Number of MCLK cycles to advance
+ **************************************************************************/
+void simAdvance(unsigned long cycles);
+
+/**************************************************************************
+ * Function: simSetInput
+ * Description:
+ *    Drives an input pin. Edges on port 1/2 pins set PxIFG according to
+ *    PxIES and raise the port interrupt if PxIE is set.
+ * Parameters:
+ *    port - Port number (1 to 8)
+ *    bit - Pin mask (BIT0 to BIT7)
+ *    level - 0 for low, non-zero for high
+ **************************************************************************/
+void simSetInput(unsigned char port, unsigned char bit, int level);
+
+/**************************************************************************
+ * Function: simSetPulseInput
+ * Description:
+ *    Toggles an input pin continuously, e.g. to stand in for the colour
+ *    sensor's frequency output on P1.3. A period of 0 stops the pulses.
+ * Parameters:
+ *    port - Port number (1 to 8)
+ *    bit - Pin mask
+ *    periodCycles - Full pulse period in MCLK cycles
+ **************************************************************************/
+void simSetPulseInput(unsigned char port, unsigned char bit, unsigned long periodCycles);
+
+/**************************************************************************
+ * Function: simSetAdcInput
+ * Description:
+ *    Sets the value the ADC returns for a channel. Channel 12 is the
+ *    on-chip temperature sensor and 13 the internal 1.5 V reference, so
+ *    tests set them to the readings those voltages give against AVCC.
+ * Parameters:
+ *    channel - ADC input channel (0 to 15)
+ *    value - Conversion result
+ **************************************************************************/
+void simSetAdcInput(unsigned char channel, unsigned int value);
+
+/**************************************************************************
+ * Function: simSetResetCause
+ * Description:
+ *    Marks a reset cause pending, as the reset that simReset() stands for
+ *    would. SYSRSTIV then reads each pending cause once, highest priority
+ *    (lowest value) first, then 0. simReset() clears them.
+ * Parameters:
+ *    cause - SYSRSTIV_* value
+ **************************************************************************/
+void simSetResetCause(unsigned int cause);
+
+/**************************************************************************
+ * Function: simSetStackPointer
+ * Description:
+ *    Sets the value __get_SP_register() returns, standing in for how deep
+ *    the code running is in the stack. Each dispatched ISR runs
+ *    SIM_ISR_FRAME_BYTES below it. simReset() puts it at SIM_STACK_TOP.
+ * Parameters:
+ *    sp - Stack pointer address
+ **************************************************************************/
+void simSetStackPointer(unsigned short sp);
+
+/**************************************************************************
+ * Type: SimUartSink
+ * Description:
+ *    Receives each byte the UART finishes shifting out.
+ **************************************************************************/
+typedef void (*SimUartSink)(unsigned char byte);
+
+/**************************************************************************
+ * Function: simSetUartSink
+ * Description:
+ *    Connects the UART TX line to a host function, e.g. a frame decoder
+ *    for a loopback test. A byte takes ten bit times (start, 8 data, stop)
+ *    worked out from UCA0BRW/UCA0MCTLW.
+ * Parameters:
+ *    sink - Function to call per byte, or 0 to discard
+ **************************************************************************/
+void simSetUartSink(SimUartSink sink);
+
+/**************************************************************************
+ * Type: SimPinWatch
+ * Description:
+ *    Called before every register access and time step, so after each
+ *    write to an output has landed, e.g. to decode a parallel bus from
+ *    the sim_PxOUT registers. It must not touch registers through the
+ *    device header itself.
+ **************************************************************************/
+typedef void (*SimPinWatch)(void);
+
+/**************************************************************************
+ * Function: simSetPinWatch
+ * Description:
+ *    Connects a host function that watches the output pins.
+ * Parameters:
+ *    watch - Function to call, or 0 for none
+ **************************************************************************/
+void simSetPinWatch(SimPinWatch watch);
+
+/**************************************************************************
+ * Function: simTimerHighCycles
+ * Description:
+ *    Returns how many MCLK cycles a Timer_A compare output has spent high
+ *    since simReset(). Used to check PWM duty cycles.
+ * Parameters:
+ *    timer - 0 for Timer_A0, 1 for Timer_A1
+ *    channel - CCR number (1 or 2)
+ **************************************************************************/
+unsigned long long simTimerHighCycles(unsigned char timer, unsigned char channel);
+
+/**************************************************************************
+ * Function: simInterruptCount
+ * Description:
+ *    Returns how many times a vector has been dispatched since simReset().
+ * Parameters:
+ *    vector - One of the SIM_VECTOR_* values
+ **************************************************************************/
+unsigned long simInterruptCount(unsigned char vector);
+
+/**************************************************************************
+ * Function: simMaxLatency
+ * Description:
+ *    Returns the longest time, in MCLK cycles, from an enabled interrupt
+ *    flag being raised to its ISR being entered, since simReset(). Flags
+ *    are timed to the cycle they are raised on, not the step boundary.
+ * Parameters:
+ *    vector - One of the SIM_VECTOR_* values
+ **************************************************************************/
+unsigned long simMaxLatency(unsigned char vector);
+
+/**************************************************************************
+ * Function: simLostEvents
+ * Description:
+ *    Returns how many interrupt events arrived while the previous one on
+ *    the same vector was still pending (compare matches, port edges or
+ *    ADC results, the last also setting ADCOVIFG), so were never served.
+ * Parameters:
+ *    vector - One of the SIM_VECTOR_* values
+ **************************************************************************/
+unsigned long simLostEvents(unsigned char vector);
+
+/**************************************************************************
+ * Register access hooks used by the shadow device header. They advance
+ * the cycle counter and bring the peripheral model up to date before
+ * returning the register's storage.
+ **************************************************************************/
+volatile unsigned char *simAccess8(volatile unsigned char *reg);
+volatile unsigned short *simAccess16(volatile unsigned short *reg);
+
+#endif /* MSP430SIM_H_ */
@@ -0,0 +1,94 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: msp430sim_regs.h
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    List of simulated registers. Included with SIM_REG8/SIM_REG16
+ *    defined to declare or define the register storage.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+// 8-bit registers
+SIM_REG8(P1IN)
+SIM_REG8(P1OUT)
+SIM_REG8(P1DIR)
+SIM_REG8(P1REN)
+SIM_REG8(P1SEL0)
+SIM_REG8(P1IES)
+SIM_REG8(P1IE)
+SIM_REG8(P1IFG)
+SIM_REG8(P2IN)
+SIM_REG8(P2OUT)
+SIM_REG8(P2DIR)
+SIM_REG8(P2REN)
+SIM_REG8(P2SEL0)
+SIM_REG8(P2IES)
+SIM_REG8(P2IE)
+SIM_REG8(P2IFG)
+SIM_REG8(P5IN)
+SIM_REG8(P5OUT)
+SIM_REG8(P5DIR)
+SIM_REG8(P5REN)
+SIM_REG8(P5SEL0)
+SIM_REG8(P8IN)
+SIM_REG8(P8OUT)
+SIM_REG8(P8DIR)
+SIM_REG8(P8REN)
+SIM_REG8(P8SEL0)
+
+// 16-bit registers
+SIM_REG16(WDTCTL)
+SIM_REG16(PM5CTL0)
+SIM_REG16(PMMCTL0)
+SIM_REG16(PMMCTL2)
+SIM_REG16(SYSCFG0)
+SIM_REG16(SYSCFG2)
+SIM_REG16(SYSRSTIV)
+SIM_REG16(FRCTL0)
+SIM_REG16(CSCTL0)
+SIM_REG16(CSCTL1)
+SIM_REG16(CSCTL2)
+SIM_REG16(CSCTL3)
+SIM_REG16(CSCTL4)
+SIM_REG16(CSCTL5)
+SIM_REG16(CSCTL7)
+SIM_REG16(P1IV)
+SIM_REG16(P2IV)
+SIM_REG16(TA0CTL)
+SIM_REG16(TA0R)
+SIM_REG16(TA0CCTL0)
+SIM_REG16(TA0CCTL1)
+SIM_REG16(TA0CCTL2)
+SIM_REG16(TA0CCR0)
+SIM_REG16(TA0CCR1)
+SIM_REG16(TA0CCR2)
+SIM_REG16(TA0EX0)
+SIM_REG16(TA0IV)
+SIM_REG16(TA1CTL)
+SIM_REG16(TA1R)
+SIM_REG16(TA1CCTL0)
+SIM_REG16(TA1CCTL1)
+SIM_REG16(TA1CCTL2)
+SIM_REG16(TA1CCR0)
+SIM_REG16(TA1CCR1)
+SIM_REG16(TA1CCR2)
+SIM_REG16(TA1EX0)
+SIM_REG16(TA1IV)
+SIM_REG16(ADCCTL0)
+SIM_REG16(ADCCTL1)
+SIM_REG16(ADCCTL2)
+SIM_REG16(ADCMCTL0)
+SIM_REG16(ADCMEM0)
+SIM_REG16(ADCIE)
+SIM_REG16(ADCIFG)
+SIM_REG16(ADCIV)
+SIM_REG16(UCA0CTLW0)
+SIM_REG16(UCA0BRW)
+SIM_REG16(UCA0MCTLW)
+SIM_REG16(UCA0STATW)
+SIM_REG16(UCA0TXBUF)
+SIM_REG16(UCA0RXBUF)
+SIM_REG16(UCA0IE)
+SIM_REG16(UCA0IFG)
+SIM_REG16(UCA0IV)
@@ -0,0 +1,166 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: profileBench.c
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Initial creation of the hot path cycle benchmark.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+/**************************************************************************
+ * Host build:
+ *    gcc -I. -Ihost -DPROFILE_ENABLED=1 host/profileBench.c profile.c \
+ *        lcd.c colourSensor.c colourCal.c lightIntensity.c lightStats.c \
+ *        adcSequence.c GasSpectra.c colours.c dither.c pwm.c timebase.c \
+ *        clock.c memUsage.c host/msp430sim.c -o profileBench
+ *
+ * Runs the hot paths on the simulator through their PROFILE_* regions:
+ *    LCD text       - lcdDisplayText() with two new lines
+ *    colour detect  - Colour_Detect() against a pulse train on P1.3
+ *    ADC to %       - blockingReadADC() then adcValueToPercentage()
+ *    spectrum       - displayGasSpectrum() of every gas
+ * and prints the cycle table of every region, ISRs included, with the
+ * host time per call alongside. The simulator charges register accesses
+ * and delays, not arithmetic, so a region that only computes (the
+ * percentage) shows what it costs on the host instead.
+ *
+ * Checks that each region counted every call and that its total agrees
+ * with the simulator's own cycle count for the calls, to the marker
+ * overhead and one timer count per call, so a hot path that slows down
+ * shows as a change in the table. Exits non-zero on any failure.
+ **************************************************************************/
+
+#include "msp430sim.h"
+#include "../profile.h"
+#include "../lcd.h"
+#include "../colourSensor.h"
+#include "../lightIntensity.h"
+#include "../GasSpectra.h"
+#include "../pwm.h"
+#include "../timebase.h"
+#include "../clock.h"
+#include <msp430fr4133.h>
+#include <stdio.h>
+#include <time.h>
+
+#define LCD_CALLS       20
+#define DETECT_CALLS    3
+#define PERCENT_CALLS   1000
+#define PULSE_PERIOD    1200     // Cycles, a 13.3 kHz colour sensor output
+#define LIGHT_ADC       612
+
+typedef struct {
+    const char *name;
+    unsigned char region;
+    unsigned int calls;          // Made by the bench, 0 for ISRs
+    unsigned long long simCycles;
+    double hostNs;
+} Row;
+
+static Row rows[] = {
+    { "LCD text", PROFILE_LCD_TEXT, 0, 0, 0 },
+    { "colour detect", PROFILE_COLOUR_DETECT, 0, 0, 0 },
+    { "ADC to %", PROFILE_ADC_PERCENT, 0, 0, 0 },
+    { "spectrum", PROFILE_SPECTRUM, 0, 0, 0 },
+    { "Timer_A_ISR", PROFILE_PWM_ISR, 0, 0, 0 },
+    { "Port_1", PROFILE_PORT1_ISR, 0, 0, 0 },
+    { "Timebase_ISR", PROFILE_TICK_ISR, 0, 0, 0 },
+    { "ADC_ISR", PROFILE_ADC_ISR, 0, 0, 0 },
+};
+#define ROWS (sizeof(rows) / sizeof(rows[0]))
+
+static struct timespec hostStart;
+static unsigned long long simStart;
+
+static void begin(void) {
+    simStart = simCycles();
+    clock_gettime(CLOCK_MONOTONIC, &hostStart);
+}
+
+static void end(Row *row) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    row->simCycles += simCycles() - simStart;
+    row->hostNs += (now.tv_sec - hostStart.tv_sec) * 1e9 + (now.tv_nsec - hostStart.tv_nsec);
+    row->calls++;
+}
+
+int main(void) {
+    static char line1[17], line2[17];
+    unsigned int i, failures = 0;
+    int percentage = 0;
+
+    simReset();
+    WDTCTL = WDTPW | WDTHOLD;
+    PM5CTL0 &= ~LOCKLPM5;
+    clockInit();
+    timebaseInit();
+    profileInit();
+    lcdInit();
+    setupGPIO();
+    setupPWM();
+    setupTimerForSWPWM();
+    initADC();
+    initialiseColourSensor();
+    simSetPulseInput(1, BIT3, PULSE_PERIOD);
+    simSetAdcInput(4, LIGHT_ADC);
+
+    for (i = 0; i < LCD_CALLS; i++) {
+        sprintf(line1, "Transit %u", i);
+        sprintf(line2, "Depth %u.%u%%", i / 10, i % 10);
+        begin();
+        lcdDisplayText(line1, line2);
+        end(&rows[0]);
+    }
+    for (i = 0; i < DETECT_CALLS; i++) {
+        begin();
+        Colour_Detect();
+        end(&rows[1]);
+    }
+    // Only the conversion is the region; the read gives it a real input
+    for (i = 0; i < PERCENT_CALLS; i++) {
+        unsigned int adcValue = blockingReadADC();
+        begin();
+        percentage += adcValueToPercentage(adcValue, 100, 900);
+        end(&rows[2]);
+    }
+    for (i = 0; i < (unsigned int)gasSpectraSize; i++) {
+        begin();
+        displayGasSpectrum(gasSpectra[i].name);
+        end(&rows[3]);
+    }
+
+    printf("%lu cycles per timer count, %lu MCLK, marker overhead taken off every region\n",
+           (unsigned long)PROFILE_RESOLUTION_CYCLES, (unsigned long)CLOCK_MCLK_HZ);
+    printf("%-14s %6s %10s %10s %10s %12s %12s %10s\n", "region", "count", "min", "mean", "max",
+           "total", "simulated", "host ns");
+    for (i = 0; i < ROWS; i++) {
+        Row *row = &rows[i];
+        ProfileStats stats;
+        int ok = 1;
+
+        profileGet(row->region, &stats);
+        if (row->calls) {
+            // Each call's two stamps are good to a count, the markers cost
+            // a little more than they do in profileInit() (a function call)
+            unsigned long long slack = (unsigned long long)row->calls * 4 * PROFILE_RESOLUTION_CYCLES;
+            ok = stats.count == row->calls && stats.totalCycles <= row->simCycles + slack &&
+                 stats.totalCycles + slack >= row->simCycles;
+            printf("%-14s %6u %10lu %10lu %10lu %12lu %12llu %10.0f%s\n", row->name, stats.count,
+                   stats.minCycles, stats.meanCycles, stats.maxCycles, stats.totalCycles, row->simCycles,
+                   row->hostNs / row->calls, ok ? "" : "  <-- FAIL");
+        } else {
+            printf("%-14s %6u %10lu %10lu %10lu %12lu %12s %10s\n", row->name, stats.count,
+                   stats.minCycles, stats.meanCycles, stats.maxCycles, stats.totalCycles, "-", "-");
+        }
+        if (!ok) failures++;
+    }
+    printf("ISRs took %lu cycles from the main loop (%.1f%% of %llu)\n", profileIsrCycles(),
+           100.0 * profileIsrCycles() / simCycles(), simCycles());
+    printf("(light reading %u%% on average)\n", percentage / PERCENT_CALLS);
+
+    printf("%u failure(s)\n", failures);
+    return failures != 0;
+}
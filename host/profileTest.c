@@ -0,0 +1,145 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: profileTest.c
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Initial creation of the profiling marker check.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+/**************************************************************************
+ * Host build:
+ *    gcc -I. -Ihost -DPROFILE_ENABLED=1 host/profileTest.c profile.c \
+ *        timebase.c clock.c memUsage.c host/msp430sim.c -o profileTest
+ *
+ * Runs profile.c on the simulator with the system tick running. Checks:
+ *    - an empty region reads at most one timer count, so the marker
+ *      overhead is taken off
+ *    - a region of a known length (__delay_cycles(), short of a count up
+ *      to many ticks long) reads that length to a count, from every phase
+ *      of the timer, against the simulator's cycle count for the region
+ *      less the markers' own register reads
+ *    - once the call count stops at 0xFFFF the total stops with it, so
+ *      the mean stays the mean of the calls counted
+ * Exits non-zero on any failure.
+ **************************************************************************/
+
+#include "msp430sim.h"
+#include "../profile.h"
+#include "../timebase.h"
+#include "../clock.h"
+#include <msp430fr4133.h>
+#include <intrinsics.h>
+#include <stdio.h>
+
+#define REGION      PROFILE_LCD_TEXT
+#define PHASES      32           // Start offsets per length, over one count
+#define EMPTY_RUNS  1000
+#define MARKER_READS_CYCLES  12  // TA1R and TA1CCTL0 read by each marker, outside its stamp
+
+static unsigned int failures = 0;
+
+static void check(int ok, const char *what) {
+    printf("  %-66s %s\n", what, ok ? "ok" : "<-- FAIL");
+    if (!ok) failures++;
+}
+
+/**************************************************************************
+ * Function: start
+ * Description:
+ *    Resets the simulator and starts the tick and the profiler.
+ **************************************************************************/
+static void start(void) {
+    simReset();
+    WDTCTL = WDTPW | WDTHOLD;
+    PM5CTL0 &= ~LOCKLPM5;
+    clockInit();
+    timebaseInit();
+    profileInit();
+    __bis_SR_register(GIE);
+}
+
+static void checkEmpty(void) {
+    ProfileStats stats;
+    unsigned int i;
+    char what[96];
+
+    start();
+    for (i = 0; i < EMPTY_RUNS; i++) {
+        simAdvance(i % PROFILE_RESOLUTION_CYCLES + 1);
+        PROFILE_BEGIN(REGION);
+        PROFILE_END(REGION);
+    }
+    profileGet(REGION, &stats);
+    sprintf(what, "empty region: max %lu cycles, total %lu over %u", stats.maxCycles, stats.totalCycles, stats.count);
+    check(stats.count == EMPTY_RUNS && stats.maxCycles <= PROFILE_RESOLUTION_CYCLES &&
+          stats.totalCycles <= (unsigned long)EMPTY_RUNS * PROFILE_RESOLUTION_CYCLES / 2, what);
+}
+
+static void checkLengths(void) {
+    static const unsigned long lengths[] = { 10, 100, 1000, 15984, 16000, 100000, 1000000 };
+    unsigned char n;
+    char what[96];
+
+    for (n = 0; n < sizeof(lengths) / sizeof(lengths[0]); n++) {
+        long worst = 0;
+        unsigned int phase;
+
+        start();
+        for (phase = 0; phase < PHASES; phase++) {
+            ProfileStats before, after;
+            unsigned long long cycles;
+            long error;
+
+            profileGet(REGION, &before);
+            simAdvance(phase * PROFILE_RESOLUTION_CYCLES / 2 + phase % 7 + 1);
+            cycles = simCycles();
+            PROFILE_BEGIN(REGION);
+            __delay_cycles(lengths[n]);
+            PROFILE_END(REGION);
+            cycles = simCycles() - cycles;
+            profileGet(REGION, &after);
+
+            // The tick ISR may land in the region; it is part of it
+            error = (long)(after.totalCycles - before.totalCycles) - (long)cycles;
+            if (error < 0 ? -error > -worst : error > worst) worst = error;
+        }
+        sprintf(what, "%lu cycle region: worst error %ld cycles over %u phases", lengths[n], worst, PHASES);
+        check(worst <= (long)PROFILE_RESOLUTION_CYCLES && -worst <= (long)PROFILE_RESOLUTION_CYCLES + MARKER_READS_CYCLES,
+              what);
+    }
+}
+
+static void checkSaturation(void) {
+    ProfileStats stats;
+    unsigned long i, total;
+    char what[96];
+
+    start();
+    for (i = 0; i < 0xFFFF; i++) {
+        PROFILE_BEGIN(REGION);
+        __delay_cycles(100);
+        PROFILE_END(REGION);
+    }
+    profileGet(REGION, &stats);
+    total = stats.totalCycles;
+    PROFILE_BEGIN(REGION);
+    __delay_cycles(1000000);
+    PROFILE_END(REGION);
+    profileGet(REGION, &stats);
+    sprintf(what, "saturated at %u calls: total %lu then %lu, mean %lu cycles", stats.count, total,
+            stats.totalCycles, stats.meanCycles);
+    check(stats.count == 0xFFFF && stats.totalCycles == total && stats.meanCycles <= 100 + PROFILE_RESOLUTION_CYCLES &&
+          stats.maxCycles >= 1000000 - PROFILE_RESOLUTION_CYCLES, what);
+}
+
+int main(void) {
+    printf("%lu cycles per timer count, tick period %u counts\n", (unsigned long)PROFILE_RESOLUTION_CYCLES,
+           (unsigned int)TIMEBASE_TICK_PERIOD);
+    checkEmpty();
+    checkLengths();
+    checkSaturation();
+    printf("%u failure(s)\n", failures);
+    return failures != 0;
+}
@@ -0,0 +1,284 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: pwmTest.c
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Other clocks are built by host/clockCheck.sh.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+/**************************************************************************
+ * Host build:
+ *    gcc -I. -Ihost host/pwmTest.c pwm.c timebase.c clock.c memUsage.c \
+ *        host/msp430sim.c -o pwmTest
+ *    (and again with -DPWM_USE_HARDWARE=0 for the software backend;
+ *    host/clockCheck.sh builds both at every CLOCK_MHZ)
+ *
+ * Runs the PWM backend on the simulator and steps through a list of
+ * colours with setRGBDutyCycle(), at uneven times, watching the outputs
+ * like a logic analyser would. A compare latched below the counter would
+ * miss its reset and leave the LED fully on for a period when dimming.
+ *
+ * Hardware backend: colours are staged all over the Timer_A0 and Timer_A1
+ * periods and latched at the next period start of each. Checks that no
+ * compare output (red, green, blue) is on for a whole period unless the
+ * colour before or after the change asks for it.
+ *
+ * Software backend: some colours are replaced before they are latched.
+ * Every Timer_A0 period's red on-time is read from the TA0.1 model and
+ * the green and blue pins after that period's step, and periods are
+ * grouped into frames with the frame hook. Checks that every whole frame
+ * shows exactly one of the colours asked for, in the order asked for
+ * (never a mix of old and new, red included in the first period), and
+ * that red is never fully on below 100.
+ *
+ * Exits non-zero on any failure.
+ **************************************************************************/
+
+#include "msp430sim.h"
+#include "../pwm.h"
+#include "../timebase.h"
+#include "../clock.h"
+#include <msp430fr4133.h>
+#include <intrinsics.h>
+#include <stdio.h>
+
+#define CYCLES_PER_COUNT  (CLOCK_MCLK_HZ / TIMEBASE_TA0_CLK_HZ)
+#define PERIOD_COUNTS     (TIMEBASE_PWM_PERIOD + 1)
+#define FRAME_PERIODS     256
+#define CHANGES           300       // Hardware backend colour changes
+
+typedef struct {
+    unsigned int red, green, blue;
+} Colour;
+
+// High to low on every channel as well as the other way
+static const Colour colours[] = {
+    { 90, 200, 30 }, { 3, 20, 220 }, { 100, 255, 0 }, { 0, 0, 255 },
+    { 60, 128, 64 }, { 2, 1, 2 }, { 95, 250, 240 }, { 1, 0, 0 },
+    { 45, 100, 180 }, { 0, 0, 0 },
+};
+#define COLOURS (sizeof(colours) / sizeof(colours[0]))
+
+#if PWM_USE_HARDWARE
+#define CHANNEL_COMPARE(c, i) ((i) == 0 ? (c)->red : (i) == 1 ? ((c)->green * PERIOD_COUNTS) >> 8 \
+                                                   : ((c)->blue * TIMEBASE_TICK_PERIOD) >> 8)
+
+static const char *const outputNames[] = { "red (TA0.1)", "green (TA0.2)", "blue (TA1.2)" };
+static const unsigned int outputTops[] = { TIMEBASE_PWM_PERIOD, TIMEBASE_PWM_PERIOD, TIMEBASE_TICK_PERIOD - 1 };
+
+/**************************************************************************
+ * Function: checkHardware
+ * Description:
+ *    Changes colour every 1.5 to 3.5 ticks, so colours are staged all over
+ *    both timers' periods, and samples each compare output's OUT bit
+ *    every half count. A period it never goes low in is fully on, which is
+ *    only right when the colour before or after the change asks for it.
+ **************************************************************************/
+static unsigned int checkHardware(void) {
+    unsigned int periods[3] = { 0 }, fullOn[3] = { 0 }, flashes[3] = { 0 };
+    unsigned char wasLow[3] = { 0 };
+    unsigned int change, failures = 0, last0, last1, seed = 12345;
+    const Colour *before = &colours[0];
+    unsigned char i;
+
+    simReset();
+    WDTCTL = WDTPW | WDTHOLD;
+    PM5CTL0 &= ~LOCKLPM5;
+    clockInit();
+    timebaseInit();
+    setupGPIO();
+    setupPWM();
+    setupTimerForSWPWM();
+    __bis_SR_register(GIE);
+
+    last0 = TA0R;
+    last1 = TA1R;
+    for (change = 0; change < CHANGES; change++) {
+        const Colour *c = &colours[change % COLOURS];
+        unsigned long end;
+
+        setRGBDutyCycle(c->red, c->green, c->blue);
+        seed = seed * 25173 + 13849;
+        end = CLOCK_CYCLES_PER_MS * 3 / 2 + seed % (2 * CLOCK_CYCLES_PER_MS);
+        for (; end >= 8; end -= 8) {
+            unsigned int count[3];
+            unsigned char out[3];
+
+            simAdvance(8);
+            count[0] = count[1] = TA0R;
+            count[2] = TA1R;
+            out[0] = (TA0CCTL1 & OUT) != 0;
+            out[1] = (TA0CCTL2 & OUT) != 0;
+            out[2] = (TA1CCTL2 & OUT) != 0;
+            for (i = 0; i < 3; i++) {
+                if (count[i] < (i < 2 ? last0 : last1)) {
+                    if (periods[i]++ && !wasLow[i]) {
+                        fullOn[i]++;
+                        if (CHANNEL_COMPARE(before, i) < outputTops[i] &&
+                            CHANNEL_COMPARE(c, i) < outputTops[i]) flashes[i]++;
+                    }
+                    wasLow[i] = 0;
+                }
+                if (!out[i]) wasLow[i] = 1;
+            }
+            last0 = count[0];
+            last1 = count[2];
+        }
+        before = c;
+    }
+
+    // Red at 100 and green at 255 are meant to be fully on: seeing them
+    // shows full-on periods are caught at all
+    printf("hardware backend, %u colour changes\n", CHANGES);
+    for (i = 0; i < 3; i++) {
+        int bad = flashes[i] || (i < 2 && fullOn[i] == 0);
+        printf("  %-14s %6u periods, %5u fully on, %u of them while dimming%s\n", outputNames[i],
+               periods[i], fullOn[i], flashes[i], bad ? "  <-- FAIL" : "");
+        if (bad) failures++;
+    }
+    return failures;
+}
+
+int main(void) {
+    unsigned int failures = checkHardware();
+
+    printf("%u failure(s)\n", failures);
+    return failures != 0;
+}
+#else
+static volatile unsigned int frames;
+
+/**************************************************************************
+ * Function: countFrame
+ * Description:
+ *    Frame hook, numbers the frames as the ISR starts them.
+ **************************************************************************/
+static void countFrame(void) {
+    frames++;
+}
+
+/**************************************************************************
+ * Function: redCounts
+ * Description:
+ *    Timer counts a red compare value keeps the output on per period:
+ *    set at CCR0, reset at CCR1.
+ **************************************************************************/
+static unsigned int redCounts(unsigned int red) {
+    return red >= TIMEBASE_PWM_PERIOD ? PERIOD_COUNTS : red + 1;
+}
+
+/**************************************************************************
+ * Function: nextPeriod
+ * Description:
+ *    Runs to the next Timer_A0 wrap and returns the red on-time, in
+ *    counts, since the last one. The pins are read back after the step.
+ **************************************************************************/
+static unsigned int nextPeriod(unsigned char *pins) {
+    static unsigned long long lastHigh;
+    static unsigned int lastCarry;
+    unsigned long long high;
+    unsigned int count, carry, last = TA0R;
+
+    while ((count = TA0R) >= last) {
+        last = count;
+        simAdvance(8);
+    }
+    // An ISR may hold the sample past the wrap: take the counts the output
+    // has already been on in the new period back out of this one
+    high = simTimerHighCycles(0, 1);
+    carry = count < TA0CCR1 ? count + 1 : TA0CCR1;
+    *pins = P1OUT;
+    count = (unsigned int)((high - lastHigh + CYCLES_PER_COUNT / 2) / CYCLES_PER_COUNT) + lastCarry - carry;
+    lastHigh = high;
+    lastCarry = carry;
+    return count;
+}
+
+static unsigned int checkSoftware(void) {
+    unsigned int frame, shown = 0, asked = 0, checked = 0, failures = 0;
+    unsigned int periodsLeft, period = 0, frameRed = 0, greenOn = 0, blueOn = 0;
+    unsigned int seed = 12345;
+    unsigned char pins, mixed = 0, fullOn = 0;
+
+    simReset();
+    WDTCTL = WDTPW | WDTHOLD;
+    PM5CTL0 &= ~LOCKLPM5;
+    clockInit();
+    timebaseInit();
+    setupGPIO();
+    setupPWM();
+    setupTimerForSWPWM();
+    pwmSetFrameHook(countFrame);
+    __bis_SR_register(GIE);
+
+    setRGBDutyCycle(colours[0].red, colours[0].green, colours[0].blue);
+    while (frames == 0) nextPeriod(&pins);
+    frame = frames;
+    periodsLeft = 2 * FRAME_PERIODS;
+
+    printf("%u colours, %u periods a frame\n", (unsigned int)COLOURS, FRAME_PERIODS);
+    while (shown < COLOURS - 1 && frames < 4 * COLOURS + 10) {
+        unsigned int red = nextPeriod(&pins);
+
+        if (frames != frame) {
+            // A whole frame ended: it must show the colour shown before or
+            // a later one asked for (one replaced before its frame is skipped)
+            if (period == FRAME_PERIODS) {
+                unsigned int c;
+                for (c = shown; c <= asked; c++) {
+                    if (redCounts(colours[c].red) == frameRed && colours[c].green == greenOn &&
+                        colours[c].blue == blueOn) break;
+                }
+                checked++;
+                if (c > asked || mixed) {
+                    printf("frame %u: red %u green %u blue %u%s is none of colours %u to %u  <-- FAIL\n",
+                           frame, frameRed, greenOn, blueOn, mixed ? " (red varies)" : "", shown, asked);
+                    failures++;
+                } else {
+                    if (fullOn && colours[c].red < TIMEBASE_PWM_PERIOD) {
+                        printf("frame %u: red fully on for a period, asked for %u  <-- FAIL\n",
+                               frame, colours[c].red);
+                        failures++;
+                    }
+                    shown = c;
+                }
+            }
+            frame = frames;
+            period = greenOn = blueOn = 0;
+            mixed = fullOn = 0;
+        }
+
+        // Red latches as the frame's first period starts: all match
+        if (period == 0) frameRed = red;
+        else if (red != frameRed) mixed = 1;
+        if (red >= PERIOD_COUNTS) fullOn = 1;
+        if (pins & BIT6) greenOn++;
+        if (pins & BIT5) blueOn++;
+        period++;
+
+        // Next colour after an uneven number of periods
+        if (--periodsLeft == 0 && asked < COLOURS - 1) {
+            asked++;
+            setRGBDutyCycle(colours[asked].red, colours[asked].green, colours[asked].blue);
+            seed = seed * 25173 + 13849;
+            periodsLeft = 60 + seed % (2 * FRAME_PERIODS);
+        }
+    }
+
+    printf("%u whole frames checked, showed colour %u of %u last\n", checked, shown + 1, (unsigned int)COLOURS);
+    if (shown != COLOURS - 1) {
+        printf("the last colour never showed  <-- FAIL\n");
+        failures++;
+    }
+    return failures;
+}
+
+int main(void) {
+    unsigned int failures = checkSoftware();
+
+    printf("%u failure(s)\n", failures);
+    return failures != 0;
+}
+#endif
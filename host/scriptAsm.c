@@ -0,0 +1,442 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: scriptAsm.c
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Added marquee.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#include "scriptAsm.h"
+#include "../GasSpectra.h"
+#include <ctype.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ASM_MAX_LABELS  64
+#define ASM_MAX_FIXUPS  128
+#define ASM_NAME_MAX    32
+
+// Same order as namedColours[] in script.c
+static const char *const colourNames[] = {
+    "off", "lilac", "purple", "lightBlue", "nBlue", "cyan", "turquoise",
+    "nGreen", "limeGreen", "yellow", "orange", "pink", "nRed"
+};
+#define COLOUR_NAME_COUNT (sizeof(colourNames) / sizeof(colourNames[0]))
+
+static const char *const opNames[SCRIPT_OP_COUNT] = {
+    "end", "colour", "named", "fade", "wait", "text", "spectrum", "loop", "next", "jump", "if", "marquee"
+};
+
+static const char *const conditionNames[SCRIPT_COND_COUNT] = {
+    "rgb_button", "light_button", "colour_button", "light_below", "colour_is"
+};
+
+static const char *const channelNames[] = { "red", "green", "blue" };
+
+typedef struct {
+    char name[ASM_NAME_MAX];
+    unsigned int address;
+} AsmLabel;
+
+typedef struct {
+    char name[ASM_NAME_MAX];
+    unsigned int at;                // Where the address goes in the output
+    unsigned int line;
+} AsmFixup;
+
+typedef struct {
+    unsigned char *out;
+    unsigned int capacity;
+    unsigned int length;
+    AsmLabel labels[ASM_MAX_LABELS];
+    unsigned int labelCount;
+    AsmFixup fixups[ASM_MAX_FIXUPS];
+    unsigned int fixupCount;
+    unsigned int line;
+    const char *cursor;             // Parse position in the current line
+    const char *lineEnd;
+    char *error;
+    unsigned int errorSize;
+} Assembler;
+
+/**************************************************************************
+ * Function: fail
+ **************************************************************************/
+static int fail(Assembler *as, const char *format, ...) {
+    va_list args;
+    int used;
+
+    used = snprintf(as->error, as->errorSize, "line %u: ", as->line);
+    if (used >= 0 && (unsigned int)used < as->errorSize) {
+        va_start(args, format);
+        vsnprintf(as->error + used, as->errorSize - used, format, args);
+        va_end(args);
+    }
+    return 0;
+}
+
+/**************************************************************************
+ * Function: emit
+ **************************************************************************/
+static int emit(Assembler *as, unsigned int byte) {
+    if (as->length >= as->capacity) return fail(as, "script longer than %u bytes", as->capacity);
+    as->out[as->length++] = (unsigned char)byte;
+    return 1;
+}
+
+static int emit16(Assembler *as, unsigned int value) {
+    return emit(as, value & 0xFF) && emit(as, value >> 8);
+}
+
+/**************************************************************************
+ * Function: skipSpace
+ **************************************************************************/
+static void skipSpace(Assembler *as) {
+    while (as->cursor < as->lineEnd && isspace((unsigned char)*as->cursor)) as->cursor++;
+}
+
+/**************************************************************************
+ * Function: word
+ * Description:
+ *    Reads the next whitespace-delimited word. Returns 0 at end of line.
+ **************************************************************************/
+static int word(Assembler *as, char *text, unsigned int size) {
+    unsigned int n = 0;
+
+    skipSpace(as);
+    if (as->cursor >= as->lineEnd) return 0;
+    while (as->cursor < as->lineEnd && !isspace((unsigned char)*as->cursor)) {
+        if (n + 1 < size) text[n++] = *as->cursor;
+        as->cursor++;
+    }
+    text[n] = '\0';
+    return 1;
+}
+
+/**************************************************************************
+ * Function: number
+ **************************************************************************/
+static int number(Assembler *as, unsigned long max, unsigned int *value, const char *what) {
+    char text[ASM_NAME_MAX], *end;
+    unsigned long parsed;
+
+    if (!word(as, text, sizeof(text))) return fail(as, "missing %s", what);
+    parsed = strtoul(text, &end, 0);
+    if (*end != '\0' || text[0] == '-') return fail(as, "bad %s '%s'", what, text);
+    if (parsed > max) return fail(as, "%s %lu out of range (max %lu)", what, parsed, max);
+    *value = (unsigned int)parsed;
+    return 1;
+}
+
+/**************************************************************************
+ * Function: lookup
+ * Description:
+ *    Finds a name in a table, or -1.
+ **************************************************************************/
+static int lookup(const char *const *names, unsigned int count, const char *name) {
+    unsigned int i;
+
+    for (i = 0; i < count; i++) {
+        if (names[i] && strcmp(names[i], name) == 0) return (int)i;
+    }
+    return -1;
+}
+
+/**************************************************************************
+ * Function: target
+ * Description:
+ *    Reads a label and emits a placeholder address, patched at the end.
+ **************************************************************************/
+static int target(Assembler *as) {
+    AsmFixup *fixup;
+
+    if (as->fixupCount == ASM_MAX_FIXUPS) return fail(as, "too many jumps");
+    fixup = &as->fixups[as->fixupCount];
+    if (!word(as, fixup->name, sizeof(fixup->name))) return fail(as, "missing label");
+    fixup->at = as->length;
+    fixup->line = as->line;
+    as->fixupCount++;
+    return emit16(as, 0);
+}
+
+/**************************************************************************
+ * Function: quoted
+ * Description:
+ *    Emits a quoted string as a length byte and its characters.
+ **************************************************************************/
+static int quoted(Assembler *as, unsigned int max, const char *what) {
+    const char *start;
+    unsigned int n;
+
+    skipSpace(as);
+    if (as->cursor >= as->lineEnd || *as->cursor != '"') return fail(as, "%s needs a quoted string", what);
+    start = ++as->cursor;
+    while (as->cursor < as->lineEnd && *as->cursor != '"') as->cursor++;
+    if (as->cursor >= as->lineEnd) return fail(as, "unterminated string");
+    n = (unsigned int)(as->cursor - start);
+    as->cursor++;
+    if (n > max) return fail(as, "%s longer than %u characters", what, max);
+
+    if (!emit(as, n)) return 0;
+    while (n--) {
+        if (!emit(as, (unsigned char)*start++)) return 0;
+    }
+    return 1;
+}
+
+/**************************************************************************
+ * Function: text
+ **************************************************************************/
+static int text(Assembler *as) {
+    unsigned int row;
+
+    if (!number(as, 1, &row, "row")) return 0;
+    return emit(as, SCRIPT_OP_TEXT) && emit(as, row) && quoted(as, SCRIPT_TEXT_MAX, "text");
+}
+
+/**************************************************************************
+ * Function: condition
+ **************************************************************************/
+static int condition(Assembler *as) {
+    char name[ASM_NAME_MAX];
+    const char *bare = name;
+    unsigned int code, arg = 0;
+    int found;
+
+    if (!word(as, name, sizeof(name))) return fail(as, "missing condition");
+    code = 0;
+    if (name[0] == '!') {
+        code = SCRIPT_COND_NOT;
+        bare = name + 1;
+    }
+    found = lookup(conditionNames, SCRIPT_COND_COUNT, bare);
+    if (found < 0) return fail(as, "unknown condition '%s'", bare);
+    code |= (unsigned int)found;
+
+    if (found == SCRIPT_COND_LIGHT_BELOW) {
+        if (!number(as, 0xFFFF, &arg, "ADC level")) return 0;
+    } else if (found == SCRIPT_COND_COLOUR_IS) {
+        if (!word(as, name, sizeof(name))) return fail(as, "missing channel");
+        found = lookup(channelNames, 3, name);
+        if (found < 0) return fail(as, "unknown channel '%s'", name);
+        arg = (unsigned int)found;
+    }
+    return emit(as, SCRIPT_OP_IF) && emit(as, code) && emit16(as, arg) && target(as);
+}
+
+/**************************************************************************
+ * Function: instruction
+ **************************************************************************/
+static int instruction(Assembler *as, const char *mnemonic) {
+    char name[ASM_NAME_MAX];
+    unsigned int a, b, c, d;
+    int op = lookup(opNames, SCRIPT_OP_COUNT, mnemonic);
+    int found;
+
+    switch (op) {
+        case SCRIPT_OP_END:
+        case SCRIPT_OP_NEXT:
+            return emit(as, op);
+        case SCRIPT_OP_COLOUR:
+            return number(as, 0xFFFF, &a, "red") && number(as, 0xFFFF, &b, "green") &&
+                   number(as, 0xFFFF, &c, "blue") &&
+                   emit(as, op) && emit16(as, a) && emit16(as, b) && emit16(as, c);
+        case SCRIPT_OP_NAMED:
+            if (!word(as, name, sizeof(name))) return fail(as, "missing colour");
+            found = lookup(colourNames, COLOUR_NAME_COUNT, name);
+            if (found < 0) return fail(as, "unknown colour '%s'", name);
+            return emit(as, op) && emit(as, found);
+        case SCRIPT_OP_FADE:
+            return number(as, 0xFFFF, &a, "red") && number(as, 0xFFFF, &b, "green") &&
+                   number(as, 0xFFFF, &c, "blue") && number(as, 0xFFFF, &d, "time") &&
+                   emit(as, op) && emit16(as, a) && emit16(as, b) && emit16(as, c) && emit16(as, d);
+        case SCRIPT_OP_WAIT:
+            return number(as, 0xFFFF, &a, "time") && emit(as, op) && emit16(as, a);
+        case SCRIPT_OP_TEXT:
+            return text(as);
+        case SCRIPT_OP_MARQUEE:
+            return emit(as, op) && quoted(as, SCRIPT_MARQUEE_MAX, "marquee") &&
+                   quoted(as, SCRIPT_MARQUEE_MAX, "marquee");
+        case SCRIPT_OP_SPECTRUM:
+            if (!word(as, name, sizeof(name))) return fail(as, "missing gas");
+            for (found = 0; found < gasSpectraSize; found++) {
+                if (strcmp(gasSpectra[found].name, name) == 0) break;
+            }
+            if (found == gasSpectraSize) return fail(as, "unknown gas '%s'", name);
+            return number(as, 0xFFFF, &a, "time") && emit(as, op) && emit(as, found) && emit16(as, a);
+        case SCRIPT_OP_LOOP:
+            return number(as, 0xFF, &a, "count") && emit(as, op) && emit(as, a);
+        case SCRIPT_OP_JUMP:
+            return emit(as, op) && target(as);
+        case SCRIPT_OP_IF:
+            return condition(as);
+    }
+    return fail(as, "unknown instruction '%s'", mnemonic);
+}
+
+/**************************************************************************
+ * Function: scriptAssemble
+ **************************************************************************/
+int scriptAssemble(const char *source, unsigned char *out, unsigned int capacity,
+                   unsigned int *length, char *error, unsigned int errorSize) {
+    static Assembler as;
+    char first[ASM_NAME_MAX];
+    const char *line = source, *end, *comment;
+    unsigned int i, j, n, bad;
+
+    memset(&as, 0, sizeof(as));
+    as.out = out;
+    as.capacity = capacity;
+    as.error = error;
+    as.errorSize = errorSize;
+
+    while (*line) {
+        as.line++;
+        end = strchr(line, '\n');
+        if (!end) end = line + strlen(line);
+        as.cursor = line;
+        as.lineEnd = end;
+
+        // A ';' outside a string starts a comment
+        for (comment = line, n = 0; comment < end; comment++) {
+            if (*comment == '"') n ^= 1;
+            if (*comment == ';' && !n) {
+                as.lineEnd = comment;
+                break;
+            }
+        }
+
+        while (word(&as, first, sizeof(first))) {
+            n = (unsigned int)strlen(first);
+            if (n > 1 && first[n - 1] == ':') {             // Label, may share a line
+                first[n - 1] = '\0';
+                for (i = 0; i < as.labelCount; i++) {
+                    if (strcmp(as.labels[i].name, first) == 0) return fail(&as, "label '%s' defined twice", first);
+                }
+                if (as.labelCount == ASM_MAX_LABELS) return fail(&as, "too many labels");
+                strcpy(as.labels[as.labelCount].name, first);
+                as.labels[as.labelCount++].address = as.length;
+                continue;
+            }
+            if (!instruction(&as, first)) return 0;
+            if (word(&as, first, sizeof(first))) return fail(&as, "unexpected '%s'", first);
+        }
+        line = *end ? end + 1 : end;
+    }
+
+    // Patch jump addresses now every label is known
+    for (i = 0; i < as.fixupCount; i++) {
+        for (j = 0; j < as.labelCount; j++) {
+            if (strcmp(as.labels[j].name, as.fixups[i].name) == 0) break;
+        }
+        as.line = as.fixups[i].line;
+        if (j == as.labelCount) return fail(&as, "undefined label '%s'", as.fixups[i].name);
+        out[as.fixups[i].at] = as.labels[j].address & 0xFF;
+        out[as.fixups[i].at + 1] = as.labels[j].address >> 8;
+    }
+
+    if (!scriptValidate(out, as.length, &bad)) {
+        snprintf(error, errorSize, "script fails validation at address %u", bad);
+        return 0;
+    }
+    *length = as.length;
+    return 1;
+}
+
+/**************************************************************************
+ * Function: scriptDisassembleOne
+ **************************************************************************/
+unsigned int scriptDisassembleOne(const unsigned char *code, unsigned int length, unsigned int pc,
+                                  char *text, unsigned int textSize) {
+    const unsigned char *ip = code + pc;
+    unsigned int size = scriptLength(code, length, pc);
+    unsigned char condition;
+
+#define U16(p) ((unsigned int)(p)[0] | ((unsigned int)(p)[1] << 8))
+    if (size == 0) {
+        snprintf(text, textSize, "; bad byte 0x%02X", pc < length ? ip[0] : 0);
+        return 0;
+    }
+    switch (ip[0]) {
+        case SCRIPT_OP_COLOUR:
+            snprintf(text, textSize, "colour %u %u %u", U16(ip + 1), U16(ip + 3), U16(ip + 5));
+            break;
+        case SCRIPT_OP_NAMED:
+            if (ip[1] < COLOUR_NAME_COUNT) snprintf(text, textSize, "named %s", colourNames[ip[1]]);
+            else snprintf(text, textSize, "; named %u", ip[1]);
+            break;
+        case SCRIPT_OP_FADE:
+            snprintf(text, textSize, "fade %u %u %u %u", U16(ip + 1), U16(ip + 3), U16(ip + 5), U16(ip + 7));
+            break;
+        case SCRIPT_OP_WAIT:
+            snprintf(text, textSize, "wait %u", U16(ip + 1));
+            break;
+        case SCRIPT_OP_TEXT:
+            snprintf(text, textSize, "text %u \"%.*s\"", ip[1], ip[2], (const char *)ip + 3);
+            break;
+        case SCRIPT_OP_MARQUEE:
+            snprintf(text, textSize, "marquee \"%.*s\" \"%.*s\"", ip[1], (const char *)ip + 2, ip[2 + ip[1]],
+                     (const char *)ip + 3 + ip[1]);
+            break;
+        case SCRIPT_OP_SPECTRUM:
+            if (ip[1] < gasSpectraSize) snprintf(text, textSize, "spectrum %s %u", gasSpectra[ip[1]].name, U16(ip + 2));
+            else snprintf(text, textSize, "; spectrum %u %u", ip[1], U16(ip + 2));
+            break;
+        case SCRIPT_OP_LOOP:
+            snprintf(text, textSize, "loop %u", ip[1]);
+            break;
+        case SCRIPT_OP_JUMP:
+            snprintf(text, textSize, "jump L%u", U16(ip + 1));
+            break;
+        case SCRIPT_OP_IF:
+            condition = ip[1] & ~SCRIPT_COND_NOT;
+            if (condition >= SCRIPT_COND_COUNT) {
+                snprintf(text, textSize, "; if 0x%02X %u L%u", ip[1], U16(ip + 2), U16(ip + 4));
+            } else if (condition == SCRIPT_COND_LIGHT_BELOW) {
+                snprintf(text, textSize, "if %s%s %u L%u", ip[1] & SCRIPT_COND_NOT ? "!" : "",
+                         conditionNames[condition], U16(ip + 2), U16(ip + 4));
+            } else if (condition == SCRIPT_COND_COLOUR_IS) {
+                snprintf(text, textSize, "if %s%s %s L%u", ip[1] & SCRIPT_COND_NOT ? "!" : "",
+                         conditionNames[condition], channelNames[U16(ip + 2) < 2 ? U16(ip + 2) : 2], U16(ip + 4));
+            } else {
+                snprintf(text, textSize, "if %s%s L%u", ip[1] & SCRIPT_COND_NOT ? "!" : "",
+                         conditionNames[condition], U16(ip + 4));
+            }
+            break;
+        default:
+            snprintf(text, textSize, "%s", opNames[ip[0]]);
+            break;
+    }
+#undef U16
+    return size;
+}
+
+/**************************************************************************
+ * Function: scriptDisassemble
+ **************************************************************************/
+int scriptDisassemble(const unsigned char *code, unsigned int length, FILE *out) {
+    static unsigned char isTarget[SCRIPT_MAX_BYTES];
+    char line[160];
+    unsigned int pc, size, address;
+
+    // Find the jump targets first so each gets a label
+    memset(isTarget, 0, sizeof(isTarget));
+    for (pc = 0; pc < length && (size = scriptLength(code, length, pc)) != 0; pc += size) {
+        if (code[pc] == SCRIPT_OP_JUMP || code[pc] == SCRIPT_OP_IF) {
+            address = code[pc] == SCRIPT_OP_JUMP ? code[pc + 1] | (code[pc + 2] << 8)
+                                                 : code[pc + 4] | (code[pc + 5] << 8);
+            if (address < SCRIPT_MAX_BYTES) isTarget[address] = 1;
+        }
+    }
+
+    for (pc = 0; pc < length; pc += size) {
+        if (pc < SCRIPT_MAX_BYTES && isTarget[pc]) fprintf(out, "L%u:\n", pc);
+        size = scriptDisassembleOne(code, length, pc, line, sizeof(line));
+        fprintf(out, "    %-40s ; %04X\n", line, pc);
+        if (size == 0) return 0;
+    }
+    return 1;
+}
@@ -0,0 +1,81 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: scriptAsm.h
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Added marquee.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#ifndef SCRIPTASM_H_
+#define SCRIPTASM_H_
+
+#include "../script.h"
+#include <stdio.h>
+
+/**************************************************************************
+ * Source format, one instruction per line, ';' starts a comment:
+ *
+ *    label:                      defines a jump target
+ *    end
+ *    colour  red green blue      raw duty cycles
+ *    named   nRed                a colour from colours.h by name
+ *    fade    red green blue ms
+ *    wait    ms
+ *    text    row "Up to 16 chars"
+ *    marquee "Line 1" "Line 2"  up to 64 chars each, scrolling if long
+ *    spectrum Helium ms          gas by name from gasSpectra[]
+ *    loop    count               0 repeats for ever
+ *    next
+ *    jump    label
+ *    if      [!]condition [arg] label
+ *
+ * Conditions are rgb_button, light_button, colour_button (no arg),
+ * light_below adc and colour_is red|green|blue. Numbers may be decimal
+ * or 0x hex. The output is checked with scriptValidate().
+ **************************************************************************/
+
+/**************************************************************************
+ * Function: scriptAssemble
+ * Description:
+ *    Assembles source text into bytecode.
+ * Parameters:
+ *    source - Source text, NUL terminated
+ *    out - Destination for the bytecode
+ *    capacity - Size of out (normally SCRIPT_MAX_BYTES)
+ *    length - Set to the bytecode length
+ *    error - Set to a message on failure ("line N: ...")
+ *    errorSize - Size of error
+ * Returns:
+ *    1 on success, 0 on an error.
+ **************************************************************************/
+int scriptAssemble(const char *source, unsigned char *out, unsigned int capacity,
+                   unsigned int *length, char *error, unsigned int errorSize);
+
+/**************************************************************************
+ * Function: scriptDisassembleOne
+ * Description:
+ *    Writes one instruction in source form, jump targets as L<address>.
+ * Parameters:
+ *    code, length - Script
+ *    pc - Address of the instruction
+ *    text - Destination
+ *    textSize - Size of text
+ * Returns:
+ *    Instruction length, 0 if it does not decode.
+ **************************************************************************/
+unsigned int scriptDisassembleOne(const unsigned char *code, unsigned int length, unsigned int pc,
+                                  char *text, unsigned int textSize);
+
+/**************************************************************************
+ * Function: scriptDisassemble
+ * Description:
+ *    Writes a whole script as source that assembles back to the same
+ *    bytes, with a label before every jump target.
+ * Returns:
+ *    1 if every instruction decoded, 0 otherwise.
+ **************************************************************************/
+int scriptDisassemble(const unsigned char *code, unsigned int length, FILE *out);
+
+#endif /* SCRIPTASM_H_ */
@@ -0,0 +1,198 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: scriptTool.c
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Host build now includes dither.c, which setColour() goes through.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+/**************************************************************************
+ * Host build:
+ *    gcc -I. -Ihost host/scriptTool.c host/scriptAsm.c script.c pwm.c dither.c \
+ *        colours.c GasSpectra.c colourSensor.c lcd.c timebase.c clock.c \
+ *        colourCal.c telemetry.c adcSequence.c memUsage.c host/msp430sim.c \
+ *        -o scriptTool
+ *
+ *    scriptTool asm show.txt show.bin    assemble
+ *    scriptTool dis show.bin             disassemble
+ *    scriptTool run show.txt [ms]        run on the simulator
+ *    scriptTool run default [ms]         run the built-in show
+ *
+ * run boots the firmware modules on the simulator, starts the script as
+ * the RGB button would and logs every instruction and every change of
+ * the LED compare registers with the simulated time. It exits non-zero
+ * if the script does not assemble or validate, faults, or is still
+ * running after the time limit (default 60000 ms), so it can sit in a
+ * script's build as a check. Buttons read as released.
+ **************************************************************************/
+
+#include "scriptAsm.h"
+#include "msp430sim.h"
+#include "../pwm.h"
+#include "../lcd.h"
+#include "../clock.h"
+#include "../timebase.h"
+#include <msp430fr4133.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static unsigned char program[SCRIPT_MAX_BYTES];
+static unsigned int programLength;
+static unsigned long instructions;
+
+/**************************************************************************
+ * Function: readFile
+ **************************************************************************/
+static char *readFile(const char *path, long *size) {
+    FILE *file = fopen(path, "rb");
+    char *data;
+
+    if (!file) {
+        perror(path);
+        return 0;
+    }
+    fseek(file, 0, SEEK_END);
+    *size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    data = malloc(*size + 1);
+    if (data && fread(data, 1, *size, file) != (size_t)*size) {
+        free(data);
+        data = 0;
+    }
+    fclose(file);
+    if (data) data[*size] = '\0';
+    return data;
+}
+
+/**************************************************************************
+ * Function: load
+ * Description:
+ *    Loads a script: .bin files as bytecode, anything else as source.
+ **************************************************************************/
+static int load(const char *path) {
+    char error[128];
+    long size;
+    char *data = readFile(path, &size);
+    const char *dot = strrchr(path, '.');
+    int ok;
+
+    if (!data) return 0;
+    if (dot && strcmp(dot, ".bin") == 0) {
+        ok = size <= SCRIPT_MAX_BYTES;
+        if (ok) {
+            memcpy(program, data, size);
+            programLength = (unsigned int)size;
+        } else {
+            fprintf(stderr, "%s: longer than %d bytes\n", path, SCRIPT_MAX_BYTES);
+        }
+    } else {
+        ok = scriptAssemble(data, program, sizeof(program), &programLength, error, sizeof(error));
+        if (!ok) fprintf(stderr, "%s: %s\n", path, error);
+    }
+    free(data);
+    return ok;
+}
+
+/**************************************************************************
+ * Function: simMs
+ **************************************************************************/
+static double simMs(void) {
+    return (double)simCycles() * 1000.0 / CLOCK_MCLK_HZ;
+}
+
+/**************************************************************************
+ * Function: trace
+ **************************************************************************/
+static void trace(unsigned int pc, unsigned char op) {
+    static unsigned int lastPc = 0xFFFF;
+    char text[160];
+
+    if (op == SCRIPT_OP_TEXT && pc == lastPc) return;   // Retry while the LCD queue drains
+    lastPc = pc;
+    scriptDisassembleOne(program, programLength, pc, text, sizeof(text));
+    printf("%10.3f ms  %04X  %s\n", simMs(), pc, text);
+    instructions++;
+}
+
+/**************************************************************************
+ * Function: run
+ **************************************************************************/
+static int run(unsigned long limitMs) {
+    unsigned int red = 0xFFFF, green = 0xFFFF, blue = 0xFFFF;
+    unsigned long ms;
+    unsigned int bad;
+
+    if (!scriptValidate(program, programLength, &bad)) {
+        fprintf(stderr, "script fails validation at address %u\n", bad);
+        return 1;
+    }
+
+    simReset();
+    simSetInput(5, BIT0 | BIT2 | BIT3, 1);           // Buttons released (pulled up)
+    WDTCTL = WDTPW | WDTHOLD;
+    PM5CTL0 &= ~LOCKLPM5;
+    clockInit();
+    timebaseInit();
+    setupGPIO();
+    setupPWM();
+    setupTimerForSWPWM();
+    __bis_SR_register(GIE);
+    lcdInit();
+
+    scriptSetTrace(trace);
+    if (scriptStart(program, programLength) != 1) {
+        fprintf(stderr, "script did not start\n");
+        return 1;
+    }
+
+    for (ms = 0; ms < limitMs && scriptStatus() == SCRIPT_RUNNING; ms++) {
+        simAdvance(CLOCK_CYCLES_PER_MS);
+        if (TA0CCR1 != red || TA0CCR2 != green || TA1CCR2 != blue) {
+            red = TA0CCR1;
+            green = TA0CCR2;
+            blue = TA1CCR2;
+            printf("%10.3f ms        LED CCR red %u green %u blue %u\n", simMs(), red, green, blue);
+        }
+    }
+
+    printf("%lu instructions, %lu ms, %s\n", instructions, ms,
+           scriptStatus() == SCRIPT_IDLE ? "finished" :
+           scriptStatus() == SCRIPT_FAULT ? "fault (loop stack)" : "still running at the limit");
+    return scriptStatus() != SCRIPT_IDLE;
+}
+
+int main(int argc, char **argv) {
+    const unsigned char *stored;
+    FILE *file;
+
+    if (argc >= 4 && strcmp(argv[1], "asm") == 0) {
+        if (!load(argv[2])) return 1;
+        file = fopen(argv[3], "wb");
+        if (!file || fwrite(program, 1, programLength, file) != programLength) {
+            perror(argv[3]);
+            return 1;
+        }
+        fclose(file);
+        printf("%u bytes\n", programLength);
+        return 0;
+    }
+    if (argc >= 3 && strcmp(argv[1], "dis") == 0) {
+        if (!load(argv[2])) return 1;
+        return !scriptDisassemble(program, programLength, stdout);
+    }
+    if (argc >= 3 && strcmp(argv[1], "run") == 0) {
+        if (strcmp(argv[2], "default") == 0) {
+            stored = scriptStored(&programLength);
+            memcpy(program, stored, programLength);
+        } else if (!load(argv[2])) {
+            return 1;
+        }
+        return run(argc >= 4 ? strtoul(argv[3], 0, 0) : 60000);
+    }
+
+    fprintf(stderr, "usage: %s asm in.txt out.bin | dis in.bin | run in.txt|in.bin|default [ms]\n", argv[0]);
+    return 2;
+}
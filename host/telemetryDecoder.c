@@ -0,0 +1,168 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: telemetryDecoder.c
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Defined the frame state machine, printer and stdin dump tool.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#include "telemetryDecoder.h"
+#include <stdio.h>
+#include <string.h>
+
+// Decoder states, in frame order
+enum {
+    DECODE_SYNC0,
+    DECODE_SYNC1,
+    DECODE_TYPE,
+    DECODE_SEQUENCE,
+    DECODE_LENGTH,
+    DECODE_PAYLOAD,
+    DECODE_CRC_HI,
+    DECODE_CRC_LO
+};
+
+/**************************************************************************
+ * Function: telemetryDecoderInit
+ **************************************************************************/
+void telemetryDecoderInit(TelemetryDecoder *decoder, TelemetryFrameHandler handler, void *context) {
+    memset(decoder, 0, sizeof(*decoder));
+    decoder->handler = handler;
+    decoder->context = context;
+    decoder->state = DECODE_SYNC0;
+}
+
+/**************************************************************************
+ * Function: telemetryDecoderFrameDone
+ * Description:
+ *    Checks the sequence number of a good frame and hands it on.
+ **************************************************************************/
+static void telemetryDecoderFrameDone(TelemetryDecoder *decoder) {
+    TelemetryFrame *frame = &decoder->frame;
+
+    if (decoder->haveSequence) {
+        decoder->framesLost += (unsigned char)(frame->sequence - decoder->nextSequence);
+    }
+    decoder->haveSequence = 1;
+    decoder->nextSequence = frame->sequence + 1;
+    decoder->framesGood++;
+
+    if (decoder->handler) decoder->handler(frame, decoder->context);
+}
+
+/**************************************************************************
+ * Function: telemetryDecoderPush
+ **************************************************************************/
+int telemetryDecoderPush(TelemetryDecoder *decoder, unsigned char byte) {
+    TelemetryFrame *frame = &decoder->frame;
+    unsigned int crc;
+
+    switch (decoder->state) {
+        case DECODE_SYNC0:
+            if (byte == TELEMETRY_SYNC0) decoder->state = DECODE_SYNC1;
+            else decoder->bytesSkipped++;
+            break;
+        case DECODE_SYNC1:
+            if (byte == TELEMETRY_SYNC1) {
+                decoder->state = DECODE_TYPE;
+            } else if (byte != TELEMETRY_SYNC0) {
+                decoder->bytesSkipped += 2;
+                decoder->state = DECODE_SYNC0;
+            } else {
+                decoder->bytesSkipped++;      // Could be the start of the real sync
+            }
+            break;
+        case DECODE_TYPE:
+            frame->type = byte;
+            decoder->state = DECODE_SEQUENCE;
+            break;
+        case DECODE_SEQUENCE:
+            frame->sequence = byte;
+            decoder->state = DECODE_LENGTH;
+            break;
+        case DECODE_LENGTH:
+            if (byte > TELEMETRY_MAX_PAYLOAD) {
+                decoder->crcErrors++;
+                decoder->state = DECODE_SYNC0;
+                break;
+            }
+            frame->length = byte;
+            decoder->received = 0;
+            decoder->crc = telemetryCrc16(0xFFFF, &frame->type, 1);
+            decoder->crc = telemetryCrc16(decoder->crc, &frame->sequence, 1);
+            decoder->crc = telemetryCrc16(decoder->crc, &frame->length, 1);
+            decoder->state = byte ? DECODE_PAYLOAD : DECODE_CRC_HI;
+            break;
+        case DECODE_PAYLOAD:
+            frame->payload[decoder->received++] = byte;
+            if (decoder->received == frame->length) {
+                decoder->crc = telemetryCrc16(decoder->crc, frame->payload, frame->length);
+                decoder->state = DECODE_CRC_HI;
+            }
+            break;
+        case DECODE_CRC_HI:
+            decoder->received = byte;         // Payload is done, reuse for the CRC high byte
+            decoder->state = DECODE_CRC_LO;
+            break;
+        case DECODE_CRC_LO:
+            crc = ((unsigned int)decoder->received << 8) | byte;
+            decoder->state = DECODE_SYNC0;
+            if (crc != decoder->crc) {
+                decoder->crcErrors++;
+                return 0;
+            }
+            telemetryDecoderFrameDone(decoder);
+            return 1;
+    }
+    return 0;
+}
+
+/**************************************************************************
+ * Function: telemetryDecoderPrint
+ **************************************************************************/
+void telemetryDecoderPrint(const TelemetryFrame *frame, void *stream) {
+    const unsigned char *p = frame->payload;
+    unsigned long tick = 0;
+    unsigned char i;
+
+    if (frame->length >= 4) {
+        tick = ((unsigned long)p[0] << 24) | ((unsigned long)p[1] << 16) | ((unsigned long)p[2] << 8) | p[3];
+    }
+
+    if (frame->type == TELEMETRY_ADC && frame->length == 6) {
+        fprintf(stream, "%lu adc %u\n", tick, (p[4] << 8) | p[5]);
+    } else if (frame->type == TELEMETRY_RGB && frame->length == 10) {
+        fprintf(stream, "%lu rgb %u %u %u\n", tick,
+                (p[4] << 8) | p[5], (p[6] << 8) | p[7], (p[8] << 8) | p[9]);
+    } else if (frame->type == TELEMETRY_EVENT && frame->length == 7) {
+        fprintf(stream, "%lu event %u %u\n", tick, p[4], (p[5] << 8) | p[6]);
+    } else {
+        fprintf(stream, "type 0x%02X seq %u:", frame->type, frame->sequence);
+        for (i = 0; i < frame->length; i++) fprintf(stream, " %02X", p[i]);
+        fprintf(stream, "\n");
+    }
+}
+
+#ifdef TELEMETRY_DECODER_MAIN
+/**************************************************************************
+ * Function: main
+ * Description:
+ *    Decodes a raw capture from stdin and prints one line per frame,
+ *    followed by the decoder counters on stderr.
+ **************************************************************************/
+int main(void) {
+    TelemetryDecoder decoder;
+    int c;
+
+    telemetryDecoderInit(&decoder, telemetryDecoderPrint, stdout);
+    while ((c = getchar()) != EOF) {
+        telemetryDecoderPush(&decoder, (unsigned char)c);
+    }
+
+    fprintf(stderr, "good %lu, crc errors %lu, lost %lu, skipped %lu\n",
+            decoder.framesGood, decoder.crcErrors, decoder.framesLost, decoder.bytesSkipped);
+    return 0;
+}
+#endif
@@ -0,0 +1,97 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: telemetryDecoder.h
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Host build enables telemetry, which is now off by default.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#ifndef TELEMETRYDECODER_H_
+#define TELEMETRYDECODER_H_
+
+#include "../telemetry.h"
+
+/**************************************************************************
+ * Host build:
+ *    Decodes the byte stream produced by telemetry.c, either from a serial
+ *    capture or straight from simSetUartSink() in a loopback run:
+ *        gcc -I. -Ihost -DTELEMETRY_ENABLED=1 -DTELEMETRY_DECODER_MAIN \
+ *            host/telemetryDecoder.c telemetry.c timebase.c memUsage.c \
+ *            host/msp430sim.c -o telemetryDump
+ *        ./telemetryDump < capture.bin
+ *    The decoder resynchronises on the sync pair after a bad CRC or a
+ *    length that cannot be valid.
+ **************************************************************************/
+
+/**************************************************************************
+ * Structure: TelemetryFrame
+ * Description:
+ *    One decoded frame.
+ **************************************************************************/
+typedef struct {
+    unsigned char type;
+    unsigned char sequence;
+    unsigned char length;
+    unsigned char payload[TELEMETRY_MAX_PAYLOAD];
+} TelemetryFrame;
+
+typedef void (*TelemetryFrameHandler)(const TelemetryFrame *frame, void *context);
+
+/**************************************************************************
+ * Structure: TelemetryDecoder
+ * Description:
+ *    Decoder state and counters.
+ * Members:
+ *    framesGood - Frames with a valid CRC
+ *    crcErrors - Frames dropped for a bad CRC or length
+ *    framesLost - Frames missing according to the sequence numbers
+ *    bytesSkipped - Bytes discarded while hunting for sync
+ **************************************************************************/
+typedef struct {
+    TelemetryFrameHandler handler;
+    void *context;
+    unsigned char state;
+    unsigned char received;
+    unsigned int crc;
+    unsigned char haveSequence;
+    unsigned char nextSequence;
+    TelemetryFrame frame;
+    unsigned long framesGood;
+    unsigned long crcErrors;
+    unsigned long framesLost;
+    unsigned long bytesSkipped;
+} TelemetryDecoder;
+
+/**************************************************************************
+ * Function: telemetryDecoderInit
+ * Description:
+ *    Clears the decoder and sets the function called per good frame.
+ * Parameters:
+ *    decoder - Decoder to initialise
+ *    handler - Frame callback, may be 0
+ *    context - Passed through to the callback
+ **************************************************************************/
+void telemetryDecoderInit(TelemetryDecoder *decoder, TelemetryFrameHandler handler, void *context);
+
+/**************************************************************************
+ * Function: telemetryDecoderPush
+ * Description:
+ *    Feeds one received byte to the decoder.
+ * Parameters:
+ *    decoder - Decoder state
+ *    byte - Received byte
+ * Returns:
+ *    1 if the byte completed a good frame, otherwise 0.
+ **************************************************************************/
+int telemetryDecoderPush(TelemetryDecoder *decoder, unsigned char byte);
+
+/**************************************************************************
+ * Function: telemetryDecoderPrint
+ * Description:
+ *    Writes a decoded frame as one line of text.
+ **************************************************************************/
+void telemetryDecoderPrint(const TelemetryFrame *frame, void *stream);
+
+#endif /* TELEMETRYDECODER_H_ */
@@ -0,0 +1,168 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: telemetryLoopback.c
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Initial creation of the telemetry loopback check.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+/**************************************************************************
+ * Host build:
+ *    gcc -I. -Ihost -DTELEMETRY_ENABLED=1 host/telemetryLoopback.c \
+ *        host/telemetryDecoder.c telemetry.c timebase.c clock.c memUsage.c \
+ *        host/msp430sim.c -o telemetryLoopback
+ *
+ * Runs telemetry.c on the simulator with the UART output fed straight to
+ * the host decoder. Checks that:
+ *    - a frame sent after the buffer has drained and the UART gone idle
+ *      is sent too, several times over, so the transmitter restarts
+ *    - at offered loads from well under to well over the line rate, every
+ *      frame queued arrives with a good CRC, every frame dropped shows as
+ *      a sequence gap, nothing is dropped below the line rate, and above
+ *      it the line is kept at least LINE_USE_MIN busy
+ * and prints the throughput and frame loss at each load. Exits non-zero
+ * on any failure.
+ **************************************************************************/
+
+#include "msp430sim.h"
+#include "telemetryDecoder.h"
+#include "../telemetry.h"
+#include "../timebase.h"
+#include "../clock.h"
+#include <msp430fr4133.h>
+#include <intrinsics.h>
+#include <stdio.h>
+
+#define ADC_FRAME_BYTES  (TELEMETRY_OVERHEAD + 6)
+#define BYTE_CYCLES      (10UL * CLOCK_MCLK_HZ / TELEMETRY_BAUD)
+#define RESTARTS         5
+#define LOAD_MS          500
+#define LINE_USE_MIN     0.95
+
+static const unsigned int loads[] = { 50, 200, 600, 850, 1000, 2000, 5000 };  // Frames per second
+
+static TelemetryDecoder decoder;
+static TelemetryStats startStats;          // The counters run on across start()
+static unsigned long bytesReceived;
+static unsigned int failures = 0;
+
+static void receive(unsigned char byte) {
+    bytesReceived++;
+    telemetryDecoderPush(&decoder, byte);
+}
+
+static void check(int ok, const char *what) {
+    printf("  %-66s %s\n", what, ok ? "ok" : "<-- FAIL");
+    if (!ok) failures++;
+}
+
+/**************************************************************************
+ * Function: start
+ * Description:
+ *    Resets the simulator, the tick, the UART and the decoder.
+ **************************************************************************/
+static void start(void) {
+    simReset();
+    WDTCTL = WDTPW | WDTHOLD;
+    PM5CTL0 &= ~LOCKLPM5;
+    clockInit();
+    timebaseInit();
+    telemetryInit();
+    telemetryGetStats(&startStats);
+    telemetryDecoderInit(&decoder, 0, 0);
+    bytesReceived = 0;
+    simSetUartSink(receive);
+    __bis_SR_register(GIE);
+}
+
+/**************************************************************************
+ * Function: runStats
+ * Description:
+ *    The channel counters since start().
+ **************************************************************************/
+static void runStats(TelemetryStats *stats) {
+    telemetryGetStats(stats);
+    stats->framesQueued -= startStats.framesQueued;
+    stats->framesDropped -= startStats.framesDropped;
+    stats->bytesSent -= startStats.bytesSent;
+}
+
+/**************************************************************************
+ * Function: drain
+ * Description:
+ *    Runs until the UART has sent nothing for a frame's worth of byte
+ *    times, so every byte queued has left or never will.
+ **************************************************************************/
+static void drain(void) {
+    unsigned long idle = 0;
+
+    while (idle < ADC_FRAME_BYTES * BYTE_CYCLES) {
+        unsigned long before = bytesReceived;
+
+        simAdvance(BYTE_CYCLES);
+        idle = bytesReceived == before ? idle + BYTE_CYCLES : 0;
+    }
+}
+
+static void checkRestart(void) {
+    TelemetryStats stats;
+    unsigned int n;
+    char what[96];
+
+    start();
+    for (n = 0; n < RESTARTS; n++) {
+        telemetrySendAdc(n);
+        drain();
+    }
+    runStats(&stats);
+    sprintf(what, "send, drain, send again: %lu of %u frames arrived", decoder.framesGood, RESTARTS);
+    check(decoder.framesGood == RESTARTS && stats.bytesSent == RESTARTS * ADC_FRAME_BYTES &&
+          bytesReceived == stats.bytesSent, what);
+}
+
+static void checkLoad(unsigned int perSecond) {
+    TelemetryStats stats;
+    unsigned long long begin, cycles, sendAt;
+    unsigned long sent = 0, lineBytes;
+    double seconds, lineUse;
+    int ok;
+
+    start();
+    begin = simCycles();
+    sendAt = begin;
+    while (sendAt < begin + (unsigned long long)LOAD_MS * CLOCK_CYCLES_PER_MS) {
+        telemetrySendAdc((unsigned int)sent++);
+        sendAt += CLOCK_MCLK_HZ / perSecond;
+        simAdvance((unsigned long)(sendAt - simCycles()));
+    }
+    cycles = simCycles() - begin;
+    lineBytes = bytesReceived;
+    drain();
+    telemetrySendAdc((unsigned int)sent++);        // Shows any drops at the end as a gap
+    drain();
+
+    runStats(&stats);
+    seconds = (double)cycles / CLOCK_MCLK_HZ;
+    lineUse = (double)lineBytes * BYTE_CYCLES / cycles;
+    ok = decoder.crcErrors == 0 && decoder.bytesSkipped == 0 && decoder.framesGood == stats.framesQueued &&
+         decoder.framesLost == stats.framesDropped && stats.framesQueued + stats.framesDropped == sent &&
+         (perSecond * ADC_FRAME_BYTES * BYTE_CYCLES < CLOCK_MCLK_HZ ? stats.framesDropped == 0
+                                                                     : lineUse >= LINE_USE_MIN);
+    printf("  %5u/s %8lu %8lu %8lu %8lu %10.0f %8.1f%%%s\n", perSecond, sent, decoder.framesGood,
+           stats.framesDropped, decoder.framesLost, lineBytes / seconds, lineUse * 100, ok ? "" : "  <-- FAIL");
+    if (!ok) failures++;
+}
+
+int main(void) {
+    unsigned char n;
+
+    printf("%lu baud, %u byte ADC frames, line carries %.0f frames/s\n", TELEMETRY_BAUD, ADC_FRAME_BYTES,
+           (double)CLOCK_MCLK_HZ / BYTE_CYCLES / ADC_FRAME_BYTES);
+    checkRestart();
+    printf("  %7s %8s %8s %8s %8s %10s %9s\n", "offered", "sent", "good", "dropped", "gaps", "bytes/s", "line use");
+    for (n = 0; n < sizeof(loads) / sizeof(loads[0]); n++) checkLoad(loads[n]);
+    printf("%u failure(s)\n", failures);
+    return failures != 0;
+}
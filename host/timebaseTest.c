@@ -0,0 +1,265 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: timebaseTest.c
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    The PWM divider check allows for the shortest count; a slow clock's
+ *    tick is checked to the nearest whole count.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+/**************************************************************************
+ * Host build:
+ *    gcc -I. -Ihost host/timebaseTest.c timebase.c clock.c memUsage.c \
+ *        host/msp430sim.c -o timebaseTest
+ *
+ * Runs timebase.c on the simulator. Checks that:
+ *    - the tick rate is within RATE_TOLERANCE of TIMEBASE_TICK_HZ, or as
+ *      near as a whole number of counts gets at a slow clock, the PWM
+ *      period rate is the nearest to TIMEBASE_PWM_HZ a divider gives
+ *      without a count shorter than TIMEBASE_COUNT_CYCLES, and the tick
+ *      count and timebaseMicros() keep time with the simulated clock over
+ *      a second
+ *    - a handler at each rate runs exactly ticks / divider times, the
+ *      first one a whole divider after subscribing
+ *    - a handler subscribed from a tick handler, into a slot before or
+ *      after the running one, first runs a whole divider later
+ *    - a handler unsubscribed from a tick handler, its own or a later
+ *      slot, does not run again, not even on that tick
+ *    - TIMEBASE_MAX_SUBSCRIBERS handlers fit, one more is refused, and
+ *      subscribing a handler again reuses its slot
+ * Exits non-zero on any failure.
+ **************************************************************************/
+
+#include "msp430sim.h"
+#include "../timebase.h"
+#include "../clock.h"
+#include <msp430fr4133.h>
+#include <intrinsics.h>
+#include <stdio.h>
+
+#define RATE_TOLERANCE  0.002           // Of the declared rate
+#define HANDLERS        10
+
+#if TIMEBASE_MAX_SUBSCRIBERS >= HANDLERS
+#error "timebaseTest needs more handlers than TIMEBASE_MAX_SUBSCRIBERS"
+#endif
+
+static unsigned int failures = 0;
+
+// Calls per handler and the tick each first ran on
+static unsigned long calls[HANDLERS];
+static unsigned long firstTick[HANDLERS];
+
+static void record(unsigned char n) {
+    if (calls[n]++ == 0) firstTick[n] = timebaseTickCount;
+}
+
+#define HANDLER(n) static void handler##n(void) { record(n); }
+HANDLER(0) HANDLER(1) HANDLER(2) HANDLER(3) HANDLER(4)
+HANDLER(5) HANDLER(6) HANDLER(7) HANDLER(8) HANDLER(9)
+
+static const TickHandler handlers[HANDLERS] = {
+    handler0, handler1, handler2, handler3, handler4,
+    handler5, handler6, handler7, handler8, handler9,
+};
+
+// What the in-tick handlers below do on the tick they act on
+static unsigned long actTick;
+static TickHandler subscribeTarget, unsubscribeTarget;
+
+/**************************************************************************
+ * Function: actingHandler
+ * Description:
+ *    Every tick, counts itself as handler 0 and on actTick subscribes
+ *    and unsubscribes the targets (either may be itself).
+ **************************************************************************/
+static void actingHandler(void) {
+    record(0);
+    if (timebaseTickCount == actTick) {
+        if (subscribeTarget) timebaseSubscribe(subscribeTarget, TIMEBASE_TICK_HZ);
+        if (unsubscribeTarget) timebaseUnsubscribe(unsubscribeTarget);
+    }
+}
+
+static void check(int ok, const char *what) {
+    printf("  %-62s %s\n", what, ok ? "ok" : "<-- FAIL");
+    if (!ok) failures++;
+}
+
+/**************************************************************************
+ * Function: start
+ * Description:
+ *    Resets the simulator, the timebase and the call records.
+ **************************************************************************/
+static void start(void) {
+    unsigned char n;
+
+    simReset();
+    WDTCTL = WDTPW | WDTHOLD;
+    PM5CTL0 &= ~LOCKLPM5;
+    clockInit();
+    timebaseInit();
+    for (n = 0; n < HANDLERS; n++) {
+        timebaseUnsubscribe(handlers[n]);
+        calls[n] = firstTick[n] = 0;
+    }
+    timebaseUnsubscribe(actingHandler);
+    actTick = 0;
+    subscribeTarget = unsubscribeTarget = 0;
+    __bis_SR_register(GIE);
+}
+
+/**************************************************************************
+ * Function: runTicks
+ * Description:
+ *    Runs until timebaseTickCount has gone up by the given number.
+ **************************************************************************/
+static void runTicks(unsigned long ticks) {
+    unsigned long end = timebaseTickCount + ticks;
+
+    while (timebaseTickCount != end) simAdvance(64);
+}
+
+/**************************************************************************
+ * Function: rateError
+ * Description:
+ *    How far the PWM period rate is from TIMEBASE_PWM_HZ with a divider.
+ *    The period is fixed at TIMEBASE_PWM_PERIOD + 1 counts, so the divider
+ *    is all there is to choose. Dividers giving too short a count are out.
+ **************************************************************************/
+static double rateError(unsigned int divider) {
+    double hz = (double)TIMEBASE_SMCLK_HZ / divider / (TIMEBASE_PWM_PERIOD + 1);
+
+    if (divider < TIMEBASE_COUNT_CYCLES) return 1e9;
+    return hz > TIMEBASE_PWM_HZ ? hz - TIMEBASE_PWM_HZ : TIMEBASE_PWM_HZ - hz;
+}
+
+static void checkRates(void) {
+    double tickHz = (double)TIMEBASE_TA1_CLK_HZ / TIMEBASE_TICK_PERIOD;
+    double pwmHz = (double)TIMEBASE_TA0_CLK_HZ / (TIMEBASE_PWM_PERIOD + 1);
+    unsigned int divider = TIMEBASE_ID_DIV(TIMEBASE_TA0_DIV) * TIMEBASE_EX_DIV(TIMEBASE_TA0_DIV);
+    double tolerance = RATE_TOLERANCE;
+    unsigned long long cycles;
+    unsigned long ticks, micros;
+    char what[96];
+
+    // Half a count either way is the best a whole tick period can do
+    if (tolerance < 0.5 / TIMEBASE_TICK_PERIOD) tolerance = 0.5 / TIMEBASE_TICK_PERIOD;
+
+    printf("dividers: SMCLK %lu Hz, timers %lu Hz, tick %.2f Hz, PWM %.1f Hz\n",
+           (unsigned long)TIMEBASE_SMCLK_HZ, (unsigned long)TIMEBASE_TA0_CLK_HZ, tickHz, pwmHz);
+    sprintf(what, "tick rate within %.1f%% of %lu Hz", tolerance * 100, TIMEBASE_TICK_HZ);
+    check(tickHz > TIMEBASE_TICK_HZ * (1 - tolerance) && tickHz < TIMEBASE_TICK_HZ * (1 + tolerance), what);
+    sprintf(what, "PWM period rate the nearest to %lu Hz a divider gives (/%u)", TIMEBASE_PWM_HZ, divider);
+    check(divider == TIMEBASE_TA0_DIV && rateError(divider) <= rateError(divider - 1) &&
+          rateError(divider) <= rateError(divider + 1), what);
+
+    start();
+    cycles = simCycles();
+    ticks = timebaseTicks();
+    micros = timebaseMicros();
+    simAdvance(CLOCK_MCLK_HZ);
+    cycles = simCycles() - cycles;
+    ticks = timebaseTicks() - ticks;
+    micros = timebaseMicros() - micros;
+    printf("  one second: %lu ticks, %lu us by timebaseMicros()\n", ticks, micros);
+    check(ticks + 1 >= (unsigned long)(cycles * tickHz / CLOCK_MCLK_HZ) &&
+          ticks <= (unsigned long)(cycles * tickHz / CLOCK_MCLK_HZ) + 1, "tick count keeps time with the clock");
+    sprintf(what, "timebaseMicros() within %.1f%% of the clock", tolerance * 100);
+    check((double)micros > 1000000.0 * (1 - tolerance) - 2 && (double)micros < 1000000.0 * (1 + tolerance) + 2, what);
+}
+
+static void checkDividers(void) {
+    static const unsigned int rates[] = { 1000, 500, 300, 100, 7, 1 };
+    unsigned char n, count = sizeof(rates) / sizeof(rates[0]);
+    unsigned long ticks = 3 * TIMEBASE_TICK_HZ;
+    char what[96];
+
+    start();
+    for (n = 0; n < count; n++) timebaseSubscribe(handlers[n], rates[n]);
+    runTicks(ticks);
+    for (n = 0; n < count; n++) {
+        unsigned int divider = TIMEBASE_TICK_HZ / rates[n];
+        sprintf(what, "%u Hz: %lu calls in %lu ticks, first on tick %lu", rates[n], calls[n], ticks, firstTick[n]);
+        check(calls[n] == ticks / divider && firstTick[n] == divider, what);
+    }
+}
+
+/**************************************************************************
+ * Function: checkInTick
+ * Description:
+ *    The acting handler takes a slot, the target another; which comes
+ *    first in the table is set by the order they are subscribed in.
+ **************************************************************************/
+static void checkInTick(int targetFirst) {
+    const char *order = targetFirst ? "an earlier" : "a later";
+    char what[96];
+
+    // Subscribe from a tick: handler 1 first runs on the following tick
+    start();
+    if (targetFirst) timebaseSubscribe(handler9, TIMEBASE_TICK_HZ);
+    timebaseSubscribe(actingHandler, TIMEBASE_TICK_HZ);
+    timebaseUnsubscribe(handler9);              // Leaves an earlier slot free
+    actTick = 5;
+    subscribeTarget = handler1;
+    runTicks(10);
+    sprintf(what, "subscribed on tick 5 into %s slot: first runs on %lu", order, firstTick[1]);
+    check(firstTick[1] == 6 && calls[1] == 5, what);
+
+    // Unsubscribe a handler on the tick it is due, from before it or itself
+    start();
+    if (targetFirst) {
+        timebaseSubscribe(handler1, TIMEBASE_TICK_HZ);
+        timebaseSubscribe(actingHandler, TIMEBASE_TICK_HZ);
+        unsubscribeTarget = actingHandler;      // Itself
+    } else {
+        timebaseSubscribe(actingHandler, TIMEBASE_TICK_HZ);
+        timebaseSubscribe(handler1, TIMEBASE_TICK_HZ);
+        unsubscribeTarget = handler1;
+    }
+    actTick = 5;
+    runTicks(10);
+    if (targetFirst) {
+        sprintf(what, "unsubscribed itself on tick 5: %lu calls", calls[0]);
+        check(calls[0] == 5 && calls[1] == 10, what);
+    } else {
+        sprintf(what, "unsubscribed a later slot on tick 5: %lu calls", calls[1]);
+        check(calls[1] == 4 && calls[0] == 10, what);
+    }
+}
+
+static void checkTable(void) {
+    unsigned char n;
+    int slot, full = 1;
+    char what[96];
+
+    start();
+    for (n = 0; n < TIMEBASE_MAX_SUBSCRIBERS; n++) {
+        if (timebaseSubscribe(handlers[n], TIMEBASE_TICK_HZ) != n) full = 0;
+    }
+    sprintf(what, "%u handlers fit", TIMEBASE_MAX_SUBSCRIBERS);
+    check(full, what);
+    check(timebaseSubscribe(handlers[TIMEBASE_MAX_SUBSCRIBERS], TIMEBASE_TICK_HZ) < 0, "one more is refused");
+    slot = timebaseSubscribe(handlers[2], 10);
+    check(slot == 2, "subscribing again reuses the slot");
+    check(timebaseSubscribe(handlers[3], 0) < 0 && timebaseSubscribe(handlers[3], TIMEBASE_TICK_HZ + 1) < 0 &&
+          timebaseSubscribe(0, 10) < 0, "bad rates and handlers are refused");
+    runTicks(1000);
+    sprintf(what, "new rate applies: %lu calls in 1000 ticks at 10 Hz", calls[2]);
+    check(calls[2] == 10 && calls[0] == 1000, what);
+    timebaseUnsubscribe(handlers[5]);
+    check(timebaseSubscribe(handlers[TIMEBASE_MAX_SUBSCRIBERS], TIMEBASE_TICK_HZ) == 5, "a freed slot is taken");
+}
+
+int main(void) {
+    checkRates();
+    printf("subscriptions:\n");
+    checkDividers();
+    checkInTick(0);
+    checkInTick(1);
+    checkTable();
+    printf("%u failure(s)\n", failures);
+    return failures != 0;
+}
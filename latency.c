@@ -0,0 +1,275 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: latency.c
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Added latencyLatch() for the PWM latch, which is not periodic.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#include "latency.h"
+#include <intrinsics.h>
+#include <string.h>
+
+#if LATENCY_ENABLED
+
+/**************************************************************************
+ * Structure: LatencySource
+ * Description:
+ *    Per-source RAM state, in timer counts.
+ * Members:
+ *    running - lastTick/lastCount hold the previous event (timer) or entry
+ *              (stream) time
+ *    reference - Timer sources: the previous latency. Streams: the period,
+ *                Q4, 0 until the first interval of a restart
+ *    settled - Streams: two intervals in a row agreed on the period
+ *    outliers - Streams: intervals in a row off the period by over a quarter
+ **************************************************************************/
+typedef struct {
+    unsigned char running;
+    unsigned char settled;
+    unsigned char outliers;
+    unsigned int lastTick;
+    unsigned int lastCount;
+    unsigned int reference;
+    unsigned int count;
+    unsigned int maxLatency;
+    unsigned long totalLatency;
+    unsigned int maxJitter;
+    unsigned int missed;
+    unsigned int latency[LATENCY_BUCKETS];
+    unsigned int jitter[LATENCY_BUCKETS];
+} LatencySource;
+
+#define LATENCY_LATE_OUTLIERS  2   // Long then short interval around a late entry
+
+static LatencySource sources[LATENCY_SOURCES];
+
+/**************************************************************************
+ * Function: addToHistogram
+ **************************************************************************/
+static void addToHistogram(unsigned int *histogram, unsigned int counts) {
+    unsigned char bucket = 0;
+
+    // log2 bucket, as profile.c
+    while ((counts >> bucket) > 1 && bucket < LATENCY_BUCKETS - 1) bucket++;
+    if (histogram[bucket] != 0xFFFF) histogram[bucket]++;
+}
+
+/**************************************************************************
+ * Function: recordJitter
+ **************************************************************************/
+static void recordJitter(LatencySource *source, unsigned int jitter) {
+    if (jitter > source->maxJitter) source->maxJitter = jitter;
+    addToHistogram(source->jitter, jitter);
+}
+
+/**************************************************************************
+ * Function: recordLatency
+ **************************************************************************/
+static void recordLatency(LatencySource *source, unsigned int latency) {
+    if (source->count != 0xFFFF) {
+        source->count++;
+        source->totalLatency += latency;    // Kept to the entries counted, for the mean
+    }
+    if (latency > source->maxLatency) source->maxLatency = latency;
+    addToHistogram(source->latency, latency);
+}
+
+/**************************************************************************
+ * Function: addMissed
+ **************************************************************************/
+static void addMissed(LatencySource *source, unsigned long missed) {
+    missed += source->missed;
+    source->missed = missed > 0xFFFF ? 0xFFFF : (unsigned int)missed;
+}
+
+/**************************************************************************
+ * Function: sinceLast
+ * Description:
+ *    Timer counts from the source's last time to tick/count.
+ **************************************************************************/
+static unsigned long sinceLast(const LatencySource *source, unsigned int tick, unsigned int count) {
+    return (unsigned long)(unsigned int)(tick - source->lastTick) * TIMEBASE_TICK_PERIOD
+           + count - source->lastCount;
+}
+
+/**************************************************************************
+ * Function: latencyInit
+ **************************************************************************/
+void latencyInit(void) {
+    unsigned short state = __get_interrupt_state();
+
+    __disable_interrupt();
+    memset(sources, 0, sizeof(sources));
+    __set_interrupt_state(state);
+}
+
+/**************************************************************************
+ * Function: latencyTimer
+ **************************************************************************/
+void latencyTimer(unsigned char id, unsigned int count, unsigned int compare, unsigned int top) {
+    LatencySource *source = &sources[id];
+    unsigned int period = top + 1;
+    unsigned int latency, tick, now;
+    unsigned long interval;
+
+    PROFILE_STAMP(tick, now);
+    latency = count >= compare ? count - compare : count + period - compare;
+
+    // Compare time on the tick timeline
+    if (now < latency) {
+        tick--;
+        now += TIMEBASE_TICK_PERIOD;
+    }
+    now -= latency;
+
+    if (source->running) {
+        interval = sinceLast(source, tick, now);
+        if (interval > period + period / 2) {
+            addMissed(source, (interval + period / 2) / period - 1);  // Rare, so the division is fine
+        } else if (interval < period / 2 && source->missed != 0 && source->missed != 0xFFFF) {
+            // The last entry read the counter past the next compare and was
+            // put a period late; the period it counted missed is this one
+            source->missed--;
+        }
+        recordJitter(source, latency > source->reference ? latency - source->reference
+                                                         : source->reference - latency);
+    }
+    source->running = 1;
+    source->lastTick = tick;
+    source->lastCount = now;
+    source->reference = latency;
+    recordLatency(source, latency);
+}
+
+/**************************************************************************
+ * Function: latencyLatch
+ **************************************************************************/
+void latencyLatch(unsigned char id, unsigned int count, unsigned int top) {
+    LatencySource *source = &sources[id];
+    unsigned int latency = count >= top ? 0 : count + 1;   // Raised at top, 0 is a count on
+
+    // Past CCR0 the compares may be written after their match
+    if (latency != 0) addMissed(source, 1);
+    if (source->running) {
+        recordJitter(source, latency > source->reference ? latency - source->reference
+                                                         : source->reference - latency);
+    }
+    source->running = 1;
+    source->reference = latency;
+    recordLatency(source, latency);
+}
+
+/**************************************************************************
+ * Function: latencyStream
+ **************************************************************************/
+void latencyStream(unsigned char id) {
+    LatencySource *source = &sources[id];
+    unsigned int tick, now, intervalQ4, jitterQ4;
+    unsigned long interval;
+    unsigned char running = source->running;
+
+    PROFILE_STAMP(tick, now);
+    interval = running ? sinceLast(source, tick, now) : 0;
+    source->running = 1;
+    source->lastTick = tick;
+    source->lastCount = now;
+    if (source->count != 0xFFFF) source->count++;
+
+    if (!running || interval > LATENCY_GAP_COUNTS) return;   // First of a burst
+    intervalQ4 = (unsigned int)interval << 4;
+    jitterQ4 = intervalQ4 > source->reference ? intervalQ4 - source->reference
+                                              : source->reference - intervalQ4;
+
+    // Settle on a period first: a late entry gives one long interval and
+    // one short one, so a single interval cannot be trusted
+    if (!source->settled) {
+        source->settled = source->reference != 0 && jitterQ4 <= source->reference / 4;
+        source->reference = source->settled ? (source->reference + intervalQ4) / 2 : intervalQ4;
+        return;
+    }
+
+    // Only intervals within a quarter of the period move it; more than a
+    // late entry's two outliers in a row means the rate itself changed
+    if (jitterQ4 <= source->reference / 4) {
+        source->outliers = 0;
+        source->reference = (unsigned int)((int)source->reference + ((int)intervalQ4 - (int)source->reference) / 8);
+    } else if (++source->outliers > LATENCY_LATE_OUTLIERS) {
+        source->settled = 0;
+        source->outliers = 0;
+        source->reference = intervalQ4;
+        return;
+    }
+
+    // Port_1: two periods or more means this entry was over a period late,
+    // and the edges that came in that time found the flag still set
+    if (id == LATENCY_PORT1_ISR && intervalQ4 >= 2 * (unsigned long)source->reference) {
+        addMissed(source, intervalQ4 / source->reference - 1);
+        return;
+    }
+    recordJitter(source, (jitterQ4 + 8) >> 4);
+}
+
+/**************************************************************************
+ * Function: latencyLost
+ **************************************************************************/
+void latencyLost(unsigned char id) {
+    unsigned short state = __get_interrupt_state();
+
+    __disable_interrupt();
+    addMissed(&sources[id], 1);
+    __set_interrupt_state(state);
+}
+
+/**************************************************************************
+ * Function: latencyRestart
+ **************************************************************************/
+void latencyRestart(unsigned char id) {
+    unsigned short state = __get_interrupt_state();
+
+    __disable_interrupt();
+    sources[id].running = 0;
+    sources[id].settled = 0;
+    sources[id].outliers = 0;
+    sources[id].reference = 0;
+    __set_interrupt_state(state);
+}
+
+/**************************************************************************
+ * Function: latencyGet
+ **************************************************************************/
+void latencyGet(unsigned char id, LatencyStats *stats) {
+    LatencySource snapshot;
+    unsigned short state = __get_interrupt_state();
+
+    __disable_interrupt();                 // ISRs may update mid-copy
+    snapshot = sources[id];
+    __set_interrupt_state(state);
+
+    stats->count = snapshot.count;
+    stats->maxLatencyCycles = (unsigned long)snapshot.maxLatency * LATENCY_CYCLES_PER_COUNT;
+    stats->meanLatencyCycles = snapshot.count ? snapshot.totalLatency * LATENCY_CYCLES_PER_COUNT / snapshot.count : 0;
+    stats->maxJitterCycles = (unsigned long)snapshot.maxJitter * LATENCY_CYCLES_PER_COUNT;
+    stats->missed = snapshot.missed;
+    memcpy(stats->latency, snapshot.latency, sizeof(stats->latency));
+    memcpy(stats->jitter, snapshot.jitter, sizeof(stats->jitter));
+}
+
+/**************************************************************************
+ * Function: latencyMissed
+ **************************************************************************/
+unsigned int latencyMissed(void) {
+    unsigned long total = 0;
+    unsigned char i;
+    unsigned short state = __get_interrupt_state();
+
+    __disable_interrupt();
+    for (i = 0; i < LATENCY_SOURCES; i++) total += sources[i].missed;
+    __set_interrupt_state(state);
+
+    return total > 0xFFFF ? 0xFFFF : (unsigned int)total;
+}
+
+#endif /* LATENCY_ENABLED */
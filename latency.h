@@ -0,0 +1,215 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: latency.h
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Added the PWM latch (Period_ISR) as a source of its own, said that
+ *    Timer_A_ISR is the software backend's, and rewrapped the notes.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#ifndef LATENCY_H_
+#define LATENCY_H_
+
+#include <msp430fr4133.h>
+#include "timebase.h"
+#include "profile.h"
+
+/**************************************************************************
+ * Measures how late each ISR starts after the event that raised it, so
+ * ISRs holding each other up (LED flicker, miscounted colour pulses) show
+ * up as numbers. Compiled in with -DLATENCY_ENABLED=1; when disabled the
+ * markers expand to nothing and latency.c compiles to nothing, so calls
+ * to the functions below must sit under #if LATENCY_ENABLED.
+ *
+ * Each ISR's marker is its first statement and works from the timer
+ * counts, one Timer_A count (LATENCY_CYCLES_PER_COUNT MCLK cycles) being
+ * the resolution:
+ *
+ *    Timer sources (Timer_A_ISR on TA0 CCR2, which only the software PWM
+ *    backend has, and Timebase_ISR on TA1 CCR0):
+ *    the counter read on entry, less the compare value, is how long ago
+ *    the compare matched - what a capture at entry would hold, without
+ *    tying up a capture channel. Jitter is the change in latency from
+ *    one entry to the next. The compare time is also placed on the tick
+ *    timeline (PROFILE_STAMP); entries more than one and a half periods
+ *    apart mean a whole PWM period went by with the flag already pending
+ *    and its software PWM step was missed; an ISR more than a period late
+ *    shows as missed periods plus the remainder. A late tick cannot be
+ *    seen this way, the timeline being the tick count itself. The tick
+ *    runs the Timer_A1 period hook (the blue latch) ahead of its marker,
+ *    so a tick with a colour to latch reads that much later.
+ *
+ *    PWM latch (Period_ISR on TA0 CCR0, both backends): only enabled
+ *    while a colour is waiting, so its entries are not periodic and only
+ *    latency and jitter are kept. It must write the compares before the
+ *    count after CCR0, where a compare of 0 matches; an entry that reads
+ *    a count past CCR0 is counted as missed, as its period may have shown
+ *    the old colour or been left fully on.
+ *
+ *    Event streams (Port_1 colour pulses, ADC_ISR per conversion): no
+ *    timer says when the edge or conversion happened, so the entry times
+ *    are stamped on the tick timeline and compared with the stream's
+ *    period, tracked as the average interval once two in a row agree.
+ *    Jitter is the difference from that period; no latency is recorded.
+ *    A Port_1 interval of two periods or more means the ISR came in over
+ *    a period after its edge, and the edges in between found the flag
+ *    still pending and were lost; the count is exact when the entry
+ *    before was prompt. Lost ADC results are flagged by ADCOVIFG instead,
+ *    a conversion being too short for the interval test; being one flag,
+ *    it says a result was overwritten but not how many were. Gaps longer
+ *    than LATENCY_GAP_COUNTS start a new burst (each ADC sequence), and
+ *    LATENCY_RESTART() forgets the period when the pulse rate is expected
+ *    to change (each colour filter).
+ *
+ * The colour timing that used to be its own timer runs from the system
+ * tick, so it is covered by the Timebase_ISR source. host/latencySim.c
+ * runs the ISRs together on the simulator, checks these figures against
+ * the simulator's own and sweeps the interleavings for the worst case.
+ **************************************************************************/
+#ifndef LATENCY_ENABLED
+#define LATENCY_ENABLED 0
+#endif
+
+#define LATENCY_BUCKETS          16  // log2 histogram buckets, last one is open-ended
+#define LATENCY_CYCLES_PER_COUNT PROFILE_RESOLUTION_CYCLES
+#define LATENCY_GAP_COUNTS       TIMEBASE_TICK_PERIOD  // 1 ms without an entry ends a burst
+
+// Measured ISRs
+enum {
+    LATENCY_PWM_ISR,           // Timer_A_ISR (software PWM), TA0 CCR2
+    LATENCY_TICK_ISR,          // Timebase_ISR, TA1 CCR0
+    LATENCY_ADC_ISR,           // ADC_ISR, one entry per conversion
+    LATENCY_PORT1_ISR,         // Port_1 (colour sensor pulses)
+    LATENCY_LATCH_ISR,         // Period_ISR (PWM latch), TA0 CCR0 while armed
+    LATENCY_SOURCES
+};
+
+/**************************************************************************
+ * Structure: LatencyStats
+ * Description:
+ *    Snapshot of one ISR's figures. Times are in MCLK cycles.
+ * Members:
+ *    count - ISR entries seen
+ *    maxLatencyCycles, meanLatencyCycles - From the compare match to the
+ *                entry marker (timer sources only)
+ *    maxJitterCycles - Largest jitter
+ *    missed - PWM periods missed, Port_1 edges lost, ADC overwrites
+ *             (each one or more results) or PWM latches in late
+ *    latency, jitter - latency[n] and jitter[n] count values of 2^n to
+ *                      2^(n+1)-1 timer counts (bucket 0 also holds 0)
+ **************************************************************************/
+typedef struct {
+    unsigned int count;
+    unsigned long maxLatencyCycles;
+    unsigned long meanLatencyCycles;
+    unsigned long maxJitterCycles;
+    unsigned int missed;
+    unsigned int latency[LATENCY_BUCKETS];
+    unsigned int jitter[LATENCY_BUCKETS];
+} LatencyStats;
+
+#if LATENCY_ENABLED
+
+// The counter is read as an argument, before the call
+#define LATENCY_PWM_ENTER()    latencyTimer(LATENCY_PWM_ISR, TA0R, TA0CCR2, TA0CCR0)
+#define LATENCY_TICK_ENTER()   latencyTimer(LATENCY_TICK_ISR, TA1R, TA1CCR0, TA1CCR0)
+#define LATENCY_LATCH_ENTER()  latencyLatch(LATENCY_LATCH_ISR, TA0R, TA0CCR0)
+#define LATENCY_PORT1_ENTER()  latencyStream(LATENCY_PORT1_ISR)
+#define LATENCY_ADC_ENTER() do {                                           \
+        latencyStream(LATENCY_ADC_ISR);                                    \
+        if (ADCIFG & ADCOVIFG) {                                           \
+            ADCIFG &= ~ADCOVIFG;                                           \
+            latencyLost(LATENCY_ADC_ISR);                                  \
+        }                                                                  \
+    } while (0)
+#define LATENCY_RESTART(id)    latencyRestart(id)
+
+#else
+
+#define LATENCY_PWM_ENTER()    ((void)0)
+#define LATENCY_TICK_ENTER()   ((void)0)
+#define LATENCY_LATCH_ENTER()  ((void)0)
+#define LATENCY_PORT1_ENTER()  ((void)0)
+#define LATENCY_ADC_ENTER()    ((void)0)
+#define LATENCY_RESTART(id)    ((void)0)
+
+#endif
+
+/**************************************************************************
+ * Function: latencyInit
+ * Description:
+ *    Clears every source. Call after timebaseInit().
+ **************************************************************************/
+void latencyInit(void);
+
+/**************************************************************************
+ * Function: latencyTimer
+ * Description:
+ *    Records the entry of an ISR raised by a Timer_A compare in up mode.
+ *    Use the LATENCY_*_ENTER macros rather than calling this directly.
+ * Parameters:
+ *    id - Source identifier
+ *    count - TAxR read on entry
+ *    compare - TAxCCRn of the compare that raised the interrupt
+ *    top - TAxCCR0, the last count of the period
+ **************************************************************************/
+void latencyTimer(unsigned char id, unsigned int count, unsigned int compare, unsigned int top);
+
+/**************************************************************************
+ * Function: latencyLatch
+ * Description:
+ *    Records the entry of a period hook ISR raised by a CCR0 compare that
+ *    is only enabled now and then. Use LATENCY_LATCH_ENTER().
+ * Parameters:
+ *    id - Source identifier
+ *    count - TAxR read on entry
+ *    top - TAxCCR0, the last count of the period
+ **************************************************************************/
+void latencyLatch(unsigned char id, unsigned int count, unsigned int top);
+
+/**************************************************************************
+ * Function: latencyStream
+ * Description:
+ *    Records the entry of an ISR raised by a stream of events with no
+ *    timer behind them.
+ * Parameters:
+ *    id - Source identifier
+ **************************************************************************/
+void latencyStream(unsigned char id);
+
+/**************************************************************************
+ * Function: latencyLost
+ * Description:
+ *    Counts an event the hardware reports as lost.
+ **************************************************************************/
+void latencyLost(unsigned char id);
+
+/**************************************************************************
+ * Function: latencyRestart
+ * Description:
+ *    Starts a stream afresh, forgetting its period, e.g. when the colour
+ *    filter changes. Safe to call from the main loop or an ISR.
+ **************************************************************************/
+void latencyRestart(unsigned char id);
+
+/**************************************************************************
+ * Function: latencyGet
+ * Description:
+ *    Copies a snapshot of one source's figures.
+ * Parameters:
+ *    id - Source identifier
+ *    stats - Destination for the snapshot
+ **************************************************************************/
+void latencyGet(unsigned char id, LatencyStats *stats);
+
+/**************************************************************************
+ * Function: latencyMissed
+ * Description:
+ *    Returns the missed periods, lost edges and lost results of all
+ *    sources together (saturates at 65535).
+ **************************************************************************/
+unsigned int latencyMissed(void);
+
+#endif /* LATENCY_H_ */
@@ -1,122 +1,614 @@
-/**************************************************************************
- * Project Name: Exoplanet Detection Simulator
- * Module Name: lcd.c
- * Created on: 20 Feb 2024
- * Date Last Updated: 02/05/2024
- * Update Description:
- *    Changed D4 and D7 pins back to the original MSP430 pins connected.
- * Author: Finlay Harris
- **************************************************************************/
-
-#include "lcd.h"
-#include <msp430fr4133.h>
-
-// Definitions for LCD pin connections on MSP430
-#define LCD_RS BIT0 // P1.0 for RS
-#define LCD_E  BIT1 // P1.1 for E
-#define LCD_D4 BIT7 // P2.7 for D4
-#define LCD_D5 BIT0 // P8.0 for D5
-#define LCD_D6 BIT1 // P5.1 for D6
-#define LCD_D7 BIT5 // P2.5 for D7
-
-/**************************************************************************
- * Function: lcdInitGPIO
- **************************************************************************/
-void lcdInitGPIO(void) {
-    // Set LCD control and data pins as output
-    P1DIR |= LCD_RS + LCD_E;
-    P2DIR |= LCD_D4 + LCD_D7; // Pins on port 2
-    P8DIR |= LCD_D5;          // Pin on port 8
-    P5DIR |= LCD_D6;          // Pin on port 5
-
-    // Initialise all control and data lines to low
-    P1OUT &= ~(LCD_RS + LCD_E);
-    P2OUT &= ~(LCD_D4 + LCD_D7);
-    P8OUT &= ~LCD_D5;
-    P5OUT &= ~LCD_D6;
-}
-
-/**************************************************************************
- * Function: lcdInit
- **************************************************************************/
-void lcdInit(void) {
-    lcdInitGPIO();          // Initialise GPIO for LCD
-
-    __delay_cycles(20000);  // Initial delay for LCD power up
-
-    // Start of sequence to initialise LCD in 4-bit mode
-    lcdSendNibble(0x03, 1); // Initial commands to set interface length
-    __delay_cycles(5000);
-    lcdSendNibble(0x03, 1);
-    __delay_cycles(1000);
-    lcdSendNibble(0x03, 1);
-    __delay_cycles(1000);
-    lcdSendNibble(0x02, 1); // Set to 4-bit interface
-
-    // Configuration commands in 4-bit mode
-    lcdWriteByte(0x28, 1);  // Function set: 4-bit/2-line
-    lcdWriteByte(0x0C, 1);  // Display ON; Cursor OFF, Blink OFF
-    lcdWriteByte(0x06, 1);  // Entry mode: Increment & no shift
-    lcdWriteByte(0x01, 1);  // Clear display
-    __delay_cycles(3000);   // Delay for clear command
-}
-
-/**************************************************************************
- * Function: lcdSendNibble
- **************************************************************************/
-void lcdSendNibble(unsigned char nibble, int isCommand) {
-    if (isCommand) {
-        P1OUT &= ~LCD_RS; // Command mode
-    } else {
-        P1OUT |= LCD_RS;  // Data mode
-    }
-
-    P2OUT = (P2OUT & ~(LCD_D4 | LCD_D7)) | ((nibble & 0x01) ? LCD_D4 : 0) | ((nibble & 0x08) ? LCD_D7 : 0);
-    P8OUT = (P8OUT & ~LCD_D5) | ((nibble & 0x02) ? LCD_D5 : 0);
-    P5OUT = (P5OUT & ~LCD_D6) | ((nibble & 0x04) ? LCD_D6 : 0);
-
-    P1OUT |= LCD_E;         // Enable high
-    __delay_cycles(2000);   // Pulse width
-    P1OUT &= ~LCD_E;        // Enable low
-}
-
-/**************************************************************************
- * Function: lcdWriteByte
- **************************************************************************/
-void lcdWriteByte(unsigned char byte, int isCommand) {
-    lcdSendNibble(byte >> 4, isCommand);   // High nibble
-    lcdSendNibble(byte & 0x0F, isCommand); // Low nibble
-}
-
-/**************************************************************************
- * Function: lcdSendCommand
- **************************************************************************/
-void lcdSendCommand(unsigned char command) {
-    lcdWriteByte(command, 1); // 1 indicates this is a command
-}
-
-
-/**************************************************************************
- * Function: lcdDisplayText
- **************************************************************************/
-void lcdDisplayText(char *line1, char *line2) {
-    lcdSendCommand(0x01); // Clear display command
-    __delay_cycles(2000); // Delay for clear command to be processed
-
-    // Set cursor to the beginning of the first line
-    lcdSendCommand(0x80);
-    while (*line1) {
-        lcdWriteByte(*line1++, 0); // Write characters of line 1
-    }
-
-    // Set cursor to the beginning of the second line
-    lcdSendCommand(0xC0);
-    while (*line2) {
-        lcdWriteByte(*line2++, 0); // Write characters of line 2
-    }
-}
-
-
-
-
-
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: lcd.c
+ * Created on: 20 Feb 2024
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Added lcdQueueMarquee(), which loads the marquee through the write
+ *    queue so it can start from a tick handler.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#include "lcd.h"
+#include <msp430fr4133.h>
+#include "clock.h"
+#include "profile.h"
+#include "telemetry.h"
+#include "timebase.h"
+#include <intrinsics.h>
+
+// Definitions for LCD pin connections on MSP430
+#if TELEMETRY_ENABLED
+#define LCD_RS     BIT1  // P8.1 for RS, P1.0 is the UART TXD
+#define LCD_RS_DIR P8DIR
+#define LCD_RS_OUT P8OUT
+#else
+#define LCD_RS     BIT0  // P1.0 for RS
+#define LCD_RS_DIR P1DIR
+#define LCD_RS_OUT P1OUT
+#endif
+#define LCD_E  BIT1 // P1.1 for E
+#define LCD_D4 BIT7 // P2.7 for D4
+#define LCD_D5 BIT0 // P8.0 for D5
+#define LCD_D6 BIT1 // P5.1 for D6
+#define LCD_D7 BIT5 // P2.5 for D7
+
+#define LCD_DDRAM_LINE      40   // DDRAM characters per line
+#define LCD_VISIBLE         16   // Characters shown per line
+#define LCD_SHIFT_LEFT      0x18 // Cursor/display shift: display, left
+#define LCD_QUEUE_SIZE      32   // Queued bytes, power of two
+#define LCD_QUEUE_COMMAND   0x100 // Queue entry flags
+#define LCD_QUEUE_PAUSE     0x200 // Entry sends nothing, holding the bus a tick
+#define LCD_CLEAR_PAUSES    2    // Ticks after a queued clear (1.52 ms)
+#define LCD_POWER_UP_MS     20   // Power-up to first command
+
+/**************************************************************************
+ * Timer-driven write queue. lcdBusTick() clocks out one nibble per system
+ * tick, so queued writes never block the caller or hold up the tick ISR.
+ * Blocking writes from the main loop wait for a queued byte that is half
+ * sent, and the queue waits while a blocking write holds the bus.
+ **************************************************************************/
+static unsigned int lcdQueue[LCD_QUEUE_SIZE];   // byte | LCD_QUEUE_COMMAND, or LCD_QUEUE_PAUSE
+static volatile unsigned char lcdQueueHead = 0;
+static volatile unsigned char lcdQueueTail = 0;
+static volatile unsigned char lcdHalfSent = 0;  // High nibble of the tail entry is out
+static volatile unsigned char lcdBusHeld = 0;   // Main-loop write in progress
+static unsigned char lcdBusRunning = 0;         // lcdBusTick() is subscribed
+
+/**************************************************************************
+ * Marquee state. In hardware mode every non-empty line is laid out around
+ * its 40-character DDRAM line and one display-shift command moves both
+ * lines; otherwise each long line is redrawn on its own (software mode).
+ **************************************************************************/
+static char marqueeText[2][LCD_MARQUEE_MAX + 1];
+static unsigned char marqueeLength[2];
+static unsigned char marqueePeriod[2];          // Text plus gap, in characters
+static unsigned char marqueeOffset[2];
+static unsigned char marqueeScrolls = 0;        // Bit per line that scrolls
+static unsigned char marqueeHardware = 0;
+static unsigned char marqueeShift = 0;          // Display shifts so far, 0 to 39
+static unsigned char marqueeHold = 0;           // Steps left before scrolling
+static volatile unsigned char marqueeActive = 0;
+static unsigned int marqueeCountdown = 0;
+static volatile unsigned char marqueeLoading = 0; // lcdQueueMarquee() text still being queued
+static unsigned char marqueeLoadAt = 0;         // Next queue entry of the load
+
+/**************************************************************************
+ * Power-up sequence for lcdInitStep(). Each entry is sent as a command
+ * and then waited for; nibble entries are the 8-bit interface resync,
+ * which works whatever state the controller was left in.
+ **************************************************************************/
+typedef struct {
+    unsigned char value;
+    unsigned char nibble;       // Send the low nibble only
+    unsigned char waitMs;
+} LcdInitEntry;
+
+static const LcdInitEntry lcdInitSequence[] = {
+    { 0x03, 1, 5 },             // Interface length, three times
+    { 0x03, 1, 1 },
+    { 0x03, 1, 1 },
+    { 0x02, 1, 1 },             // Set to 4-bit interface
+    { 0x28, 0, 1 },             // Function set: 4-bit/2-line
+    { 0x0C, 0, 1 },             // Display ON; Cursor OFF, Blink OFF
+    { 0x06, 0, 1 },             // Entry mode: Increment & no shift
+    { 0x01, 0, 3 },             // Clear display
+};
+static unsigned char lcdInitIndex = 0;
+
+static void lcdBusTick(void);
+static void lcdStrobe(unsigned char nibble, int isCommand);
+
+/**************************************************************************
+ * Function: lcdInitGPIO
+ **************************************************************************/
+void lcdInitGPIO(void) {
+    // Set LCD control and data pins as output
+    LCD_RS_DIR |= LCD_RS;
+    P1DIR |= LCD_E;
+    P2DIR |= LCD_D4 + LCD_D7; // Pins on port 2
+    P8DIR |= LCD_D5;          // Pin on port 8
+    P5DIR |= LCD_D6;          // Pin on port 5
+
+    // Initialise all control and data lines to low
+    LCD_RS_OUT &= ~LCD_RS;
+    P1OUT &= ~LCD_E;
+    P2OUT &= ~(LCD_D4 + LCD_D7);
+    P8OUT &= ~LCD_D5;
+    P5OUT &= ~LCD_D6;
+}
+
+/**************************************************************************
+ * Function: lcdInitBegin
+ **************************************************************************/
+unsigned char lcdInitBegin(unsigned char powered) {
+    lcdInitGPIO();
+    lcdInitIndex = 0;
+    lcdBusRunning = 0;
+    return powered ? 0 : LCD_POWER_UP_MS;
+}
+
+/**************************************************************************
+ * Function: lcdInitStep
+ **************************************************************************/
+unsigned char lcdInitStep(void) {
+    const LcdInitEntry *entry;
+
+    if (lcdInitIndex == sizeof(lcdInitSequence) / sizeof(lcdInitSequence[0])) {
+        lcdBusRunning = timebaseSubscribe(lcdBusTick, TIMEBASE_TICK_HZ) >= 0;
+        return 0;
+    }
+    entry = &lcdInitSequence[lcdInitIndex++];
+    if (!entry->nibble) lcdStrobe(entry->value >> 4, 1);
+    lcdStrobe(entry->value & 0x0F, 1);
+    return entry->waitMs;
+}
+
+/**************************************************************************
+ * Function: lcdInit
+ **************************************************************************/
+void lcdInit(void) {
+    unsigned char wait = lcdInitBegin(0);
+
+    for (;;) {
+        while (wait) {
+            delay_ms(1);
+            wait--;
+        }
+        wait = lcdInitStep();
+        if (wait == 0) break;
+    }
+}
+
+/**************************************************************************
+ * Function: lcdPutNibble
+ * Description:
+ *    Sets RS and the data lines for a nibble, ready for an E pulse.
+ **************************************************************************/
+static void lcdPutNibble(unsigned char nibble, int isCommand) {
+    if (isCommand) {
+        LCD_RS_OUT &= ~LCD_RS; // Command mode
+    } else {
+        LCD_RS_OUT |= LCD_RS;  // Data mode
+    }
+
+    P2OUT = (P2OUT & ~(LCD_D4 | LCD_D7)) | ((nibble & 0x01) ? LCD_D4 : 0) | ((nibble & 0x08) ? LCD_D7 : 0);
+    P8OUT = (P8OUT & ~LCD_D5) | ((nibble & 0x02) ? LCD_D5 : 0);
+    P5OUT = (P5OUT & ~LCD_D6) | ((nibble & 0x04) ? LCD_D6 : 0);
+}
+
+/**************************************************************************
+ * Function: lcdStrobe
+ * Description:
+ *    Clocks one nibble out with a short E pulse.
+ **************************************************************************/
+static void lcdStrobe(unsigned char nibble, int isCommand) {
+    lcdPutNibble(nibble, isCommand);
+    P1OUT |= LCD_E;
+    delay_us(1);            // E high time, 450 ns minimum
+    P1OUT &= ~LCD_E;
+}
+
+/**************************************************************************
+ * Function: lcdSendNibble
+ **************************************************************************/
+void lcdSendNibble(unsigned char nibble, int isCommand) {
+    lcdPutNibble(nibble, isCommand);
+
+    P1OUT |= LCD_E;         // Enable high
+    delay_us(2000);         // Pulse width
+    P1OUT &= ~LCD_E;        // Enable low
+}
+
+/**************************************************************************
+ * Function: lcdWriteByte
+ **************************************************************************/
+void lcdWriteByte(unsigned char byte, int isCommand) {
+    unsigned short state;
+
+    // Take the bus between queued bytes, never between their nibbles
+    for (;;) {
+        state = __get_interrupt_state();
+        __disable_interrupt();
+        if (!lcdHalfSent) break;
+        __set_interrupt_state(state);
+    }
+    lcdBusHeld = 1;
+    __set_interrupt_state(state);
+
+    lcdSendNibble(byte >> 4, isCommand);   // High nibble
+    lcdSendNibble(byte & 0x0F, isCommand); // Low nibble
+
+    lcdBusHeld = 0;
+}
+
+/**************************************************************************
+ * Function: lcdSendCommand
+ **************************************************************************/
+void lcdSendCommand(unsigned char command) {
+    lcdWriteByte(command, 1); // 1 indicates this is a command
+}
+
+
+/**************************************************************************
+ * Function: lcdDisplayText
+ **************************************************************************/
+void lcdDisplayText(char *line1, char *line2) {
+    PROFILE_BEGIN(PROFILE_LCD_TEXT);
+
+    lcdMarqueeStop();     // Clear also undoes any display shift
+
+    lcdSendCommand(0x01); // Clear display command
+    delay_us(2000);       // Delay for clear command to be processed
+
+    // Set cursor to the beginning of the first line
+    lcdSendCommand(0x80);
+    while (*line1) {
+        lcdWriteByte(*line1++, 0); // Write characters of line 1
+    }
+
+    // Set cursor to the beginning of the second line
+    lcdSendCommand(0xC0);
+    while (*line2) {
+        lcdWriteByte(*line2++, 0); // Write characters of line 2
+    }
+
+    PROFILE_END(PROFILE_LCD_TEXT);
+}
+
+/**************************************************************************
+ * Function: lcdSetCursor
+ **************************************************************************/
+void lcdSetCursor(unsigned char row, unsigned char col) {
+    lcdSendCommand((row ? 0xC0 : 0x80) + col); // Set DDRAM address
+}
+
+/**************************************************************************
+ * Function: lcdWriteText
+ **************************************************************************/
+void lcdWriteText(const char *text) {
+    while (*text) {
+        lcdWriteByte(*text++, 0);
+    }
+}
+
+/**************************************************************************
+ * Function: lcdQueueFree
+ * Description:
+ *    Returns the number of free queue entries. Called with interrupts
+ *    disabled or from the tick.
+ **************************************************************************/
+static unsigned char lcdQueueFree(void) {
+    return (unsigned char)((lcdQueueTail - lcdQueueHead - 1) & (LCD_QUEUE_SIZE - 1));
+}
+
+/**************************************************************************
+ * Function: lcdQueueByte
+ * Description:
+ *    Adds a byte to the queue. The caller checks for room first.
+ **************************************************************************/
+static void lcdQueueByte(unsigned char byte, int isCommand) {
+    lcdQueue[lcdQueueHead] = byte | (isCommand ? LCD_QUEUE_COMMAND : 0);
+    lcdQueueHead = (lcdQueueHead + 1) & (LCD_QUEUE_SIZE - 1);
+}
+
+/**************************************************************************
+ * Function: lcdPulseQueued
+ * Description:
+ *    Clocks one nibble of the tail entry out with a short E pulse.
+ **************************************************************************/
+static void lcdPulseQueued(void) {
+    unsigned int entry = lcdQueue[lcdQueueTail];
+
+    lcdStrobe(lcdHalfSent ? (entry & 0x0F) : ((entry >> 4) & 0x0F), entry & LCD_QUEUE_COMMAND);
+
+    if (lcdHalfSent) {
+        lcdQueueTail = (lcdQueueTail + 1) & (LCD_QUEUE_SIZE - 1);
+        lcdHalfSent = 0;
+    } else {
+        lcdHalfSent = 1;
+    }
+}
+
+/**************************************************************************
+ * Function: lcdQueueClear
+ * Description:
+ *    Queues a clear display, which also undoes any display shift, and the
+ *    pause it needs. The caller checks for LCD_CLEAR_PAUSES + 1 free.
+ **************************************************************************/
+static void lcdQueueClear(void) {
+    unsigned char i;
+
+    lcdQueueByte(0x01, 1);
+    for (i = 0; i < LCD_CLEAR_PAUSES; i++) {
+        lcdQueue[lcdQueueHead] = LCD_QUEUE_PAUSE;
+        lcdQueueHead = (lcdQueueHead + 1) & (LCD_QUEUE_SIZE - 1);
+    }
+}
+
+/**************************************************************************
+ * Function: marqueeChar
+ * Description:
+ *    Character at a position of a line's repeating text-plus-gap pattern.
+ **************************************************************************/
+static char marqueeChar(unsigned char line, unsigned char position) {
+    position %= marqueePeriod[line];
+    return position < marqueeLength[line] ? marqueeText[line][position] : ' ';
+}
+
+/**************************************************************************
+ * Function: marqueeShown
+ * Description:
+ *    Characters of a line written when the marquee starts: the whole
+ *    DDRAM line in hardware mode, else the visible part, and no more than
+ *    the text of a line that stays where it is.
+ **************************************************************************/
+static unsigned char marqueeShown(unsigned char line) {
+    if (!marqueeLength[line] || (!marqueeHardware && !(marqueeScrolls & (1 << line)))) {
+        return marqueeLength[line];         // Nothing past the text to write over the clear
+    }
+    return marqueeHardware ? LCD_DDRAM_LINE : LCD_VISIBLE;
+}
+
+/**************************************************************************
+ * Function: marqueeBegin
+ * Description:
+ *    Starts the scroll steps, after a hold at the start. Called with
+ *    interrupts disabled or from the tick.
+ **************************************************************************/
+static void marqueeBegin(void) {
+    if (!marqueeScrolls) return;
+    marqueeShift = 0;
+    marqueeHold = LCD_MARQUEE_HOLD;
+    marqueeCountdown = TIMEBASE_TICK_HZ / LCD_MARQUEE_HZ;
+    marqueeActive = 1;
+}
+
+/**************************************************************************
+ * Function: lcdMarqueeLoad
+ * Description:
+ *    Queues as much of a lcdQueueMarquee() screen as fits: the clear,
+ *    then each line's address and characters. Starts the scrolling once
+ *    it is all queued.
+ **************************************************************************/
+static void lcdMarqueeLoad(void) {
+    unsigned char line, at, shown;
+
+    if (marqueeLoadAt == 0) {
+        if (lcdQueueFree() < LCD_CLEAR_PAUSES + 1) return;
+        lcdQueueClear();
+        marqueeLoadAt = 1;
+    }
+    while (lcdQueueFree()) {
+        at = marqueeLoadAt - 1;
+        for (line = 0; line < 2; line++) {
+            shown = marqueeShown(line);
+            if (at <= shown) break;
+            at -= shown + 1;
+        }
+        if (line == 2) {
+            marqueeLoading = 0;
+            marqueeBegin();
+            return;
+        }
+        if (at == 0) lcdQueueByte(line ? 0xC0 : 0x80, 1);
+        else lcdQueueByte(marqueeChar(line, at - 1), 0);
+        marqueeLoadAt++;
+    }
+}
+
+/**************************************************************************
+ * Function: lcdMarqueeStep
+ * Description:
+ *    Queues one scroll step, or nothing if the queue has no room for it
+ *    (the step is then retried next time).
+ **************************************************************************/
+static void lcdMarqueeStep(void) {
+    unsigned char line, i;
+
+    if (marqueeHold) {
+        marqueeHold--;
+        return;
+    }
+
+    if (marqueeHardware) {
+        if (lcdQueueFree() < 1) return;
+        lcdQueueByte(LCD_SHIFT_LEFT, 1);
+        if (++marqueeShift == LCD_DDRAM_LINE) {
+            marqueeShift = 0;
+            marqueeHold = LCD_MARQUEE_HOLD;  // Back at the start
+        }
+        return;
+    }
+
+    for (line = 0; line < 2; line++) {
+        if (!(marqueeScrolls & (1 << line))) continue;
+        if (lcdQueueFree() < LCD_VISIBLE + 1) return;
+
+        if (++marqueeOffset[line] == marqueePeriod[line]) {
+            marqueeOffset[line] = 0;
+            if (line == 0 || !(marqueeScrolls & 1)) marqueeHold = LCD_MARQUEE_HOLD;
+        }
+        lcdQueueByte(line ? 0xC0 : 0x80, 1);
+        for (i = 0; i < LCD_VISIBLE; i++) {
+            lcdQueueByte(marqueeChar(line, marqueeOffset[line] + i), 0);
+        }
+    }
+}
+
+/**************************************************************************
+ * Function: lcdBusTick
+ * Description:
+ *    System tick subscriber: paces the marquee and sends one queued nibble
+ *    unless the main loop is mid-write.
+ **************************************************************************/
+static void lcdBusTick(void) {
+    if (marqueeLoading) {
+        lcdMarqueeLoad();
+    } else if (marqueeActive && --marqueeCountdown == 0) {
+        marqueeCountdown = TIMEBASE_TICK_HZ / LCD_MARQUEE_HZ;
+        lcdMarqueeStep();
+    }
+
+    if (!lcdBusHeld && (lcdHalfSent || lcdQueueTail != lcdQueueHead)) {
+        if (lcdQueue[lcdQueueTail] & LCD_QUEUE_PAUSE) {
+            lcdQueueTail = (lcdQueueTail + 1) & (LCD_QUEUE_SIZE - 1);
+        } else {
+            lcdPulseQueued();
+        }
+    }
+}
+
+/**************************************************************************
+ * Function: lcdQueueLine
+ **************************************************************************/
+int lcdQueueLine(unsigned char row, const char *text, unsigned char length) {
+    unsigned short state = __get_interrupt_state();
+    unsigned char i;
+
+    if (!lcdBusRunning) {
+        // No tick to send the queue: write the line directly instead
+        lcdSetCursor(row, 0);
+        for (i = 0; i < LCD_VISIBLE; i++) {
+            lcdWriteByte(i < length ? text[i] : ' ', 0);
+        }
+        return 1;
+    }
+
+    __disable_interrupt();
+    if (marqueeActive || marqueeLoading) {
+        // The queue only holds marquee writes: drop them and undo the shift
+        marqueeActive = 0;
+        marqueeLoading = 0;
+        if (lcdHalfSent) lcdPulseQueued();
+        lcdQueueHead = lcdQueueTail;
+        lcdQueueClear();
+    }
+    if (lcdQueueFree() < LCD_VISIBLE + 1) {
+        __set_interrupt_state(state);
+        return 0;
+    }
+    lcdQueueByte(row ? 0xC0 : 0x80, 1);
+    for (i = 0; i < LCD_VISIBLE; i++) {
+        lcdQueueByte(i < length ? text[i] : ' ', 0);   // Pad so no clear is needed
+    }
+    __set_interrupt_state(state);
+    return 1;
+}
+
+/**************************************************************************
+ * Function: lcdMarqueeStop
+ **************************************************************************/
+void lcdMarqueeStop(void) {
+    unsigned short state = __get_interrupt_state();
+
+    __disable_interrupt();
+    marqueeActive = 0;
+    marqueeLoading = 0;
+    if (lcdHalfSent) lcdPulseQueued();       // Finish the byte on the bus
+    lcdQueueHead = lcdQueueTail;             // Drop steps not yet sent
+    __set_interrupt_state(state);
+}
+
+/**************************************************************************
+ * Function: marqueeSetup
+ * Description:
+ *    Takes a copy of the two lines and picks hardware or software mode
+ *    and each line's period.
+ **************************************************************************/
+static void marqueeSetup(const char *const *text, const unsigned char *length) {
+    unsigned char line, i;
+
+    marqueeScrolls = 0;
+    marqueeHardware = 1;
+    for (line = 0; line < 2; line++) {
+        for (i = 0; i < length[line] && i < LCD_MARQUEE_MAX; i++) {
+            marqueeText[line][i] = text[line][i];
+        }
+        marqueeText[line][i] = '\0';
+        marqueeLength[line] = i;
+        marqueeOffset[line] = 0;
+
+        if (i > LCD_VISIBLE) marqueeScrolls |= 1 << line;
+        if (i + LCD_MARQUEE_GAP > LCD_DDRAM_LINE) marqueeHardware = 0;
+    }
+    if (!marqueeScrolls) marqueeHardware = 0;
+    for (line = 0; line < 2; line++) {
+        if (marqueeHardware) {
+            // Shortest period dividing the DDRAM line, so the wrap is seamless.
+            // A short line is laid out the same way and moves with the shift.
+            marqueePeriod[line] = marqueeLength[line] + LCD_MARQUEE_GAP <= LCD_DDRAM_LINE / 2 ? LCD_DDRAM_LINE / 2
+                                                                                            : LCD_DDRAM_LINE;
+        } else if (marqueeScrolls & (1 << line)) {
+            marqueePeriod[line] = marqueeLength[line] + LCD_MARQUEE_GAP;
+        } else {
+            marqueePeriod[line] = LCD_DDRAM_LINE;
+        }
+    }
+}
+
+/**************************************************************************
+ * Function: lcdMarquee
+ **************************************************************************/
+void lcdMarquee(const char *line1, const char *line2) {
+    const char *text[2];
+    unsigned char length[2];
+    unsigned char line, i, shown;
+    unsigned short state;
+
+    text[0] = line1;
+    text[1] = line2;
+    for (line = 0; line < 2; line++) {
+        for (length[line] = 0; text[line][length[line]] && length[line] < LCD_MARQUEE_MAX; length[line]++) {
+        }
+    }
+
+    lcdMarqueeStop();
+    lcdSendCommand(0x01);   // Clear display, also resets the display shift
+    delay_us(2000);
+
+    marqueeSetup(text, length);
+
+    // Write each line once
+    for (line = 0; line < 2; line++) {
+        shown = marqueeShown(line);
+        lcdSetCursor(line, 0);
+        for (i = 0; i < shown; i++) {
+            lcdWriteByte(marqueeChar(line, i), 0);
+        }
+    }
+
+    state = __get_interrupt_state();
+    __disable_interrupt();
+    marqueeBegin();
+    __set_interrupt_state(state);
+}
+
+/**************************************************************************
+ * Function: lcdQueueMarquee
+ **************************************************************************/
+void lcdQueueMarquee(const char *line1, unsigned char length1, const char *line2, unsigned char length2) {
+    const char *text[2];
+    unsigned char length[2];
+    unsigned short state;
+
+    if (!lcdBusRunning) {
+        // No tick to send the queue or scroll: show the start of each line
+        lcdQueueLine(0, line1, length1 < LCD_VISIBLE ? length1 : LCD_VISIBLE);
+        lcdQueueLine(1, line2, length2 < LCD_VISIBLE ? length2 : LCD_VISIBLE);
+        return;
+    }
+
+    text[0] = line1;
+    text[1] = line2;
+    length[0] = length1;
+    length[1] = length2;
+
+    state = __get_interrupt_state();
+    __disable_interrupt();
+    lcdMarqueeStop();
+    marqueeSetup(text, length);
+    marqueeLoadAt = 0;
+    marqueeLoading = 1;
+    __set_interrupt_state(state);
+}
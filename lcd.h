@@ -1,77 +1,185 @@
-/**************************************************************************
- * Project Name: Exoplanet Detection Simulator
- * Module Name: lcd.h
- * Created on: 20 Feb 2024
- * Date Last Updated: 03/03/2024
- * Update Description:
- *    Modified lcdDisplayText() to support displaying two strings, allowing
- *    text to be set separately on each line of the LCD.
- * Author: Finlay Harris
- **************************************************************************/
-
-#ifndef LCD_H_
-#define LCD_H_
-
-/**************************************************************************
- * Function: lcdInitGPIO
- * Description:
- *    Initialises GPIO pins connected to the LCD for output. This includes
- *    both control and data lines. Ensures all lines are set to a known low
- *    state initially.
- **************************************************************************/
-void lcdInitGPIO(void);
-
-/**************************************************************************
- * Function: lcdInit
- * Description:
- *    Performs the initial setup of the LCD display after powering up.
- *    This function is critical in setting the LCD to operate in 4-bit mode
- *    and configuring display characteristics like display mode and cursor
- *    settings.
- **************************************************************************/
-void lcdInit(void);
-
-/**************************************************************************
- * Function: lcdSendNibble
- * Description:
- *    Sends a 4-bit nibble to the LCD, used in both command and data mode.
- * Parameters:
- *    nibble - 4-bit data to send
- *    isCommand - Indicates if the nibble is part of a command (1) or data (0)
- **************************************************************************/
-void lcdSendNibble(unsigned char nibble, int isCommand);
-
-/**************************************************************************
- * Function: lcdWriteByte
- * Description:
- *    Sends a full byte to the LCD by splitting it into two nibbles. This function
- *    is used for both sending commands and writing display data.
- * Parameters:
- *    byte - The byte to send to the LCD.
- *    isCommand - Indicator if the byte is a command or data.
- **************************************************************************/
-void lcdWriteByte(unsigned char byte, int isCommand);
-
-/**************************************************************************
- * Function: lcdSendCommand
- * Description:
- *    Sends a command byte to the LCD to perform various display functions.
- *    This function utilises the lcdWriteByte function to send the command.
- * Parameters:
- *    command - The command byte to send to the LCD.
- **************************************************************************/
-void lcdSendCommand(unsigned char command);
-
-/**************************************************************************
- * Function: lcdDisplayText
- * Description:
- *    Displays specified text on the LCD. The function clears the display
- *    first, then positions the cursor and writes the provided strings
- *    to the first and second line.
- * Parameters:
- *    line1 - Text to display on the first line.
- *    line2 - Text to display on the second line.
- **************************************************************************/
-void lcdDisplayText(char *line1, char *line2);
-
-#endif /* LCD_H_ */
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: lcd.h
+ * Created on: 20 Feb 2024
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Added lcdQueueMarquee() for starting a marquee from a tick handler.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#ifndef LCD_H_
+#define LCD_H_
+
+#ifndef LCD_MARQUEE_HZ
+#define LCD_MARQUEE_HZ      4    // Scroll steps per second
+#endif
+#define LCD_MARQUEE_HOLD    4    // Steps to pause with the text at its start
+#define LCD_MARQUEE_GAP     3    // Minimum blanks between repeats of the text
+#define LCD_MARQUEE_MAX     64   // Longest line lcdMarquee() accepts
+
+/**************************************************************************
+ * Function: lcdInitGPIO
+ * Description:
+ *    Initialises GPIO pins connected to the LCD for output. This includes
+ *    both control and data lines. Ensures all lines are set to a known low
+ *    state initially.
+ **************************************************************************/
+void lcdInitGPIO(void);
+
+/**************************************************************************
+ * Function: lcdInit
+ * Description:
+ *    Performs the initial setup of the LCD display after powering up.
+ *    This function is critical in setting the LCD to operate in 4-bit mode
+ *    and configuring display characteristics like display mode and cursor
+ *    settings.
+ **************************************************************************/
+void lcdInit(void);
+
+/**************************************************************************
+ * Function: lcdInitBegin
+ * Description:
+ *    Starts the power-up sequence without blocking: sets up the GPIO and
+ *    returns how long to wait before the first lcdInitStep(). lcdInit()
+ *    is these two run with busy-wait delays.
+ * Parameters:
+ *    powered - 1 if the display stayed powered through the reset (e.g. a
+ *              watchdog reset), which skips the power-up wait
+ * Returns:
+ *    Milliseconds to wait.
+ **************************************************************************/
+unsigned char lcdInitBegin(unsigned char powered);
+
+/**************************************************************************
+ * Function: lcdInitStep
+ * Description:
+ *    Sends the next command of the power-up sequence. The display is
+ *    ready, and the write queue running, once it returns 0.
+ * Returns:
+ *    Milliseconds to wait before the next call, or 0 when done.
+ **************************************************************************/
+unsigned char lcdInitStep(void);
+
+/**************************************************************************
+ * Function: lcdSendNibble
+ * Description:
+ *    Sends a 4-bit nibble to the LCD, used in both command and data mode.
+ * Parameters:
+ *    nibble - 4-bit data to send
+ *    isCommand - Indicates if the nibble is part of a command (1) or data (0)
+ **************************************************************************/
+void lcdSendNibble(unsigned char nibble, int isCommand);
+
+/**************************************************************************
+ * Function: lcdWriteByte
+ * Description:
+ *    Sends a full byte to the LCD by splitting it into two nibbles. This function
+ *    is used for both sending commands and writing display data.
+ * Parameters:
+ *    byte - The byte to send to the LCD.
+ *    isCommand - Indicator if the byte is a command or data.
+ **************************************************************************/
+void lcdWriteByte(unsigned char byte, int isCommand);
+
+/**************************************************************************
+ * Function: lcdSendCommand
+ * Description:
+ *    Sends a command byte to the LCD to perform various display functions.
+ *    This function utilises the lcdWriteByte function to send the command.
+ * Parameters:
+ *    command - The command byte to send to the LCD.
+ **************************************************************************/
+void lcdSendCommand(unsigned char command);
+
+/**************************************************************************
+ * Function: lcdDisplayText
+ * Description:
+ *    Displays specified text on the LCD. The function clears the display
+ *    first, then positions the cursor and writes the provided strings
+ *    to the first and second line.
+ * Parameters:
+ *    line1 - Text to display on the first line.
+ *    line2 - Text to display on the second line.
+ **************************************************************************/
+void lcdDisplayText(char *line1, char *line2);
+
+/**************************************************************************
+ * Function: lcdSetCursor
+ * Description:
+ *    Moves the DDRAM address so the next data write lands at a position.
+ * Parameters:
+ *    row - Line, 0 or 1
+ *    col - Column, 0 to 15
+ **************************************************************************/
+void lcdSetCursor(unsigned char row, unsigned char col);
+
+/**************************************************************************
+ * Function: lcdWriteText
+ * Description:
+ *    Writes a string at the current cursor position without clearing the
+ *    display, for updating part of a screen.
+ * Parameters:
+ *    text - Text to write
+ **************************************************************************/
+void lcdWriteText(const char *text);
+
+/**************************************************************************
+ * Function: lcdMarquee
+ * Description:
+ *    Shows two lines, scrolling any line longer than 16 characters from
+ *    the system tick. If both lines fit their 40 character DDRAM lines
+ *    (with the gap), the text is written once and each step is a single
+ *    display-shift command; a short line then scrolls along with the
+ *    long one. Otherwise long lines are redrawn one at a time, leaving a
+ *    short line where it is. Steps are queued and sent a nibble per tick,
+ *    so the caller never waits on them. Scrolling stops at the next
+ *    lcdDisplayText(), lcdMarquee() or lcdQueueLine(); call
+ *    lcdMarqueeStop() before other cursor-positioned writes.
+ *    Needs the system tick (timebaseInit()) and interrupts enabled.
+ * Parameters:
+ *    line1 - Text for the first line (up to LCD_MARQUEE_MAX characters)
+ *    line2 - Text for the second line
+ **************************************************************************/
+void lcdMarquee(const char *line1, const char *line2);
+
+/**************************************************************************
+ * Function: lcdQueueMarquee
+ * Description:
+ *    As lcdMarquee(), but the clear and the text go out through the write
+ *    queue and scrolling starts once they have. Never blocks, so it can
+ *    be called from a tick handler. If the tick table was full at
+ *    lcdInitStep() the start of each line is written directly instead.
+ * Parameters:
+ *    line1 - Characters for the first line (need not be terminated)
+ *    length1 - Number of characters in line1, up to LCD_MARQUEE_MAX
+ *    line2, length2 - The same for the second line
+ **************************************************************************/
+void lcdQueueMarquee(const char *line1, unsigned char length1, const char *line2, unsigned char length2);
+
+/**************************************************************************
+ * Function: lcdQueueLine
+ * Description:
+ *    Queues a whole line (padded with spaces to 16 characters) to be sent
+ *    from the system tick. Never blocks, so it can be called from a tick
+ *    handler. Stops a running marquee, clearing the display and undoing
+ *    its shift. If the tick table was full at lcdInitStep() the line is
+ *    written directly instead.
+ * Parameters:
+ *    row - Line, 0 or 1
+ *    text - Characters to show (need not be terminated)
+ *    length - Number of characters in text, up to 16
+ * Returns:
+ *    1 if queued, 0 if the queue has no room yet.
+ **************************************************************************/
+int lcdQueueLine(unsigned char row, const char *text, unsigned char length);
+
+/**************************************************************************
+ * Function: lcdMarqueeStop
+ * Description:
+ *    Stops scrolling, leaving the text where it is, and drops any steps
+ *    still queued.
+ **************************************************************************/
+void lcdMarqueeStop(void);
+
+#endif /* LCD_H_ */
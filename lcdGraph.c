@@ -0,0 +1,209 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: lcdGraph.c
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Defined glyph generation, incremental CGRAM upload and the graphs.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#include "lcdGraph.h"
+#include "lcd.h"
+
+#define LCD_FULL_BLOCK  0xFF    // All pixels on, in the HD44780 A00 ROM
+#define LCD_BLANK       ' '
+#define CELL_UNKNOWN    0xFE    // Character code never drawn by the graphs
+
+static unsigned char glyphCopy[8][8];       // What CGRAM holds
+static unsigned char glyphKnown = 0;        // Bit per glyph with a valid copy
+
+static unsigned char barCells[LCDGRAPH_MAX_WIDTH];
+static unsigned char barRow = 0xFF, barCol = 0xFF;
+static unsigned char sparkPlaced = 0;
+static unsigned char sparkRow, sparkCol, sparkPlacedSlot;
+
+static unsigned int sparkSamples[LCDGRAPH_SPARK_SAMPLES];
+static unsigned long sparkTotal = 0;        // Samples pushed since lcdGraphInit()
+static unsigned int sparkMin, sparkMax;     // Current scale
+static unsigned long sparkScaleGroup;       // Newest group when the scale was set
+
+/**************************************************************************
+ * Function: lcdGraphInit
+ **************************************************************************/
+void lcdGraphInit(void) {
+    glyphKnown = 0;
+    barRow = barCol = 0xFF;
+    sparkPlaced = 0;
+    sparkTotal = 0;
+}
+
+/**************************************************************************
+ * Function: lcdGlyphBar
+ **************************************************************************/
+void lcdGlyphBar(unsigned char columns, unsigned char *glyph) {
+    unsigned char bits = (0x1F << (5 - columns)) & 0x1F;
+    unsigned char row;
+
+    for (row = 0; row < 8; row++) glyph[row] = bits;
+}
+
+/**************************************************************************
+ * Function: lcdGlyphSpark
+ **************************************************************************/
+void lcdGlyphSpark(const unsigned char *heights, unsigned char *glyph) {
+    unsigned char row, column;
+
+    for (row = 0; row < 8; row++) {
+        glyph[row] = 0;
+        for (column = 0; column < 5; column++) {
+            if (heights[column] <= 7 && heights[column] >= 7 - row) glyph[row] |= 0x10 >> column;
+        }
+    }
+}
+
+/**************************************************************************
+ * Function: lcdGlyphUpload
+ **************************************************************************/
+unsigned int lcdGlyphUpload(unsigned char slot, const unsigned char *glyph) {
+    unsigned int writes = 0;
+    unsigned char addressed = 0;            // LCD address counter is on this row
+    unsigned char known = glyphKnown & (1 << slot);
+    unsigned char row;
+
+    for (row = 0; row < 8; row++) {
+        if (known && glyphCopy[slot][row] == glyph[row]) {
+            addressed = 0;
+            continue;
+        }
+        if (!addressed) {
+            lcdSendCommand(0x40 | (slot << 3) | row); // Set CGRAM address
+            writes++;
+            addressed = 1;
+        }
+        lcdWriteByte(glyph[row], 0);        // Address counter moves to the next row
+        writes++;
+        glyphCopy[slot][row] = glyph[row];
+    }
+    glyphKnown |= 1 << slot;
+    return writes;
+}
+
+/**************************************************************************
+ * Function: lcdBarDraw
+ **************************************************************************/
+unsigned int lcdBarDraw(unsigned char row, unsigned char col, unsigned char width,
+                        unsigned int value, unsigned int max) {
+    unsigned char glyph[8];
+    unsigned char cell, code, addressed = 0;
+    unsigned int level, writes = 0;
+
+    if (width > LCDGRAPH_MAX_WIDTH) width = LCDGRAPH_MAX_WIDTH;
+    if (value > max) value = max;
+    level = max ? (unsigned int)((unsigned long)value * width * 5 / max) : 0;
+
+    // Moved, or first draw since lcdGraphInit(): resend every cell
+    if (row != barRow || col != barCol) {
+        for (cell = 0; cell < LCDGRAPH_MAX_WIDTH; cell++) barCells[cell] = CELL_UNKNOWN;
+        barRow = row;
+        barCol = col;
+    }
+
+    if (level % 5) {
+        lcdGlyphBar(level % 5, glyph);
+        writes += lcdGlyphUpload(LCDGRAPH_BAR_GLYPH, glyph);
+    }
+
+    for (cell = 0; cell < width; cell++) {
+        if (cell < level / 5) code = LCD_FULL_BLOCK;
+        else if (cell == level / 5 && level % 5) code = LCDGRAPH_BAR_GLYPH;
+        else code = LCD_BLANK;
+
+        if (barCells[cell] == code) {
+            addressed = 0;
+            continue;
+        }
+        if (!addressed) {
+            lcdSetCursor(row, col + cell);
+            writes++;
+            addressed = 1;
+        }
+        lcdWriteByte(code, 0);
+        writes++;
+        barCells[cell] = code;
+    }
+    return writes;
+}
+
+/**************************************************************************
+ * Function: lcdSparkPush
+ **************************************************************************/
+void lcdSparkPush(unsigned int sample) {
+    sparkSamples[sparkTotal % LCDGRAPH_SPARK_SAMPLES] = sample;
+    sparkTotal++;
+}
+
+/**************************************************************************
+ * Function: lcdSparkDraw
+ * Description:
+ *    Samples are grouped five to a cell by their sample number, and group
+ *    G always lives in glyph LCDGRAPH_SPARK_GLYPH + G % 7. A new sample
+ *    only changes its own group's glyph; when a new group starts, the
+ *    cells are rewritten in rotated order rather than every bitmap being
+ *    shifted. The scale widens as soon as a sample falls outside it but
+ *    only narrows when a new group starts, so it rarely forces a redraw.
+ **************************************************************************/
+unsigned int lcdSparkDraw(unsigned char row, unsigned char col) {
+    unsigned char heights[5];
+    unsigned char glyph[8];
+    unsigned int min = 0xFFFF, max = 0, sample, writes = 0;
+    unsigned long newest, first, n;
+    unsigned char cell, column, slot;
+
+    newest = sparkTotal ? (sparkTotal - 1) / 5 : 0;                    // Newest group
+    first = newest >= LCDGRAPH_SPARK_CELLS - 1 ? (newest - (LCDGRAPH_SPARK_CELLS - 1)) * 5 : 0;
+
+    for (n = first; n < sparkTotal; n++) {
+        sample = sparkSamples[n % LCDGRAPH_SPARK_SAMPLES];
+        if (sample < min) min = sample;
+        if (sample > max) max = sample;
+    }
+    if (newest != sparkScaleGroup || min < sparkMin || max > sparkMax) {
+        sparkMin = min;
+        sparkMax = max;
+        sparkScaleGroup = newest;
+    }
+
+    for (cell = 0; cell < LCDGRAPH_SPARK_CELLS; cell++) {
+        slot = (unsigned char)((newest + 1 + cell) % LCDGRAPH_SPARK_CELLS);
+        for (column = 0; column < 5; column++) {
+            // Sample number shown in this column, if it exists yet
+            n = (newest + 1 + cell) * 5 + column;
+            if (n < (unsigned long)LCDGRAPH_SPARK_CELLS * 5 || n - LCDGRAPH_SPARK_CELLS * 5 >= sparkTotal) {
+                heights[column] = LCDGRAPH_SPARK_EMPTY;
+                continue;
+            }
+            sample = sparkSamples[(n - LCDGRAPH_SPARK_CELLS * 5) % LCDGRAPH_SPARK_SAMPLES];
+            heights[column] = sparkMax > sparkMin
+                ? (unsigned char)((unsigned long)(sample - sparkMin) * 7 / (sparkMax - sparkMin)) : 3;
+        }
+        lcdGlyphSpark(heights, glyph);
+        writes += lcdGlyphUpload(LCDGRAPH_SPARK_GLYPH + slot, glyph);
+    }
+
+    // Cells only change when a new group rotates the glyph order
+    slot = (unsigned char)((newest + 1) % LCDGRAPH_SPARK_CELLS);
+    if (!sparkPlaced || row != sparkRow || col != sparkCol || slot != sparkPlacedSlot) {
+        lcdSetCursor(row, col);
+        writes++;
+        for (cell = 0; cell < LCDGRAPH_SPARK_CELLS; cell++) {
+            lcdWriteByte(LCDGRAPH_SPARK_GLYPH + (slot + cell) % LCDGRAPH_SPARK_CELLS, 0);
+            writes++;
+        }
+        sparkPlaced = 1;
+        sparkRow = row;
+        sparkCol = col;
+        sparkPlacedSlot = slot;
+    }
+    return writes;
+}
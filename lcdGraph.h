@@ -0,0 +1,115 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: lcdGraph.h
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Initial creation of the CGRAM bar graph and sparkline.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#ifndef LCDGRAPH_H_
+#define LCDGRAPH_H_
+
+/**************************************************************************
+ * The HD44780 has 8 user glyphs (5x8 pixels) in CGRAM, shown by character
+ * codes 0 to 7. They are shared out as:
+ *    glyph 0     - the partly filled cell at the end of the bar graph
+ *    glyphs 1-7  - the sparkline, one glyph per 5 samples
+ * so there is one bar graph and one sparkline on screen at a time.
+ *
+ * A RAM copy of every glyph and of the cells the graphs own is kept, and
+ * only rows and cells that differ from it are sent. A refresh where one
+ * sample scrolls in usually costs a few CGRAM rows, not a redraw.
+ *
+ * CGRAM writes leave the LCD address counter in CGRAM, so always set the
+ * cursor (lcdSetCursor/lcdDisplayText) before writing text afterwards.
+ **************************************************************************/
+#define LCDGRAPH_BAR_GLYPH      0
+#define LCDGRAPH_SPARK_GLYPH    1    // First sparkline glyph
+#define LCDGRAPH_SPARK_CELLS    7
+#define LCDGRAPH_SPARK_SAMPLES  (LCDGRAPH_SPARK_CELLS * 5)
+#define LCDGRAPH_MAX_WIDTH      16
+#define LCDGRAPH_SPARK_EMPTY    0xFF // Column height with no pixels
+
+/**************************************************************************
+ * Function: lcdGraphInit
+ * Description:
+ *    Forgets the RAM copies so the next draw sends everything, and empties
+ *    the sparkline. Call after lcdInit() and whenever the display has been
+ *    cleared (e.g. by lcdDisplayText()).
+ **************************************************************************/
+void lcdGraphInit(void);
+
+/**************************************************************************
+ * Function: lcdBarDraw
+ * Description:
+ *    Draws a horizontal bar with 5 steps per character cell.
+ * Parameters:
+ *    row, col - Position of the left end
+ *    width - Cells used (up to LCDGRAPH_MAX_WIDTH)
+ *    value - Value to show
+ *    max - Value that fills the whole width
+ * Returns:
+ *    Number of LCD bus writes (commands and data) made.
+ **************************************************************************/
+unsigned int lcdBarDraw(unsigned char row, unsigned char col, unsigned char width,
+                        unsigned int value, unsigned int max);
+
+/**************************************************************************
+ * Function: lcdSparkPush
+ * Description:
+ *    Adds a sample to the sparkline, dropping the oldest when it is full.
+ * Parameters:
+ *    sample - New sample
+ **************************************************************************/
+void lcdSparkPush(unsigned int sample);
+
+/**************************************************************************
+ * Function: lcdSparkDraw
+ * Description:
+ *    Draws the sparkline, scaled between the smallest and largest samples
+ *    shown. The right-hand cell fills a column per sample, then the line
+ *    steps left by a cell.
+ * Parameters:
+ *    row, col - Position of the left end (LCDGRAPH_SPARK_CELLS wide)
+ * Returns:
+ *    Number of LCD bus writes made.
+ **************************************************************************/
+unsigned int lcdSparkDraw(unsigned char row, unsigned char col);
+
+/**************************************************************************
+ * Function: lcdGlyphBar
+ * Description:
+ *    Builds the bitmap of a cell with its left columns filled.
+ * Parameters:
+ *    columns - Filled columns, 0 to 5
+ *    glyph - Destination, 8 rows of 5 bits, top row first
+ **************************************************************************/
+void lcdGlyphBar(unsigned char columns, unsigned char *glyph);
+
+/**************************************************************************
+ * Function: lcdGlyphSpark
+ * Description:
+ *    Builds the bitmap of one sparkline cell, 5 columns filled up from the
+ *    bottom.
+ * Parameters:
+ *    heights - 5 column heights, 0 (one pixel) to 7 (full), or
+ *              LCDGRAPH_SPARK_EMPTY
+ *    glyph - Destination, 8 rows of 5 bits, top row first
+ **************************************************************************/
+void lcdGlyphSpark(const unsigned char *heights, unsigned char *glyph);
+
+/**************************************************************************
+ * Function: lcdGlyphUpload
+ * Description:
+ *    Sends the rows of a glyph that differ from the RAM copy.
+ * Parameters:
+ *    slot - Glyph number, 0 to 7
+ *    glyph - New bitmap, 8 rows
+ * Returns:
+ *    Number of LCD bus writes made.
+ **************************************************************************/
+unsigned int lcdGlyphUpload(unsigned char slot, const unsigned char *glyph);
+
+#endif /* LCDGRAPH_H_ */
@@ -0,0 +1,212 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: lightCodec.c
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Defined the delta/zigzag/Rice encoder and decoder.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#include "lightCodec.h"
+#include "profile.h"
+
+#define SUM_START   4       // Starting mean of 4 gives k = 2
+#define SUM_LIMIT   4095    // Largest value added to the running sum
+#define COUNT_LIMIT 16      // Sum and count are halved at this count
+
+/**************************************************************************
+ * Function: riceParameter
+ * Description:
+ *    Smallest k with count * 2^k >= sum, i.e. k tracks log2 of the mean.
+ **************************************************************************/
+static unsigned char riceParameter(unsigned int sum, unsigned char count) {
+    unsigned char k = 0;
+    while (((unsigned int)count << k) < sum && k < 15) k++;
+    return k;
+}
+
+/**************************************************************************
+ * Function: riceUpdate
+ **************************************************************************/
+static void riceUpdate(unsigned int *sum, unsigned char *count, unsigned int value) {
+    *sum += value > SUM_LIMIT ? SUM_LIMIT : value;
+    if (++(*count) == COUNT_LIMIT) {
+        *sum >>= 1;
+        *count >>= 1;
+    }
+}
+
+/**************************************************************************
+ * Function: putBits
+ * Description:
+ *    Appends the low bitCount bits of value, most significant first.
+ **************************************************************************/
+static void putBits(LightEncoder *encoder, unsigned int value, unsigned char bitCount) {
+    while (bitCount--) {
+        if (encoder->bitsFree == 0) {
+            encoder->buffer[encoder->bytes++] = 0;
+            encoder->bitsFree = 8;
+        }
+        encoder->bitsFree--;
+        if ((value >> bitCount) & 1) {
+            encoder->buffer[encoder->bytes - 1] |= 1 << encoder->bitsFree;
+        }
+    }
+}
+
+/**************************************************************************
+ * Function: lightEncoderInit
+ **************************************************************************/
+void lightEncoderInit(LightEncoder *encoder, unsigned char *buffer, unsigned int capacity,
+                      unsigned int *index, unsigned int indexSize) {
+    encoder->buffer = buffer;
+    encoder->capacity = capacity;
+    encoder->bytes = 0;
+    encoder->bitsFree = 0;
+    encoder->previous = 0;
+    encoder->position = 0;
+    encoder->sum = SUM_START;
+    encoder->count = 1;
+    encoder->index = index;
+    encoder->indexSize = indexSize;
+    encoder->keyframes = 0;
+    encoder->samples = 0;
+}
+
+/**************************************************************************
+ * Function: lightEncode
+ **************************************************************************/
+int lightEncode(LightEncoder *encoder, unsigned int sample) {
+    unsigned int delta, value, quotient;
+    unsigned char k;
+
+    if (encoder->bytes + LIGHTCODEC_MAX_BYTES > encoder->capacity) return 0;
+
+    PROFILE_BEGIN(PROFILE_LIGHT_ENCODE);
+    sample &= 0xFFFF;
+
+    if (encoder->position == 0) {
+        // Keyframe: byte aligned, raw, adaptation restarted
+        if (encoder->keyframes < encoder->indexSize) {
+            encoder->index[encoder->keyframes] = encoder->bytes;
+        }
+        encoder->keyframes++;
+        encoder->buffer[encoder->bytes++] = (unsigned char)(sample >> 8);
+        encoder->buffer[encoder->bytes++] = (unsigned char)sample;
+        encoder->bitsFree = 0;
+        encoder->sum = SUM_START;
+        encoder->count = 1;
+    } else {
+        delta = (sample - encoder->previous) & 0xFFFF;
+        value = ((delta << 1) ^ ((delta & 0x8000) ? 0xFFFF : 0)) & 0xFFFF;  // Zigzag
+
+        k = riceParameter(encoder->sum, encoder->count);
+        quotient = value >> k;
+        if (quotient < LIGHTCODEC_ESCAPE) {
+            putBits(encoder, (1 << quotient) - 1, quotient);
+            putBits(encoder, 0, 1);
+            putBits(encoder, value, k);
+        } else {
+            putBits(encoder, (1 << LIGHTCODEC_ESCAPE) - 1, LIGHTCODEC_ESCAPE);
+            putBits(encoder, value, 16);
+        }
+        riceUpdate(&encoder->sum, &encoder->count, value);
+    }
+
+    encoder->previous = sample;
+    if (++encoder->position == LIGHTCODEC_KEYFRAME) encoder->position = 0;
+    encoder->samples++;
+    PROFILE_END(PROFILE_LIGHT_ENCODE);
+    return 1;
+}
+
+/**************************************************************************
+ * Function: lightEncoderBytes
+ **************************************************************************/
+unsigned int lightEncoderBytes(const LightEncoder *encoder) {
+    return encoder->bytes;
+}
+
+/**************************************************************************
+ * Function: getBit
+ **************************************************************************/
+static unsigned int getBit(LightDecoder *decoder) {
+    unsigned long byte = decoder->bitPosition >> 3;
+    unsigned char shift = 7 - (unsigned char)(decoder->bitPosition & 7);
+
+    decoder->bitPosition++;
+    if (byte >= decoder->length) return 0;
+    return (decoder->buffer[byte] >> shift) & 1;
+}
+
+/**************************************************************************
+ * Function: getBits
+ **************************************************************************/
+static unsigned int getBits(LightDecoder *decoder, unsigned char bitCount) {
+    unsigned int value = 0;
+    while (bitCount--) value = (value << 1) | getBit(decoder);
+    return value;
+}
+
+/**************************************************************************
+ * Function: lightDecoderInit
+ **************************************************************************/
+void lightDecoderInit(LightDecoder *decoder, const unsigned char *buffer, unsigned int length,
+                      unsigned long samples) {
+    decoder->buffer = buffer;
+    decoder->length = length;
+    decoder->samples = samples;
+    decoder->bitPosition = 0;
+    decoder->previous = 0;
+    decoder->position = 0;
+    decoder->sum = SUM_START;
+    decoder->count = 1;
+}
+
+/**************************************************************************
+ * Function: lightDecoderSeek
+ **************************************************************************/
+int lightDecoderSeek(LightDecoder *decoder, unsigned int keyframe, unsigned int offset) {
+    unsigned long skipped = (unsigned long)keyframe * LIGHTCODEC_KEYFRAME;
+
+    if (skipped >= decoder->samples || offset >= decoder->length) return 0;
+    decoder->samples -= skipped;
+    decoder->bitPosition = (unsigned long)offset << 3;
+    decoder->position = 0;
+    return 1;
+}
+
+/**************************************************************************
+ * Function: lightDecode
+ **************************************************************************/
+int lightDecode(LightDecoder *decoder, unsigned int *sample) {
+    unsigned int value, quotient = 0;
+    unsigned char k;
+
+    if (decoder->samples == 0) return 0;
+    decoder->samples--;
+
+    if (decoder->position == 0) {
+        decoder->bitPosition = (decoder->bitPosition + 7) & ~7UL;
+        decoder->previous = getBits(decoder, 16);
+        decoder->sum = SUM_START;
+        decoder->count = 1;
+    } else {
+        k = riceParameter(decoder->sum, decoder->count);
+        while (quotient < LIGHTCODEC_ESCAPE && getBit(decoder)) quotient++;
+        if (quotient < LIGHTCODEC_ESCAPE) {
+            value = (quotient << k) | getBits(decoder, k);
+        } else {
+            value = getBits(decoder, 16);
+        }
+        riceUpdate(&decoder->sum, &decoder->count, value);
+
+        value = (value & 1) ? (~(value >> 1) & 0xFFFF) : (value >> 1);      // Undo zigzag
+        decoder->previous = (decoder->previous + value) & 0xFFFF;
+    }
+
+    if (++decoder->position == LIGHTCODEC_KEYFRAME) decoder->position = 0;
+    *sample = decoder->previous;
+    return 1;
+}
@@ -0,0 +1,147 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: lightCodec.h
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Initial creation of the light-curve compression codec.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#ifndef LIGHTCODEC_H_
+#define LIGHTCODEC_H_
+
+/**************************************************************************
+ * Streaming codec for light-curve samples (up to 16 bits).
+ *
+ * Each sample is stored as the difference from the one before, zigzag
+ * mapped to unsigned (0, -1, 1, -2 ... -> 0, 1, 2, 3 ...) and Rice coded:
+ * the value >> k in unary (ones ended by a zero) then the low k bits. k
+ * follows the running mean of recent values, so a quiet curve costs 2-4
+ * bits per sample and a noisy one adapts without a side channel. A
+ * quotient of LIGHTCODEC_ESCAPE or more is sent as LIGHTCODEC_ESCAPE ones
+ * and the raw 16-bit value, which bounds every sample to 28 bits.
+ *
+ * Every LIGHTCODEC_KEYFRAME samples the stream is padded to a byte, the
+ * sample is stored raw in two bytes and the adaptation restarts. Keyframe
+ * byte offsets can be recorded in an index, and decoding can start at any
+ * of them.
+ *
+ * Bits are packed most significant first. The code is plain C, shared by
+ * the firmware and host tools.
+ **************************************************************************/
+#define LIGHTCODEC_KEYFRAME    64   // Samples per block, including the keyframe
+#define LIGHTCODEC_ESCAPE      12   // Unary length that marks a raw value
+#define LIGHTCODEC_MAX_BYTES   5    // Worst case bytes written by one sample
+
+/**************************************************************************
+ * Structure: LightEncoder
+ * Description:
+ *    Encoder state. The caller supplies the output buffer (which may be
+ *    in FRAM) and optionally an array for the keyframe index.
+ **************************************************************************/
+typedef struct {
+    unsigned char *buffer;
+    unsigned int capacity;
+    unsigned int bytes;            // Bytes started, the last may be partial
+    unsigned char bitsFree;        // Unused bits in buffer[bytes - 1]
+    unsigned int previous;
+    unsigned int position;         // Sample number within the block
+    unsigned int sum;              // Running sum of coded values for k
+    unsigned char count;           // Values in sum
+    unsigned int *index;
+    unsigned int indexSize;
+    unsigned int keyframes;
+    unsigned long samples;
+} LightEncoder;
+
+/**************************************************************************
+ * Structure: LightDecoder
+ * Description:
+ *    Decoder state, mirroring the encoder.
+ **************************************************************************/
+typedef struct {
+    const unsigned char *buffer;
+    unsigned int length;
+    unsigned long samples;         // Samples left in the stream
+    unsigned long bitPosition;
+    unsigned int previous;
+    unsigned int position;
+    unsigned int sum;
+    unsigned char count;
+} LightDecoder;
+
+/**************************************************************************
+ * Function: lightEncoderInit
+ * Description:
+ *    Starts a new stream.
+ * Parameters:
+ *    encoder - Encoder state
+ *    buffer, capacity - Output buffer
+ *    index, indexSize - Array for keyframe byte offsets, or 0 and 0
+ **************************************************************************/
+void lightEncoderInit(LightEncoder *encoder, unsigned char *buffer, unsigned int capacity,
+                      unsigned int *index, unsigned int indexSize);
+
+/**************************************************************************
+ * Function: lightEncode
+ * Description:
+ *    Appends one sample. The cost is bounded by LIGHTCODEC_ESCAPE plus 16
+ *    bit writes.
+ * Parameters:
+ *    encoder - Encoder state
+ *    sample - Sample value
+ * Returns:
+ *    1 if the sample was stored, 0 if the buffer might not hold it (the
+ *    stream is left unchanged).
+ **************************************************************************/
+int lightEncode(LightEncoder *encoder, unsigned int sample);
+
+/**************************************************************************
+ * Function: lightEncoderBytes
+ * Description:
+ *    Returns the number of buffer bytes the stream occupies. The unused
+ *    bits of the last byte are zero.
+ **************************************************************************/
+unsigned int lightEncoderBytes(const LightEncoder *encoder);
+
+/**************************************************************************
+ * Function: lightDecoderInit
+ * Description:
+ *    Starts decoding a stream from its first sample.
+ * Parameters:
+ *    decoder - Decoder state
+ *    buffer, length - Encoded stream
+ *    samples - Number of samples in the stream (the encoder's samples)
+ **************************************************************************/
+void lightDecoderInit(LightDecoder *decoder, const unsigned char *buffer, unsigned int length,
+                      unsigned long samples);
+
+/**************************************************************************
+ * Function: lightDecoderSeek
+ * Description:
+ *    Moves to a keyframe, so the next sample decoded is sample number
+ *    keyframe * LIGHTCODEC_KEYFRAME of the stream. Only valid straight
+ *    after lightDecoderInit().
+ * Parameters:
+ *    decoder - Decoder state
+ *    keyframe - Keyframe number
+ *    offset - Byte offset of that keyframe, from the encoder's index
+ * Returns:
+ *    1 on success, 0 if the keyframe is past the end of the stream.
+ **************************************************************************/
+int lightDecoderSeek(LightDecoder *decoder, unsigned int keyframe, unsigned int offset);
+
+/**************************************************************************
+ * Function: lightDecode
+ * Description:
+ *    Decodes the next sample.
+ * Parameters:
+ *    decoder - Decoder state
+ *    sample - Destination for the sample
+ * Returns:
+ *    1 if a sample was decoded, 0 at the end of the stream.
+ **************************************************************************/
+int lightDecode(LightDecoder *decoder, unsigned int *sample);
+
+#endif /* LIGHTCODEC_H_ */
@@ -1,60 +1,109 @@
-/**************************************************************************
- * Project Name: Exoplanet Detection Simulator
- * Module Name: lightIntensity.h
- * Created on: 21 March 2024
- * Date Last Updated: 02/05/2024
- * Update Description:
- *    Defined blockingReadADC function.
- * Author: Finlay Harris
- **************************************************************************/
-
-#ifndef LIGHTSENSOR_H_
-#define LIGHTSENSOR_H_
-
-#include <msp430fr4133.h>
-
-/**************************************************************************
- * Function: initADC
- * Description:
- *    Initialises the ADC for reading light intensity from a phototransistor
- *    connected to P1.4. This function configures the ADC to use AVCC and AVSS
- *    as references and sets the sample and hold time.
- **************************************************************************/
-void initADC(void);
-
-/**************************************************************************
- * Function: startADC
- * Description:
- *    Starts the ADC conversion process by enabling ADC interrupts and
- *    starting the conversion. This setup allows for continuous reading
- *    as needed by enabling and starting the ADC converter.
- **************************************************************************/
-void startADC(void);
-
-/**************************************************************************
- * Function: blockingReadADC
- * Description:
- *    Performs a synchronous (blocking) read of the ADC. This function
- *    starts an ADC conversion and waits until it is complete, returning
- *    the result.
- * Returns:
- *    adcResult - The result of the ADC conversion.
- **************************************************************************/
-unsigned int blockingReadADC(void);
-
-/**************************************************************************
- * Function: adcValueToPercentage
- * Description:
- *    Converts an ADC value to a percentage relative to defined minimum and
- *    maximum values. This function provides a normalised output between 0%
- *    and 100% based on specified thresholds.
- * Parameters:
- *    adcValue - The ADC value to convert.
- *    minADCValue - The minimum ADC value corresponding to 0%.
- *    maxADCValue - The maximum ADC value corresponding to 100%.
- * Returns:
- *    The percentage representation of the adcValue.
- **************************************************************************/
-int adcValueToPercentage(unsigned int adcValue, unsigned int minADCValue, unsigned int maxADCValue);
-
-#endif /* LIGHTSENSOR_H_ */
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: lightIntensity.h
+ * Created on: 21 March 2024
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Added running statistics of the light readings.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#ifndef LIGHTSENSOR_H_
+#define LIGHTSENSOR_H_
+
+#include <msp430fr4133.h>
+#include "lightStats.h"
+
+/**************************************************************************
+ * Light statistics: once started, every ADC sequence's raw light reading
+ * is added to a LightStats (lightStats.h) from ADC_ISR, so they cover
+ * every sample whatever the main loop is doing. They are of raw A4
+ * readings; supply and temperature drift slowly next to the window, so
+ * compare the mean with a reading rather than with a compensated value.
+ **************************************************************************/
+#ifndef LIGHT_STATS_WINDOW_SHIFT
+#define LIGHT_STATS_WINDOW_SHIFT 8   // Mean/variance over about 256 sequences (2.56 s)
+#endif
+#ifndef LIGHT_STATS_EMA_SHIFT
+#define LIGHT_STATS_EMA_SHIFT    3   // EMA over about 8 sequences (80 ms)
+#endif
+
+/**************************************************************************
+ * Function: initADC
+ * Description:
+ *    Initialises the ADC for reading light intensity from a phototransistor
+ *    connected to P1.4. This function configures the ADC to use AVCC and AVSS
+ *    as references and sets the sample and hold time.
+ **************************************************************************/
+void initADC(void);
+
+/**************************************************************************
+ * Function: startADC
+ * Description:
+ *    Starts the ADC conversion process by enabling ADC interrupts and
+ *    starting the conversion. This setup allows for continuous reading
+ *    as needed by enabling and starting the ADC converter.
+ **************************************************************************/
+void startADC(void);
+
+/**************************************************************************
+ * Function: blockingReadADC
+ * Description:
+ *    Performs a synchronous (blocking) read of the ADC. This function
+ *    starts an ADC conversion and waits until it is complete, returning
+ *    the result.
+ * Returns:
+ *    adcResult - The result of the ADC conversion.
+ **************************************************************************/
+unsigned int blockingReadADC(void);
+
+/**************************************************************************
+ * Function: adcValueToPercentage
+ * Description:
+ *    Converts an ADC value to a percentage relative to defined minimum and
+ *    maximum values. This function provides a normalised output between 0%
+ *    and 100% based on specified thresholds.
+ * Parameters:
+ *    adcValue - The ADC value to convert.
+ *    minADCValue - The minimum ADC value corresponding to 0%.
+ *    maxADCValue - The maximum ADC value corresponding to 100%.
+ * Returns:
+ *    The percentage representation of the adcValue.
+ **************************************************************************/
+int adcValueToPercentage(unsigned int adcValue, unsigned int minADCValue, unsigned int maxADCValue);
+
+/**************************************************************************
+ * Function: startLightStats
+ * Description:
+ *    Clears the light statistics and feeds them from the ADC sequence
+ *    (adcSequence.h) from now on. Takes over the sequence hook.
+ * Parameters:
+ *    windowShift - Mean/variance window, 2^windowShift sequences
+ *    emaShift - EMA weight 2^-emaShift
+ **************************************************************************/
+void startLightStats(unsigned char windowShift, unsigned char emaShift);
+
+/**************************************************************************
+ * Function: stopLightStats
+ * Description:
+ *    Stops feeding the light statistics. They keep their last values.
+ **************************************************************************/
+void stopLightStats(void);
+
+/**************************************************************************
+ * Function: readLightStats
+ * Description:
+ *    Takes a snapshot of the light statistics.
+ * Parameters:
+ *    snapshot - Filled in (see LightStatsSnapshot)
+ **************************************************************************/
+void readLightStats(LightStatsSnapshot *snapshot);
+
+/**************************************************************************
+ * Function: resetLightStats
+ * Description:
+ *    Clears the light statistics, keeping the windows.
+ **************************************************************************/
+void resetLightStats(void);
+
+#endif /* LIGHTSENSOR_H_ */
@@ -0,0 +1,147 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: lightStats.c
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Defined the Welford update, EMA and snapshot conversion.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#include "lightStats.h"
+#include <string.h>
+
+#define MEAN_SHIFT      16                      // Q16 mean and ema
+#define VARIANCE_SHIFT  10                      // Q10 variance, from Q5 deltas
+#define DELTA_SHIFT     (MEAN_SHIFT - VARIANCE_SHIFT / 2)
+
+// 65536 / n rounded, for n = 2 upwards, worked out by the compiler
+#define RECIP(n)    (unsigned int)((65536UL + (n) / 2) / (n))
+#define RECIP4(n)   RECIP(n), RECIP(n + 1), RECIP(n + 2), RECIP(n + 3)
+#define RECIP16(n)  RECIP4(n), RECIP4(n + 4), RECIP4(n + 8), RECIP4(n + 12)
+#define RECIP64(n)  RECIP16(n), RECIP16(n + 16), RECIP16(n + 32), RECIP16(n + 48)
+
+static const unsigned int reciprocals[] = {
+    RECIP64(2), RECIP64(66), RECIP64(130), RECIP64(194)
+};
+
+/**************************************************************************
+ * Function: mulQ16
+ * Description:
+ *    (value * weight) >> 16, rounded, without a 64-bit product: the high
+ *    and low words of value are multiplied separately. weight is at most
+ *    32768 (1/2).
+ **************************************************************************/
+static long mulQ16(long value, unsigned int weight) {
+    return (value >> 16) * (long)weight +
+           (long)(((unsigned long)(value & 0xFFFF) * weight + 0x8000UL) >> 16);
+}
+
+/**************************************************************************
+ * Function: squareRoot
+ * Description:
+ *    Integer square root, rounded to nearest (bit by bit).
+ **************************************************************************/
+static unsigned int squareRoot(unsigned long value) {
+    unsigned long root = 0, bit = 1UL << 30;
+
+    while (bit > value) bit >>= 2;
+    while (bit) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    if (value > root) root++;                   // Remainder past root + 1/2
+    return (unsigned int)root;
+}
+
+/**************************************************************************
+ * Function: lightStatsInit
+ **************************************************************************/
+void lightStatsInit(LightStats *stats, unsigned char windowShift, unsigned char emaShift) {
+    if (windowShift < 1) windowShift = 1;
+    if (windowShift > LIGHTSTATS_MAX_WINDOW_SHIFT) windowShift = LIGHTSTATS_MAX_WINDOW_SHIFT;
+    if (emaShift > LIGHTSTATS_MAX_EMA_SHIFT) emaShift = LIGHTSTATS_MAX_EMA_SHIFT;
+    stats->windowShift = windowShift;
+    stats->emaShift = emaShift;
+    lightStatsReset(stats);
+}
+
+/**************************************************************************
+ * Function: lightStatsReset
+ **************************************************************************/
+void lightStatsReset(LightStats *stats) {
+    stats->count = 0;
+    stats->min = 0;
+    stats->max = 0;
+    stats->mean = 0;
+    stats->variance = 0;
+    stats->varianceCarry = 0;
+    stats->ema = 0;
+}
+
+/**************************************************************************
+ * Function: lightStatsUpdate
+ **************************************************************************/
+void lightStatsUpdate(LightStats *stats, unsigned int sample) {
+    long x, delta, step, spread;
+    unsigned int n;
+
+    if (sample > LIGHTSTATS_MAX_SAMPLE) sample = LIGHTSTATS_MAX_SAMPLE;
+    x = (long)sample << MEAN_SHIFT;
+    if (stats->count < 0xFFFF) stats->count++;
+    n = stats->count;
+
+    if (n == 1) {
+        stats->min = stats->max = sample;
+        stats->mean = stats->ema = x;
+        stats->variance = 0;
+        return;
+    }
+    if (sample < stats->min) stats->min = sample;
+    if (sample > stats->max) stats->max = sample;
+    stats->ema += (x - stats->ema) >> stats->emaShift;
+
+    // Welford: weight 1/n until the window is full, then 2^-windowShift.
+    // (x - old mean) * (x - new mean) is taken from Q5 deltas, which
+    // keeps the product of two 10-bit differences inside a long.
+    delta = x - stats->mean;
+    if ((n >> stats->windowShift) == 0) {
+        step = mulQ16(delta, reciprocals[n - 2]);
+        stats->mean += step;
+        spread = ((delta + (1L << (DELTA_SHIFT - 1))) >> DELTA_SHIFT) *
+                 ((delta - step + (1L << (DELTA_SHIFT - 1))) >> DELTA_SHIFT);
+        stats->variance += mulQ16(spread - stats->variance, reciprocals[n - 2]);
+    } else {
+        step = delta >> stats->windowShift;
+        stats->mean += step;
+        spread = ((delta + (1L << (DELTA_SHIFT - 1))) >> DELTA_SHIFT) *
+                 ((delta - step + (1L << (DELTA_SHIFT - 1))) >> DELTA_SHIFT);
+        // The bits shifted out are carried into the next update; otherwise
+        // rounding stalls the variance up to 2^windowShift Q10 steps out
+        spread += stats->varianceCarry - stats->variance;
+        step = spread >> stats->windowShift;
+        stats->varianceCarry = (int)(spread - (step << stats->windowShift));
+        stats->variance += step;
+    }
+}
+
+/**************************************************************************
+ * Function: lightStatsSnapshot
+ **************************************************************************/
+void lightStatsSnapshot(const LightStats *stats, LightStatsSnapshot *snapshot) {
+    memset(snapshot, 0, sizeof(*snapshot));
+    if (!stats->count) return;
+    snapshot->count = stats->count;
+    snapshot->min = stats->min;
+    snapshot->max = stats->max;
+    snapshot->mean = (unsigned int)((stats->mean + (1L << (MEAN_SHIFT - 5))) >> (MEAN_SHIFT - 4));
+    snapshot->ema = (unsigned int)((stats->ema + (1L << (MEAN_SHIFT - 5))) >> (MEAN_SHIFT - 4));
+    snapshot->variance = stats->variance <= 0 ? 0 :
+                         (unsigned long)(stats->variance + (1L << (VARIANCE_SHIFT - 9))) >> (VARIANCE_SHIFT - 8);
+    snapshot->stdDev = squareRoot(snapshot->variance);
+}
@@ -0,0 +1,124 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: lightStats.h
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Initial creation of the streaming light statistics.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#ifndef LIGHTSTATS_H_
+#define LIGHTSTATS_H_
+
+/**************************************************************************
+ * Running statistics over a stream of 10-bit light samples, updated one
+ * sample at a time with no stored history and no division.
+ *
+ * Mean and variance use Welford's update with weight w:
+ *    d = x - mean;  mean += w * d;  variance += w * (d * (x - mean) - variance)
+ * For the first 2^windowShift samples w is 1/n, which gives the mean
+ * and (population) variance of everything so far; 1/n comes from a
+ * table of Q16 reciprocals, whose rounding keeps the mean within a
+ * few hundredths of a count of exact. After that w stays at 2^-windowShift, so
+ * both become exponentially weighted over about the last 2^windowShift
+ * samples and the update is shifts only. A step in the light level shows
+ * up within a window rather than being averaged away by a long history.
+ *
+ * Separately, ema is an exponential moving average with weight
+ * 2^-emaShift from the first sample, and min/max cover everything since
+ * the last reset.
+ *
+ * Internally the mean and ema are Q16 counts and the variance is Q10
+ * counts squared, all in longs; one update costs a handful of 16x16
+ * multiplies. Snapshots are rounded to Q4 (1/16 count) and Q8.
+ *
+ * The code is plain C, shared by the firmware and host tools. Nothing
+ * here disables interrupts; a caller feeding stats from an ISR reads and
+ * resets them with that interrupt off (see lightIntensity.h).
+ **************************************************************************/
+#define LIGHTSTATS_MAX_SAMPLE        1023  // 10-bit samples
+#define LIGHTSTATS_MAX_WINDOW_SHIFT  8     // Up to 256 samples
+#define LIGHTSTATS_MAX_EMA_SHIFT     10    // Up to about 1024 samples
+
+/**************************************************************************
+ * Structure: LightStats
+ * Description:
+ *    Running state. Set up with lightStatsInit().
+ **************************************************************************/
+typedef struct {
+    unsigned char windowShift;     // Mean/variance window, 2^windowShift samples
+    unsigned char emaShift;        // EMA weight 2^-emaShift
+    unsigned int count;            // Samples since reset, stops at 65535
+    unsigned int min;
+    unsigned int max;
+    long mean;                     // Q16
+    long variance;                 // Q10
+    int varianceCarry;             // Q10 remainder from the last shift
+    long ema;                      // Q16
+} LightStats;
+
+/**************************************************************************
+ * Structure: LightStatsSnapshot
+ * Description:
+ *    Statistics at one moment, in sample counts.
+ * Members:
+ *    count - Samples since reset (stops at 65535)
+ *    min, max - Extremes since reset
+ *    mean - Windowed mean, Q4 (sixteenths of a count)
+ *    ema - Exponential moving average, Q4
+ *    variance - Windowed variance, Q8 (counts squared / 256)
+ *    stdDev - Square root of variance, Q4
+ **************************************************************************/
+typedef struct {
+    unsigned int count;
+    unsigned int min;
+    unsigned int max;
+    unsigned int mean;
+    unsigned int ema;
+    unsigned long variance;
+    unsigned int stdDev;
+} LightStatsSnapshot;
+
+/**************************************************************************
+ * Function: lightStatsInit
+ * Description:
+ *    Sets the windows and clears the statistics.
+ * Parameters:
+ *    stats - State to set up
+ *    windowShift - Mean/variance window, 1 to LIGHTSTATS_MAX_WINDOW_SHIFT
+ *                  (clamped)
+ *    emaShift - EMA weight 2^-emaShift, 0 to LIGHTSTATS_MAX_EMA_SHIFT
+ *               (clamped)
+ **************************************************************************/
+void lightStatsInit(LightStats *stats, unsigned char windowShift, unsigned char emaShift);
+
+/**************************************************************************
+ * Function: lightStatsReset
+ * Description:
+ *    Clears the statistics, keeping the windows.
+ **************************************************************************/
+void lightStatsReset(LightStats *stats);
+
+/**************************************************************************
+ * Function: lightStatsUpdate
+ * Description:
+ *    Adds one sample. Short enough for an ISR.
+ * Parameters:
+ *    stats - Running state
+ *    sample - 0 to LIGHTSTATS_MAX_SAMPLE (larger values are clamped)
+ **************************************************************************/
+void lightStatsUpdate(LightStats *stats, unsigned int sample);
+
+/**************************************************************************
+ * Function: lightStatsSnapshot
+ * Description:
+ *    Converts the running state to a snapshot. All zero before the first
+ *    sample.
+ * Parameters:
+ *    stats - Running state
+ *    snapshot - Filled in
+ **************************************************************************/
+void lightStatsSnapshot(const LightStats *stats, LightStatsSnapshot *snapshot);
+
+#endif /* LIGHTSTATS_H_ */
@@ -1,254 +1,329 @@
-/**************************************************************************
- * Project Name: Exoplanet Detection Simulator
- * Module Name: main
- * Created on: 12 Feb 2024
- * Date Last Updated: 02/05/2024
- * Update Description:
- *    Changed colour & light sensor button pins.
- * Author: Finlay Harris
- **************************************************************************/
-
-// Include necessary header files & libraries
-#include "GasSpectra.h"
-#include "colours.h"
-#include "pwm.h"
-#include "lcd.h"
-#include "colourSensor.h"
-#include "lightIntensity.h"
-#include <msp430fr4133.h>
-#include<stdio.h>
-#include<string.h>
-
-/**************************************************************************
- * Functions to intilise all system elements & buttons correctly
- **************************************************************************/
-void initialiseSystem(void) {
-    WDTCTL = WDTPW | WDTHOLD;  // Stop watchdog timer
-    PM5CTL0 &= ~LOCKLPM5;      // Disable GPIO power-on default high-impedance mode
-
-    setupGPIO();               // Setup GPIO for LEDs
-    setupPWM();                // Setup PWM for LEDs
-    setupTimerForSWPWM();      // Setup software PWM time control
-}
-
-void initLightButton(void) {
-    P5DIR &= ~BIT0;            // Set P5.0 as input
-    P5REN |= BIT0;             // Enable pull-up/pull-down resistor
-    P5OUT |= BIT0;             // Select pull-up mode
-
-}
-
-void initialiseRGBButton(void) {
-    P5DIR &= ~BIT2;            // Set P5.2 to input
-    P5REN |= BIT2;             // Enable pull-up/pull-down resistor
-    P5OUT |= BIT2;             // Select pull-up mode
-}
-
-void initialiseColourSensorButton(void) {
-    P5DIR &= ~BIT3;            // Set P5.3 as input
-    P5REN |= BIT3;             // Enable pull-up/pull-down resistor
-    P5OUT |= BIT3;             // Select pull-up mode
-
-}
-
-/**************************************************************************
- * Functions to test if buttons are pressed
- * Returns 1 if button is pressed (active low)
- **************************************************************************/
-int isLightButtonPressed(void) {
-    return (P5IN & BIT0) == 0;
-}
-
-int isRGBButtonPressed(void) {
-    return (P5IN & BIT2) == 0;
-}
-
-int isColourSensorButtonPressed(void) {
-    return (P5IN & BIT3) == 0;
-}
-
-/**************************************************************************
- * Functions to check if detected is white, red or blue.
- **************************************************************************/
-int isDetectedColorValid() {
-    char* detectedColor = Identify_Colour();        // Get the detected colour as a string
-    return strcmp(detectedColor, "White") == 0 ||
-           strcmp(detectedColor, "Red") == 0 ||
-           strcmp(detectedColor, "Blue") == 0;
-}
-
-/**************************************************************************
- * Functions to check if light intensity is below threshold.
- **************************************************************************/
-int isLightIntensityBelowThreshold(unsigned int threshold) {
-    initADC();                                         // Initialise ADC for the light sensor
-    unsigned int adcValue = blockingReadADC();         // Read ADC value using the blocking function
-    int percentage = adcValueToPercentage(adcValue, 3, 75); // Convert ADC value to percentage
-
-    return percentage < threshold;                     // Return true if light intensity is below threshold
-}
-
-/**************************************************************************
- * Main Function
- **************************************************************************/
-int main(void) {
-    // Initlising entire system - GPIO,PWM, buttons, LCD, ADC
-    initialiseSystem();                      // Setup system, GPIO, PWM
-    initLightButton();                       // Initialise the button
-    initialiseRGBButton();
-    initialiseColourSensorButton();
-    lcdInit();                              // Initialise the LCD
-    initADC();                              // Initialise ADC for the light sensor
-
-    // Defining constant values for ADC
-    unsigned const int minADCValue = 3;     // Minimum possible ADC value
-    unsigned const int maxADCValue = 150;    // Maximum possible ADC value
-
-    // Enable global interrupts
-    _bis_SR_register(GIE);
-    lcdDisplayText("Emission", " Spectrum 1");
-
-
-    // Loop to check when buttons are pressed
-        while(1) {
-
-            // Check if the RGB button is pressed
-            // If pressed display text on LCD...
-            // ... & show colours on RGB...
-            // ... only if a ' planet is found '
-            // AKA- the light intensity is below 100 or red,blue or white is sensed
-            // Otherwise display no planet found
-            // This is simply a sequence of different gas spectrums shown using the RGB when a planet is found
-
-            if (isRGBButtonPressed()) {
-                //if (isLightIntensityBelowThreshold(100) && isDetectedColorValid()) {
-                        lcdDisplayText("Emission", " Spectrum 1");
-                        __delay_cycles(50000);
-                        displayGasSpectrum("Hydrogen");
-                        setColour(&off);
-
-                        lcdDisplayText("Emission", " Spectrum 2");
-                        __delay_cycles(50000);
-                        displayGasSpectrum("Helium");
-                        setColour(&off);
-
-                        lcdDisplayText("Emission", " Spectrum 3");
-                        __delay_cycles(50000);
-                        displayGasSpectrum("Nitrogen");
-                        setColour(&off);
-                        lcdDisplayText("", "");
-                    } else {
-                        lcdDisplayText("No Planet", "Found");
-                        __delay_cycles(50000);
-                        setColour(&off);
-
-                   // }
-
-            }
-
-
-
-            // Check if the Colour Sensor button is pressed
-            // If pressed display text on878\ LCD...
-            // ... & call colour detection function
-            // Determine colour sensed via function
-            // Display colour name on LCD
-            // This is simply detecting & identifying the colour sensed, the displaying it
-            if (isColourSensorButtonPressed()) {
-                initialiseColourSensor();                                 // Initialise colour sensor
-                __delay_cycles(10000);                                    // Debounce delay
-                if (isColourSensorButtonPressed()) {
-                    while (isColourSensorButtonPressed());                // Wait for release
-                    lcdDisplayText("Observing", "Colour");
-                    Colour_Detect();                                      // Perform colour detection
-                    char* detectedColour = Identify_Colour();             // Get the detected colour as a string
-                    lcdDisplayText("Detected Colour:", detectedColour);   // Display the detected colour on the LCD
-                }
-            }
-
-            // Check if the Light Sensor button is pressed
-            // If pressed initlise ADC and start conversion...
-            // ... & read ADC value read
-            // Convert ADC value into a percentage
-            // Display percentage on LCD
-            // This is simply detecting & converting the light intensity (voltage)...
-            // ... to an ADC value, mapping it to a percentage and displaying it.
-            if (isLightButtonPressed()) {
-                initADC();                                                                              // Initialise ADC only after button is pressed
-                ADCCTL0 |= ADCENC | ADCSC;                                                              // Enable and start conversion
-                   // Wait until the button is released
-                   while(isLightButtonPressed()) {
-                      // Read the voltage value & Convert to digital signal
-                       unsigned int adcValue = blockingReadADC();
-                       // Convert to percentage
-                       int percentage = adcValueToPercentage(adcValue, minADCValue, maxADCValue);
-                       // Convert percentage int to string
-                       char displayBuffer[32];                                                          // Define a buffer large enough to hold formatted string
-                       sprintf(displayBuffer, " %d%%", percentage);                                     // Format the string with the percentage value
-                       lcdDisplayText("Light Itensity:",displayBuffer);                                 // Pass the formatted string to your display function
-                   }
-
-               }
-
-        }
-
-
-    return 0;
-}
-
-/**************************************************************************
- * Function Name: Timer_A_ISR
- * Description:
- *    Interrupt Service Routine for Timer A. It manages PWM for the LEDs
- *    by adjusting the duty cycle based on a software PWM approach. This
- *    ISR handles the Compare/Capture Interrupt for CCR2. PWM for Blue
- *    and Green LEDs are adjusted within this interrupt.
- **************************************************************************/
-#pragma vector=TIMER0_A1_VECTOR
-__interrupt void Timer_A_ISR(void) {
-    switch(__even_in_range(TA0IV, TA0IV_TAIFG)) {
-        case TA0IV_TACCR2: {                             // Handle CCR1 interrupt
-            static unsigned int pwmCount = 0;
-            pwmCount = (pwmCount + 1) % 256;
-
-            // Software PWM for Blue LED
-            if (pwmCount < blueDutyCycle) P1OUT |= BIT5; // BIT5 for blue LED
-            else P1OUT &= ~BIT5;
-
-            // Software PWM for Green LED
-            if (pwmCount < greenDutyCycle) P1OUT |= BIT6; // BIT6 for green LED
-            else P1OUT &= ~BIT6;
-
-            break;
-        }
-    }
-}
-
-/**************************************************************************
- * Function Name: ADC_ISR
- * Description:
- *    Interrupt Service Routine for the ADC. This ISR handles the ADC
- *    interrupt flag and reads the result from the ADC memory. The result
- *    is stored in adcResult. It also clears the ADC interrupt flag to
- *    prepare for the next ADC operation.
- **************************************************************************/
-#pragma vector=ADC_VECTOR
-__interrupt void ADC_ISR(void) {
-    unsigned int adcResult;
-
-    switch(__even_in_range(ADCIV, ADCIV_ADCIFG)) {
-        case ADCIV_ADCIFG:                           // ADC Interrupt Flag
-            adcResult = ADCMEM0;
-
-            // Clear the interrupt flag
-            ADCIFG &= ~ADCIFG0;
-            break;
-    }
-}
-
-
-
-
-
-
-
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: main
+ * Created on: 12 Feb 2024
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    The detection latency is sent with the planet telemetry events.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+// Include necessary header files & libraries
+#include "GasSpectra.h"
+#include "colours.h"
+#include "pwm.h"
+#include "lcd.h"
+#include "colourSensor.h"
+#include "lightIntensity.h"
+#include "timebase.h"
+#include "clock.h"
+#include "profile.h"
+#include "telemetry.h"
+#include "dataLog.h"
+#include "lcdGraph.h"
+#include "script.h"
+#include "detect.h"
+#include "adcSequence.h"
+#include "boot.h"
+#include "colourCal.h"
+#include "memUsage.h"
+#include "latency.h"
+#include <msp430fr4133.h>
+#include<stdio.h>
+#include<string.h>
+#include<stdlib.h>
+
+/**************************************************************************
+ * Functions to intilise all system elements & buttons correctly
+ **************************************************************************/
+void initLightButton(void) {
+    P5DIR &= ~BIT0;            // Set P5.0 as input
+    P5REN |= BIT0;             // Enable pull-up/pull-down resistor
+    P5OUT |= BIT0;             // Select pull-up mode
+
+}
+
+void initialiseRGBButton(void) {
+    P5DIR &= ~BIT2;            // Set P5.2 to input
+    P5REN |= BIT2;             // Enable pull-up/pull-down resistor
+    P5OUT |= BIT2;             // Select pull-up mode
+}
+
+void initialiseColourSensorButton(void) {
+    P5DIR &= ~BIT3;            // Set P5.3 as input
+    P5REN |= BIT3;             // Enable pull-up/pull-down resistor
+    P5OUT |= BIT3;             // Select pull-up mode
+
+}
+
+/**************************************************************************
+ * Functions to test if buttons are pressed
+ * Returns 1 if button is pressed (active low)
+ **************************************************************************/
+int isLightButtonPressed(void) {
+    return (P5IN & BIT0) == 0;
+}
+
+int isRGBButtonPressed(void) {
+    return (P5IN & BIT2) == 0;
+}
+
+int isColourSensorButtonPressed(void) {
+    return (P5IN & BIT3) == 0;
+}
+
+/**************************************************************************
+ * Colour calibration. Holding the colour button for CALIBRATE_HOLD_MS
+ * measures a white & a black reference target (& with CALIBRATE_MATRIX
+ * red, green & blue targets too), each when the button is pressed, then
+ * stores the result in FRAM. See colourCal.h.
+ **************************************************************************/
+#ifndef CALIBRATE_HOLD_MS
+#define CALIBRATE_HOLD_MS 2000
+#endif
+#ifndef CALIBRATE_MATRIX
+#define CALIBRATE_MATRIX 0
+#endif
+
+static void measureTarget(char *name, unsigned int pulses[3]) {
+    lcdDisplayText("Calibrate: place", name);
+    while (!isColourSensorButtonPressed());  // Wait for a press...
+    delay_ms(10);                            // ... debounce...
+    while (isColourSensorButtonPressed());   // ... & release
+    lcdDisplayText("Measuring", name);
+    colourMeasureRaw(pulses);
+}
+
+static void calibrateColour(void) {
+    unsigned int white[3], black[3];
+    ColourCal cal;
+#if CALIBRATE_MATRIX
+    unsigned int primaries[3][3];
+#endif
+
+    measureTarget("white target", white);
+    measureTarget("black target", black);
+    if (!colourCalFromTargets(white, black, &cal)) {
+        lcdDisplayText("Calibration", "failed: contrast");
+        return;
+    }
+#if CALIBRATE_MATRIX
+    measureTarget("red target", primaries[0]);
+    measureTarget("green target", primaries[1]);
+    measureTarget("blue target", primaries[2]);
+    if (!colourCalSolveMatrix(&cal, primaries)) {
+        lcdDisplayText("Calibration", "failed: colours");
+        return;
+    }
+#endif
+    colourCalSet(&cal);                      // Used from the next reading...
+    bootSaveCalibration();                   // ... & after a reset
+    lcdDisplayText("Colour sensor", "calibrated");
+}
+
+/**************************************************************************
+ * Start-up stages
+ **************************************************************************/
+static void startSampling(void) {
+    adcSeqInit();              // Light, temperature & reference sequence
+    adcSeqStart();             // ... sampled continuously from here on
+    startLightStats(LIGHT_STATS_WINDOW_SHIFT, LIGHT_STATS_EMA_SHIFT);  // Running light statistics
+}
+
+// Set-up stages, run by bootRun() while the LCD powers up
+static const BootStage bootStages[] = {
+    dataLogInit,               // Recover the FRAM sample log
+    setupGPIO,                 // Setup GPIO for LEDs
+    setupPWM,                  // Setup PWM for LEDs
+    setupTimerForSWPWM,        // Setup software PWM time control
+    initLightButton,           // Initialise the buttons
+    initialiseRGBButton,
+    initialiseColourSensorButton,
+    startSampling,
+#if PROFILE_ENABLED
+    profileInit,               // Clear profiling table & calibrate markers
+#endif
+#if LATENCY_ENABLED
+    latencyInit,               // Clear the ISR latency figures
+#endif
+#if TELEMETRY_ENABLED
+    telemetryInit,             // Setup UART telemetry on P1.0
+#endif
+};
+
+/**************************************************************************
+ * Main Function
+ **************************************************************************/
+int main(void) {
+    // Initlising entire system - clock, tick, LCD, GPIO, PWM, buttons, ADC
+    // Interrupts are enabled from here on
+    BootReport boot;
+    bootRun(bootStages, sizeof(bootStages) / sizeof(bootStages[0]), &boot);
+    if (boot.warm) detectRestore(boot.lastPlanet);  // Pick up where the reset left off
+
+    // Defining constant values for ADC
+    unsigned const int minADCValue = 3;     // Minimum possible ADC value
+    unsigned const int maxADCValue = 150;    // Maximum possible ADC value
+
+    DetectResult detection;                 // Latest planet decision
+
+    lcdDisplayText("Emission", " Spectrum 1");
+#if TELEMETRY_ENABLED
+    telemetrySendEvent(boot.warm ? TELEMETRY_EVENT_BOOT_WARM : TELEMETRY_EVENT_BOOT_COLD,
+                       boot.firstSampleUs > 0xFFFF ? 0xFFFF : (unsigned int)boot.firstSampleUs);
+#endif
+
+
+#if (MEMUSAGE_ENABLED || LATENCY_ENABLED) && TELEMETRY_ENABLED
+    unsigned long healthCheckDue = timebaseTicks();
+#endif
+#if LATENCY_ENABLED && TELEMETRY_ENABLED
+    unsigned int missedReported = 0;
+#endif
+#if TELEMETRY_ENABLED
+    unsigned char planetReported = 0xFF;    // No decision sent yet
+#endif
+
+    // Loop to check when buttons are pressed
+        while(1) {
+#if (MEMUSAGE_ENABLED || LATENCY_ENABLED) && TELEMETRY_ENABLED
+            // Once a second, report the stack high-water mark if it has grown
+            // and any PWM periods, colour pulses or ADC results lost since
+            if ((long)(timebaseTicks() - healthCheckDue) >= 0) {
+                healthCheckDue += TIMEBASE_TICK_HZ;
+#if MEMUSAGE_ENABLED
+                unsigned int stackPeak;
+                if (memStackGrew(&stackPeak)) telemetrySendEvent(TELEMETRY_EVENT_STACK_PEAK, stackPeak);
+#endif
+#if LATENCY_ENABLED
+                unsigned int missed = latencyMissed();
+                if (missed != missedReported) {
+                    telemetrySendEvent(TELEMETRY_EVENT_ISR_MISSED, missed - missedReported);
+                    missedReported = missed;
+                }
+#endif
+            }
+#endif
+
+            // Check if the RGB button is pressed
+            // If pressed measure light & colour together (about 400 ms, without blocking)...
+            // ... & when the result comes in show the spectrum script on the RGB & LCD...
+            // ... only if a ' planet is found '
+            // AKA- the light dips and red, blue or white is sensed (see detect.h for the score)
+            // Otherwise display no planet found
+            // This is simply a sequence of different gas spectrums shown using the RGB when a planet is found
+
+            if (isRGBButtonPressed()) {
+                if (scriptStatus() != SCRIPT_RUNNING && !detectBusy()) {
+                    lcdDisplayText("Scanning", "");
+                    detectStart(0);                                        // One light & colour cycle
+                }
+            } else if (scriptStatus() != SCRIPT_RUNNING && !detectBusy()) {
+                lcdDisplayText("No Planet", "Found");
+                delay_ms(50);
+                setColour(&off);
+            }
+
+            if (detectPoll(&detection)) {
+                bootSavePlanet(detection.planet);                                   // Restored after a warm boot
+#if TELEMETRY_ENABLED
+                if (detection.planet != planetReported) {                          // Only when the decision changes
+                    telemetrySendEvent(detection.planet ? TELEMETRY_EVENT_PLANET_FOUND : TELEMETRY_EVENT_NO_PLANET,
+                                       detection.score);
+                    telemetrySendEvent(TELEMETRY_EVENT_DECISION_MS, detection.latencyMs);
+                    planetReported = detection.planet;
+                }
+#endif
+                if (detection.planet) {
+                    unsigned int scriptBytes;
+                    const unsigned char *show = scriptStored(&scriptBytes);       // Uploaded show, or the three spectra
+                    scriptStart(show, scriptBytes);                                // Runs from the system tick
+                } else {
+                    lcdDisplayText("No Planet", "Found");
+                }
+            }
+
+
+
+            // Check if the Colour Sensor button is pressed
+            // If pressed display text on878\ LCD...
+            // ... & call colour detection function
+            // Determine colour sensed via function
+            // Display colour name on LCD
+            // This is simply detecting & identifying the colour sensed, the displaying it
+            if (isColourSensorButtonPressed()) {
+                if (initialiseColourSensor() < 0) continue;               // Initialise colour sensor
+                delay_ms(10);                                             // Debounce delay
+                if (isColourSensorButtonPressed()) {
+                    scriptStop();                                         // The sensor needs the LCD
+                    detectStop();                                         // ... & the pulse counter
+                    unsigned long pressed = timebaseTicks();
+                    while (isColourSensorButtonPressed());                // Wait for release
+                    if (timebaseTicks() - pressed >= CALIBRATE_HOLD_MS * TIMEBASE_TICK_HZ / 1000) {
+                        calibrateColour();                                // Long press
+                        continue;
+                    }
+                    lcdDisplayText("Observing", "Colour");
+                    Colour_Detect();                                      // Perform colour detection
+                    char* detectedColour = Identify_Colour();             // Get the detected colour as a string
+                    dataLogColour(red_val, green_val, blue_val);
+#if TELEMETRY_ENABLED
+                    telemetrySendRGB(red_val, green_val, blue_val);
+#endif
+                    lcdDisplayText("Detected Colour:", detectedColour);   // Display the detected colour on the LCD
+                }
+            }
+
+            // Check if the Light Sensor button is pressed
+            // If pressed initlise ADC and start conversion...
+            // ... & read ADC value read
+            // Convert ADC value into a percentage
+            // Display percentage on LCD
+            // This is simply detecting & converting the light intensity (voltage)...
+            // ... to an ADC value, mapping it to a percentage and displaying it.
+            if (isLightButtonPressed()) {
+                scriptStop();                                                                           // The graphs need the LCD
+                detectStop();
+                lcdDisplayText("Light", "");                                                            // Static text drawn once
+                lcdGraphInit();                                                                         // Display was cleared, resend graphs
+                resetLightStats();                                                                      // Mean & spread from this press on
+                   // Wait until the button is released
+                   while(isLightButtonPressed()) {
+                      // Wait for the next sequence & take its compensated light reading
+                       adcSeqWait();
+                       unsigned int adcValue = adcSeqCompensate(adcSeqLatest(ADCSEQ_LIGHT));
+#if TELEMETRY_ENABLED
+                       telemetrySendAdc(adcValue);
+#endif
+                       // Convert to percentage
+                       int percentage = adcValueToPercentage(adcValue, minADCValue, maxADCValue);
+                       dataLogLightSample(adcValue);                                                    // Coded into a block
+                       // Convert percentage int to string
+                       char displayBuffer[32];                                                          // Define a buffer large enough to hold formatted string
+                       sprintf(displayBuffer, "%3d%%", percentage);                                     // Format the string with the percentage value
+                       lcdSetCursor(0, 5);                                                              // Update the number in place
+                       lcdWriteText(displayBuffer);
+                       lcdSparkPush(adcValue);                                                          // Recent samples, top right
+                       lcdSparkDraw(0, 9);
+                       lcdBarDraw(1, 0, 12, percentage, 100);                                           // Percentage bar, bottom line
+                       // Smoothed light against its running mean, in standard deviations: a real
+                       // dip shows as a steady negative value well beyond the noise (e.g. -2.0)
+                       LightStatsSnapshot stats;
+                       readLightStats(&stats);
+                       long deviation = stats.stdDev ? ((long)stats.ema - (long)stats.mean) * 10 / stats.stdDev : 0;
+                       if (deviation > 99) deviation = 99;
+                       if (deviation < -99) deviation = -99;
+                       sprintf(displayBuffer, "%c%d.%d", deviation < 0 ? '-' : '+',
+                               (int)(labs(deviation) / 10), (int)(labs(deviation) % 10));
+                       lcdSetCursor(1, 12);
+                       lcdWriteText(displayBuffer);
+                   }
+                   dataLogLightFlush();                                                                 // Store the last, part block
+
+               }
+
+        }
+
+
+    return 0;
+}
@@ -0,0 +1,125 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: memUsage.c
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Defined the stack paint, watermark scan and ISR records.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#include "memUsage.h"
+#include <string.h>
+
+/**************************************************************************
+ * Stack bounds. STACK_BOTTOM is the first word above the static data and
+ * STACK_TOP the word past the end of RAM; STACK_TOP_ADDR is the latter as
+ * a stack pointer value. Words are 2 bytes on the target and wider on a
+ * host, so byte counts go through WORD.
+ **************************************************************************/
+#if defined(__TI_COMPILER_VERSION__)
+// The TI linker places a fixed-size .stack section at the top of RAM
+extern char __STACK_END;
+extern char __STACK_SIZE;
+#define STACK_TOP       ((unsigned int *)&__STACK_END)
+#define STACK_BOTTOM    ((unsigned int *)(&__STACK_END - (unsigned int)&__STACK_SIZE))
+#define STACK_TOP_ADDR  ((unsigned int)&__STACK_END)
+#elif defined(__MSP430__)
+// msp430-elf: the stack starts at __stack and may grow down to the end of .bss
+extern char __stack;
+extern char end;
+#define STACK_TOP       ((unsigned int *)&__stack)
+#define STACK_BOTTOM    ((unsigned int *)(((unsigned int)&end + 1) & ~1u))
+#define STACK_TOP_ADDR  ((unsigned int)&__stack)
+#else
+unsigned int memHostStack[(MEMUSAGE_RAM_SIZE - MEMUSAGE_HOST_STATIC) / sizeof(unsigned int)];
+#define STACK_TOP       (memHostStack + sizeof(memHostStack) / sizeof(unsigned int))
+#define STACK_BOTTOM    memHostStack
+#define STACK_TOP_ADDR  (MEMUSAGE_RAM_START + MEMUSAGE_RAM_SIZE)
+#endif
+
+#define WORD            sizeof(unsigned int)
+#define STACK_BYTES     ((unsigned int)((STACK_TOP - STACK_BOTTOM) * WORD))
+
+#if MEMUSAGE_ENABLED
+volatile unsigned char memIsrNesting = 0;
+MemIsrRecord memIsrRecords[MEMUSAGE_ISRS];
+static unsigned int lastPeak = 0;
+#endif
+
+/**************************************************************************
+ * Function: memPaint
+ **************************************************************************/
+void memPaint(unsigned int *from, unsigned int *to) {
+    while (from < to) *from++ = MEMUSAGE_PAINT;
+}
+
+/**************************************************************************
+ * Function: memUntouched
+ **************************************************************************/
+unsigned int memUntouched(const unsigned int *from, const unsigned int *to) {
+    const unsigned int *p = from;
+
+    while (p < to && *p == MEMUSAGE_PAINT) p++;
+    return (unsigned int)((p - from) * sizeof(*p));
+}
+
+#if MEMUSAGE_ENABLED
+
+/**************************************************************************
+ * Function: memUsageInit
+ **************************************************************************/
+void memUsageInit(void) {
+    unsigned int *sp = STACK_TOP - (STACK_TOP_ADDR - __get_SP_register()) / WORD;
+    unsigned char i;
+
+    // Everything from the static data to just below this function's frame
+    if (sp - MEMUSAGE_PAINT_MARGIN / WORD > STACK_BOTTOM) {
+        memPaint(STACK_BOTTOM, sp - MEMUSAGE_PAINT_MARGIN / WORD);
+    }
+    memIsrNesting = 0;
+    for (i = 0; i < MEMUSAGE_ISRS; i++) {
+        memIsrRecords[i].entries = 0;
+        memIsrRecords[i].maxNesting = 0;
+        memIsrRecords[i].lowestSp = 0xFFFF;
+    }
+    lastPeak = 0;
+}
+
+/**************************************************************************
+ * Function: memUsageGet
+ **************************************************************************/
+void memUsageGet(MemReport *report) {
+    MemIsrRecord records[MEMUSAGE_ISRS];
+    unsigned short state;
+    unsigned char i;
+
+    memset(report, 0, sizeof(*report));
+    report->staticRam = STACK_TOP_ADDR - STACK_BYTES - MEMUSAGE_RAM_START;
+    report->stackSize = STACK_BYTES;
+    report->stackPeak = STACK_BYTES - memUntouched(STACK_BOTTOM, STACK_TOP);
+    report->overflow = *STACK_BOTTOM != MEMUSAGE_PAINT;
+
+    state = __get_interrupt_state();
+    __disable_interrupt();
+    memcpy(records, memIsrRecords, sizeof(records));
+    __set_interrupt_state(state);
+
+    for (i = 0; i < MEMUSAGE_ISRS; i++) {
+        report->isrEntries[i] = records[i].entries;
+        report->isrNesting[i] = records[i].maxNesting;
+        report->isrStack[i] = records[i].maxNesting ? STACK_TOP_ADDR - records[i].lowestSp : 0;
+    }
+}
+
+/**************************************************************************
+ * Function: memStackGrew
+ **************************************************************************/
+int memStackGrew(unsigned int *peak) {
+    *peak = STACK_BYTES - memUntouched(STACK_BOTTOM, STACK_TOP);
+    if (*peak <= lastPeak) return 0;
+    lastPeak = *peak;
+    return 1;
+}
+
+#endif /* MEMUSAGE_ENABLED */
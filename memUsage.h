@@ -0,0 +1,173 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: memUsage.h
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Initial creation of the stack watermark and ISR nesting records.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#ifndef MEMUSAGE_H_
+#define MEMUSAGE_H_
+
+#include <intrinsics.h>
+
+/**************************************************************************
+ * The FR4133 has 2 KB of RAM: static data (.data, .bss) from the bottom,
+ * the stack down from the top. Nothing checks that they stay apart, so:
+ *
+ *    memUsageInit(), first thing at boot, paints the free RAM between the
+ *    static data and the current stack pointer with MEMUSAGE_PAINT. The
+ *    deepest the stack has been is then the lowest word no longer
+ *    holding the paint, found by scanning up from the bottom. The bottom
+ *    word being gone means the stack has run into the static data.
+ *
+ *    MEMUSAGE_ISR_ENTER/EXIT in each ISR count how deeply ISRs nest and
+ *    record the stack pointer on entry, so the report shows how much
+ *    stack was in use when each ISR came in on top of it.
+ *
+ * The static breakdown per module comes from the linker map rather than
+ * at run time: host/memMap.c reads a GCC or TI map and lists each
+ * module's code, constants, data, bss and persistent bytes.
+ *
+ * With msp430-elf the heap (which newlib's printf family may use) also
+ * grows up from the static data, so it shows as the stack having reached
+ * down to it; the TI .stack section is separate from its heap.
+ *
+ * Compiled in with MEMUSAGE_ENABLED (the default). The ISR markers cost a
+ * few instructions per interrupt; disabled, they expand to nothing and
+ * only memPaint()/memUntouched() are built, so calls to the other
+ * functions must sit under #if MEMUSAGE_ENABLED.
+ **************************************************************************/
+#ifndef MEMUSAGE_ENABLED
+#define MEMUSAGE_ENABLED 1
+#endif
+
+#define MEMUSAGE_RAM_START    0x2000
+#define MEMUSAGE_RAM_SIZE     2048
+#define MEMUSAGE_PAINT        0xA55A  // Unlikely as a return address or small value
+#define MEMUSAGE_PAINT_MARGIN 32      // Bytes below the stack pointer left for memUsageInit() itself
+
+// ISRs with markers
+enum {
+    MEMUSAGE_TICK_ISR,         // Timebase_ISR
+    MEMUSAGE_PWM_ISR,          // Timer_A_ISR (software PWM)
+    MEMUSAGE_PORT1_ISR,        // Port_1 (colour sensor pulses)
+    MEMUSAGE_ADC_ISR,          // ADC_ISR
+    MEMUSAGE_UART_ISR,         // USCI_A0_ISR (telemetry)
+    MEMUSAGE_ISRS
+};
+
+/**************************************************************************
+ * Structure: MemIsrRecord
+ * Description:
+ *    Per-ISR RAM state, updated by the markers.
+ **************************************************************************/
+typedef struct {
+    unsigned int entries;          // Wraps at 65536
+    unsigned char maxNesting;      // 1 = only ever ran on top of the main loop
+    unsigned int lowestSp;         // Lowest stack pointer on entry
+} MemIsrRecord;
+
+/**************************************************************************
+ * Structure: MemReport
+ * Description:
+ *    Memory usage snapshot. Stack depths are bytes below the top of RAM.
+ * Members:
+ *    staticRam - Bytes of static data below the stack
+ *    stackSize - Bytes from the static data to the top of RAM
+ *    stackPeak - Deepest the stack has been (from the paint)
+ *    overflow - 1 if the paint is gone right down to the static data
+ *    isrEntries, isrNesting, isrStack - Per ISR: entries, deepest
+ *                nesting seen and the deepest stack on entry (0 if
+ *                never entered)
+ **************************************************************************/
+typedef struct {
+    unsigned int staticRam;
+    unsigned int stackSize;
+    unsigned int stackPeak;
+    unsigned char overflow;
+    unsigned int isrEntries[MEMUSAGE_ISRS];
+    unsigned char isrNesting[MEMUSAGE_ISRS];
+    unsigned int isrStack[MEMUSAGE_ISRS];
+} MemReport;
+
+#if MEMUSAGE_ENABLED
+
+extern volatile unsigned char memIsrNesting;
+extern MemIsrRecord memIsrRecords[MEMUSAGE_ISRS];
+
+#define MEMUSAGE_ISR_ENTER(id) do {                                        \
+        unsigned int sp_ = __get_SP_register();                            \
+        memIsrNesting++;                                                   \
+        memIsrRecords[id].entries++;                                       \
+        if (memIsrNesting > memIsrRecords[id].maxNesting) {                \
+            memIsrRecords[id].maxNesting = memIsrNesting;                  \
+        }                                                                  \
+        if (sp_ < memIsrRecords[id].lowestSp) memIsrRecords[id].lowestSp = sp_; \
+    } while (0)
+#define MEMUSAGE_ISR_EXIT(id)  (memIsrNesting--)
+
+#else
+
+#define MEMUSAGE_ISR_ENTER(id) ((void)0)
+#define MEMUSAGE_ISR_EXIT(id)  ((void)0)
+
+#endif
+
+/**************************************************************************
+ * Function: memPaint
+ * Description:
+ *    Fills words from up to (not including) to with MEMUSAGE_PAINT.
+ **************************************************************************/
+void memPaint(unsigned int *from, unsigned int *to);
+
+/**************************************************************************
+ * Function: memUntouched
+ * Description:
+ *    Counts the words from up that still hold MEMUSAGE_PAINT, stopping at
+ *    the first that does not (or at to).
+ * Returns:
+ *    Bytes still painted.
+ **************************************************************************/
+unsigned int memUntouched(const unsigned int *from, const unsigned int *to);
+
+/**************************************************************************
+ * Function: memUsageInit
+ * Description:
+ *    Paints the free stack and clears the ISR records. Call before
+ *    anything else at boot, with interrupts off.
+ **************************************************************************/
+void memUsageInit(void);
+
+/**************************************************************************
+ * Function: memUsageGet
+ * Description:
+ *    Scans the paint and copies the ISR records. The scan reads every
+ *    word the stack has never reached, so this takes a few thousand
+ *    cycles; do not call it from an ISR.
+ * Parameters:
+ *    report - Filled in
+ **************************************************************************/
+void memUsageGet(MemReport *report);
+
+/**************************************************************************
+ * Function: memStackGrew
+ * Description:
+ *    Checks the stack high-water mark.
+ * Parameters:
+ *    peak - Set to the deepest the stack has been, in bytes
+ * Returns:
+ *    1 if it is deeper than at the last call, 0 otherwise.
+ **************************************************************************/
+int memStackGrew(unsigned int *peak);
+
+#if !defined(__MSP430__) && !defined(__TI_COMPILER_VERSION__)
+// Host build: stands in for the RAM above the static data, so host tools
+// can mark it as used
+#define MEMUSAGE_HOST_STATIC  512
+extern unsigned int memHostStack[(MEMUSAGE_RAM_SIZE - MEMUSAGE_HOST_STATIC) / sizeof(unsigned int)];
+#endif
+
+#endif /* MEMUSAGE_H_ */
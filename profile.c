@@ -0,0 +1,103 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: profile.c
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Stopped adding to the total once the call count saturates.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#include "profile.h"
+#include <intrinsics.h>
+#include <string.h>
+
+#if PROFILE_ENABLED
+
+ProfileRegion profileRegions[PROFILE_REGIONS];
+
+static unsigned int markerOverhead = 0; // Timer counts of an empty begin/end pair
+static volatile unsigned long isrCounts = 0;
+
+/**************************************************************************
+ * Function: profileInit
+ **************************************************************************/
+void profileInit(void) {
+    unsigned int startTick, startCount, endTick, endCount;
+    unsigned char i;
+
+    memset(profileRegions, 0, sizeof(profileRegions));
+    for (i = 0; i < PROFILE_REGIONS; i++) {
+        profileRegions[i].minCounts = 0xFFFFFFFFUL;
+    }
+    isrCounts = 0;
+
+    // Calibrate the cost of the markers themselves
+    PROFILE_STAMP(startTick, startCount);
+    PROFILE_STAMP(endTick, endCount);
+    markerOverhead = (unsigned int)((unsigned long)(unsigned int)(endTick - startTick) * TIMEBASE_TICK_PERIOD
+                                    + endCount - startCount);
+}
+
+/**************************************************************************
+ * Function: profileEnd
+ **************************************************************************/
+void profileEnd(unsigned char id, unsigned char isr) {
+    ProfileRegion *region = &profileRegions[id];
+    unsigned int tick, count;
+    unsigned long elapsed;
+    unsigned char bucket = 0;
+
+    PROFILE_STAMP(tick, count);
+    elapsed = (unsigned long)(unsigned int)(tick - region->startTick) * TIMEBASE_TICK_PERIOD
+              + count - region->startCount;
+    elapsed = elapsed > markerOverhead ? elapsed - markerOverhead : 0;
+
+    if (region->count != 0xFFFF) {
+        region->count++;
+        region->totalCounts += elapsed;     // Kept to the calls counted, for the mean
+    }
+    if (elapsed < region->minCounts) region->minCounts = elapsed;
+    if (elapsed > region->maxCounts) region->maxCounts = elapsed;
+
+    // log2 bucket: highest set bit of the duration
+    while ((elapsed >> bucket) > 1 && bucket < PROFILE_BUCKETS - 1) bucket++;
+    if (region->histogram[bucket] != 0xFFFF) region->histogram[bucket]++;
+
+    if (isr) isrCounts += elapsed;
+}
+
+/**************************************************************************
+ * Function: profileGet
+ **************************************************************************/
+void profileGet(unsigned char id, ProfileStats *stats) {
+    ProfileRegion snapshot;
+    unsigned short state = __get_interrupt_state();
+
+    __disable_interrupt();                 // ISR regions may update mid-copy
+    snapshot = profileRegions[id];
+    __set_interrupt_state(state);
+
+    stats->count = snapshot.count;
+    stats->minCycles = snapshot.count ? snapshot.minCounts * PROFILE_RESOLUTION_CYCLES : 0;
+    stats->maxCycles = snapshot.maxCounts * PROFILE_RESOLUTION_CYCLES;
+    stats->totalCycles = snapshot.totalCounts * PROFILE_RESOLUTION_CYCLES;
+    stats->meanCycles = snapshot.count ? stats->totalCycles / snapshot.count : 0;
+    memcpy(stats->histogram, snapshot.histogram, sizeof(stats->histogram));
+}
+
+/**************************************************************************
+ * Function: profileIsrCycles
+ **************************************************************************/
+unsigned long profileIsrCycles(void) {
+    unsigned long counts;
+    unsigned short state = __get_interrupt_state();
+
+    __disable_interrupt();
+    counts = isrCounts;
+    __set_interrupt_state(state);
+
+    return counts * PROFILE_RESOLUTION_CYCLES;
+}
+
+#endif /* PROFILE_ENABLED */
@@ -0,0 +1,168 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: profile.h
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Renamed PROFILE_CYCLES_PER_COUNT to PROFILE_RESOLUTION_CYCLES and
+ *    explained why Timer_A1 is divided.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#ifndef PROFILE_H_
+#define PROFILE_H_
+
+#include <msp430fr4133.h>
+#include "timebase.h"
+
+/**************************************************************************
+ * Profiling is compiled in with -DPROFILE_ENABLED=1. When disabled every
+ * marker expands to nothing and profile.c compiles to nothing, so calls
+ * to the functions below must sit under #if PROFILE_ENABLED.
+ *
+ * Timestamps are the low word of the system tick count plus TA1R. Timer_A1
+ * is not run undivided: a count is TIMEBASE_COUNT_CYCLES long so the
+ * tick's period hook is in before its first compare (timebase.h). The
+ * resolution is therefore PROFILE_RESOLUTION_CYCLES, 32 MCLK cycles at
+ * every clock, not one cycle: every figure is a whole number of counts,
+ * and a region shorter than a count may read as 0 or 1. Regions may span
+ * many ticks. A begin marker is only a timestamp read into the region
+ * table; the bookkeeping is done in the end marker.
+ **************************************************************************/
+#ifndef PROFILE_ENABLED
+#define PROFILE_ENABLED 0
+#endif
+
+#define PROFILE_BUCKETS           16  // log2 histogram buckets, last one is open-ended
+#define PROFILE_RESOLUTION_CYCLES (CLOCK_SMCLK_HZ / TIMEBASE_TA1_CLK_HZ)  // One Timer_A1 count
+
+// Profiled regions
+enum {
+    PROFILE_LCD_TEXT,          // lcdDisplayText()
+    PROFILE_COLOUR_DETECT,     // Colour_Detect()
+    PROFILE_PWM_ISR,           // Timer_A_ISR (software PWM)
+    PROFILE_PORT1_ISR,         // Port_1 (colour sensor pulses)
+    PROFILE_TICK_ISR,          // Timebase_ISR
+    PROFILE_ADC_ISR,           // ADC_ISR
+    PROFILE_LIGHT_ENCODE,      // lightEncode()
+    PROFILE_SCRIPT_TICK,       // Script interpreter, per tick
+    PROFILE_LIGHT_STATS,       // lightStatsUpdate() from ADC_ISR
+    PROFILE_ADC_PERCENT,       // adcValueToPercentage()
+    PROFILE_SPECTRUM,          // displayGasSpectrum()
+    PROFILE_REGIONS
+};
+
+/**************************************************************************
+ * Structure: ProfileStats
+ * Description:
+ *    Snapshot of one region's statistics. Times are in MCLK cycles, in
+ *    steps of PROFILE_RESOLUTION_CYCLES.
+ * Members:
+ *    count - Number of completed begin/end pairs, stops at 0xFFFF
+ *    minCycles, maxCycles, meanCycles - Duration statistics
+ *    totalCycles - Sum of the durations counted in count
+ *    histogram - histogram[n] counts durations of 2^n to 2^(n+1)-1 timer
+ *                counts (bucket 0 also holds 0)
+ **************************************************************************/
+typedef struct {
+    unsigned int count;
+    unsigned long minCycles;
+    unsigned long maxCycles;
+    unsigned long meanCycles;
+    unsigned long totalCycles;
+    unsigned int histogram[PROFILE_BUCKETS];
+} ProfileStats;
+
+/**************************************************************************
+ * Structure: ProfileRegion
+ * Description:
+ *    Per-region RAM state. Durations are kept in Timer_A1 counts and only
+ *    converted to cycles by profileGet().
+ **************************************************************************/
+typedef struct {
+    unsigned int startTick;
+    unsigned int startCount;
+    unsigned int count;
+    unsigned long minCounts;
+    unsigned long maxCounts;
+    unsigned long totalCounts;
+    unsigned int histogram[PROFILE_BUCKETS];
+} ProfileRegion;
+
+// Timestamp read. The tick count is re-read in case the tick ISR ran in
+// between. The tick interrupt fires when TA1R reaches CCR0, one count
+// before the wrap, so the count is corrected on either side of it: a
+// tick still pending after the wrap (interrupts masked) is added, and a
+// tick already counted before the wrap is taken off. Also used by
+// latency.h, so it does not depend on PROFILE_ENABLED.
+#define PROFILE_STAMP(tick, cnt) do {                                      \
+        do {                                                               \
+            (tick) = (unsigned int)timebaseTickCount;                      \
+            (cnt) = TA1R;                                                  \
+        } while ((tick) != (unsigned int)timebaseTickCount);               \
+        if (TA1CCTL0 & CCIFG) {                                            \
+            if ((cnt) < TIMEBASE_TICK_PERIOD / 2) (tick)++;                \
+        } else if ((cnt) == TIMEBASE_TICK_PERIOD - 1) {                    \
+            (tick)--;                                                      \
+        }                                                                  \
+    } while (0)
+
+#if PROFILE_ENABLED
+
+extern ProfileRegion profileRegions[PROFILE_REGIONS];
+
+#define PROFILE_BEGIN(id)     PROFILE_STAMP(profileRegions[id].startTick, profileRegions[id].startCount)
+#define PROFILE_END(id)       profileEnd(id, 0)
+#define PROFILE_ISR_ENTER(id) PROFILE_BEGIN(id)
+#define PROFILE_ISR_EXIT(id)  profileEnd(id, 1)
+
+#else
+
+#define PROFILE_BEGIN(id)     ((void)0)
+#define PROFILE_END(id)       ((void)0)
+#define PROFILE_ISR_ENTER(id) ((void)0)
+#define PROFILE_ISR_EXIT(id)  ((void)0)
+
+#endif
+
+/**************************************************************************
+ * Function: profileInit
+ * Description:
+ *    Clears every region and measures the cost of an empty begin/end
+ *    pair, which is then subtracted from every measurement. Call after
+ *    timebaseInit().
+ **************************************************************************/
+void profileInit(void);
+
+/**************************************************************************
+ * Function: profileEnd
+ * Description:
+ *    Closes a region opened with PROFILE_BEGIN and records its duration.
+ *    Use the PROFILE_END/PROFILE_ISR_EXIT macros rather than calling this
+ *    directly.
+ * Parameters:
+ *    id - Region identifier
+ *    isr - 1 if the region is an ISR, so its time counts as stolen from
+ *          the main loop
+ **************************************************************************/
+void profileEnd(unsigned char id, unsigned char isr);
+
+/**************************************************************************
+ * Function: profileGet
+ * Description:
+ *    Copies a snapshot of one region's statistics.
+ * Parameters:
+ *    id - Region identifier
+ *    stats - Destination for the snapshot
+ **************************************************************************/
+void profileGet(unsigned char id, ProfileStats *stats);
+
+/**************************************************************************
+ * Function: profileIsrCycles
+ * Description:
+ *    Returns the total MCLK cycles spent in profiled ISRs since
+ *    profileInit(), i.e. time taken away from the main loop.
+ **************************************************************************/
+unsigned long profileIsrCycles(void);
+
+#endif /* PROFILE_H_ */
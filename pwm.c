@@ -1,67 +1,299 @@
-/**************************************************************************
- * Project Name: Exoplanet Detection Simulator
- * Module Name: pwm.c
- * Created on: 13 Feb 2024
- * Date Last Updated: 13/02/2024
- * Update Description:
- *    Defined setRGBDutyCycle function.
- * Author: Finlay Harris
- **************************************************************************/
-
-#include "pwm.h"
-
-/**************************************************************************
- * Global Variables:
- *    blueDutyCycle - Stores the current duty cycle value for the blue LED.
- *    greenDutyCycle - Stores the current duty cycle value for the green LED.
- * These variables are volatile as they may be accessed by ISRs.
- **************************************************************************/
-volatile unsigned int blueDutyCycle = 0;
-volatile unsigned int greenDutyCycle = 0;
-
-// Function for PWM frequency setup
-void setupTimerForSWPWM(void) {
-    TA0CCTL2 = CCIE; // Enable interrupt for CCR2
-    TA0CCR2 = 5;     // Interrupt frequency
-}
-
-// Function to set up GPIO for blue and green LEDs
-void setupGPIO(void) {
-    // Configure P1.5 as output for the blue LED and P1.6 for the green LED
-    P1DIR |= BIT5 + BIT6 ;
-    P1OUT &= ~(BIT5 + BIT6 ); // Initially off
-}
-
-// Function to set up PWM for red LED
-void setupPWM(void) {
-    WDTCTL = WDTPW | WDTHOLD; // Stop watchdog timer
-
-    // Configure Red LED pin as output
-    P1DIR |= BIT7;            // Red LED is connected to P1.7
-    P1OUT &= ~(BIT7 );        // Initially off
-
-    // Timer_A output mode for this pin
-    P1SEL0 |= BIT7;           // Enable TA0.1 functionality on P1.7 for PWM output
-
-    // Configure Timer_A
-    TA0CTL = TASSEL_2 | MC_1; // Use SMCLK, up mode
-    TA0CCR0 = 100;            // Set PWM Period
-
-    // Initialise CCR1 for PWM, OUTMOD_7 for reset/set mode for the red LED
-    TA0CCTL1 = OUTMOD_7;
-
-    // Initial duty cycle for the red channel
-    TA0CCR1 = 0;              // Initially off
-}
-
-// Function to set duty cycle for each LED (how 'bright' each colour is)
-void setRGBDutyCycle(unsigned int redDuty, unsigned int greenDuty, unsigned int blueDuty) {
-    // Update duty cycle for red LED (hardware PWM)
-    TA0CCR1 = redDuty;
-
-    // Update duty cycles for green and blue LEDs (software PWM)
-    greenDutyCycle = greenDuty;
-    blueDutyCycle = blueDuty;
-}
-
-
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: pwm.c
+ * Created on: 13 Feb 2024
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    The hardware frame hook waits for the last frame to be latched, for
+ *    clocks where a Timer_A0 period is longer than a tick.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#include "pwm.h"
+#include "timebase.h"
+#include "profile.h"
+#include "memUsage.h"
+#include "latency.h"
+#include <intrinsics.h>
+
+/**************************************************************************
+ * Global Variables:
+ *    blueDutyCycle - Stores the current blue compare (0 to PWM_BLUE_FULL).
+ *    greenDutyCycle - Stores the current green compare (0 to PWM_GREEN_FULL).
+ * These variables are volatile as they may be accessed by ISRs.
+ **************************************************************************/
+volatile unsigned int blueDutyCycle = 0;
+volatile unsigned int greenDutyCycle = 0;
+
+/**************************************************************************
+ * Staged compares written by pwmSetCompares(). The period hooks copy them
+ * into the active registers at each timer's next period start, so a
+ * period is never shown with a mix of old and new values.
+ **************************************************************************/
+static volatile unsigned int stagedRed = 0;
+static volatile unsigned int stagedGreen = 0;
+static volatile unsigned int stagedBlue = 0;
+static volatile unsigned char commitPending = 0;
+static volatile unsigned int commitCount = 0;
+static volatile PWMFrameHook frameHook = 0;
+
+#if PWM_USE_HARDWARE
+#define PWM_PENDING_TA0  BIT0  // Red and green compares still to latch
+#define PWM_PENDING_TA1  BIT1  // Blue compare still to latch
+
+static void pwmLatchTA0(void);
+static void pwmLatchTA1(void);
+static void pwmFrameTick(void);
+static volatile unsigned char latchPending = 0;  // PWM_PENDING_* bits
+static unsigned char latchOnPeriod = 0; // Else setRGBDutyCycle() latches
+#else
+static void pwmLatchTA0(void);
+static unsigned int pwmCount = 0;      // Software PWM step, 0 starts a frame
+#endif
+
+// Function for PWM frequency setup
+void setupTimerForSWPWM(void) {
+#if PWM_USE_HARDWARE
+    // Hardware PWM needs no pacing interrupt: each timer latches its own
+    // compares at its next period start, and frames follow the system tick
+    timebaseSetPeriodHook(TIMEBASE_TA0, pwmLatchTA0);
+    timebaseSetPeriodHook(TIMEBASE_TA1, pwmLatchTA1);
+    latchOnPeriod = 1;
+    timebaseSubscribe(pwmFrameTick, TIMEBASE_TICK_HZ);
+#else
+    if (!timebaseClaimChannel(TIMEBASE_TA0, 2)) return;
+
+    timebaseSetPeriodHook(TIMEBASE_TA0, pwmLatchTA0);
+    pwmCount = 0;
+    TA0CCTL2 = CCIE; // Enable interrupt for CCR2, fires once per TA0 period
+    TA0CCR2 = 5;     // Interrupt frequency
+#endif
+}
+
+// Function to set up GPIO for blue and green LEDs
+void setupGPIO(void) {
+#if PWM_USE_HARDWARE
+    // Green on P1.6 (TA0.2), blue on P8.3 (TA1.2)
+    P1DIR |= BIT6;
+    P1OUT &= ~BIT6;           // Initially off
+    P1SEL0 |= BIT6;           // Enable TA0.2 functionality on P1.6
+    P8DIR |= BIT3;
+    P8OUT &= ~BIT3;
+    P8SEL0 |= BIT3;           // Enable TA1.2 functionality on P8.3
+#else
+    // Configure P1.5 as output for the blue LED and P1.6 for the green LED
+    P1DIR |= BIT5 + BIT6 ;
+    P1OUT &= ~(BIT5 + BIT6 ); // Initially off
+#endif
+}
+
+// Function to set up PWM for red LED
+void setupPWM(void) {
+    WDTCTL = WDTPW | WDTHOLD; // Stop watchdog timer
+
+    // Configure Red LED pin as output
+    P1DIR |= BIT7;            // Red LED is connected to P1.7
+    P1OUT &= ~(BIT7 );        // Initially off
+
+    // Timer_A output mode for this pin
+    P1SEL0 |= BIT7;           // Enable TA0.1 functionality on P1.7 for PWM output
+
+    // Timer_A0 period and clock are owned by the timebase module
+    if (!timebaseClaimChannel(TIMEBASE_TA0, 1)) return;
+
+    // Initialise CCR1 for PWM, OUTMOD_7 for reset/set mode for the red LED
+    TA0CCTL1 = OUTMOD_7;
+
+    // Initial duty cycle for the red channel
+    TA0CCR1 = 0;              // Initially off
+
+#if PWM_USE_HARDWARE
+    // Green: TA0.2 shares the red channel's Timer_A0 period
+    if (timebaseClaimChannel(TIMEBASE_TA0, 2)) {
+        TA0CCTL2 = OUTMOD_7;
+        TA0CCR2 = 0;
+    }
+
+    // Blue: TA1.2 runs at the Timer_A1 system tick period
+    if (timebaseClaimChannel(TIMEBASE_TA1, 2)) {
+        TA1CCTL2 = OUTMOD_7;
+        TA1CCR2 = 0;
+    }
+#endif
+}
+
+// Function to set duty cycle for each LED (how 'bright' each colour is)
+void setRGBDutyCycle(unsigned int redDuty, unsigned int greenDuty, unsigned int blueDuty) {
+#if PWM_USE_HARDWARE
+    // Green and blue to the nearest compare below a 256th of their range
+    if (greenDuty > 256) greenDuty = 256;
+    if (blueDuty > 256) blueDuty = 256;
+    greenDuty = (unsigned int)(((unsigned long)greenDuty * PWM_GREEN_FULL) >> 8);
+    blueDuty = (unsigned int)(((unsigned long)blueDuty * PWM_BLUE_FULL) >> 8);
+#endif
+    pwmSetCompares(redDuty, greenDuty, blueDuty);
+}
+
+// Function to stage compares in each channel's own range
+void pwmSetCompares(unsigned int red, unsigned int green, unsigned int blue) {
+    unsigned short state = __get_interrupt_state();
+    __disable_interrupt();        // Stage all three values as one unit
+
+    stagedRed = red;
+    stagedGreen = green;
+    stagedBlue = blue;
+    commitPending = 1;            // Latched at the next frame
+#if PWM_USE_HARDWARE
+    latchPending = PWM_PENDING_TA0 | PWM_PENDING_TA1;
+    if (latchOnPeriod) {
+        timebaseArmPeriodHook(TIMEBASE_TA0);
+        timebaseArmPeriodHook(TIMEBASE_TA1);
+    } else {
+        pwmLatchTA0();            // Not set up yet, latch straight away
+        pwmLatchTA1();
+    }
+#endif
+
+    __set_interrupt_state(state);
+}
+
+// Function to check if staged duty cycles are still waiting to be latched
+int pwmCommitPending(void) {
+    return commitPending;
+}
+
+// Function to read the number of staged colours latched so far
+unsigned int pwmCommitCount(void) {
+    return commitCount;
+}
+
+// Function to wait until the last staged colour is on the LEDs
+void pwmWaitForCommit(void) {
+    if (!(__get_SR_register() & GIE)) return; // ISR can't run, don't hang
+    while (commitPending);
+}
+
+// Function to install the per-frame callback
+void pwmSetFrameHook(PWMFrameHook hook) {
+    frameHook = hook;
+}
+
+#if PWM_USE_HARDWARE
+/**************************************************************************
+ * Function: pwmLatched
+ * Description:
+ *    Notes one timer's share of the staged colour as latched, and commits
+ *    the colour once both timers have theirs.
+ **************************************************************************/
+static void pwmLatched(unsigned char timer) {
+    latchPending &= ~timer;
+    if (latchPending == 0 && commitPending) {
+        greenDutyCycle = stagedGreen;
+        blueDutyCycle = stagedBlue;
+        commitPending = 0;
+        commitCount++;
+    }
+}
+
+/**************************************************************************
+ * Function: pwmLatchTA0
+ * Description:
+ *    Timer_A0 period hook. Writes the staged red and green compares as the
+ *    period starts, before either can match, so the whole period shows
+ *    them.
+ **************************************************************************/
+static void pwmLatchTA0(void) {
+    TA0CCR1 = stagedRed;
+    TA0CCR2 = stagedGreen;
+    pwmLatched(PWM_PENDING_TA0);
+}
+
+/**************************************************************************
+ * Function: pwmLatchTA1
+ * Description:
+ *    Timer_A1 period hook, the same for the blue compare.
+ **************************************************************************/
+static void pwmLatchTA1(void) {
+    TA1CCR2 = stagedBlue;
+    pwmLatched(PWM_PENDING_TA1);
+}
+
+/**************************************************************************
+ * Function: pwmFrameTick
+ * Description:
+ *    System tick handler for the hardware backend. A frame is one Timer_A1
+ *    period: the blue latch has run at its start, and red and green latch
+ *    within its first Timer_A0 period. At 1 MHz a Timer_A0 period is
+ *    longer than a tick, so a frame then waits for the last one to be
+ *    latched on both timers rather than replacing it unseen.
+ **************************************************************************/
+static void pwmFrameTick(void) {
+    if (frameHook && !commitPending) {
+        frameHook();                                     // Stage the next frame
+    }
+}
+
+#else
+/**************************************************************************
+ * Function: pwmLatchTA0
+ * Description:
+ *    Timer_A0 period hook, armed on the last step of a frame. Writes the
+ *    staged red compare as the frame's first period starts, and swaps in
+ *    the green and blue duty cycles that the step ISR drives from it.
+ **************************************************************************/
+static void pwmLatchTA0(void) {
+    TA0CCR1 = stagedRed;
+    greenDutyCycle = stagedGreen;
+    blueDutyCycle = stagedBlue;
+    commitPending = 0;
+    commitCount++;
+}
+
+/**************************************************************************
+ * Function Name: Timer_A_ISR
+ * Description:
+ *    Interrupt Service Routine for Timer A. It manages PWM for the LEDs
+ *    by adjusting the duty cycle based on a software PWM approach. This
+ *    ISR handles the Compare/Capture Interrupt for CCR2. PWM for Blue
+ *    and Green LEDs are adjusted within this interrupt. Any staged colour
+ *    is latched for all three channels at once as a 256-step frame starts
+ *    (see pwmLatchTA0).
+ **************************************************************************/
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma vector = TIMER0_A1_VECTOR
+__interrupt void Timer_A_ISR(void)
+#elif defined(__GNUC__)
+void __attribute__ ((interrupt(TIMER0_A1_VECTOR))) Timer_A_ISR(void)
+#endif
+{
+    LATENCY_PWM_ENTER();
+    PROFILE_ISR_ENTER(PROFILE_PWM_ISR);
+    MEMUSAGE_ISR_ENTER(MEMUSAGE_PWM_ISR);
+    switch(__even_in_range(TA0IV, TA0IV_TAIFG)) {
+        case TA0IV_TACCR2: {                             // Handle CCR2 interrupt
+            pwmCount = (pwmCount + 1) % 256;
+
+            // Last step of a frame: the staged colour is swapped in as the
+            // next Timer_A0 period, the frame's first, starts
+            if (pwmCount == 255 && commitPending) {
+                timebaseArmPeriodHook(TIMEBASE_TA0);
+            }
+            if (pwmCount == 0 && frameHook) {
+                frameHook();                             // Stage the next frame
+            }
+
+            // Software PWM for Blue LED
+            if (pwmCount < blueDutyCycle) P1OUT |= BIT5; // BIT5 for blue LED
+            else P1OUT &= ~BIT5;
+
+            // Software PWM for Green LED
+            if (pwmCount < greenDutyCycle) P1OUT |= BIT6; // BIT6 for green LED
+            else P1OUT &= ~BIT6;
+
+            break;
+        }
+    }
+    MEMUSAGE_ISR_EXIT(MEMUSAGE_PWM_ISR);
+    PROFILE_ISR_EXIT(PROFILE_PWM_ISR);
+}
+#endif
@@ -1,60 +1,163 @@
-/**************************************************************************
- * Project Name: Exoplanet Detection Simulator
- * Module Name: pwm.h
- * Created on: 13 Feb 2024
- * Date Last Updated: 13/02/2024
- * Update Description:
- *    Added setRGBDutyCycle() function to control RGB LED duty cycles more
- *    precisely via software PWM.
- * Author: Finlay Harris
- **************************************************************************/
-
-#ifndef PWM_H
-#define PWM_H
-
-#include <msp430fr4133.h>
-
-/**************************************************************************
- * External variables for duty cycles of RGB LEDs. These variables are used
- * to manage the PWM duty cycle for blue and green LEDs.
- **************************************************************************/
-extern volatile unsigned int blueDutyCycle;
-extern volatile unsigned int greenDutyCycle;
-
-/**************************************************************************
- * Function: setupTimerForSWPWM
- * Description:
- *    Configures the timer used for software PWM. This setup includes
- *    timer period, mode, and interrupts.
- **************************************************************************/
-void setupTimerForSWPWM(void);
-
-/**************************************************************************
- * Function: setupGPIO
- * Description:
- *    Initialises GPIO settings for PWM functionality.
- *    This sets the direction and initial state of pins.
- **************************************************************************/
-void setupGPIO(void);
-
-/**************************************************************************
- * Function: setupPWM
- * Description:
- *    Initialises hardware PWM settings, including configuration of PWM
- *    registers and enabling PWM outputs on specific pins.
- **************************************************************************/
-void setupPWM(void);
-
-/**************************************************************************
- * Function: setRGBDutyCycle
- * Description:
- *    Sets the duty cycles for the RGB LEDs connected to PWM outputs.
- *    Allows independent control of each colour's brightness.
- * Parameters:
- *    redDuty - Duty cycle for the red LED
- *    greenDuty - Duty cycle for the green LED
- *    blueDuty - Duty cycle for the blue LED
- **************************************************************************/
-void setRGBDutyCycle(unsigned int redDuty, unsigned int greenDuty, unsigned int blueDuty);
-
-#endif /* PWM_H */
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: pwm.h
+ * Created on: 13 Feb 2024
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Hardware frames skip ticks while the last frame is still to latch.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#ifndef PWM_H
+#define PWM_H
+
+#include <msp430fr4133.h>
+#include "timebase.h"
+
+/**************************************************************************
+ * PWM backend selection:
+ *    PWM_USE_HARDWARE 1 - All three channels driven by Timer_A compare
+ *                         outputs in reset/set mode, no PWM interrupt:
+ *                           Red   P1.7 (TA0.1), 0-100 per Timer_A0 period
+ *                           Green P1.6 (TA0.2), 0-256 scaled to Timer_A0
+ *                           Blue  P8.3 (TA1.2), 0-256 scaled to Timer_A1
+ *                         P1.5 has no timer output on the FR4133, so the
+ *                         blue LED moves to P8.3 and the colour sensor
+ *                         select line formerly on P8.3 moves to P1.5.
+ *    PWM_USE_HARDWARE 0 - Original wiring. Red on TA0.1, green and blue
+ *                         bit-banged on P1.6/P1.5 from the CCR2 interrupt.
+ **************************************************************************/
+#ifndef PWM_USE_HARDWARE
+#define PWM_USE_HARDWARE 1
+#endif
+
+/**************************************************************************
+ * Compare range of each channel for pwmSetCompares(): a compare of the
+ * full value or more is fully on. With the hardware backend these are the
+ * timer periods the compares run against; the software backend drives
+ * green and blue in 256 steps.
+ **************************************************************************/
+#define PWM_RED_FULL     (TIMEBASE_PWM_PERIOD + 1)  // CCR1 > CCR0 keeps TA0.1 high
+#if PWM_USE_HARDWARE
+#define PWM_GREEN_FULL   (TIMEBASE_PWM_PERIOD + 1)
+#define PWM_BLUE_FULL    TIMEBASE_TICK_PERIOD
+#else
+#define PWM_GREEN_FULL   256
+#define PWM_BLUE_FULL    256
+#endif
+
+/**************************************************************************
+ * External variables for duty cycles of RGB LEDs. These variables are used
+ * to manage the PWM duty cycle for blue and green LEDs.
+ **************************************************************************/
+// In compares: 0 to PWM_BLUE_FULL and PWM_GREEN_FULL
+extern volatile unsigned int blueDutyCycle;
+extern volatile unsigned int greenDutyCycle;
+
+/**************************************************************************
+ * Type: PWMFrameHook
+ * Description:
+ *    Callback run at the start of every PWM frame, once the staged colour
+ *    has been latched. With the hardware backend a frame starts on a
+ *    Timer_A1 tick, skipping ticks while the last colour is still to
+ *    latch on Timer_A0 (a Timer_A0 period is longer than a tick at 1 MHz).
+ *    Used to stage the duty cycles for the following frame (e.g. temporal
+ *    dithering).
+ **************************************************************************/
+typedef void (*PWMFrameHook)(void);
+
+/**************************************************************************
+ * Function: setupTimerForSWPWM
+ * Description:
+ *    Configures the timer used for software PWM. This setup includes
+ *    timer period, mode, and interrupts. With the hardware backend this
+ *    only hooks the colour latch onto the Timer_A0 and Timer_A1 period
+ *    starts, and the frame hook onto the system tick.
+ **************************************************************************/
+void setupTimerForSWPWM(void);
+
+/**************************************************************************
+ * Function: setupGPIO
+ * Description:
+ *    Initialises GPIO settings for PWM functionality.
+ *    This sets the direction and initial state of pins.
+ **************************************************************************/
+void setupGPIO(void);
+
+/**************************************************************************
+ * Function: setupPWM
+ * Description:
+ *    Initialises hardware PWM settings, including configuration of PWM
+ *    registers and enabling PWM outputs on specific pins. Timer_A0 must
+ *    already be running (see timebaseInit()). With the hardware backend
+ *    the green and blue compare channels are set up here too.
+ **************************************************************************/
+void setupPWM(void);
+
+/**************************************************************************
+ * Function: setRGBDutyCycle
+ * Description:
+ *    Sets the duty cycles for the RGB LEDs connected to PWM outputs.
+ *    Allows independent control of each colour's brightness. The values
+ *    are staged and applied together at the start of the next PWM frame;
+ *    calling again before then replaces the staged colour. The hardware
+ *    backend writes each timer's compares at that timer's next period
+ *    start, so a period never mixes old and new values on one timer; red
+ *    and green (Timer_A0) can land up to a tick before blue (Timer_A1).
+ *    Before setupTimerForSWPWM() they apply straight away.
+ * Parameters:
+ *    redDuty - Duty cycle for the red LED (0 to PWM_RED_FULL)
+ *    greenDuty - Duty cycle for the green LED (0 to 256)
+ *    blueDuty - Duty cycle for the blue LED (0 to 256)
+ **************************************************************************/
+void setRGBDutyCycle(unsigned int redDuty, unsigned int greenDuty, unsigned int blueDuty);
+
+/**************************************************************************
+ * Function: pwmSetCompares
+ * Description:
+ *    setRGBDutyCycle() in each channel's own compare range, with no
+ *    scaling, so the hardware backend's green and blue can be set to any
+ *    compare rather than the nearest to a 256th.
+ * Parameters:
+ *    red - Red compare (0 to PWM_RED_FULL)
+ *    green - Green compare (0 to PWM_GREEN_FULL)
+ *    blue - Blue compare (0 to PWM_BLUE_FULL)
+ **************************************************************************/
+void pwmSetCompares(unsigned int red, unsigned int green, unsigned int blue);
+
+/**************************************************************************
+ * Function: pwmCommitPending
+ * Description:
+ *    Checks whether a colour passed to setRGBDutyCycle() is still waiting
+ *    for the next PWM frame.
+ * Returns:
+ *    1 if a staged colour has not been latched yet, 0 otherwise.
+ **************************************************************************/
+int pwmCommitPending(void);
+
+/**************************************************************************
+ * Function: pwmCommitCount
+ * Description:
+ *    Returns the number of staged colours latched so far. Wraps at 16 bits;
+ *    callers compare against a previously read value.
+ **************************************************************************/
+unsigned int pwmCommitCount(void);
+
+/**************************************************************************
+ * Function: pwmWaitForCommit
+ * Description:
+ *    Blocks until the last staged colour is being shown. Returns straight
+ *    away if interrupts are disabled, as the latch could never happen.
+ **************************************************************************/
+void pwmWaitForCommit(void);
+
+/**************************************************************************
+ * Function: pwmSetFrameHook
+ * Description:
+ *    Installs the per-frame callback. Pass 0 to remove it.
+ * Parameters:
+ *    hook - Function to run at the start of each PWM frame
+ **************************************************************************/
+void pwmSetFrameHook(PWMFrameHook hook);
+
+#endif /* PWM_H */
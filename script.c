@@ -0,0 +1,564 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: script.c
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Spectrum colours are kept as the script's colour, so a fade after a
+ *    spectrum starts from the colour shown.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#include "script.h"
+#include "colours.h"
+#include "GasSpectra.h"
+#include "colourSensor.h"
+#include "pwm.h"
+#include "dither.h"
+#include "lcd.h"
+#include "timebase.h"
+#include "fram.h"
+#include "profile.h"
+#include "adcSequence.h"
+#include <msp430fr4133.h>
+
+#define RGB_BUTTON      BIT2    // P5.2, active low
+#define LIGHT_BUTTON    BIT0    // P5.0
+#define COLOUR_BUTTON   BIT3    // P5.3
+
+#define U16(p)          ((unsigned int)(p)[0] | ((unsigned int)(p)[1] << 8))
+#define W16(x)          ((x) & 0xFF), ((x) >> 8)
+
+// What the current wait is for
+#define WAIT_PLAIN      0
+#define WAIT_FADE       1
+#define WAIT_SPECTRUM   2
+
+/**************************************************************************
+ * Colours reachable from NAMED, by index. Keep in step with the host
+ * assembler's name table.
+ **************************************************************************/
+static const Colour *const namedColours[] = {
+    &off, &lilac, &purple, &lightBlue, &nBlue, &cyan, &turquoise,
+    &nGreen, &limeGreen, &yellow, &orange, &pink, &nRed
+};
+#define NAMED_COUNT     (sizeof(namedColours) / sizeof(namedColours[0]))
+
+/**************************************************************************
+ * Built-in show, used until a script is uploaded: the three gas spectra
+ * from the original RGB button sequence, each title scrolling above the
+ * gas name.
+ **************************************************************************/
+static const unsigned char defaultScript[] = {
+    SCRIPT_OP_MARQUEE, 19, 'E','m','i','s','s','i','o','n',' ','S','p','e','c','t','r','u','m',' ','1',
+                       13, 'G','a','s',':',' ','H','y','d','r','o','g','e','n',
+    SCRIPT_OP_SPECTRUM, 0, W16(500),
+    SCRIPT_OP_NAMED, 0,
+    SCRIPT_OP_MARQUEE, 19, 'E','m','i','s','s','i','o','n',' ','S','p','e','c','t','r','u','m',' ','2',
+                       11, 'G','a','s',':',' ','H','e','l','i','u','m',
+    SCRIPT_OP_SPECTRUM, 1, W16(500),
+    SCRIPT_OP_NAMED, 0,
+    SCRIPT_OP_MARQUEE, 19, 'E','m','i','s','s','i','o','n',' ','S','p','e','c','t','r','u','m',' ','3',
+                       13, 'G','a','s',':',' ','N','i','t','r','o','g','e','n',
+    SCRIPT_OP_SPECTRUM, 2, W16(500),
+    SCRIPT_OP_NAMED, 0,
+    SCRIPT_OP_TEXT, 0, 0,
+    SCRIPT_OP_TEXT, 1, 0,
+    SCRIPT_OP_END
+};
+
+/**************************************************************************
+ * FRAM script store. length is 0 while an upload is in progress.
+ **************************************************************************/
+typedef struct {
+    unsigned int length;
+    unsigned int check;
+    unsigned char code[SCRIPT_MAX_BYTES];
+} ScriptStore;
+
+#if defined(__TI_COMPILER_VERSION__)
+#pragma PERSISTENT(scriptStore)
+#endif
+static ScriptStore scriptStore FRAM_PERSISTENT = { 0 };
+static unsigned char uploadOpen = 0;
+
+/**************************************************************************
+ * Fade state for one channel. Each tick the value moves by step, plus one
+ * more whenever the remainder accumulates past a whole step (Bresenham),
+ * so it lands exactly on the target without a multiply or long division
+ * per tick.
+ **************************************************************************/
+typedef struct {
+    unsigned int value;
+    unsigned int step;
+    unsigned int rem;
+    unsigned int err;
+    unsigned char down;
+} FadeChannel;
+
+static const unsigned char *code;
+static unsigned int codeLength;
+static unsigned int pc;
+static volatile unsigned char status = SCRIPT_IDLE;
+static ScriptTrace traceHook = 0;
+
+static unsigned int waitTicks;
+static unsigned char waitKind;
+static unsigned int fadeTicks;
+static FadeChannel fade[3];
+static unsigned int colour[3];             // Last colour the script set
+static unsigned char spectrumGas, spectrumIndex;
+static unsigned int spectrumDwell;
+
+static unsigned int loopAddress[SCRIPT_LOOP_DEPTH];
+static unsigned char loopCount[SCRIPT_LOOP_DEPTH];
+static unsigned char loopDepth;
+
+static void scriptTick(void);
+
+/**************************************************************************
+ * Function: scriptLength
+ **************************************************************************/
+unsigned int scriptLength(const unsigned char *code, unsigned int length, unsigned int pc) {
+    unsigned int size;
+
+    if (pc >= length) return 0;
+    switch (code[pc]) {
+        case SCRIPT_OP_END:
+        case SCRIPT_OP_NEXT:     size = 1; break;
+        case SCRIPT_OP_NAMED:
+        case SCRIPT_OP_LOOP:     size = 2; break;
+        case SCRIPT_OP_WAIT:
+        case SCRIPT_OP_JUMP:     size = 3; break;
+        case SCRIPT_OP_SPECTRUM: size = 4; break;
+        case SCRIPT_OP_IF:       size = 6; break;
+        case SCRIPT_OP_COLOUR:   size = 7; break;
+        case SCRIPT_OP_FADE:     size = 9; break;
+        case SCRIPT_OP_TEXT:
+            if (length - pc < 3) return 0;
+            size = 3 + code[pc + 2];
+            break;
+        case SCRIPT_OP_MARQUEE:
+            if (length - pc < 2 || length - pc - 2 <= code[pc + 1]) return 0;
+            size = 3 + code[pc + 1] + code[pc + 2 + code[pc + 1]];
+            break;
+        default:                 return 0;
+    }
+    return size <= length - pc ? size : 0;
+}
+
+/**************************************************************************
+ * Function: isInstructionStart
+ * Description:
+ *    Walks the script from the start to see whether an address begins an
+ *    instruction. Only used by the checker, so the cost does not matter.
+ **************************************************************************/
+static int isInstructionStart(const unsigned char *code, unsigned int length, unsigned int address) {
+    unsigned int at = 0;
+
+    while (at < address) {
+        at += scriptLength(code, length, at);
+    }
+    return at == address;
+}
+
+/**************************************************************************
+ * Function: scriptValidate
+ **************************************************************************/
+int scriptValidate(const unsigned char *code, unsigned int length, unsigned int *badOffset) {
+    unsigned int at = 0, size, target;
+    const unsigned char *ip;
+    int ok;
+
+    if (length == 0 || length > SCRIPT_MAX_BYTES) {
+        if (badOffset) *badOffset = 0;
+        return 0;
+    }
+
+    // First pass: every instruction decodes and fits
+    while (at < length) {
+        size = scriptLength(code, length, at);
+        if (size == 0) {
+            if (badOffset) *badOffset = at;
+            return 0;
+        }
+        at += size;
+    }
+
+    // Second pass: operand ranges and jump targets
+    for (at = 0; at < length; at += scriptLength(code, length, at)) {
+        ip = code + at;
+        ok = 1;
+        switch (ip[0]) {
+            case SCRIPT_OP_NAMED:
+                ok = ip[1] < NAMED_COUNT;
+                break;
+            case SCRIPT_OP_TEXT:
+                ok = ip[1] < 2 && ip[2] <= SCRIPT_TEXT_MAX;
+                break;
+            case SCRIPT_OP_MARQUEE:
+                ok = ip[1] <= SCRIPT_MARQUEE_MAX && ip[2 + ip[1]] <= SCRIPT_MARQUEE_MAX;
+                break;
+            case SCRIPT_OP_SPECTRUM:
+                ok = ip[1] < gasSpectraSize && U16(ip + 2) != 0;
+                break;
+            case SCRIPT_OP_JUMP:
+            case SCRIPT_OP_IF:
+                if (ip[0] == SCRIPT_OP_IF) {
+                    ok = (ip[1] & ~SCRIPT_COND_NOT) < SCRIPT_COND_COUNT;
+                    target = U16(ip + 4);
+                } else {
+                    target = U16(ip + 1);
+                }
+                ok = ok && target < length && isInstructionStart(code, length, target);
+                break;
+        }
+        if (!ok) {
+            if (badOffset) *badOffset = at;
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/**************************************************************************
+ * Function: setScriptColour
+ **************************************************************************/
+static void setScriptColour(unsigned int red, unsigned int green, unsigned int blue) {
+    colour[0] = red;
+    colour[1] = green;
+    colour[2] = blue;
+    ditherSetDuty(red, green, blue);
+}
+
+/**************************************************************************
+ * Function: spectrumShow
+ * Description:
+ *    Shows the current colour of the playing spectrum.
+ **************************************************************************/
+static void spectrumShow(void) {
+    const Colour *shown = gasSpectra[spectrumGas].colours[spectrumIndex];
+    setScriptColour(shown->red, shown->green, shown->blue);
+}
+
+/**************************************************************************
+ * Function: fadeBegin
+ * Description:
+ *    Sets up a fade over a number of ticks. The divisions happen once
+ *    here rather than every tick.
+ **************************************************************************/
+static void fadeBegin(const unsigned char *target, unsigned int ticks) {
+    unsigned char i;
+    unsigned int to, distance;
+
+    for (i = 0; i < 3; i++) {
+        to = U16(target + 2 * i);
+        fade[i].value = colour[i];
+        fade[i].down = to < colour[i];
+        distance = fade[i].down ? colour[i] - to : to - colour[i];
+        fade[i].step = distance / ticks;
+        fade[i].rem = distance % ticks;
+        fade[i].err = 0;
+    }
+    fadeTicks = ticks;
+}
+
+/**************************************************************************
+ * Function: fadeStep
+ **************************************************************************/
+static void fadeStep(void) {
+    unsigned char i;
+    unsigned int delta;
+
+    for (i = 0; i < 3; i++) {
+        delta = fade[i].step;
+        if (fade[i].err >= fadeTicks - fade[i].rem) {
+            fade[i].err -= fadeTicks - fade[i].rem;     // Written so it cannot overflow
+            delta++;
+        } else {
+            fade[i].err += fade[i].rem;
+        }
+        if (fade[i].down) fade[i].value -= delta;
+        else fade[i].value += delta;
+    }
+    setScriptColour(fade[0].value, fade[1].value, fade[2].value);
+}
+
+/**************************************************************************
+ * Function: testCondition
+ **************************************************************************/
+static int testCondition(unsigned char condition, unsigned int arg) {
+    unsigned int level;
+
+    switch (condition) {
+        case SCRIPT_COND_RGB_BUTTON:    return (P5IN & RGB_BUTTON) == 0;
+        case SCRIPT_COND_LIGHT_BUTTON:  return (P5IN & LIGHT_BUTTON) == 0;
+        case SCRIPT_COND_COLOUR_BUTTON: return (P5IN & COLOUR_BUTTON) == 0;
+        case SCRIPT_COND_LIGHT_BELOW:
+            return adcSeqCount() != 0 && adcSeqCompensate(adcSeqLatest(ADCSEQ_LIGHT)) < arg;
+        case SCRIPT_COND_COLOUR_IS:
+            level = arg == 0 ? red_val : arg == 1 ? green_val : blue_val;
+            return level >= red_val && level >= green_val && level >= blue_val && level > 0;
+    }
+    return 0;
+}
+
+/**************************************************************************
+ * Function: finish
+ **************************************************************************/
+static void finish(unsigned char result) {
+    timebaseUnsubscribe(scriptTick);
+    status = result;
+}
+
+/**************************************************************************
+ * Function: scriptRun
+ * Description:
+ *    Finishes the current wait, then runs instructions until one has to
+ *    wait or the per-tick budget is spent.
+ **************************************************************************/
+static void scriptRun(void) {
+    const unsigned char *ip;
+    unsigned char ops;
+
+    if (waitTicks) {
+        if (waitKind == WAIT_FADE) fadeStep();
+        if (--waitTicks) return;
+        if (waitKind == WAIT_SPECTRUM && ++spectrumIndex < gasSpectra[spectrumGas].numColours) {
+            spectrumShow();
+            waitTicks = spectrumDwell;
+            return;
+        }
+    }
+
+    for (ops = SCRIPT_OPS_PER_TICK; ops; ops--) {
+        if (pc >= codeLength) {
+            finish(SCRIPT_IDLE);
+            return;
+        }
+        ip = code + pc;
+        if (traceHook) traceHook(pc, ip[0]);
+
+        switch (ip[0]) {
+            case SCRIPT_OP_END:
+                finish(SCRIPT_IDLE);
+                return;
+
+            case SCRIPT_OP_COLOUR:
+                setScriptColour(U16(ip + 1), U16(ip + 3), U16(ip + 5));
+                pc += 7;
+                break;
+
+            case SCRIPT_OP_NAMED:
+                setScriptColour(namedColours[ip[1]]->red, namedColours[ip[1]]->green,
+                                namedColours[ip[1]]->blue);
+                pc += 2;
+                break;
+
+            case SCRIPT_OP_FADE:
+                pc += 9;
+                if (U16(ip + 7) == 0) {
+                    setScriptColour(U16(ip + 1), U16(ip + 3), U16(ip + 5));
+                    break;
+                }
+                fadeBegin(ip + 1, U16(ip + 7));
+                waitKind = WAIT_FADE;
+                waitTicks = U16(ip + 7);
+                return;
+
+            case SCRIPT_OP_WAIT:
+                pc += 3;
+                waitKind = WAIT_PLAIN;
+                waitTicks = U16(ip + 1);
+                if (waitTicks) return;
+                break;
+
+            case SCRIPT_OP_TEXT:
+                if (!lcdQueueLine(ip[1], (const char *)ip + 3, ip[2])) return; // Queue full, retry
+                pc += 3 + ip[2];
+                break;
+
+            case SCRIPT_OP_MARQUEE:
+                lcdQueueMarquee((const char *)ip + 2, ip[1], (const char *)ip + 3 + ip[1], ip[2 + ip[1]]);
+                pc += 3 + ip[1] + ip[2 + ip[1]];
+                break;
+
+            case SCRIPT_OP_SPECTRUM:
+                pc += 4;
+                spectrumGas = ip[1];
+                spectrumIndex = 0;
+                spectrumDwell = U16(ip + 2);
+                spectrumShow();
+                waitKind = WAIT_SPECTRUM;
+                waitTicks = spectrumDwell;
+                return;
+
+            case SCRIPT_OP_LOOP:
+                if (loopDepth == SCRIPT_LOOP_DEPTH) {
+                    finish(SCRIPT_FAULT);
+                    return;
+                }
+                pc += 2;
+                loopAddress[loopDepth] = pc;
+                loopCount[loopDepth] = ip[1];
+                loopDepth++;
+                break;
+
+            case SCRIPT_OP_NEXT:
+                if (loopDepth == 0) {
+                    finish(SCRIPT_FAULT);
+                    return;
+                }
+                if (loopCount[loopDepth - 1] == 0 || --loopCount[loopDepth - 1]) {
+                    pc = loopAddress[loopDepth - 1];
+                } else {
+                    loopDepth--;
+                    pc += 1;
+                }
+                break;
+
+            case SCRIPT_OP_JUMP:
+                pc = U16(ip + 1);
+                break;
+
+            case SCRIPT_OP_IF:
+                if (testCondition(ip[1] & ~SCRIPT_COND_NOT, U16(ip + 2)) ^ (ip[1] >> 7)) {
+                    pc = U16(ip + 4);
+                } else {
+                    pc += 6;
+                }
+                break;
+        }
+    }
+}
+
+/**************************************************************************
+ * Function: scriptTick
+ * Description:
+ *    Tick handler, runs at SCRIPT_TICK_HZ.
+ **************************************************************************/
+static void scriptTick(void) {
+    PROFILE_BEGIN(PROFILE_SCRIPT_TICK);
+    scriptRun();
+    PROFILE_END(PROFILE_SCRIPT_TICK);
+}
+
+/**************************************************************************
+ * Function: scriptStart
+ **************************************************************************/
+int scriptStart(const unsigned char *script, unsigned int length) {
+    if (!scriptValidate(script, length, 0)) return 0;
+
+    timebaseUnsubscribe(scriptTick);
+    lcdMarqueeStop();
+
+    code = script;
+    codeLength = length;
+    pc = 0;
+    waitTicks = 0;
+    loopDepth = 0;
+    colour[0] = colour[1] = colour[2] = 0;
+    status = SCRIPT_RUNNING;
+
+    if (timebaseSubscribe(scriptTick, SCRIPT_TICK_HZ) < 0) {
+        status = SCRIPT_IDLE;
+        return -1;
+    }
+    return 1;
+}
+
+/**************************************************************************
+ * Function: scriptStop
+ **************************************************************************/
+void scriptStop(void) {
+    timebaseUnsubscribe(scriptTick);
+    status = SCRIPT_IDLE;
+}
+
+/**************************************************************************
+ * Function: scriptStatus
+ **************************************************************************/
+unsigned char scriptStatus(void) {
+    return status;
+}
+
+/**************************************************************************
+ * Function: scriptSetTrace
+ **************************************************************************/
+void scriptSetTrace(ScriptTrace trace) {
+    traceHook = trace;
+}
+
+/**************************************************************************
+ * Function: scriptChecksum
+ **************************************************************************/
+unsigned int scriptChecksum(const unsigned char *data, unsigned int length) {
+    unsigned int sum1 = 0, sum2 = 0;
+
+    while (length--) {
+        sum1 += *data++;
+        if (sum1 >= 255) sum1 -= 255;
+        sum2 += sum1;
+        if (sum2 >= 255) sum2 -= 255;
+    }
+    return (sum2 << 8) | sum1;
+}
+
+/**************************************************************************
+ * Function: scriptUploadBegin
+ **************************************************************************/
+void scriptUploadBegin(void) {
+    unsigned int fram;
+
+    if (status == SCRIPT_RUNNING && code == scriptStore.code) scriptStop();
+
+    FRAM_UNLOCK(fram);
+    scriptStore.length = 0;
+    FRAM_RESTORE(fram);
+    uploadOpen = 1;
+}
+
+/**************************************************************************
+ * Function: scriptUploadWrite
+ **************************************************************************/
+int scriptUploadWrite(unsigned int offset, const unsigned char *data, unsigned int length) {
+    unsigned int fram;
+
+    if (!uploadOpen || offset > SCRIPT_MAX_BYTES || length > SCRIPT_MAX_BYTES - offset) return 0;
+
+    FRAM_UNLOCK(fram);
+    while (length--) {
+        scriptStore.code[offset++] = *data++;
+    }
+    FRAM_RESTORE(fram);
+    return 1;
+}
+
+/**************************************************************************
+ * Function: scriptUploadCommit
+ **************************************************************************/
+int scriptUploadCommit(unsigned int length) {
+    unsigned int fram;
+
+    if (!uploadOpen || !scriptValidate(scriptStore.code, length, 0)) return 0;
+
+    FRAM_UNLOCK(fram);
+    scriptStore.check = scriptChecksum(scriptStore.code, length);
+    scriptStore.length = length;                 // Last, marks the store valid
+    FRAM_RESTORE(fram);
+    uploadOpen = 0;
+    return 1;
+}
+
+/**************************************************************************
+ * Function: scriptStored
+ **************************************************************************/
+const unsigned char *scriptStored(unsigned int *length) {
+    if (scriptStore.length != 0 && scriptStore.length <= SCRIPT_MAX_BYTES &&
+        scriptChecksum(scriptStore.code, scriptStore.length) == scriptStore.check) {
+        *length = scriptStore.length;
+        return scriptStore.code;
+    }
+    *length = sizeof(defaultScript);
+    return defaultScript;
+}
@@ -0,0 +1,215 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: script.h
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Added MARQUEE, scrolling text through lcdQueueMarquee().
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#ifndef SCRIPT_H_
+#define SCRIPT_H_
+
+/**************************************************************************
+ * A script is a byte string of instructions, each an opcode followed by
+ * fixed operands. 16-bit operands are little-endian. Addresses are byte
+ * offsets from the start of the script.
+ *
+ *    op    name      operands                 action
+ *    0x00  END                                stop
+ *    0x01  COLOUR    red16 green16 blue16     set the LED duty cycles
+ *    0x02  NAMED     index8                   set a colour from colours.h
+ *                                             (see below)
+ *    0x03  FADE      red16 green16 blue16 ms16  fade linearly to a colour
+ *    0x04  WAIT      ms16                     pause
+ *    0x05  TEXT      row8 length8 chars       show a line (up to 16 chars)
+ *    0x06  SPECTRUM  gas8 ms16                step through a gas spectrum,
+ *                                             ms per colour
+ *    0x07  LOOP      count8                   repeat up to NEXT count
+ *                                             times, 0 for ever
+ *    0x08  NEXT                               end of the LOOP body
+ *    0x09  JUMP      address16                continue at address
+ *    0x0A  IF        condition8 arg16 address16  jump if the condition holds
+ *    0x0B  MARQUEE   length8 chars length8 chars  show two lines, scrolling
+ *                                             any longer than 16 chars
+ *
+ * NAMED indexes: 0 off, 1 lilac, 2 purple, 3 lightBlue, 4 nBlue, 5 cyan,
+ * 6 turquoise, 7 nGreen, 8 limeGreen, 9 yellow, 10 orange, 11 pink,
+ * 12 nRed. SPECTRUM gases index gasSpectra[] (0 Hydrogen, 1 Helium,
+ * 2 Nitrogen).
+ *
+ * Scripts are checked once when started (opcodes, operand ranges, jump
+ * targets on instruction boundaries), so the interpreter does no checks
+ * of its own beyond the loop stack. It runs from the system tick: every
+ * millisecond it carries on until an instruction has to wait, or until
+ * SCRIPT_OPS_PER_TICK instructions have run so a tight loop cannot hold
+ * the tick interrupt.
+ **************************************************************************/
+#define SCRIPT_OP_END        0x00
+#define SCRIPT_OP_COLOUR     0x01
+#define SCRIPT_OP_NAMED      0x02
+#define SCRIPT_OP_FADE       0x03
+#define SCRIPT_OP_WAIT       0x04
+#define SCRIPT_OP_TEXT       0x05
+#define SCRIPT_OP_SPECTRUM   0x06
+#define SCRIPT_OP_LOOP       0x07
+#define SCRIPT_OP_NEXT       0x08
+#define SCRIPT_OP_JUMP       0x09
+#define SCRIPT_OP_IF         0x0A
+#define SCRIPT_OP_MARQUEE    0x0B
+#define SCRIPT_OP_COUNT      0x0C
+
+// IF conditions. OR in SCRIPT_COND_NOT to jump when the condition fails.
+#define SCRIPT_COND_RGB_BUTTON     0x00  // P5.2 pressed
+#define SCRIPT_COND_LIGHT_BUTTON   0x01  // P5.0 pressed
+#define SCRIPT_COND_COLOUR_BUTTON  0x02  // P5.3 pressed
+#define SCRIPT_COND_LIGHT_BELOW    0x03  // Newest light reading below arg
+#define SCRIPT_COND_COLOUR_IS      0x04  // Last sensed colour mostly arg (0 red, 1 green, 2 blue)
+#define SCRIPT_COND_COUNT          0x05
+#define SCRIPT_COND_NOT            0x80
+
+#define SCRIPT_TEXT_MAX      16    // Characters in a TEXT line
+#define SCRIPT_MARQUEE_MAX   64    // Characters in a MARQUEE line (LCD_MARQUEE_MAX)
+#define SCRIPT_LOOP_DEPTH    4     // Nested LOOPs
+#define SCRIPT_MAX_BYTES     512   // Size of the FRAM script store
+#ifndef SCRIPT_OPS_PER_TICK
+#define SCRIPT_OPS_PER_TICK  8
+#endif
+#define SCRIPT_TICK_HZ       1000U // Interpreter rate, one tick per ms
+
+// scriptStatus() values
+#define SCRIPT_IDLE          0     // Not started, or ran to END
+#define SCRIPT_RUNNING       1
+#define SCRIPT_FAULT         2     // Stopped on a loop stack error
+
+/**************************************************************************
+ * Function: ScriptTrace
+ * Description:
+ *    Optional callback run before each instruction, from the tick
+ *    interrupt. Used by the host runner to log execution.
+ * Parameters:
+ *    pc - Address of the instruction about to run
+ *    op - Its opcode
+ **************************************************************************/
+typedef void (*ScriptTrace)(unsigned int pc, unsigned char op);
+
+/**************************************************************************
+ * Function: scriptLength
+ * Description:
+ *    Returns the length of the instruction at a given address, operands
+ *    included.
+ * Parameters:
+ *    code - Script
+ *    length - Script length in bytes
+ *    pc - Address of the instruction
+ * Returns:
+ *    Instruction length, or 0 if the opcode is unknown or the operands run
+ *    past the end of the script.
+ **************************************************************************/
+unsigned int scriptLength(const unsigned char *code, unsigned int length, unsigned int pc);
+
+/**************************************************************************
+ * Function: scriptValidate
+ * Description:
+ *    Checks a script before it is run: every opcode known, operands in
+ *    range and inside the script, and every jump landing on the start of
+ *    an instruction.
+ * Parameters:
+ *    code - Script
+ *    length - Script length in bytes (1 to SCRIPT_MAX_BYTES)
+ *    badOffset - Set to the address of the first bad instruction (may be 0)
+ * Returns:
+ *    1 if the script is valid, 0 otherwise.
+ **************************************************************************/
+int scriptValidate(const unsigned char *code, unsigned int length, unsigned int *badOffset);
+
+/**************************************************************************
+ * Function: scriptStart
+ * Description:
+ *    Validates a script and starts it from the system tick, replacing any
+ *    script already running. Stops the LCD marquee, as TEXT and MARQUEE
+ *    write through the LCD queue. The script must stay in memory while it runs.
+ * Parameters:
+ *    code - Script
+ *    length - Script length in bytes
+ * Returns:
+ *    1 if started, 0 if the script is invalid, -1 if no tick slot is free.
+ **************************************************************************/
+int scriptStart(const unsigned char *code, unsigned int length);
+
+/**************************************************************************
+ * Function: scriptStop
+ * Description:
+ *    Stops the running script, leaving the LEDs and LCD as they are.
+ **************************************************************************/
+void scriptStop(void);
+
+/**************************************************************************
+ * Function: scriptStatus
+ * Description:
+ *    Returns SCRIPT_IDLE, SCRIPT_RUNNING or SCRIPT_FAULT.
+ **************************************************************************/
+unsigned char scriptStatus(void);
+
+/**************************************************************************
+ * Function: scriptSetTrace
+ * Description:
+ *    Installs a trace callback, or removes it when passed 0.
+ **************************************************************************/
+void scriptSetTrace(ScriptTrace trace);
+
+/**************************************************************************
+ * Function: scriptUploadBegin
+ * Description:
+ *    Marks the FRAM script store empty so it can be rewritten. Until
+ *    scriptUploadCommit() succeeds, scriptStored() returns the default.
+ **************************************************************************/
+void scriptUploadBegin(void);
+
+/**************************************************************************
+ * Function: scriptUploadWrite
+ * Description:
+ *    Copies part of a new script into the FRAM store.
+ * Parameters:
+ *    offset - Address in the script of the first byte
+ *    data - Bytes to write
+ *    length - Number of bytes
+ * Returns:
+ *    1 on success, 0 if the bytes do not fit or an upload is not open.
+ **************************************************************************/
+int scriptUploadWrite(unsigned int offset, const unsigned char *data, unsigned int length);
+
+/**************************************************************************
+ * Function: scriptUploadCommit
+ * Description:
+ *    Validates the uploaded script and makes it the stored script. The
+ *    length and checksum are written last, so a power cut part way
+ *    through an upload leaves the store empty rather than half written.
+ * Parameters:
+ *    length - Total script length in bytes
+ * Returns:
+ *    1 if stored, 0 if the script is invalid.
+ **************************************************************************/
+int scriptUploadCommit(unsigned int length);
+
+/**************************************************************************
+ * Function: scriptStored
+ * Description:
+ *    Returns the script in the FRAM store, or the built-in spectrum show
+ *    if the store is empty or fails its checksum.
+ * Parameters:
+ *    length - Set to the script length in bytes
+ * Returns:
+ *    Pointer to the script.
+ **************************************************************************/
+const unsigned char *scriptStored(unsigned int *length);
+
+/**************************************************************************
+ * Function: scriptChecksum
+ * Description:
+ *    Fletcher-16 checksum used to check the stored script.
+ **************************************************************************/
+unsigned int scriptChecksum(const unsigned char *data, unsigned int length);
+
+#endif /* SCRIPT_H_ */
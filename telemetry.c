@@ -0,0 +1,217 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: telemetry.c
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Restarted the transmitter after the buffer drains.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#include "telemetry.h"
+#include "timebase.h"
+#include "memUsage.h"
+#include <intrinsics.h>
+
+#if TELEMETRY_ENABLED
+
+#define TX_MASK (TELEMETRY_TX_SIZE - 1)
+
+/**************************************************************************
+ * TX ring buffer. Producers fill from txHead with interrupts masked; the
+ * ISR drains from txTail.
+ **************************************************************************/
+static unsigned char txBuffer[TELEMETRY_TX_SIZE];
+static volatile unsigned char txHead = 0;
+static volatile unsigned char txTail = 0;
+static unsigned char txSequence = 0;
+static TelemetryStats stats;
+
+// CRC-16/CCITT nibble table
+static const unsigned int crcTable[16] = {
+    0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50A5, 0x60C6, 0x70E7,
+    0x8108, 0x9129, 0xA14A, 0xB16B, 0xC18C, 0xD1AD, 0xE1CE, 0xF1EF
+};
+
+/**************************************************************************
+ * Function: telemetryInit
+ **************************************************************************/
+void telemetryInit(void) {
+    UCA0CTLW0 = UCSWRST;                      // Hold eUSCI in reset
+    UCA0CTLW0 |= UCSSEL__SMCLK;
+    UCA0BRW = TELEMETRY_UCBR;
+    UCA0MCTLW = (TELEMETRY_UCBRS << 8) | (TELEMETRY_UCBRF << 4) | (TELEMETRY_UCOS16 ? UCOS16 : 0);
+
+    P1SEL0 |= BIT0;                           // UCA0TXD on P1.0
+
+    UCA0CTLW0 &= ~UCSWRST;                    // Release for operation
+    UCA0IE &= ~UCTXIE;                        // Enabled when there is data
+}
+
+/**************************************************************************
+ * Function: telemetryCrc16
+ **************************************************************************/
+unsigned int telemetryCrc16(unsigned int crc, const unsigned char *data, unsigned char length) {
+    while (length--) {
+        crc = (crc << 4) ^ crcTable[((crc >> 12) ^ (*data >> 4)) & 0x0F];
+        crc = (crc << 4) ^ crcTable[((crc >> 12) ^ (*data & 0x0F)) & 0x0F];
+        data++;
+    }
+    return crc & 0xFFFF;
+}
+
+/**************************************************************************
+ * Function: telemetrySend
+ **************************************************************************/
+int telemetrySend(unsigned char type, const unsigned char *payload, unsigned char length) {
+    unsigned char header[3];
+    unsigned char frameLength = length + TELEMETRY_OVERHEAD;
+    unsigned char head;
+    unsigned char i;
+    unsigned int crc;
+    unsigned short state;
+
+    if (length > TELEMETRY_MAX_PAYLOAD) return 0;
+
+    state = __get_interrupt_state();
+    __disable_interrupt();
+
+    // Free space, one slot is kept empty to tell full from empty
+    if (((txTail - txHead - 1) & TX_MASK) < frameLength) {
+        stats.framesDropped++;
+        txSequence++;                         // Leave a gap the receiver can see
+        __set_interrupt_state(state);
+        return 0;
+    }
+
+    header[0] = type;
+    header[1] = txSequence++;
+    header[2] = length;
+    crc = telemetryCrc16(0xFFFF, header, 3);
+    crc = telemetryCrc16(crc, payload, length);
+
+    head = txHead;
+    txBuffer[head] = TELEMETRY_SYNC0;
+    head = (head + 1) & TX_MASK;
+    txBuffer[head] = TELEMETRY_SYNC1;
+    head = (head + 1) & TX_MASK;
+    for (i = 0; i < 3; i++) {
+        txBuffer[head] = header[i];
+        head = (head + 1) & TX_MASK;
+    }
+    for (i = 0; i < length; i++) {
+        txBuffer[head] = payload[i];
+        head = (head + 1) & TX_MASK;
+    }
+    txBuffer[head] = (unsigned char)(crc >> 8);
+    head = (head + 1) & TX_MASK;
+    txBuffer[head] = (unsigned char)crc;
+    head = (head + 1) & TX_MASK;
+    txHead = head;
+
+    stats.framesQueued++;
+    if (!(UCA0IE & UCTXIE)) {
+        // Idle: the UCA0IV read that found the buffer empty cleared TXIFG
+        // with TXBUF still empty, so raise it again to start the ISR
+        UCA0IFG |= UCTXIFG;
+        UCA0IE |= UCTXIE;
+    }
+
+    __set_interrupt_state(state);
+    return 1;
+}
+
+/**************************************************************************
+ * Function: telemetryPutTick
+ * Description:
+ *    Writes the current system tick big-endian into a payload.
+ **************************************************************************/
+static unsigned char *telemetryPutTick(unsigned char *p) {
+    unsigned long tick = timebaseTicks();
+    p[0] = (unsigned char)(tick >> 24);
+    p[1] = (unsigned char)(tick >> 16);
+    p[2] = (unsigned char)(tick >> 8);
+    p[3] = (unsigned char)tick;
+    return p + 4;
+}
+
+/**************************************************************************
+ * Function: telemetrySendAdc
+ **************************************************************************/
+int telemetrySendAdc(unsigned int sample) {
+    unsigned char payload[6];
+    unsigned char *p = telemetryPutTick(payload);
+    p[0] = (unsigned char)(sample >> 8);
+    p[1] = (unsigned char)sample;
+    return telemetrySend(TELEMETRY_ADC, payload, sizeof(payload));
+}
+
+/**************************************************************************
+ * Function: telemetrySendRGB
+ **************************************************************************/
+int telemetrySendRGB(unsigned int red, unsigned int green, unsigned int blue) {
+    unsigned char payload[10];
+    unsigned char *p = telemetryPutTick(payload);
+    p[0] = (unsigned char)(red >> 8);
+    p[1] = (unsigned char)red;
+    p[2] = (unsigned char)(green >> 8);
+    p[3] = (unsigned char)green;
+    p[4] = (unsigned char)(blue >> 8);
+    p[5] = (unsigned char)blue;
+    return telemetrySend(TELEMETRY_RGB, payload, sizeof(payload));
+}
+
+/**************************************************************************
+ * Function: telemetrySendEvent
+ **************************************************************************/
+int telemetrySendEvent(unsigned char event, unsigned int value) {
+    unsigned char payload[7];
+    unsigned char *p = telemetryPutTick(payload);
+    p[0] = event;
+    p[1] = (unsigned char)(value >> 8);
+    p[2] = (unsigned char)value;
+    return telemetrySend(TELEMETRY_EVENT, payload, sizeof(payload));
+}
+
+/**************************************************************************
+ * Function: telemetryGetStats
+ **************************************************************************/
+void telemetryGetStats(TelemetryStats *out) {
+    unsigned short state = __get_interrupt_state();
+    __disable_interrupt();
+    *out = stats;
+    __set_interrupt_state(state);
+}
+
+/**************************************************************************
+ * ISR: USCI_A0_ISR
+ * Description:
+ *    Interrupt Service Routine for USCI_A0_VECTOR. Moves the next byte of
+ *    the TX ring buffer into UCA0TXBUF each time it empties, and turns the
+ *    TX interrupt off once the buffer is drained. Reading UCA0IV clears
+ *    TXIFG, so telemetrySend() sets it again when it turns the interrupt
+ *    back on.
+ **************************************************************************/
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma vector = USCI_A0_VECTOR
+__interrupt void USCI_A0_ISR(void)
+#elif defined(__GNUC__)
+void __attribute__ ((interrupt(USCI_A0_VECTOR))) USCI_A0_ISR(void)
+#endif
+{
+    MEMUSAGE_ISR_ENTER(MEMUSAGE_UART_ISR);
+    switch(__even_in_range(UCA0IV, USCI_UART_UCTXCPTIFG)) {
+        case USCI_UART_UCTXIFG:
+            if (txTail != txHead) {
+                UCA0TXBUF = txBuffer[txTail];
+                txTail = (txTail + 1) & TX_MASK;
+                stats.bytesSent++;
+            } else {
+                UCA0IE &= ~UCTXIE;            // Nothing left to send
+            }
+            break;
+    }
+    MEMUSAGE_ISR_EXIT(MEMUSAGE_UART_ISR);
+}
+
+#endif /* TELEMETRY_ENABLED */
@@ -0,0 +1,150 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: telemetry.h
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Added the detection latency event.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+#include <msp430fr4133.h>
+#include "clock.h"
+
+/**************************************************************************
+ * Telemetry is compiled in with -DTELEMETRY_ENABLED=1. It is streamed out
+ * of eUSCI_A0 TXD on P1.0 (the LaunchPad back-channel UART) at 115200 8N1.
+ * P1.0 is the LCD RS line, so enabling telemetry needs the board rewired:
+ * move the LCD RS wire from P1.0 to P8.1, which lcd.c then drives as RS.
+ * RXD (P1.1) is left as the LCD E line; the channel is transmit only.
+ * When disabled telemetry.c compiles to nothing, so calls must sit under
+ * #if TELEMETRY_ENABLED.
+ **************************************************************************/
+#ifndef TELEMETRY_ENABLED
+#define TELEMETRY_ENABLED 0
+#endif
+
+#define TELEMETRY_BAUD       115200UL
+
+// Baud rate settings for 115200 from SMCLK (TI eUSCI baud rate table)
+#if CLOCK_MHZ == 16
+#define TELEMETRY_UCBR       8
+#define TELEMETRY_UCBRF      10
+#define TELEMETRY_UCBRS      0xF7
+#define TELEMETRY_UCOS16     1
+#elif CLOCK_MHZ == 8
+#define TELEMETRY_UCBR       4
+#define TELEMETRY_UCBRF      5
+#define TELEMETRY_UCBRS      0x55
+#define TELEMETRY_UCOS16     1
+#else
+#define TELEMETRY_UCBR       8
+#define TELEMETRY_UCBRF      0
+#define TELEMETRY_UCBRS      0xD6
+#define TELEMETRY_UCOS16     0
+#endif
+
+/**************************************************************************
+ * Frame format:
+ *    SYNC0 SYNC1 TYPE SEQ LEN PAYLOAD[LEN] CRC_HI CRC_LO
+ * The CRC is CRC-16/CCITT (poly 0x1021, init 0xFFFF) over TYPE to the end
+ * of the payload. SEQ increments on every frame queued, so a receiver can
+ * count lost frames from gaps. Multi-byte payload fields are big-endian.
+ **************************************************************************/
+#define TELEMETRY_SYNC0      0xA5
+#define TELEMETRY_SYNC1      0x5A
+#define TELEMETRY_HEADER     5
+#define TELEMETRY_MAX_PAYLOAD 16
+#define TELEMETRY_OVERHEAD   (TELEMETRY_HEADER + 2)
+
+#define TELEMETRY_TX_SIZE    128  // Ring buffer size, power of two
+
+// Frame types and their payloads
+#define TELEMETRY_ADC        0x01 // tick(4) sample(2)
+#define TELEMETRY_RGB        0x02 // tick(4) red(2) green(2) blue(2)
+#define TELEMETRY_EVENT      0x03 // tick(4) event(1) value(2)
+
+// Event codes for telemetrySendEvent()
+#define TELEMETRY_EVENT_PLANET_FOUND  0x01 // Value: detector score, 0 to 100
+#define TELEMETRY_EVENT_NO_PLANET     0x02 // Value: detector score, 0 to 100
+#define TELEMETRY_EVENT_BOOT_COLD     0x03 // Value: boot to first sample, us
+#define TELEMETRY_EVENT_BOOT_WARM     0x04
+#define TELEMETRY_EVENT_STACK_PEAK    0x05 // Value: deepest stack so far, bytes (memUsage.h)
+#define TELEMETRY_EVENT_ISR_MISSED    0x06 // Value: ISR events missed since the last report (latency.h)
+#define TELEMETRY_EVENT_DECISION_MS   0x07 // Value: detect cycle start to the decision, ms; follows the two above
+
+/**************************************************************************
+ * Structure: TelemetryStats
+ * Description:
+ *    Channel counters.
+ * Members:
+ *    framesQueued - Frames accepted into the TX buffer
+ *    framesDropped - Frames rejected because the buffer was full
+ *    bytesSent - Bytes handed to the UART
+ **************************************************************************/
+typedef struct {
+    unsigned long framesQueued;
+    unsigned long framesDropped;
+    unsigned long bytesSent;
+} TelemetryStats;
+
+/**************************************************************************
+ * Function: telemetryInit
+ * Description:
+ *    Configures eUSCI_A0 for 115200 8N1 from SMCLK and routes TXD to P1.0.
+ **************************************************************************/
+void telemetryInit(void);
+
+/**************************************************************************
+ * Function: telemetrySend
+ * Description:
+ *    Queues one frame for transmission. Never blocks: if the whole frame
+ *    does not fit in the TX buffer it is dropped and counted. Safe to call
+ *    from ISRs.
+ * Parameters:
+ *    type - Frame type
+ *    payload - Payload bytes
+ *    length - Payload length (up to TELEMETRY_MAX_PAYLOAD)
+ * Returns:
+ *    1 if the frame was queued, 0 if it was dropped.
+ **************************************************************************/
+int telemetrySend(unsigned char type, const unsigned char *payload, unsigned char length);
+
+/**************************************************************************
+ * Functions: telemetrySendAdc, telemetrySendRGB, telemetrySendEvent
+ * Description:
+ *    Build and queue the standard frames, stamped with the system tick.
+ * Returns:
+ *    1 if the frame was queued, 0 if it was dropped.
+ **************************************************************************/
+int telemetrySendAdc(unsigned int sample);
+int telemetrySendRGB(unsigned int red, unsigned int green, unsigned int blue);
+int telemetrySendEvent(unsigned char event, unsigned int value);
+
+/**************************************************************************
+ * Function: telemetryGetStats
+ * Description:
+ *    Copies the channel counters.
+ * Parameters:
+ *    stats - Destination for the counters
+ **************************************************************************/
+void telemetryGetStats(TelemetryStats *stats);
+
+/**************************************************************************
+ * Function: telemetryCrc16
+ * Description:
+ *    Continues a CRC-16/CCITT over a block of bytes. Start with 0xFFFF.
+ *    Shared with the host-side decoder.
+ * Parameters:
+ *    crc - CRC so far
+ *    data - Bytes to add
+ *    length - Number of bytes
+ * Returns:
+ *    The updated CRC.
+ **************************************************************************/
+unsigned int telemetryCrc16(unsigned int crc, const unsigned char *data, unsigned char length);
+
+#endif /* TELEMETRY_H_ */
@@ -0,0 +1,230 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: timebase.c
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Period_ISR times its entry for latency.h as the PWM latch.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#include "timebase.h"
+#include "profile.h"
+#include "memUsage.h"
+#include "latency.h"
+#include <intrinsics.h>
+
+/**************************************************************************
+ * Tick subscription table. countdown is decremented every tick and the
+ * handler runs when it reaches zero. tickSlot is the slot the ISR is
+ * running, or TIMEBASE_MAX_SUBSCRIBERS outside it.
+ **************************************************************************/
+typedef struct {
+    TickHandler handler;
+    unsigned int divider;
+    unsigned int countdown;
+} TickSubscription;
+
+static TickSubscription subscribers[TIMEBASE_MAX_SUBSCRIBERS];
+static unsigned char tickSlot = TIMEBASE_MAX_SUBSCRIBERS; // Slot the ISR is at
+static unsigned char claimedChannels[2]; // One bit per CCR, per timer
+static TickHandler periodHooks[2];
+static volatile unsigned char tickHookArmed = 0; // Timer_A0's is its CCIE bit
+volatile unsigned long timebaseTickCount = 0;
+
+/**************************************************************************
+ * Function: timebaseInit
+ **************************************************************************/
+void timebaseInit(void) {
+    // Timer_A0: PWM timer, up mode, CCR0 interrupt left disabled
+    TA0CTL = TASSEL_2 | TACLR;                               // SMCLK, stopped
+    TA0EX0 = TIMEBASE_EX_BITS(TIMEBASE_TA0_DIV);
+    TA0CCR0 = TIMEBASE_PWM_PERIOD;                           // Set PWM Period
+    TA0CCTL0 = 0;
+    TA0CTL = TASSEL_2 | TIMEBASE_ID_BITS(TIMEBASE_TA0_DIV) | MC_1;
+
+    // Timer_A1: system tick, up mode, CCR0 interrupt every tick
+    TA1CTL = TASSEL_2 | TACLR;
+    TA1EX0 = TIMEBASE_EX_BITS(TIMEBASE_TA1_DIV);
+    TA1CCR0 = TIMEBASE_TICK_PERIOD - 1;
+    TA1CCTL0 = CCIE;
+    TA1CTL = TASSEL_2 | TIMEBASE_ID_BITS(TIMEBASE_TA1_DIV) | MC_1;
+
+    claimedChannels[TIMEBASE_TA0] = BIT0;
+    claimedChannels[TIMEBASE_TA1] = BIT0;
+    timebaseTickCount = 0;
+}
+
+/**************************************************************************
+ * Function: timebaseClaimChannel
+ **************************************************************************/
+int timebaseClaimChannel(unsigned char timer, unsigned char channel) {
+    if (timer > TIMEBASE_TA1 || channel >= TIMEBASE_CHANNELS) {
+        return 0;
+    }
+    if (claimedChannels[timer] & (1 << channel)) {
+        return 0;  // Already owned by another module
+    }
+    claimedChannels[timer] |= (1 << channel);
+    return 1;
+}
+
+/**************************************************************************
+ * Function: timebaseSubscribe
+ **************************************************************************/
+int timebaseSubscribe(TickHandler handler, unsigned int rateHz) {
+    int i;
+    int slot = -1;
+    unsigned short state;
+
+    if (handler == 0 || rateHz == 0 || rateHz > TIMEBASE_TICK_HZ) {
+        return -1;
+    }
+
+    // Reuse the handler's existing slot, otherwise take the first free one
+    for (i = 0; i < TIMEBASE_MAX_SUBSCRIBERS; i++) {
+        if (subscribers[i].handler == handler) {
+            slot = i;
+            break;
+        }
+        if (slot < 0 && subscribers[i].handler == 0) {
+            slot = i;
+        }
+    }
+    if (slot < 0) {
+        return -1;
+    }
+
+    state = __get_interrupt_state();
+    __disable_interrupt();
+    subscribers[slot].divider = (unsigned int)(TIMEBASE_TICK_HZ / rateHz);
+    subscribers[slot].countdown = subscribers[slot].divider;
+    if (slot > tickSlot) {
+        subscribers[slot].countdown++;  // The ISR is yet to count this tick
+    }
+    subscribers[slot].handler = handler;
+    __set_interrupt_state(state);
+
+    return slot;
+}
+
+/**************************************************************************
+ * Function: timebaseUnsubscribe
+ **************************************************************************/
+void timebaseUnsubscribe(TickHandler handler) {
+    int i;
+    for (i = 0; i < TIMEBASE_MAX_SUBSCRIBERS; i++) {
+        if (subscribers[i].handler == handler) {
+            subscribers[i].handler = 0;
+        }
+    }
+}
+
+/**************************************************************************
+ * Function: timebaseSetPeriodHook
+ **************************************************************************/
+void timebaseSetPeriodHook(unsigned char timer, TickHandler hook) {
+    if (timer <= TIMEBASE_TA1) {
+        periodHooks[timer] = hook;
+    }
+}
+
+/**************************************************************************
+ * Function: timebaseArmPeriodHook
+ **************************************************************************/
+void timebaseArmPeriodHook(unsigned char timer) {
+    unsigned short state = __get_interrupt_state();
+    __disable_interrupt();
+    if (timer == TIMEBASE_TA1) {
+        tickHookArmed = 1;
+    } else if (timer == TIMEBASE_TA0 && !(TA0CCTL0 & CCIE)) {
+        TA0CCTL0 = CCIE;  // Clears the CCIFG left by earlier periods
+    }
+    __set_interrupt_state(state);
+}
+
+/**************************************************************************
+ * Function: timebaseTicks
+ **************************************************************************/
+unsigned long timebaseTicks(void) {
+    unsigned long ticks;
+    unsigned short state = __get_interrupt_state();
+    __disable_interrupt();
+    ticks = timebaseTickCount;  // 32-bit read is not atomic on the MSP430
+    __set_interrupt_state(state);
+    return ticks;
+}
+
+/**************************************************************************
+ * Function: timebaseMicros
+ **************************************************************************/
+unsigned long timebaseMicros(void) {
+    unsigned long ticks;
+    unsigned int count;
+    unsigned short state = __get_interrupt_state();
+
+    __disable_interrupt();
+    ticks = timebaseTickCount;
+    count = TA1R;
+    // Same wrap correction as PROFILE_STAMP: the tick is raised at CCR0,
+    // one count before TA1R wraps
+    if (TA1CCTL0 & CCIFG) {
+        if (count < TIMEBASE_TICK_PERIOD / 2) ticks++;
+    } else if (count == TIMEBASE_TICK_PERIOD - 1) {
+        ticks--;
+    }
+    __set_interrupt_state(state);
+    return ticks * (1000000UL / TIMEBASE_TICK_HZ) + (unsigned long)count * (1000000UL / TIMEBASE_TICK_HZ) / TIMEBASE_TICK_PERIOD;
+}
+
+/**************************************************************************
+ * ISR: Timebase_ISR
+ * Description:
+ *    Interrupt Service Routine for TIMER1_A0_VECTOR. Fires once per system
+ *    tick, advances the tick counter and runs every subscribed handler
+ *    whose divider has elapsed.
+ **************************************************************************/
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma vector = TIMER1_A0_VECTOR
+__interrupt void Timebase_ISR(void)
+#elif defined(__GNUC__)
+void __attribute__ ((interrupt(TIMER1_A0_VECTOR))) Timebase_ISR(void)
+#endif
+{
+    if (tickHookArmed) {          // First, to land inside the first count
+        tickHookArmed = 0;
+        if (periodHooks[TIMEBASE_TA1]) periodHooks[TIMEBASE_TA1]();
+    }
+    LATENCY_TICK_ENTER();
+    timebaseTickCount++;
+    PROFILE_ISR_ENTER(PROFILE_TICK_ISR);
+    MEMUSAGE_ISR_ENTER(MEMUSAGE_TICK_ISR);
+    for (tickSlot = 0; tickSlot < TIMEBASE_MAX_SUBSCRIBERS; tickSlot++) {
+        TickSubscription *sub = &subscribers[tickSlot];
+        if (sub->handler && --sub->countdown == 0) {
+            sub->countdown = sub->divider;
+            sub->handler();
+        }
+    }
+    MEMUSAGE_ISR_EXIT(MEMUSAGE_TICK_ISR);
+    PROFILE_ISR_EXIT(PROFILE_TICK_ISR);
+}
+
+/**************************************************************************
+ * ISR: Period_ISR
+ * Description:
+ *    Interrupt Service Routine for TIMER0_A0_VECTOR. Enabled only while
+ *    the Timer_A0 period hook is armed: runs it at the start of the next
+ *    PWM period and disarms.
+ **************************************************************************/
+#if defined(__TI_COMPILER_VERSION__) || defined(__IAR_SYSTEMS_ICC__)
+#pragma vector = TIMER0_A0_VECTOR
+__interrupt void Period_ISR(void)
+#elif defined(__GNUC__)
+void __attribute__ ((interrupt(TIMER0_A0_VECTOR))) Period_ISR(void)
+#endif
+{
+    LATENCY_LATCH_ENTER();
+    if (periodHooks[TIMEBASE_TA0]) periodHooks[TIMEBASE_TA0]();
+    TA0CCTL0 = 0;
+}
@@ -0,0 +1,198 @@
+/**************************************************************************
+ * Project Name: Exoplanet Detection Simulator
+ * Module Name: timebase.h
+ * Created on: 19 Oct 2026
+ * Date Last Updated: 19/10/2026
+ * Update Description:
+ *    Added the period hooks, run at the start of a Timer_A0 or Timer_A1
+ *    period, and a shortest count so they can land in time.
+ * Author: Finlay Harris
+ **************************************************************************/
+
+#ifndef TIMEBASE_H_
+#define TIMEBASE_H_
+
+#include <msp430fr4133.h>
+#include "clock.h"
+
+/**************************************************************************
+ * Timer ownership:
+ *    Timer_A0 - LED PWM timer. CCR0 sets the PWM period and interrupts
+ *               only when its period hook is armed. CCR1 drives the red
+ *               LED (TA0.1) and CCR2 either drives the green LED (TA0.2)
+ *               or paces the software PWM (see pwm.h).
+ *    Timer_A1 - System tick. CCR0 interrupts at TIMEBASE_TICK_HZ and
+ *               runs the period hook, if armed, then the subscribed tick
+ *               handlers. CCR2 drives the blue LED (TA1.2) with the
+ *               hardware PWM backend.
+ * Both timers are divided down from SMCLK so each consumer gets the rate
+ * it declares below, whatever clock the system is running at, as long as
+ * a count stays TIMEBASE_COUNT_CYCLES long.
+ **************************************************************************/
+#define TIMEBASE_SMCLK_HZ    CLOCK_SMCLK_HZ
+
+#define TIMEBASE_PWM_PERIOD  100       // TA0CCR0 value, red duty range 0-100
+#define TIMEBASE_PWM_HZ      5000UL    // TA0 period rate (software PWM step rate)
+#define TIMEBASE_TICK_HZ     1000UL    // System tick rate (1 ms)
+
+// Timer identifiers and channel count for timebaseClaimChannel()
+#define TIMEBASE_TA0         0
+#define TIMEBASE_TA1         1
+#define TIMEBASE_CHANNELS    3
+
+/**************************************************************************
+ * Tick handlers that can be subscribed at once. The firmware runs six:
+ * the colour sensor timeout, the hardware PWM latch, the LCD bus, the
+ * show script, the detector and the ADC sequence trigger. Raise it at
+ * build time when adding more.
+ **************************************************************************/
+#ifndef TIMEBASE_MAX_SUBSCRIBERS
+#define TIMEBASE_MAX_SUBSCRIBERS 8
+#endif
+
+/**************************************************************************
+ * Divider selection:
+ *    The input divider is split into ID (/1, /2, /4, /8) and the TAxEX0
+ *    expansion divider (/1 to /8). The smallest ID that keeps the
+ *    expansion divider in range is used, so the timer clock stays as
+ *    close as possible to the requested rate.
+ **************************************************************************/
+#define TIMEBASE_RAW_DIV(hz)   ((TIMEBASE_SMCLK_HZ + (hz) / 2) / (hz))
+#define TIMEBASE_ID_DIV(div)   ((div) <= 8 ? 1 : (div) <= 16 ? 2 : (div) <= 32 ? 4 : 8)
+#define TIMEBASE_EX_DIV(div)   (((div) + TIMEBASE_ID_DIV(div) / 2) / TIMEBASE_ID_DIV(div))
+#define TIMEBASE_ID_BITS(div)  (TIMEBASE_ID_DIV(div) == 1 ? ID_0 : TIMEBASE_ID_DIV(div) == 2 ? ID_1 : \
+                                TIMEBASE_ID_DIV(div) == 4 ? ID_2 : ID_3)
+#define TIMEBASE_EX_BITS(div)  (TIMEBASE_EX_DIV(div) - 1)
+
+/**************************************************************************
+ * Shortest timer count, in SMCLK cycles. A period hook writes compares
+ * from the CCR0 interrupt, raised one count before the new period's first
+ * match (a compare of 0), and needs up to about 30 cycles from the flag
+ * to its last write. Below 16 MHz the PWM and tick rates lose accuracy
+ * to keep this: at 1 MHz the PWM runs at 314 Hz and the tick at 992 Hz.
+ **************************************************************************/
+#define TIMEBASE_COUNT_CYCLES  32
+
+// Timer_A0: one PWM period (TIMEBASE_PWM_PERIOD + 1 counts) at TIMEBASE_PWM_HZ,
+// or slower if that would make a count shorter than TIMEBASE_COUNT_CYCLES
+#define TIMEBASE_PWM_DIV       TIMEBASE_RAW_DIV(TIMEBASE_PWM_HZ * (TIMEBASE_PWM_PERIOD + 1))
+#define TIMEBASE_TA0_DIV       (TIMEBASE_PWM_DIV > TIMEBASE_COUNT_CYCLES ? TIMEBASE_PWM_DIV : TIMEBASE_COUNT_CYCLES)
+#define TIMEBASE_TA0_CLK_HZ    (TIMEBASE_SMCLK_HZ / (TIMEBASE_ID_DIV(TIMEBASE_TA0_DIV) * TIMEBASE_EX_DIV(TIMEBASE_TA0_DIV)))
+
+// Timer_A1: same input clock as Timer_A0, period chosen for the tick rate
+#define TIMEBASE_TA1_DIV       TIMEBASE_TA0_DIV
+#define TIMEBASE_TA1_CLK_HZ    TIMEBASE_TA0_CLK_HZ
+#define TIMEBASE_TICK_PERIOD   ((TIMEBASE_TA1_CLK_HZ + TIMEBASE_TICK_HZ / 2) / TIMEBASE_TICK_HZ)
+
+#if TIMEBASE_EX_DIV(TIMEBASE_TA0_DIV) > 8
+#error "timebase: SMCLK too fast for the requested PWM rate"
+#endif
+#if TIMEBASE_TICK_PERIOD < 2 || TIMEBASE_TICK_PERIOD > 65536
+#error "timebase: tick period does not fit in Timer_A1"
+#endif
+
+/**************************************************************************
+ * Global Variable:
+ *    timebaseTickCount - System ticks since timebaseInit(). Use
+ *    timebaseTicks() for a consistent 32-bit read; the low word alone can
+ *    be read directly, e.g. together with TA1R for a fine timestamp.
+ **************************************************************************/
+extern volatile unsigned long timebaseTickCount;
+
+/**************************************************************************
+ * Type: TickHandler
+ * Description:
+ *    Callback run from the Timer_A1 tick interrupt. Handlers run with
+ *    interrupts disabled and must be short.
+ **************************************************************************/
+typedef void (*TickHandler)(void);
+
+/**************************************************************************
+ * Function: timebaseInit
+ * Description:
+ *    Configures Timer_A0 as the PWM timer and Timer_A1 as the system tick,
+ *    using the dividers and periods computed above. Claims CCR0 of both
+ *    timers. Must be called before any other timer user is set up.
+ **************************************************************************/
+void timebaseInit(void);
+
+/**************************************************************************
+ * Function: timebaseClaimChannel
+ * Description:
+ *    Reserves a capture/compare channel so two modules cannot silently
+ *    reprogram the same CCR.
+ * Parameters:
+ *    timer - TIMEBASE_TA0 or TIMEBASE_TA1
+ *    channel - CCR number (0 to 2)
+ * Returns:
+ *    1 if the channel was free and is now claimed, 0 otherwise.
+ **************************************************************************/
+int timebaseClaimChannel(unsigned char timer, unsigned char channel);
+
+/**************************************************************************
+ * Function: timebaseSubscribe
+ * Description:
+ *    Runs a handler at the declared rate from the system tick. The tick
+ *    divider is computed from TIMEBASE_TICK_HZ. Subscribing the same
+ *    handler again updates its rate rather than adding a second entry.
+ *    May be called from a tick handler: the first call is always a whole
+ *    divider away, whichever slot is taken.
+ * Parameters:
+ *    handler - Function to call
+ *    rateHz - Call rate in Hz (1 to TIMEBASE_TICK_HZ)
+ * Returns:
+ *    The subscription slot, or -1 if the rate is invalid or the table
+ *    is full.
+ **************************************************************************/
+int timebaseSubscribe(TickHandler handler, unsigned int rateHz);
+
+/**************************************************************************
+ * Function: timebaseUnsubscribe
+ * Description:
+ *    Removes a handler previously added with timebaseSubscribe().
+ * Parameters:
+ *    handler - Function to remove
+ **************************************************************************/
+void timebaseUnsubscribe(TickHandler handler);
+
+/**************************************************************************
+ * Function: timebaseSetPeriodHook
+ * Description:
+ *    Installs the handler run once at the start of a timer's period each
+ *    time it is armed with timebaseArmPeriodHook(). It runs first thing
+ *    in that timer's CCR0 interrupt, before the tick handlers, so compare
+ *    registers written from it take effect from the period just started.
+ *    One hook per timer; pass 0 to remove it.
+ * Parameters:
+ *    timer - TIMEBASE_TA0 or TIMEBASE_TA1
+ *    hook - Function to call, with interrupts disabled
+ **************************************************************************/
+void timebaseSetPeriodHook(unsigned char timer, TickHandler hook);
+
+/**************************************************************************
+ * Function: timebaseArmPeriodHook
+ * Description:
+ *    Runs the timer's period hook at the start of its next period. Arming
+ *    it again before then has no further effect.
+ * Parameters:
+ *    timer - TIMEBASE_TA0 or TIMEBASE_TA1
+ **************************************************************************/
+void timebaseArmPeriodHook(unsigned char timer);
+
+/**************************************************************************
+ * Function: timebaseTicks
+ * Description:
+ *    Returns the number of system ticks since timebaseInit().
+ **************************************************************************/
+unsigned long timebaseTicks(void);
+
+/**************************************************************************
+ * Function: timebaseMicros
+ * Description:
+ *    Returns microseconds since timebaseInit(), from the tick count and
+ *    TA1R. Wraps after about 71 minutes; only differences are meaningful.
+ *    Works with interrupts disabled for up to one tick.
+ **************************************************************************/
+unsigned long timebaseMicros(void);
+
+#endif /* TIMEBASE_H_ */